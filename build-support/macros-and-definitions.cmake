@@ -890,6 +890,10 @@ macro(process_options)
     endif()
   endif()
 
+  if(${NS3_MTP})
+    add_definitions(-DNS3_MTP)
+  endif()
+
   if(${NS3_VERBOSE})
     set_property(GLOBAL PROPERTY TARGET_MESSAGES TRUE)
     set(CMAKE_FIND_DEBUG_MODE TRUE)
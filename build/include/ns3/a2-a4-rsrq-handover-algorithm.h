@@ -0,0 +1 @@
+/root/repo/src/lte/model/a2-a4-rsrq-handover-algorithm.h
\ No newline at end of file
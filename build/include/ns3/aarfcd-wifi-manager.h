@@ -0,0 +1 @@
+/root/repo/src/wifi/model/rate-control/aarfcd-wifi-manager.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/uan/helper/acoustic-modem-energy-model-helper.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/wifi/model/amsdu-subframe-header.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/antenna/model/angles.h
\ No newline at end of file
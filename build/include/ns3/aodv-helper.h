@@ -0,0 +1 @@
+/root/repo/src/aodv/helper/aodv-helper.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/aodv/model/aodv-routing-protocol.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/wifi/model/ap-wifi-mac.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/internet/model/arp-header.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/internet/model/arp-queue-disc-item.h
\ No newline at end of file
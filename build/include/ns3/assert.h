@@ -0,0 +1 @@
+/root/repo/src/core/model/assert.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/core/model/attribute-container.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/energy/helper/basic-energy-source-helper.h
\ No newline at end of file
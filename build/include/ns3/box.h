@@ -0,0 +1 @@
+/root/repo/src/mobility/model/box.h
\ No newline at end of file
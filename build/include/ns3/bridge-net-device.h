@@ -0,0 +1 @@
+/root/repo/src/bridge/model/bridge-net-device.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/buildings/model/buildings-channel-condition-model.h
\ No newline at end of file
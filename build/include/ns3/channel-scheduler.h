@@ -0,0 +1 @@
+/root/repo/src/wave/model/channel-scheduler.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/core/model/compact-heap-scheduler.h
\ No newline at end of file
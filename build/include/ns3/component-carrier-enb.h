@@ -0,0 +1 @@
+/root/repo/src/lte/model/component-carrier-enb.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/lte/model/component-carrier-ue.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/lte/model/component-carrier.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/core/model/default-simulator-impl.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/network/helper/delay-jitter-estimation.h
\ No newline at end of file
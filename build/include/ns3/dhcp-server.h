@@ -0,0 +1 @@
+/root/repo/src/internet-apps/model/dhcp-server.h
\ No newline at end of file
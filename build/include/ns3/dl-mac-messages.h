@@ -0,0 +1 @@
+/root/repo/src/wimax/model/dl-mac-messages.h
\ No newline at end of file
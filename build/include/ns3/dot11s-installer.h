@@ -0,0 +1 @@
+/root/repo/src/mesh/helper/dot11s/dot11s-installer.h
\ No newline at end of file
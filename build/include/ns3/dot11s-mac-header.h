@@ -0,0 +1 @@
+/root/repo/src/mesh/model/dot11s/dot11s-mac-header.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/stats/model/double-probe.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/dsdv/model/dsdv-packet-queue.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/dsdv/model/dsdv-rtable.h
\ No newline at end of file
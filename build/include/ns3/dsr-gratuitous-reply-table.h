@@ -0,0 +1 @@
+/root/repo/src/dsr/model/dsr-gratuitous-reply-table.h
\ No newline at end of file
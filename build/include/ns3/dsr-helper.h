@@ -0,0 +1 @@
+/root/repo/src/dsr/helper/dsr-helper.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/dsr/model/dsr-network-queue.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/dsr/model/dsr-rcache.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/dsr/model/dsr-rsendbuff.h
\ No newline at end of file
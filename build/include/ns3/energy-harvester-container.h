@@ -0,0 +1 @@
+/root/repo/src/energy/helper/energy-harvester-container.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/energy/helper/energy-model-helper.h
\ No newline at end of file
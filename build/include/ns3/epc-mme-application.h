@@ -0,0 +1 @@
+/root/repo/src/lte/model/epc-mme-application.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/lte/model/eps-bearer-tag.h
\ No newline at end of file
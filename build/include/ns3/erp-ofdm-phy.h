@@ -0,0 +1 @@
+/root/repo/src/wifi/model/non-ht/erp-ofdm-phy.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/core/model/event-impl.h
\ No newline at end of file
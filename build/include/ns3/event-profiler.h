@@ -0,0 +1 @@
+/root/repo/src/core/model/event-profiler.h
\ No newline at end of file
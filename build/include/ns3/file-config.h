@@ -0,0 +1 @@
+/root/repo/src/config-store/model/file-config.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/flow-monitor/model/flow-classifier.h
\ No newline at end of file
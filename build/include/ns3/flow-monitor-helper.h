@@ -0,0 +1 @@
+/root/repo/src/flow-monitor/helper/flow-monitor-helper.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/stats/model/get-wildcard-matches.h
\ No newline at end of file
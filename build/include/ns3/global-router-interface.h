@@ -0,0 +1 @@
+/root/repo/src/internet/model/global-router-interface.h
\ No newline at end of file
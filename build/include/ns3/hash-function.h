@@ -0,0 +1 @@
+/root/repo/src/core/model/hash-function.h
\ No newline at end of file
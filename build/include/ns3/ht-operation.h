@@ -0,0 +1 @@
+/root/repo/src/wifi/model/ht/ht-operation.h
\ No newline at end of file
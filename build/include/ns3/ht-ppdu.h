@@ -0,0 +1 @@
+/root/repo/src/wifi/model/ht/ht-ppdu.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/internet/helper/internet-stack-helper.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/flow-monitor/model/ipv4-flow-classifier.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/internet/model/ipv4-l3-protocol.h
\ No newline at end of file
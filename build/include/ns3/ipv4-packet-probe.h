@@ -0,0 +1 @@
+/root/repo/src/internet/model/ipv4-packet-probe.h
\ No newline at end of file
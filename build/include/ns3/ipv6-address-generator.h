@@ -0,0 +1 @@
+/root/repo/src/internet/model/ipv6-address-generator.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/propagation/model/itu-r-1411-los-propagation-loss-model.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/mtp/model/logical-process.h
\ No newline at end of file
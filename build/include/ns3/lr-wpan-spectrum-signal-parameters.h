@@ -0,0 +1 @@
+/root/repo/src/lr-wpan/model/lr-wpan-spectrum-signal-parameters.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/lte/model/lte-amc.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/lte/model/lte-asn1-header.h
\ No newline at end of file
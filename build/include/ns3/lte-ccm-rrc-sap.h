@@ -0,0 +1 @@
+/root/repo/src/lte/model/lte-ccm-rrc-sap.h
\ No newline at end of file
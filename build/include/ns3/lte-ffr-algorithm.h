@@ -0,0 +1 @@
+/root/repo/src/lte/model/lte-ffr-algorithm.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/lte/model/lte-fr-hard-algorithm.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/lte/model/lte-pdcp-header.h
\ No newline at end of file
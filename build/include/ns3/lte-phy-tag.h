@@ -0,0 +1 @@
+/root/repo/src/lte/model/lte-phy-tag.h
\ No newline at end of file
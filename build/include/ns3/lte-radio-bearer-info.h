@@ -0,0 +1 @@
+/root/repo/src/lte/model/lte-radio-bearer-info.h
\ No newline at end of file
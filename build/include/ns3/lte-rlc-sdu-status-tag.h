@@ -0,0 +1 @@
+/root/repo/src/lte/model/lte-rlc-sdu-status-tag.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/lte/model/lte-rrc-header.h
\ No newline at end of file
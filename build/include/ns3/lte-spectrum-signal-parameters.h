@@ -0,0 +1 @@
+/root/repo/src/lte/model/lte-spectrum-signal-parameters.h
\ No newline at end of file
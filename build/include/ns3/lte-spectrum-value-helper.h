@@ -0,0 +1 @@
+/root/repo/src/lte/model/lte-spectrum-value-helper.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/lte/model/lte-ue-mac.h
\ No newline at end of file
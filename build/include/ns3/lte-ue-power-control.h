@@ -0,0 +1 @@
+/root/repo/src/lte/model/lte-ue-power-control.h
\ No newline at end of file
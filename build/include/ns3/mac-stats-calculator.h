@@ -0,0 +1 @@
+/root/repo/src/lte/helper/mac-stats-calculator.h
\ No newline at end of file
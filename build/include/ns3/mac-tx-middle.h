@@ -0,0 +1 @@
+/root/repo/src/wifi/model/mac-tx-middle.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/network/utils/mac16-address.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/network/utils/mac48-address.h
\ No newline at end of file
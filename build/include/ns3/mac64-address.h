@@ -0,0 +1 @@
+/root/repo/src/network/utils/mac64-address.h
\ No newline at end of file
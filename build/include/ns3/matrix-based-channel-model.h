@@ -0,0 +1 @@
+/root/repo/src/spectrum/model/matrix-based-channel-model.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/mesh/helper/mesh-helper.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/mesh/helper/mesh-stack-installer.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/wifi/model/rate-control/minstrel-wifi-manager.h
\ No newline at end of file
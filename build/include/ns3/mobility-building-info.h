@@ -0,0 +1 @@
+/root/repo/src/buildings/model/mobility-building-info.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/mtp/model/multithreaded-simulator-impl.h
\ No newline at end of file
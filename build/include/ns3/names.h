@@ -0,0 +1 @@
+/root/repo/src/core/model/names.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/network/model/node.h
\ No newline at end of file
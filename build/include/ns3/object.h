@@ -0,0 +1 @@
+/root/repo/src/core/model/object.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/wimax/model/ofdm-downlink-frame-prefix.h
\ No newline at end of file
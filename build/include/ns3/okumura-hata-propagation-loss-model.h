@@ -0,0 +1 @@
+/root/repo/src/propagation/model/okumura-hata-propagation-loss-model.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/olsr/helper/olsr-helper.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/olsr/model/olsr-routing-protocol.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/network/model/packet-metadata.h
\ No newline at end of file
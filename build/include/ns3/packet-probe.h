@@ -0,0 +1 @@
+/root/repo/src/network/utils/packet-probe.h
\ No newline at end of file
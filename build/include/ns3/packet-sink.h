@@ -0,0 +1 @@
+/root/repo/src/applications/model/packet-sink.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/network/utils/packet-socket.h
\ No newline at end of file
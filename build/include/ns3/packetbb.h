@@ -0,0 +1 @@
+/root/repo/src/network/utils/packetbb.h
\ No newline at end of file
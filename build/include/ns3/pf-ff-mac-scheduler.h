@@ -0,0 +1 @@
+/root/repo/src/lte/model/pf-ff-mac-scheduler.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/internet-apps/helper/ping6-helper.h
\ No newline at end of file
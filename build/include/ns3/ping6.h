@@ -0,0 +1 @@
+/root/repo/src/internet-apps/model/ping6.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/wifi/model/preamble-detection-model.h
\ No newline at end of file
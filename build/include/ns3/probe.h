@@ -0,0 +1 @@
+/root/repo/src/stats/model/probe.h
\ No newline at end of file
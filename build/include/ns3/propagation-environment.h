@@ -0,0 +1 @@
+/root/repo/src/propagation/model/propagation-environment.h
\ No newline at end of file
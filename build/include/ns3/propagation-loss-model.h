@@ -0,0 +1 @@
+/root/repo/src/propagation/model/propagation-loss-model.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/traffic-control/helper/queue-disc-container.h
\ No newline at end of file
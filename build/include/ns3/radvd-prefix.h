@@ -0,0 +1 @@
+/root/repo/src/internet-apps/model/radvd-prefix.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/internet-apps/model/radvd.h
\ No newline at end of file
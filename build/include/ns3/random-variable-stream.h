@@ -0,0 +1 @@
+/root/repo/src/core/model/random-variable-stream.h
\ No newline at end of file
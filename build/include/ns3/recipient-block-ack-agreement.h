@@ -0,0 +1 @@
+/root/repo/src/wifi/model/recipient-block-ack-agreement.h
\ No newline at end of file
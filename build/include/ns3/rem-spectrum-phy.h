@@ -0,0 +1 @@
+/root/repo/src/lte/model/rem-spectrum-phy.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/wimax/model/service-flow-record.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/wimax/model/simple-ofdm-send-param.h
\ No newline at end of file
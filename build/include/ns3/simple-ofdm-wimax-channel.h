@@ -0,0 +1 @@
+/root/repo/src/wimax/model/simple-ofdm-wimax-channel.h
\ No newline at end of file
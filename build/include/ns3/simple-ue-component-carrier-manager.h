@@ -0,0 +1 @@
+/root/repo/src/lte/model/simple-ue-component-carrier-manager.h
\ No newline at end of file
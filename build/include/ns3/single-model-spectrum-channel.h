@@ -0,0 +1 @@
+/root/repo/src/spectrum/model/single-model-spectrum-channel.h
\ No newline at end of file
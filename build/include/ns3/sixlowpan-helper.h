@@ -0,0 +1 @@
+/root/repo/src/sixlowpan/helper/sixlowpan-helper.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/sixlowpan/model/sixlowpan-net-device.h
\ No newline at end of file
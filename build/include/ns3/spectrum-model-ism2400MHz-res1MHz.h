@@ -0,0 +1 @@
+/root/repo/src/spectrum/model/spectrum-model-ism2400MHz-res1MHz.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/spectrum/model/spectrum-model.h
\ No newline at end of file
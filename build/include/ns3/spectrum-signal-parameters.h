@@ -0,0 +1 @@
+/root/repo/src/spectrum/model/spectrum-signal-parameters.h
\ No newline at end of file
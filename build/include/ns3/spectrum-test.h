@@ -0,0 +1 @@
+/root/repo/src/spectrum/test/spectrum-test.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/wifi/model/spectrum-wifi-phy.h
\ No newline at end of file
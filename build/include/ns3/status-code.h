@@ -0,0 +1 @@
+/root/repo/src/wifi/model/status-code.h
\ No newline at end of file
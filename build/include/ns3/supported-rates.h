@@ -0,0 +1 @@
+/root/repo/src/wifi/model/supported-rates.h
\ No newline at end of file
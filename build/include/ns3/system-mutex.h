@@ -0,0 +1 @@
+/root/repo/src/core/model/system-mutex.h
\ No newline at end of file
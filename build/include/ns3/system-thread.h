@@ -0,0 +1 @@
+/root/repo/src/core/model/system-thread.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/core/model/system-wall-clock-timestamp.h
\ No newline at end of file
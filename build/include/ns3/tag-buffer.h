@@ -0,0 +1 @@
+/root/repo/src/network/model/tag-buffer.h
\ No newline at end of file
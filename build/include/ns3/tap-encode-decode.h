@@ -0,0 +1 @@
+/root/repo/src/tap-bridge/model/tap-encode-decode.h
\ No newline at end of file
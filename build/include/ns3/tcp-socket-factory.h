@@ -0,0 +1 @@
+/root/repo/src/internet/model/tcp-socket-factory.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/spectrum/model/three-gpp-channel-model.h
\ No newline at end of file
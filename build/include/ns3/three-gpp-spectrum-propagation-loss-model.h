@@ -0,0 +1 @@
+/root/repo/src/spectrum/model/three-gpp-spectrum-propagation-loss-model.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/wifi/model/threshold-preamble-detection-model.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/core/model/timer.h
\ No newline at end of file
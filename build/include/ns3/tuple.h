@@ -0,0 +1 @@
+/root/repo/src/core/model/tuple.h
\ No newline at end of file
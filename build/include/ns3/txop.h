@@ -0,0 +1 @@
+/root/repo/src/wifi/model/txop.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/uan/model/uan-header-common.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/uan/model/uan-mac-aloha.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/uan/model/uan-mac-cw.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/uan/model/uan-noise-model.h
\ No newline at end of file
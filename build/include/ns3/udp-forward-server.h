@@ -0,0 +1 @@
+/root/repo/src/applications/model/udp-forward-server.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/applications/model/udp-iomust-client.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/applications/helper/udp-iomust-helper.h
\ No newline at end of file
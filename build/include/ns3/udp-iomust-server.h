@@ -0,0 +1 @@
+/root/repo/src/applications/model/udp-iomust-server.h
\ No newline at end of file
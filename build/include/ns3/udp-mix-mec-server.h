@@ -0,0 +1 @@
+/root/repo/src/applications/model/udp-mix-mec-server.h
\ No newline at end of file
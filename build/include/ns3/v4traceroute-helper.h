@@ -0,0 +1 @@
+/root/repo/src/internet-apps/helper/v4traceroute-helper.h
\ No newline at end of file
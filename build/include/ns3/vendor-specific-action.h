@@ -0,0 +1 @@
+/root/repo/src/wave/model/vendor-specific-action.h
\ No newline at end of file
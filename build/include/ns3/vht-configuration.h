@@ -0,0 +1 @@
+/root/repo/src/wifi/model/vht/vht-configuration.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/wifi/model/vht/vht-phy.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/wifi/model/vht/vht-ppdu.h
\ No newline at end of file
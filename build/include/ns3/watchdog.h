@@ -0,0 +1 @@
+/root/repo/src/core/model/watchdog.h
\ No newline at end of file
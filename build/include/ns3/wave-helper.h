@@ -0,0 +1 @@
+/root/repo/src/wave/helper/wave-helper.h
\ No newline at end of file
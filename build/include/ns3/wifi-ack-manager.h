@@ -0,0 +1 @@
+/root/repo/src/wifi/model/wifi-ack-manager.h
\ No newline at end of file
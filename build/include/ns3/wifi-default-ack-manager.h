@@ -0,0 +1 @@
+/root/repo/src/wifi/model/wifi-default-ack-manager.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/wifi/helper/wifi-helper.h
\ No newline at end of file
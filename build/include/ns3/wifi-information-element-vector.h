@@ -0,0 +1 @@
+/root/repo/src/wifi/model/wifi-information-element-vector.h
\ No newline at end of file
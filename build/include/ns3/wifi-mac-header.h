@@ -0,0 +1 @@
+/root/repo/src/wifi/model/wifi-mac-header.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/wifi/model/wifi-mac-queue-item.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/wifi/model/wifi-phy-common.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/wifi/model/wifi-phy-state-helper.h
\ No newline at end of file
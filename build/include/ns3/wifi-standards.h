@@ -0,0 +1 @@
+/root/repo/src/wifi/model/wifi-standards.h
\ No newline at end of file
@@ -0,0 +1 @@
+/root/repo/src/wimax/helper/wimax-helper.h
\ No newline at end of file
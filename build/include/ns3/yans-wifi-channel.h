@@ -0,0 +1 @@
+/root/repo/src/wifi/model/yans-wifi-channel.h
\ No newline at end of file
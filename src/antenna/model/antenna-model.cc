@@ -21,6 +21,7 @@
 
 #include <ns3/log.h>
 #include <cmath>
+#include <limits>
 #include "antenna-model.h"
 
 
@@ -39,6 +40,12 @@ AntennaModel::~AntennaModel ()
 {
 }
 
+double
+AntennaModel::GetMaxGainDb (void) const
+{
+  return std::numeric_limits<double>::infinity ();
+}
+
 TypeId
 AntennaModel::GetTypeId ()
 {
@@ -80,6 +80,15 @@ public:
    */
   virtual double GetGainDb (Angles a) = 0;
 
+  /**
+   * An upper bound of the gain of the radiation pattern, used e.g. by
+   * the channels to skip the receivers out of reach of a transmission.
+   * The default implementation returns an infinite gain, i.e., no bound.
+   *
+   * eturn an upper bound, in dBi, of the values returned by GetGainDb
+   */
+  virtual double GetMaxGainDb (void) const;
+
 };
 
 
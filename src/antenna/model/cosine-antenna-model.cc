@@ -173,5 +173,12 @@ CosineAntennaModel::GetGainDb (Angles a)
   return gainDb + m_maxGain;
 }
 
+double
+CosineAntennaModel::GetMaxGainDb (void) const
+{
+  // both cosine factors are at most one
+  return m_maxGain;
+}
+
 
 }
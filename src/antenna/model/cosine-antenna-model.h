@@ -58,6 +58,7 @@ public:
 
   // inherited from AntennaModel
   virtual double GetGainDb (Angles a);
+  virtual double GetMaxGainDb (void) const;
 
   /**
    * Get the vertical 3 dB beamwidth of the cosine antenna model.
@@ -62,5 +62,11 @@ IsotropicAntennaModel::GetGainDb (Angles a)
   return m_gainDb;
 }
 
+double
+IsotropicAntennaModel::GetMaxGainDb (void) const
+{
+  return m_gainDb;
+}
+
 }
 
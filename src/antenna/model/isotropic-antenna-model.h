@@ -48,6 +48,7 @@ public:
 
   // inherited from AntennaModel
   virtual double GetGainDb (Angles a);
+  virtual double GetMaxGainDb (void) const;
 
 protected:
 
@@ -113,6 +113,12 @@ ParabolicAntennaModel::GetGainDb (Angles a)
   return gainDb;
 }
 
+double
+ParabolicAntennaModel::GetMaxGainDb (void) const
+{
+  return std::max (0.0, -m_maxAttenuation);
+}
+
 
 }
 
@@ -55,6 +55,7 @@ public:
 
   // inherited from AntennaModel
   virtual double GetGainDb (Angles a);
+  virtual double GetMaxGainDb (void) const;
 
 
   // attribute getters/setters
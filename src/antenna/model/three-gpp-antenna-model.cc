@@ -113,6 +113,13 @@ ThreeGppAntennaModel::GetGainDb (Angles a)
 
 }
 
+double
+ThreeGppAntennaModel::GetMaxGainDb (void) const
+{
+  // the attenuation of each cut is at least min (limit, 0)
+  return m_geMax - std::min (m_aMax, std::min (m_slaV, 0.0) + std::min (m_aMax, 0.0));
+}
+
 
 }
 
@@ -46,6 +46,7 @@ public:
 
   // inherited from AntennaModel
   virtual double GetGainDb (Angles a) override;
+  virtual double GetMaxGainDb (void) const override;
 
   /**
    * Get the vertical beamwidth of the antenna element.
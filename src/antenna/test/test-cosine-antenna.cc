@@ -115,6 +115,7 @@ CosineAntennaModelTestCase::DoRun ()
   a->SetAttribute ("Orientation", DoubleValue (m_o));
   a->SetAttribute ("MaxGain", DoubleValue (m_g));
   double actualGain = a->GetGainDb (m_a);
+  NS_TEST_EXPECT_MSG_LT_OR_EQ (actualGain, a->GetMaxGainDb (), "gain higher than the maximum gain");
   switch (m_cond) 
     {
     case EQUAL:
@@ -28,7 +28,10 @@
 #include "attribute.h"
 #include "attribute-helper.h"
 #include "simple-ref-count.h"
+#include <cstddef>
+#include <new>
 #include <typeinfo>
+#include <utility>
 
 /**
  * \file
@@ -122,8 +125,63 @@ public:
    * \return The object type as a string.
    */
   virtual std::string GetTypeid (void) const = 0;
+  /**
+   * Copy this object into the inline storage of a Callback.
+   *
+   * \param [in] storage The storage, large enough for this object.
+   * \return The copy.
+   */
+  virtual CallbackImplBase * CopyTo ([[maybe_unused]] void *storage) const
+  {
+    NS_FATAL_ERROR ("This callback implementation cannot be stored inline");
+    return 0;
+  }
+  /**
+   * Copy this object on the heap.
+   *
+   * \return The copy.
+   */
+  virtual Ptr<CallbackImplBase> Clone (void) const
+  {
+    NS_FATAL_ERROR ("This callback implementation cannot be copied");
+    return 0;
+  }
+
+  /** Size of the inline storage of a Callback. */
+  static const std::size_t INLINE_SIZE = 6 * sizeof (void *);
+  /**
+   * \tparam IMPL \explicit The implementation type.
+   * \return \c true if \pname{IMPL} fits in the inline storage of a Callback.
+   */
+  template <typename IMPL>
+  static constexpr bool FitsInline (void)
+  {
+    return sizeof (IMPL) <= INLINE_SIZE && alignof (IMPL) <= alignof (void *);
+  }
 
 protected:
+  /**
+   * Copy an implementation into the inline storage of a Callback.
+   * Only the implementations which fit are ever copied there.
+   *
+   * \tparam IMPL \deduced The implementation type.
+   * \param [in] impl The implementation.
+   * \param [in] storage The storage.
+   * \return The copy.
+   */
+  template <typename IMPL>
+  static CallbackImplBase * CopyInline (const IMPL &impl, [[maybe_unused]] void *storage)
+  {
+    if constexpr (FitsInline<IMPL> ())
+      {
+        return new (storage) IMPL (impl);
+      }
+    else
+      {
+        return impl.CallbackImplBase::CopyTo (storage);
+      }
+  }
+
   /**
    * \param [in] mangled The mangled string
    * \return The demangled form of mangled
@@ -584,6 +642,15 @@ public:
     return true;
   }
 
+  virtual CallbackImplBase * CopyTo (void *storage) const
+  {
+    return CallbackImplBase::CopyInline (*this, storage);
+  }
+  virtual Ptr<CallbackImplBase> Clone (void) const
+  {
+    return Ptr<CallbackImplBase> (new FunctorCallbackImpl (*this), false);
+  }
+
 private:
   T m_functor;                          //!< the functor
 };
@@ -749,6 +816,15 @@ public:
     return true;
   }
 
+  virtual CallbackImplBase * CopyTo (void *storage) const
+  {
+    return CallbackImplBase::CopyInline (*this, storage);
+  }
+  virtual Ptr<CallbackImplBase> Clone (void) const
+  {
+    return Ptr<CallbackImplBase> (new MemPtrCallbackImpl (*this), false);
+  }
+
 private:
   OBJ_PTR const m_objPtr;               //!< the object pointer
   MEM_PTR m_memPtr;                     //!< the member function pointer
@@ -903,6 +979,15 @@ public:
     return true;
   }
 
+  virtual CallbackImplBase * CopyTo (void *storage) const
+  {
+    return CallbackImplBase::CopyInline (*this, storage);
+  }
+  virtual Ptr<CallbackImplBase> Clone (void) const
+  {
+    return Ptr<CallbackImplBase> (new BoundFunctorCallbackImpl (*this), false);
+  }
+
 private:
   T m_functor;                          //!< The functor
   typename TypeTraits<TX>::ReferencedType m_a;  //!< the bound argument
@@ -1046,6 +1131,15 @@ public:
     return true;
   }
 
+  virtual CallbackImplBase * CopyTo (void *storage) const
+  {
+    return CallbackImplBase::CopyInline (*this, storage);
+  }
+  virtual Ptr<CallbackImplBase> Clone (void) const
+  {
+    return Ptr<CallbackImplBase> (new TwoBoundFunctorCallbackImpl (*this), false);
+  }
+
 private:
   T m_functor;                                    //!< The functor
   typename TypeTraits<TX1>::ReferencedType m_a1;  //!< first bound argument
@@ -1180,6 +1274,15 @@ public:
     return true;
   }
 
+  virtual CallbackImplBase * CopyTo (void *storage) const
+  {
+    return CallbackImplBase::CopyInline (*this, storage);
+  }
+  virtual Ptr<CallbackImplBase> Clone (void) const
+  {
+    return Ptr<CallbackImplBase> (new ThreeBoundFunctorCallbackImpl (*this), false);
+  }
+
 private:
   T m_functor;                                    //!< The functor
   typename TypeTraits<TX1>::ReferencedType m_a1;  //!< first bound argument
@@ -1191,26 +1294,138 @@ private:
  * \ingroup callbackimpl
  * Base class for Callback class.
  * Provides pimpl abstraction.
+ *
+ * Small implementations, such as an object pointer and a member
+ * function pointer, or a function pointer and a couple of bound
+ * arguments, are stored inline, so building, copying and invoking
+ * the Callback does not touch the heap.  Larger implementations are
+ * allocated on the heap, and shared by the copies of the Callback.
  */
 class CallbackBase
 {
 public:
-  CallbackBase () : m_impl ()
+  CallbackBase () : m_impl (), m_peek (0)
   {}
-  /** \return The impl pointer */
+  /**
+   * Copy constructor.
+   * \param [in] o The other Callback.
+   */
+  CallbackBase (const CallbackBase &o)
+    : m_impl (), m_peek (0)
+  {
+    DoCopy (o);
+  }
+  /**
+   * Assignment operator.
+   * \param [in] o The other Callback.
+   * \returns This Callback.
+   */
+  CallbackBase & operator = (const CallbackBase &o)
+  {
+    if (this != &o)
+      {
+        Reset ();
+        DoCopy (o);
+      }
+    return *this;
+  }
+  ~CallbackBase ()
+  {
+    Reset ();
+  }
+  /**
+   * \return The impl pointer.  If the implementation is stored inline,
+   *         this is a heap copy of it.
+   */
   Ptr<CallbackImplBase> GetImpl (void) const
   {
+    if (IsInline ())
+      {
+        return m_peek->Clone ();
+      }
     return m_impl;
   }
+  /**
+   * \return The implementation, which is only valid as long as
+   *         this Callback is not modified or destroyed.
+   */
+  const CallbackImplBase * PeekImpl (void) const
+  {
+    return m_peek;
+  }
 
 protected:
   /**
    * Construct from a pimpl
    * \param [in] impl The CallbackImplBase Ptr
    */
-  CallbackBase (Ptr<CallbackImplBase> impl) : m_impl (impl)
+  CallbackBase (Ptr<CallbackImplBase> impl)
+    : m_impl (impl), m_peek (PeekPointer (impl))
   {}
-  Ptr<CallbackImplBase> m_impl;         //!< the pimpl
+  /**
+   * Construct the implementation, inline if it fits.
+   * The Callback must be null.
+   *
+   * \tparam IMPL \explicit The implementation type.
+   * \tparam Args \deduced The constructor argument types.
+   * \param [in] args The constructor arguments.
+   */
+  template <typename IMPL, typename... Args>
+  void Emplace (Args&&... args)
+  {
+    if constexpr (CallbackImplBase::FitsInline<IMPL> ())
+      {
+        m_peek = new (m_storage) IMPL (std::forward<Args> (args)...);
+      }
+    else
+      {
+        m_peek = new IMPL (std::forward<Args> (args)...);
+        m_impl = Ptr<CallbackImplBase> (m_peek, false);
+      }
+  }
+  /** Discard the implementation. */
+  void Reset (void)
+  {
+    if (IsInline ())
+      {
+        m_peek->~CallbackImplBase ();
+      }
+    else if (m_impl != 0)
+      {
+        m_impl = 0;
+      }
+    m_peek = 0;
+  }
+  /** \return \c true if the implementation is stored inline. */
+  bool IsInline (void) const
+  {
+    return m_peek != 0 && m_impl == 0;
+  }
+
+  Ptr<CallbackImplBase> m_impl;         //!< the heap pimpl, or null if inline
+  CallbackImplBase *m_peek;             //!< the pimpl, inline or not
+
+private:
+  /**
+   * Copy the implementation of another Callback into this null one:
+   * copy it if it is inline, share it otherwise.
+   * \param [in] o The other Callback.
+   */
+  void DoCopy (const CallbackBase &o)
+  {
+    if (o.IsInline ())
+      {
+        m_peek = o.m_peek->CopyTo (m_storage);
+      }
+    else if (o.m_impl != 0)
+      {
+        m_impl = o.m_impl;
+        m_peek = o.m_peek;
+      }
+  }
+
+  /** The inline storage. */
+  alignas (void *) unsigned char m_storage[CallbackImplBase::INLINE_SIZE];
 };
 
 /**
@@ -1248,7 +1463,8 @@ protected:
  *     is smaller than the maximum supported number
  *   - the pimpl idiom: the Callback class is passed around by
  *     value and delegates the crux of the work to its pimpl
- *     pointer.
+ *     pointer.  Small pimpls are stored inline in the Callback
+ *     (see CallbackBase), larger ones on the heap.
  *   - two pimpl implementations which derive from CallbackImpl
  *     FunctorCallbackImpl can be used with any functor-type
  *     while MemPtrCallbackImpl can be used with pointers to
@@ -1293,8 +1509,9 @@ public:
    */
   template <typename FUNCTOR>
   Callback (FUNCTOR const &functor, bool, bool)
-    : CallbackBase (Create<FunctorCallbackImpl<FUNCTOR,R,T1,T2,T3,T4,T5,T6,T7,T8,T9> > (functor))
-  {}
+  {
+    Emplace<FunctorCallbackImpl<FUNCTOR,R,T1,T2,T3,T4,T5,T6,T7,T8,T9> > (functor);
+  }
 
   /**
    * Construct a member function pointer call back.
@@ -1306,8 +1523,9 @@ public:
    */
   template <typename OBJ_PTR, typename MEM_PTR>
   Callback (OBJ_PTR const &objPtr, MEM_PTR memPtr)
-    : CallbackBase (Create<MemPtrCallbackImpl<OBJ_PTR,MEM_PTR,R,T1,T2,T3,T4,T5,T6,T7,T8,T9> > (objPtr, memPtr))
-  {}
+  {
+    Emplace<MemPtrCallbackImpl<OBJ_PTR,MEM_PTR,R,T1,T2,T3,T4,T5,T6,T7,T8,T9> > (objPtr, memPtr);
+  }
 
   /**
    * Construct from a CallbackImpl pointer
@@ -1318,6 +1536,23 @@ public:
     : CallbackBase (impl)
   {}
 
+  /**
+   * Construct a Callback with an implementation of type \pname{IMPL}.
+   *
+   * \tparam IMPL \explicit The implementation type, derived from
+   *         CallbackImpl<R,T1,T2,T3,T4,T5,T6,T7,T8,T9>.
+   * \tparam Args \deduced The constructor argument types.
+   * \param [in] args The constructor arguments.
+   * \return The Callback.
+   */
+  template <typename IMPL, typename... Args>
+  static Callback Make (Args&&... args)
+  {
+    Callback cb;
+    cb.template Emplace<IMPL> (std::forward<Args> (args)...);
+    return cb;
+  }
+
   /**
    * Bind the first arguments
    *
@@ -1390,7 +1625,7 @@ public:
   /** Discard the implementation, set it to null */
   void Nullify (void)
   {
-    m_impl = 0;
+    Reset ();
   }
 
   /**
@@ -1520,7 +1755,7 @@ public:
    */
   bool IsEqual (const CallbackBase &other) const
   {
-    return m_impl->IsEqual (other.GetImpl ());
+    return m_peek->IsEqual (Ptr<const CallbackImplBase> (other.PeekImpl ()));
   }
 
   /**
@@ -1531,7 +1766,7 @@ public:
    */
   bool CheckType (const CallbackBase & other) const
   {
-    return DoCheckType (other.GetImpl ());
+    return DoCheckType (other.PeekImpl ());
   }
   /**
    * Adopt the other's implementation, if type compatible
@@ -1541,25 +1776,25 @@ public:
    */
   bool Assign (const CallbackBase &other)
   {
-    return DoAssign (other.GetImpl ());
+    return DoAssign (other);
   }
 
 private:
   /** \return The pimpl pointer */
   CallbackImpl<R,T1,T2,T3,T4,T5,T6,T7,T8,T9> * DoPeekImpl (void) const
   {
-    return static_cast<CallbackImpl<R,T1,T2,T3,T4,T5,T6,T7,T8,T9> *> (PeekPointer (m_impl));
+    return static_cast<CallbackImpl<R,T1,T2,T3,T4,T5,T6,T7,T8,T9> *> (m_peek);
   }
   /**
    * Check for compatible types
    *
-   * \param [in] other Callback Ptr
+   * \param [in] other The other implementation
    * \return \c true if other can be dynamic_cast to my type
    */
-  bool DoCheckType (Ptr<const CallbackImplBase> other) const
+  bool DoCheckType (const CallbackImplBase *other) const
   {
     if (other != 0
-        && dynamic_cast<const CallbackImpl<R,T1,T2,T3,T4,T5,T6,T7,T8,T9> *> (PeekPointer (other)) != 0)
+        && dynamic_cast<const CallbackImpl<R,T1,T2,T3,T4,T5,T6,T7,T8,T9> *> (other) != 0)
       {
         return true;
       }
@@ -1579,18 +1814,18 @@ private:
    * \param [in] other Callback
    * \returns \c true if \pname{other} was type-compatible and could be adopted.
    */
-  bool DoAssign (Ptr<const CallbackImplBase> other)
+  bool DoAssign (const CallbackBase &other)
   {
-    if (!DoCheckType (other))
+    if (!DoCheckType (other.PeekImpl ()))
       {
-        std::string othTid = other->GetTypeid ();
+        std::string othTid = other.PeekImpl ()->GetTypeid ();
         std::string myTid = CallbackImpl<R,T1,T2,T3,T4,T5,T6,T7,T8,T9>::DoGetTypeid ();
         NS_FATAL_ERROR_CONT ("Incompatible types. (feed to \"c++filt -t\" if needed)" << std::endl <<
                              "got=" << othTid << std::endl <<
                              "expected=" << myTid);
         return false;
       }
-    m_impl = const_cast<CallbackImplBase *> (PeekPointer (other));
+    CallbackBase::operator = (other);
     return true;
   }
 };
@@ -1708,73 +1943,55 @@ Callback<R,Ts...> MakeNullCallback (void)
 template <typename R, typename TX, typename ARG>
 Callback<R> MakeBoundCallback (R (*fnPtr)(TX), ARG a1)
 {
-  Ptr<CallbackImpl<R,empty,empty,empty,empty,empty,empty,empty,empty,empty> > impl =
-    Create<BoundFunctorCallbackImpl<R (*)(TX),R,TX,empty,empty,empty,empty,empty,empty,empty,empty> > (fnPtr, a1);
-  return Callback<R> (impl);
+  return Callback<R>::template Make<BoundFunctorCallbackImpl<R (*)(TX),R,TX,empty,empty,empty,empty,empty,empty,empty,empty> > (fnPtr, a1);
 }
 template <typename R, typename TX, typename ARG,
           typename T1>
 Callback<R,T1> MakeBoundCallback (R (*fnPtr)(TX,T1), ARG a1)
 {
-  Ptr<CallbackImpl<R,T1,empty,empty,empty,empty,empty,empty,empty,empty> > impl =
-    Create<BoundFunctorCallbackImpl<R (*)(TX,T1),R,TX,T1,empty,empty,empty,empty,empty,empty,empty> > (fnPtr, a1);
-  return Callback<R,T1> (impl);
+  return Callback<R,T1>::template Make<BoundFunctorCallbackImpl<R (*)(TX,T1),R,TX,T1,empty,empty,empty,empty,empty,empty,empty> > (fnPtr, a1);
 }
 template <typename R, typename TX, typename ARG,
           typename T1, typename T2>
 Callback<R,T1,T2> MakeBoundCallback (R (*fnPtr)(TX,T1,T2), ARG a1)
 {
-  Ptr<CallbackImpl<R,T1,T2,empty,empty,empty,empty,empty,empty,empty> > impl =
-    Create<BoundFunctorCallbackImpl<R (*)(TX,T1,T2),R,TX,T1,T2,empty,empty,empty,empty,empty,empty> > (fnPtr, a1);
-  return Callback<R,T1,T2> (impl);
+  return Callback<R,T1,T2>::template Make<BoundFunctorCallbackImpl<R (*)(TX,T1,T2),R,TX,T1,T2,empty,empty,empty,empty,empty,empty> > (fnPtr, a1);
 }
 template <typename R, typename TX, typename ARG,
           typename T1, typename T2,typename T3>
 Callback<R,T1,T2,T3> MakeBoundCallback (R (*fnPtr)(TX,T1,T2,T3), ARG a1)
 {
-  Ptr<CallbackImpl<R,T1,T2,T3,empty,empty,empty,empty,empty,empty> > impl =
-    Create<BoundFunctorCallbackImpl<R (*)(TX,T1,T2,T3),R,TX,T1,T2,T3,empty,empty,empty,empty,empty> > (fnPtr, a1);
-  return Callback<R,T1,T2,T3> (impl);
+  return Callback<R,T1,T2,T3>::template Make<BoundFunctorCallbackImpl<R (*)(TX,T1,T2,T3),R,TX,T1,T2,T3,empty,empty,empty,empty,empty> > (fnPtr, a1);
 }
 template <typename R, typename TX, typename ARG,
           typename T1, typename T2,typename T3,typename T4>
 Callback<R,T1,T2,T3,T4> MakeBoundCallback (R (*fnPtr)(TX,T1,T2,T3,T4), ARG a1)
 {
-  Ptr<CallbackImpl<R,T1,T2,T3,T4,empty,empty,empty,empty,empty> > impl =
-    Create<BoundFunctorCallbackImpl<R (*)(TX,T1,T2,T3,T4),R,TX,T1,T2,T3,T4,empty,empty,empty,empty> > (fnPtr, a1);
-  return Callback<R,T1,T2,T3,T4> (impl);
+  return Callback<R,T1,T2,T3,T4>::template Make<BoundFunctorCallbackImpl<R (*)(TX,T1,T2,T3,T4),R,TX,T1,T2,T3,T4,empty,empty,empty,empty> > (fnPtr, a1);
 }
 template <typename R, typename TX, typename ARG,
           typename T1, typename T2,typename T3,typename T4,typename T5>
 Callback<R,T1,T2,T3,T4,T5> MakeBoundCallback (R (*fnPtr)(TX,T1,T2,T3,T4,T5), ARG a1)
 {
-  Ptr<CallbackImpl<R,T1,T2,T3,T4,T5,empty,empty,empty,empty> > impl =
-    Create<BoundFunctorCallbackImpl<R (*)(TX,T1,T2,T3,T4,T5),R,TX,T1,T2,T3,T4,T5,empty,empty,empty> > (fnPtr, a1);
-  return Callback<R,T1,T2,T3,T4,T5> (impl);
+  return Callback<R,T1,T2,T3,T4,T5>::template Make<BoundFunctorCallbackImpl<R (*)(TX,T1,T2,T3,T4,T5),R,TX,T1,T2,T3,T4,T5,empty,empty,empty> > (fnPtr, a1);
 }
 template <typename R, typename TX, typename ARG,
           typename T1, typename T2,typename T3,typename T4,typename T5, typename T6>
 Callback<R,T1,T2,T3,T4,T5,T6> MakeBoundCallback (R (*fnPtr)(TX,T1,T2,T3,T4,T5,T6), ARG a1)
 {
-  Ptr<CallbackImpl<R,T1,T2,T3,T4,T5,T6,empty,empty,empty> > impl =
-    Create<BoundFunctorCallbackImpl<R (*)(TX,T1,T2,T3,T4,T5,T6),R,TX,T1,T2,T3,T4,T5,T6,empty,empty> > (fnPtr, a1);
-  return Callback<R,T1,T2,T3,T4,T5,T6> (impl);
+  return Callback<R,T1,T2,T3,T4,T5,T6>::template Make<BoundFunctorCallbackImpl<R (*)(TX,T1,T2,T3,T4,T5,T6),R,TX,T1,T2,T3,T4,T5,T6,empty,empty> > (fnPtr, a1);
 }
 template <typename R, typename TX, typename ARG,
           typename T1, typename T2,typename T3,typename T4,typename T5, typename T6, typename T7>
 Callback<R,T1,T2,T3,T4,T5,T6,T7> MakeBoundCallback (R (*fnPtr)(TX,T1,T2,T3,T4,T5,T6,T7), ARG a1)
 {
-  Ptr<CallbackImpl<R,T1,T2,T3,T4,T5,T6,T7,empty,empty> > impl =
-    Create<BoundFunctorCallbackImpl<R (*)(TX,T1,T2,T3,T4,T5,T6,T7),R,TX,T1,T2,T3,T4,T5,T6,T7,empty> > (fnPtr, a1);
-  return Callback<R,T1,T2,T3,T4,T5,T6,T7> (impl);
+  return Callback<R,T1,T2,T3,T4,T5,T6,T7>::template Make<BoundFunctorCallbackImpl<R (*)(TX,T1,T2,T3,T4,T5,T6,T7),R,TX,T1,T2,T3,T4,T5,T6,T7,empty> > (fnPtr, a1);
 }
 template <typename R, typename TX, typename ARG,
           typename T1, typename T2,typename T3,typename T4,typename T5, typename T6, typename T7, typename T8>
 Callback<R,T1,T2,T3,T4,T5,T6,T7,T8> MakeBoundCallback (R (*fnPtr)(TX,T1,T2,T3,T4,T5,T6,T7,T8), ARG a1)
 {
-  Ptr<CallbackImpl<R,T1,T2,T3,T4,T5,T6,T7,T8,empty> > impl =
-    Create<BoundFunctorCallbackImpl<R (*)(TX,T1,T2,T3,T4,T5,T6,T7,T8),R,TX,T1,T2,T3,T4,T5,T6,T7,T8> > (fnPtr, a1);
-  return Callback<R,T1,T2,T3,T4,T5,T6,T7,T8> (impl);
+  return Callback<R,T1,T2,T3,T4,T5,T6,T7,T8>::template Make<BoundFunctorCallbackImpl<R (*)(TX,T1,T2,T3,T4,T5,T6,T7,T8),R,TX,T1,T2,T3,T4,T5,T6,T7,T8> > (fnPtr, a1);
 }
 /**@}*/
 
@@ -1797,65 +2014,49 @@ Callback<R,T1,T2,T3,T4,T5,T6,T7,T8> MakeBoundCallback (R (*fnPtr)(TX,T1,T2,T3,T4
 template <typename R, typename TX1, typename TX2, typename ARG1, typename ARG2>
 Callback<R> MakeBoundCallback (R (*fnPtr)(TX1,TX2), ARG1 a1, ARG2 a2)
 {
-  Ptr<CallbackImpl<R,empty,empty,empty,empty,empty,empty,empty,empty,empty> > impl =
-    Create<TwoBoundFunctorCallbackImpl<R (*)(TX1,TX2),R,TX1,TX2,empty,empty,empty,empty,empty,empty,empty> > (fnPtr, a1, a2);
-  return Callback<R> (impl);
+  return Callback<R>::template Make<TwoBoundFunctorCallbackImpl<R (*)(TX1,TX2),R,TX1,TX2,empty,empty,empty,empty,empty,empty,empty> > (fnPtr, a1, a2);
 }
 template <typename R, typename TX1, typename TX2, typename ARG1, typename ARG2,
           typename T1>
 Callback<R,T1> MakeBoundCallback (R (*fnPtr)(TX1,TX2,T1), ARG1 a1, ARG2 a2)
 {
-  Ptr<CallbackImpl<R,T1,empty,empty,empty,empty,empty,empty,empty,empty> > impl =
-    Create<TwoBoundFunctorCallbackImpl<R (*)(TX1,TX2,T1),R,TX1,TX2,T1,empty,empty,empty,empty,empty,empty> > (fnPtr, a1, a2);
-  return Callback<R,T1> (impl);
+  return Callback<R,T1>::template Make<TwoBoundFunctorCallbackImpl<R (*)(TX1,TX2,T1),R,TX1,TX2,T1,empty,empty,empty,empty,empty,empty> > (fnPtr, a1, a2);
 }
 template <typename R, typename TX1, typename TX2, typename ARG1, typename ARG2,
           typename T1, typename T2>
 Callback<R,T1,T2> MakeBoundCallback (R (*fnPtr)(TX1,TX2,T1,T2), ARG1 a1, ARG2 a2)
 {
-  Ptr<CallbackImpl<R,T1,T2,empty,empty,empty,empty,empty,empty,empty> > impl =
-    Create<TwoBoundFunctorCallbackImpl<R (*)(TX1,TX2,T1,T2),R,TX1,TX2,T1,T2,empty,empty,empty,empty,empty> > (fnPtr, a1, a2);
-  return Callback<R,T1,T2> (impl);
+  return Callback<R,T1,T2>::template Make<TwoBoundFunctorCallbackImpl<R (*)(TX1,TX2,T1,T2),R,TX1,TX2,T1,T2,empty,empty,empty,empty,empty> > (fnPtr, a1, a2);
 }
 template <typename R, typename TX1, typename TX2, typename ARG1, typename ARG2,
           typename T1, typename T2,typename T3>
 Callback<R,T1,T2,T3> MakeBoundCallback (R (*fnPtr)(TX1,TX2,T1,T2,T3), ARG1 a1, ARG2 a2)
 {
-  Ptr<CallbackImpl<R,T1,T2,T3,empty,empty,empty,empty,empty,empty> > impl =
-    Create<TwoBoundFunctorCallbackImpl<R (*)(TX1,TX2,T1,T2,T3),R,TX1,TX2,T1,T2,T3,empty,empty,empty,empty> > (fnPtr, a1, a2);
-  return Callback<R,T1,T2,T3> (impl);
+  return Callback<R,T1,T2,T3>::template Make<TwoBoundFunctorCallbackImpl<R (*)(TX1,TX2,T1,T2,T3),R,TX1,TX2,T1,T2,T3,empty,empty,empty,empty> > (fnPtr, a1, a2);
 }
 template <typename R, typename TX1, typename TX2, typename ARG1, typename ARG2,
           typename T1, typename T2,typename T3,typename T4>
 Callback<R,T1,T2,T3,T4> MakeBoundCallback (R (*fnPtr)(TX1,TX2,T1,T2,T3,T4), ARG1 a1, ARG2 a2)
 {
-  Ptr<CallbackImpl<R,T1,T2,T3,T4,empty,empty,empty,empty,empty> > impl =
-    Create<TwoBoundFunctorCallbackImpl<R (*)(TX1,TX2,T1,T2,T3,T4),R,TX1,TX2,T1,T2,T3,T4,empty,empty,empty> > (fnPtr, a1, a2);
-  return Callback<R,T1,T2,T3,T4> (impl);
+  return Callback<R,T1,T2,T3,T4>::template Make<TwoBoundFunctorCallbackImpl<R (*)(TX1,TX2,T1,T2,T3,T4),R,TX1,TX2,T1,T2,T3,T4,empty,empty,empty> > (fnPtr, a1, a2);
 }
 template <typename R, typename TX1, typename TX2, typename ARG1, typename ARG2,
           typename T1, typename T2,typename T3,typename T4,typename T5>
 Callback<R,T1,T2,T3,T4,T5> MakeBoundCallback (R (*fnPtr)(TX1,TX2,T1,T2,T3,T4,T5), ARG1 a1, ARG2 a2)
 {
-  Ptr<CallbackImpl<R,T1,T2,T3,T4,T5,empty,empty,empty,empty> > impl =
-    Create<TwoBoundFunctorCallbackImpl<R (*)(TX1,TX2,T1,T2,T3,T4,T5),R,TX1,TX2,T1,T2,T3,T4,T5,empty,empty> > (fnPtr, a1, a2);
-  return Callback<R,T1,T2,T3,T4,T5> (impl);
+  return Callback<R,T1,T2,T3,T4,T5>::template Make<TwoBoundFunctorCallbackImpl<R (*)(TX1,TX2,T1,T2,T3,T4,T5),R,TX1,TX2,T1,T2,T3,T4,T5,empty,empty> > (fnPtr, a1, a2);
 }
 template <typename R, typename TX1, typename TX2, typename ARG1, typename ARG2,
           typename T1, typename T2,typename T3,typename T4,typename T5, typename T6>
 Callback<R,T1,T2,T3,T4,T5,T6> MakeBoundCallback (R (*fnPtr)(TX1,TX2,T1,T2,T3,T4,T5,T6), ARG1 a1, ARG2 a2)
 {
-  Ptr<CallbackImpl<R,T1,T2,T3,T4,T5,T6,empty,empty,empty> > impl =
-    Create<TwoBoundFunctorCallbackImpl<R (*)(TX1,TX2,T1,T2,T3,T4,T5,T6),R,TX1,TX2,T1,T2,T3,T4,T5,T6,empty> > (fnPtr, a1, a2);
-  return Callback<R,T1,T2,T3,T4,T5,T6> (impl);
+  return Callback<R,T1,T2,T3,T4,T5,T6>::template Make<TwoBoundFunctorCallbackImpl<R (*)(TX1,TX2,T1,T2,T3,T4,T5,T6),R,TX1,TX2,T1,T2,T3,T4,T5,T6,empty> > (fnPtr, a1, a2);
 }
 template <typename R, typename TX1, typename TX2, typename ARG1, typename ARG2,
           typename T1, typename T2,typename T3,typename T4,typename T5, typename T6, typename T7>
 Callback<R,T1,T2,T3,T4,T5,T6,T7> MakeBoundCallback (R (*fnPtr)(TX1,TX2,T1,T2,T3,T4,T5,T6,T7), ARG1 a1, ARG2 a2)
 {
-  Ptr<CallbackImpl<R,T1,T2,T3,T4,T5,T6,T7,empty,empty> > impl =
-    Create<TwoBoundFunctorCallbackImpl<R (*)(TX1,TX2,T1,T2,T3,T4,T5,T6,T7),R,TX1,TX2,T1,T2,T3,T4,T5,T6,T7> > (fnPtr, a1, a2);
-  return Callback<R,T1,T2,T3,T4,T5,T6,T7> (impl);
+  return Callback<R,T1,T2,T3,T4,T5,T6,T7>::template Make<TwoBoundFunctorCallbackImpl<R (*)(TX1,TX2,T1,T2,T3,T4,T5,T6,T7),R,TX1,TX2,T1,T2,T3,T4,T5,T6,T7> > (fnPtr, a1, a2);
 }
 /**@}*/
 
@@ -1881,57 +2082,43 @@ Callback<R,T1,T2,T3,T4,T5,T6,T7> MakeBoundCallback (R (*fnPtr)(TX1,TX2,T1,T2,T3,
 template <typename R, typename TX1, typename TX2, typename TX3, typename ARG1, typename ARG2, typename ARG3>
 Callback<R> MakeBoundCallback (R (*fnPtr)(TX1,TX2,TX3), ARG1 a1, ARG2 a2, ARG3 a3)
 {
-  Ptr<CallbackImpl<R,empty,empty,empty,empty,empty,empty,empty,empty,empty> > impl =
-    Create<ThreeBoundFunctorCallbackImpl<R (*)(TX1,TX2,TX3),R,TX1,TX2,TX3,empty,empty,empty,empty,empty,empty> > (fnPtr, a1, a2, a3);
-  return Callback<R> (impl);
+  return Callback<R>::template Make<ThreeBoundFunctorCallbackImpl<R (*)(TX1,TX2,TX3),R,TX1,TX2,TX3,empty,empty,empty,empty,empty,empty> > (fnPtr, a1, a2, a3);
 }
 template <typename R, typename TX1, typename TX2, typename TX3, typename ARG1, typename ARG2, typename ARG3,
           typename T1>
 Callback<R,T1> MakeBoundCallback (R (*fnPtr)(TX1,TX2,TX3,T1), ARG1 a1, ARG2 a2, ARG3 a3)
 {
-  Ptr<CallbackImpl<R,T1,empty,empty,empty,empty,empty,empty,empty,empty> > impl =
-    Create<ThreeBoundFunctorCallbackImpl<R (*)(TX1,TX2,TX3,T1),R,TX1,TX2,TX3,T1,empty,empty,empty,empty,empty> > (fnPtr, a1, a2, a3);
-  return Callback<R,T1> (impl);
+  return Callback<R,T1>::template Make<ThreeBoundFunctorCallbackImpl<R (*)(TX1,TX2,TX3,T1),R,TX1,TX2,TX3,T1,empty,empty,empty,empty,empty> > (fnPtr, a1, a2, a3);
 }
 template <typename R, typename TX1, typename TX2, typename TX3, typename ARG1, typename ARG2, typename ARG3,
           typename T1, typename T2>
 Callback<R,T1,T2> MakeBoundCallback (R (*fnPtr)(TX1,TX2,TX3,T1,T2), ARG1 a1, ARG2 a2, ARG3 a3)
 {
-  Ptr<CallbackImpl<R,T1,T2,empty,empty,empty,empty,empty,empty,empty> > impl =
-    Create<ThreeBoundFunctorCallbackImpl<R (*)(TX1,TX2,TX3,T1,T2),R,TX1,TX2,TX3,T1,T2,empty,empty,empty,empty> > (fnPtr, a1, a2, a3);
-  return Callback<R,T1,T2> (impl);
+  return Callback<R,T1,T2>::template Make<ThreeBoundFunctorCallbackImpl<R (*)(TX1,TX2,TX3,T1,T2),R,TX1,TX2,TX3,T1,T2,empty,empty,empty,empty> > (fnPtr, a1, a2, a3);
 }
 template <typename R, typename TX1, typename TX2, typename TX3, typename ARG1, typename ARG2, typename ARG3,
           typename T1, typename T2,typename T3>
 Callback<R,T1,T2,T3> MakeBoundCallback (R (*fnPtr)(TX1,TX2,TX3,T1,T2,T3), ARG1 a1, ARG2 a2, ARG3 a3)
 {
-  Ptr<CallbackImpl<R,T1,T2,T3,empty,empty,empty,empty,empty,empty> > impl =
-    Create<ThreeBoundFunctorCallbackImpl<R (*)(TX1,TX2,TX3,T1,T2,T3),R,TX1,TX2,TX3,T1,T2,T3,empty,empty,empty> > (fnPtr, a1, a2, a3);
-  return Callback<R,T1,T2,T3> (impl);
+  return Callback<R,T1,T2,T3>::template Make<ThreeBoundFunctorCallbackImpl<R (*)(TX1,TX2,TX3,T1,T2,T3),R,TX1,TX2,TX3,T1,T2,T3,empty,empty,empty> > (fnPtr, a1, a2, a3);
 }
 template <typename R, typename TX1, typename TX2, typename TX3, typename ARG1, typename ARG2, typename ARG3,
           typename T1, typename T2,typename T3,typename T4>
 Callback<R,T1,T2,T3,T4> MakeBoundCallback (R (*fnPtr)(TX1,TX2,TX3,T1,T2,T3,T4), ARG1 a1, ARG2 a2, ARG3 a3)
 {
-  Ptr<CallbackImpl<R,T1,T2,T3,T4,empty,empty,empty,empty,empty> > impl =
-    Create<ThreeBoundFunctorCallbackImpl<R (*)(TX1,TX2,TX3,T1,T2,T3,T4),R,TX1,TX2,TX3,T1,T2,T3,T4,empty,empty> > (fnPtr, a1, a2, a3);
-  return Callback<R,T1,T2,T3,T4> (impl);
+  return Callback<R,T1,T2,T3,T4>::template Make<ThreeBoundFunctorCallbackImpl<R (*)(TX1,TX2,TX3,T1,T2,T3,T4),R,TX1,TX2,TX3,T1,T2,T3,T4,empty,empty> > (fnPtr, a1, a2, a3);
 }
 template <typename R, typename TX1, typename TX2, typename TX3, typename ARG1, typename ARG2, typename ARG3,
           typename T1, typename T2,typename T3,typename T4,typename T5>
 Callback<R,T1,T2,T3,T4,T5> MakeBoundCallback (R (*fnPtr)(TX1,TX2,TX3,T1,T2,T3,T4,T5), ARG1 a1, ARG2 a2, ARG3 a3)
 {
-  Ptr<CallbackImpl<R,T1,T2,T3,T4,T5,empty,empty,empty,empty> > impl =
-    Create<ThreeBoundFunctorCallbackImpl<R (*)(TX1,TX2,TX3,T1,T2,T3,T4,T5),R,TX1,TX2,TX3,T1,T2,T3,T4,T5,empty> > (fnPtr, a1, a2, a3);
-  return Callback<R,T1,T2,T3,T4,T5> (impl);
+  return Callback<R,T1,T2,T3,T4,T5>::template Make<ThreeBoundFunctorCallbackImpl<R (*)(TX1,TX2,TX3,T1,T2,T3,T4,T5),R,TX1,TX2,TX3,T1,T2,T3,T4,T5,empty> > (fnPtr, a1, a2, a3);
 }
 template <typename R, typename TX1, typename TX2, typename TX3, typename ARG1, typename ARG2, typename ARG3,
           typename T1, typename T2,typename T3,typename T4,typename T5, typename T6>
 Callback<R,T1,T2,T3,T4,T5,T6> MakeBoundCallback (R (*fnPtr)(TX1,TX2,TX3,T1,T2,T3,T4,T5,T6), ARG1 a1, ARG2 a2, ARG3 a3)
 {
-  Ptr<CallbackImpl<R,T1,T2,T3,T4,T5,T6,empty,empty,empty> > impl =
-    Create<ThreeBoundFunctorCallbackImpl<R (*)(TX1,TX2,TX3,T1,T2,T3,T4,T5,T6),R,TX1,TX2,TX3,T1,T2,T3,T4,T5,T6> > (fnPtr, a1, a2, a3);
-  return Callback<R,T1,T2,T3,T4,T5,T6> (impl);
+  return Callback<R,T1,T2,T3,T4,T5,T6>::template Make<ThreeBoundFunctorCallbackImpl<R (*)(TX1,TX2,TX3,T1,T2,T3,T4,T5,T6),R,TX1,TX2,TX3,T1,T2,T3,T4,T5,T6> > (fnPtr, a1, a2, a3);
 }
 /**@}*/
 
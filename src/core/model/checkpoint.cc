@@ -0,0 +1,134 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "checkpoint.h"
+#include "default-simulator-impl.h"
+#include "fatal-error.h"
+#include "log.h"
+#include "simulator.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::Checkpoint implementation.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("Checkpoint");
+
+/**
+ * \ingroup simulator
+ * The index of the current branch.
+ */
+static uint32_t g_branch = 0;
+
+/**
+ * \ingroup simulator
+ * The branch processes forked by this process, and their indices.
+ */
+static std::vector<std::pair<pid_t, uint32_t> > g_children;
+
+void
+Checkpoint::Fork (uint32_t branches, Callback<void, uint32_t> configure)
+{
+  NS_LOG_FUNCTION (branches);
+  NS_ABORT_MSG_IF (branches == 0, "Checkpoint::Fork needs at least one branch");
+  NS_ABORT_MSG_UNLESS (Simulator::GetImplementation ()->GetInstanceTypeId ()
+                       == DefaultSimulatorImpl::GetTypeId (),
+                       "Checkpoint::Fork only supports ns3::DefaultSimulatorImpl");
+
+  // Buffered output would otherwise be written by every branch.
+  std::cout.flush ();
+  std::cerr.flush ();
+  std::clog.flush ();
+  std::fflush (nullptr);
+
+  bool waiting = !g_children.empty ();
+  for (uint32_t branch = 1; branch < branches; ++branch)
+    {
+      pid_t pid = fork ();
+      NS_ABORT_MSG_IF (pid < 0, "Checkpoint::Fork: fork failed: " << std::strerror (errno));
+      if (pid == 0)
+        {
+          NS_LOG_LOGIC ("Started branch " << branch);
+          g_branch = branch;
+          g_children.clear ();
+          if (!configure.IsNull ())
+            {
+              configure (branch);
+            }
+          return;
+        }
+      g_children.push_back (std::make_pair (pid, branch));
+    }
+
+  if (!waiting && !g_children.empty ())
+    {
+      Simulator::ScheduleDestroy (&Checkpoint::WaitBranches);
+    }
+  g_branch = 0;
+  if (!configure.IsNull ())
+    {
+      configure (0);
+    }
+}
+
+uint32_t
+Checkpoint::GetBranch (void)
+{
+  return g_branch;
+}
+
+void
+Checkpoint::WaitBranches (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  uint32_t failed = 0;
+  for (const auto &child : g_children)
+    {
+      int status;
+      pid_t pid;
+      do
+        {
+          pid = waitpid (child.first, &status, 0);
+        }
+      while (pid < 0 && errno == EINTR);
+      if (pid < 0 || !WIFEXITED (status) || WEXITSTATUS (status) != 0)
+        {
+          std::cerr << "Checkpoint: branch " << child.second << " failed" << std::endl;
+          ++failed;
+        }
+      NS_LOG_LOGIC ("Branch " << child.second << " done");
+    }
+  g_children.clear ();
+  if (failed != 0)
+    {
+      NS_FATAL_ERROR (failed << " simulation branches failed");
+    }
+}
+
+} // namespace ns3
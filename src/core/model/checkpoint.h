@@ -0,0 +1,107 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include "callback.h"
+
+#include <stdint.h>
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::Checkpoint declaration.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup simulator
+ *
+ * Fork a simulation into several runs sharing the state reached so far.
+ *
+ * Fork() duplicates the simulation process: every branch continues
+ * from the exact state of the simulation at the time of the call,
+ * including the pending events, the random number generator states
+ * and all the objects.  This lets a scenario go through its warm-up
+ * phase (e.g. attachment and bearer setup) once, and then run many
+ * what-if variations of the rest of the simulation in parallel:
+ *
+ * \code
+ *   void
+ *   Branch (uint32_t branch)
+ *   {
+ *     // Each branch uses its own random numbers and application rate.
+ *     RngSeedManager::SetRun (branch + 1);
+ *     RandomVariableStream::RestartAll ();
+ *     Config::Set ("/NodeList/0/ApplicationList/0/$ns3::OnOffApplication/DataRate",
+ *                  DataRateValue (DataRate ((branch + 1) * 1000000)));
+ *   }
+ *
+ *   Simulator::Schedule (Seconds (10), &Checkpoint::Fork, 8, MakeCallback (&Branch));
+ *   Simulator::Run ();
+ *   // Write the results of the branch Checkpoint::GetBranch ()
+ *   Simulator::Destroy ();
+ * \endcode
+ *
+ * The calling process continues as branch 0, and waits for the other
+ * branches in Simulator::Destroy().  Without a call to
+ * RandomVariableStream::RestartAll(), all the branches draw the same
+ * random numbers, i.e. they use common random numbers.
+ *
+ * The branches are separate processes which share nothing after the
+ * call: a branch must write its results to its own files, and the
+ * output streams opened before the call are shared.  The branches run
+ * concurrently, so the number of branches should not exceed the number
+ * of cores.
+ *
+ * Fork() relies on the POSIX fork() call, which only duplicates the
+ * calling thread: it can only be used with the DefaultSimulatorImpl,
+ * and without threads such as the ones of the FdNetDevice or the
+ * TapBridge.
+ */
+class Checkpoint
+{
+public:
+  /**
+   * Fork the simulation into several branches.
+   *
+   * Each branch, including branch 0 in the calling process, calls
+   * \p configure with its index before returning.
+   *
+   * \param [in] branches The number of branches, including the calling
+   *             process.
+   * \param [in] configure The function configuring a branch.
+   */
+  static void Fork (uint32_t branches, Callback<void, uint32_t> configure);
+
+  /**
+   * Get the index of the current branch.
+   *
+   * \returns The index of the branch passed to the configure function
+   *          by the last Fork(), or 0 before any Fork().
+   */
+  static uint32_t GetBranch (void);
+
+private:
+  /** Wait for the branches forked by this process. */
+  static void WaitBranches (void);
+};
+
+} // namespace ns3
+
+#endif /* CHECKPOINT_H */
@@ -0,0 +1,207 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "compact-heap-scheduler.h"
+#include "event-impl.h"
+#include "assert.h"
+#include "log.h"
+
+#include <algorithm>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * Implementation of ns3::CompactHeapScheduler class.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("CompactHeapScheduler");
+
+NS_OBJECT_ENSURE_REGISTERED (CompactHeapScheduler);
+
+namespace {
+
+/** Number of children of each heap node. */
+const std::size_t ARITY = 4;
+
+} // unnamed namespace
+
+TypeId
+CompactHeapScheduler::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::CompactHeapScheduler")
+    .SetParent<Scheduler> ()
+    .SetGroupName ("Core")
+    .AddConstructor<CompactHeapScheduler> ()
+  ;
+  return tid;
+}
+
+CompactHeapScheduler::CompactHeapScheduler ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+CompactHeapScheduler::~CompactHeapScheduler ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+bool
+CompactHeapScheduler::IsLess (const Key &a, const Key &b)
+{
+  return a.ts < b.ts || (a.ts == b.ts && a.order < b.order);
+}
+
+Scheduler::Event
+CompactHeapScheduler::GetEvent (std::size_t index) const
+{
+  Scheduler::Event ev;
+  ev.impl = m_impls[index];
+  ev.key.m_ts = m_keys[index].ts;
+  ev.key.m_uid = static_cast<uint32_t> (m_keys[index].order >> 32);
+  ev.key.m_context = static_cast<uint32_t> (m_keys[index].order);
+  return ev;
+}
+
+void
+CompactHeapScheduler::SiftUp (std::size_t index, const Key &key, EventImpl *impl)
+{
+  while (index > 0)
+    {
+      std::size_t parent = (index - 1) / ARITY;
+      if (!IsLess (key, m_keys[parent]))
+        {
+          break;
+        }
+      m_keys[index] = m_keys[parent];
+      m_impls[index] = m_impls[parent];
+      index = parent;
+    }
+  m_keys[index] = key;
+  m_impls[index] = impl;
+}
+
+void
+CompactHeapScheduler::SiftDown (std::size_t index, const Key &key, EventImpl *impl)
+{
+  std::size_t size = m_keys.size ();
+  while (true)
+    {
+      std::size_t first = index * ARITY + 1;
+      if (first >= size)
+        {
+          break;
+        }
+      std::size_t last = std::min (first + ARITY, size);
+      std::size_t smallest = first;
+      for (std::size_t child = first + 1; child < last; ++child)
+        {
+          if (IsLess (m_keys[child], m_keys[smallest]))
+            {
+              smallest = child;
+            }
+        }
+      if (!IsLess (m_keys[smallest], key))
+        {
+          break;
+        }
+      m_keys[index] = m_keys[smallest];
+      m_impls[index] = m_impls[smallest];
+      index = smallest;
+    }
+  m_keys[index] = key;
+  m_impls[index] = impl;
+}
+
+void
+CompactHeapScheduler::RemoveAt (std::size_t index)
+{
+  Key key = m_keys.back ();
+  EventImpl *impl = m_impls.back ();
+  m_keys.pop_back ();
+  m_impls.pop_back ();
+  if (index == m_keys.size ())
+    {
+      return;
+    }
+  // The last entry fills the hole; it may belong above or below it.
+  if (index > 0 && IsLess (key, m_keys[(index - 1) / ARITY]))
+    {
+      SiftUp (index, key, impl);
+    }
+  else
+    {
+      SiftDown (index, key, impl);
+    }
+}
+
+void
+CompactHeapScheduler::Insert (const Event &ev)
+{
+  NS_LOG_FUNCTION (this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+  Key key;
+  key.ts = ev.key.m_ts;
+  key.order = (static_cast<uint64_t> (ev.key.m_uid) << 32) | ev.key.m_context;
+  m_keys.push_back (key);
+  m_impls.push_back (ev.impl);
+  SiftUp (m_keys.size () - 1, key, ev.impl);
+}
+
+bool
+CompactHeapScheduler::IsEmpty (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_keys.empty ();
+}
+
+Scheduler::Event
+CompactHeapScheduler::PeekNext (void) const
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (!IsEmpty ());
+  return GetEvent (0);
+}
+
+Scheduler::Event
+CompactHeapScheduler::RemoveNext (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (!IsEmpty ());
+  Scheduler::Event next = GetEvent (0);
+  RemoveAt (0);
+  return next;
+}
+
+void
+CompactHeapScheduler::Remove (const Event &ev)
+{
+  NS_LOG_FUNCTION (this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+  uint64_t uid = ev.key.m_uid;
+  for (std::size_t i = 0; i < m_keys.size (); i++)
+    {
+      if ((m_keys[i].order >> 32) == uid)
+        {
+          NS_ASSERT (m_impls[i] == ev.impl);
+          RemoveAt (i);
+          return;
+        }
+    }
+  NS_ASSERT (false);
+}
+
+} // namespace ns3
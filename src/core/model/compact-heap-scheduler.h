@@ -0,0 +1,146 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef COMPACT_HEAP_SCHEDULER_H
+#define COMPACT_HEAP_SCHEDULER_H
+
+#include "scheduler.h"
+#include <stdint.h>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * ns3::CompactHeapScheduler declaration.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup scheduler
+ * \brief a 4-ary heap event scheduler with structure-of-arrays storage
+ *
+ * This scheduler is a 4-ary heap, like HeapScheduler, but it does not
+ * store Scheduler::Event entries directly.  Instead the sort keys and
+ * the EventImpl pointers are kept in two separate `std::vector`s, in
+ * the same order:
+ *  - each key is 16 bytes: the time stamp, and the event uid and
+ *    context packed in a second 64 bit word with the uid in the most
+ *    significant half.  Since uids are unique, comparing two keys takes
+ *    at most two 64 bit comparisons and the context never affects the
+ *    result;
+ *  - the EventImpl pointers are only touched when an entry moves,
+ *    never when comparing.
+ *
+ * With four children per node the heap is half as deep as a binary
+ * heap, and the four children of a node are contiguous, 64 bytes in
+ * total, so each level of a sift touches about one cache line of keys.
+ * This makes a difference for very large event lists, where most of
+ * the cost of HeapScheduler is cache misses.
+ *
+ * \par Time Complexity
+ *
+ * Operation    | Amortized %Time | Reason
+ * :----------- | :-------------- | :-----
+ * Insert()     | Logarithmic     | Sift up
+ * IsEmpty()    | Constant        | Explicit queue size
+ * PeekNext()   | Constant        | Heap kept sorted
+ * Remove()     | Linear          | Search, sift
+ * RemoveNext() | Logarithmic     | Sift down
+ *
+ * \par Memory Complexity
+ *
+ * Category  | Memory                           | Reason
+ * :-------- | :------------------------------- | :-----
+ * Overhead  | 6 x `sizeof (*)`<br/>(48 bytes)  | Two `std::vector`
+ * Per Event | 0                                | Keys and pointers stored in `std::vector` directly
+ */
+class CompactHeapScheduler : public Scheduler
+{
+public:
+  /**
+   *  Register this type.
+   *  \return The object TypeId.
+   */
+  static TypeId GetTypeId (void);
+
+  /** Constructor. */
+  CompactHeapScheduler ();
+  /** Destructor. */
+  virtual ~CompactHeapScheduler ();
+
+  // Inherited
+  virtual void Insert (const Scheduler::Event &ev);
+  virtual bool IsEmpty (void) const;
+  virtual Scheduler::Event PeekNext (void) const;
+  virtual Scheduler::Event RemoveNext (void);
+  virtual void Remove (const Scheduler::Event &ev);
+
+private:
+  /** Compact 16 byte sort key. */
+  struct Key
+  {
+    uint64_t ts;     /**< Event time stamp. */
+    uint64_t order;  /**< Event uid in the high half, context in the low half. */
+  };
+
+  /**
+   * Compare (less than) two keys.
+   *
+   * \param [in] a The first key.
+   * \param [in] b The second key.
+   * \returns \c true if \c a < \c b
+   */
+  static inline bool IsLess (const Key &a, const Key &b);
+  /**
+   * Get the entry at a given index.
+   *
+   * \param [in] index The entry index.
+   * \returns The event stored at \pname{index}.
+   */
+  Scheduler::Event GetEvent (std::size_t index) const;
+  /**
+   * Move an entry up the heap to its proper position.
+   *
+   * \param [in] index The index of a hole in the heap.
+   * \param [in] key The key of the entry to place.
+   * \param [in] impl The event of the entry to place.
+   */
+  void SiftUp (std::size_t index, const Key &key, EventImpl *impl);
+  /**
+   * Move an entry down the heap to its proper position.
+   *
+   * \param [in] index The index of a hole in the heap.
+   * \param [in] key The key of the entry to place.
+   * \param [in] impl The event of the entry to place.
+   */
+  void SiftDown (std::size_t index, const Key &key, EventImpl *impl);
+  /**
+   * Remove the entry at a given index.
+   *
+   * \param [in] index The index of the entry to remove.
+   */
+  void RemoveAt (std::size_t index);
+
+  /** The sort keys, managed as a 4-ary heap. */
+  std::vector<Key> m_keys;
+  /** The events, in the same order as m_keys. */
+  std::vector<EventImpl *> m_impls;
+};
+
+} // namespace ns3
+
+#endif /* COMPACT_HEAP_SCHEDULER_H */
@@ -24,8 +24,13 @@
 #include "scheduler.h"
 #include "assert.h"
 #include "log.h"
+#include "boolean.h"
+#include "string.h"
 
+#include <chrono>
 #include <cmath>
+#include <fstream>
+#include <iostream>
 
 
 /**
@@ -50,6 +55,19 @@ DefaultSimulatorImpl::GetTypeId (void)
     .SetParent<SimulatorImpl> ()
     .SetGroupName ("Core")
     .AddConstructor<DefaultSimulatorImpl> ()
+    .AddAttribute ("EventProfiling",
+                   "Measure the wall-clock time spent in each event, "
+                   "by event type and by context, and write the report "
+                   "at Simulator::Destroy().",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&DefaultSimulatorImpl::m_profiling),
+                   MakeBooleanChecker ())
+    .AddAttribute ("EventProfilingFile",
+                   "The file to write the event profiling report to. "
+                   "If empty, the report is written to the standard output.",
+                   StringValue (""),
+                   MakeStringAccessor (&DefaultSimulatorImpl::m_profilingFile),
+                   MakeStringChecker ())
   ;
   return tid;
 }
@@ -64,8 +82,8 @@ DefaultSimulatorImpl::DefaultSimulatorImpl ()
   m_currentContext = Simulator::NO_CONTEXT;
   m_unscheduledEvents = 0;
   m_eventCount = 0;
-  m_eventsWithContextEmpty = true;
   m_main = SystemThread::Self ();
+  m_profiling = false;
 }
 
 DefaultSimulatorImpl::~DefaultSimulatorImpl ()
@@ -101,6 +119,28 @@ DefaultSimulatorImpl::Destroy ()
           ev->Invoke ();
         }
     }
+  if (m_profiling)
+    {
+      if (m_profilingFile.empty ())
+        {
+          m_profiler.Report (std::cout);
+        }
+      else
+        {
+          std::ofstream os (m_profilingFile.c_str ());
+          if (!os.is_open ())
+            {
+              NS_LOG_ERROR ("Cannot open the event profiling file " << m_profilingFile);
+            }
+          m_profiler.Report (os);
+        }
+    }
+}
+
+const EventProfiler &
+DefaultSimulatorImpl::GetEventProfiler (void) const
+{
+  return m_profiler;
 }
 
 void
@@ -143,7 +183,17 @@ DefaultSimulatorImpl::ProcessOneEvent (void)
   m_currentTs = next.key.m_ts;
   m_currentContext = next.key.m_context;
   m_currentUid = next.key.m_uid;
-  next.impl->Invoke ();
+  if (m_profiling)
+    {
+      std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+      next.impl->Invoke ();
+      std::chrono::nanoseconds duration = std::chrono::steady_clock::now () - start;
+      m_profiler.Record (next.impl, next.key.m_context, duration.count ());
+    }
+  else
+    {
+      next.impl->Invoke ();
+    }
   next.impl->Unref ();
 
   ProcessEventsWithContext ();
@@ -158,22 +208,9 @@ DefaultSimulatorImpl::IsFinished (void) const
 void
 DefaultSimulatorImpl::ProcessEventsWithContext (void)
 {
-  if (m_eventsWithContextEmpty)
-    {
-      return;
-    }
-
-  // swap queues
-  EventsWithContext eventsWithContext;
-  {
-    CriticalSection cs (m_eventsWithContextMutex);
-    m_eventsWithContext.swap (eventsWithContext);
-    m_eventsWithContextEmpty = true;
-  }
-  while (!eventsWithContext.empty ())
+  EventWithContext event;
+  while (m_eventsWithContext.Pop (event))
     {
-      EventWithContext event = eventsWithContext.front ();
-      eventsWithContext.pop_front ();
       Scheduler::Event ev;
       ev.impl = event.event;
       ev.key.m_ts = m_currentTs + event.timestamp;
@@ -265,11 +302,7 @@ DefaultSimulatorImpl::ScheduleWithContext (uint32_t context, Time const &delay,
       // Current time added in ProcessEventsWithContext()
       ev.timestamp = delay.GetTimeStep ();
       ev.event = event;
-      {
-        CriticalSection cs (m_eventsWithContextMutex);
-        m_eventsWithContext.push_back (ev);
-        m_eventsWithContextEmpty = false;
-      }
+      m_eventsWithContext.Push (ev);
     }
 }
 
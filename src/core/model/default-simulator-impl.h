@@ -23,9 +23,11 @@
 
 #include "simulator-impl.h"
 #include "system-thread.h"
-#include "system-mutex.h"
+#include "mpsc-queue.h"
+#include "event-profiler.h"
 
 #include <list>
+#include <string>
 
 /**
  * \file
@@ -78,6 +80,14 @@ public:
   virtual uint32_t GetContext (void) const;
   virtual uint64_t GetEventCount (void) const;
 
+  /**
+   * Get the event profile, recorded when the \c EventProfiling
+   * attribute is \c true.
+   *
+   * \returns The event profiler.
+   */
+  const EventProfiler & GetEventProfiler (void) const;
+
 private:
   virtual void DoDispose (void);
 
@@ -96,17 +106,11 @@ private:
     /** The event implementation. */
     EventImpl *event;
   };
-  /** Container type for the events from a different context. */
-  typedef std::list<struct EventWithContext> EventsWithContext;
-  /** The container of events from a different context. */
-  EventsWithContext m_eventsWithContext;
   /**
-   * Flag \c true if all events with context have been moved to the
-   * primary event queue.
+   * The events from a different context, pushed by other threads
+   * without taking a lock.
    */
-  bool m_eventsWithContextEmpty;
-  /** Mutex to control access to the list of events with context. */
-  SystemMutex m_eventsWithContextMutex;
+  MpscQueue<EventWithContext> m_eventsWithContext;
 
   /** Container type for the events to run at Simulator::Destroy() */
   typedef std::list<EventId> DestroyEvents;
@@ -135,6 +139,13 @@ private:
 
   /** Main execution thread. */
   SystemThread::ThreadId m_main;
+
+  /** Flag \c true to profile the events. */
+  bool m_profiling;
+  /** File to write the event profile to, or empty for the standard output. */
+  std::string m_profilingFile;
+  /** The event profile. */
+  EventProfiler m_profiler;
 };
 
 } // namespace ns3
@@ -21,6 +21,15 @@
 #include "event-impl.h"
 #include "log.h"
 
+#include <new>
+
+/**
+ * Define to recycle EventImpl storage through per-thread free lists.
+ * Undefine to use the system allocator for every event, which can be
+ * useful when tracking memory errors with valgrind.
+ */
+#define EVENT_IMPL_FREE_LIST 1
+
 /**
  * \file
  * \ingroup events
@@ -31,6 +40,179 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("EventImpl");
 
+#ifdef EVENT_IMPL_FREE_LIST
+namespace {
+
+/** Granularity of the EventImpl size classes, in bytes. */
+const std::size_t EVENT_IMPL_SIZE_STEP = 16;
+/** Number of EventImpl size classes. */
+const std::size_t EVENT_IMPL_SIZE_CLASSES = 16;
+/** Maximum number of blocks kept in each free list. */
+const uint32_t EVENT_IMPL_MAX_FREE = 1 << 16;
+
+/** A released block, linked into its free list. */
+struct FreeBlock
+{
+  FreeBlock *next; //!< Next released block of the same size class.
+};
+
+/**
+ * Per-thread EventImpl free lists.
+ *
+ * This is a trivially destructible aggregate so that it can be used
+ * safely at any time during thread and process teardown; the blocks
+ * are released by EventImplPoolReleaser.
+ */
+struct EventImplPool
+{
+  FreeBlock *head[EVENT_IMPL_SIZE_CLASSES];   //!< Free list heads.
+  uint32_t count[EVENT_IMPL_SIZE_CLASSES];    //!< Free list lengths.
+  EventImpl::PoolStats stats;                 //!< Recycling statistics.
+  bool armed;                                 //!< Releaser registered.
+  bool destroyed;                             //!< Releaser has run.
+};
+
+/** The free lists of the current thread. */
+thread_local EventImplPool g_eventImplPool;
+
+/** Release the free lists of the current thread at thread exit. */
+struct EventImplPoolReleaser
+{
+  /** Make sure the destructor is registered for this thread. */
+  void Arm (void)
+  {
+    g_eventImplPool.armed = true;
+  }
+  /** Release all cached blocks and switch to the system allocator. */
+  ~EventImplPoolReleaser ()
+  {
+    EventImplPool &pool = g_eventImplPool;
+    for (std::size_t i = 0; i < EVENT_IMPL_SIZE_CLASSES; ++i)
+      {
+        while (pool.head[i] != 0)
+          {
+            FreeBlock *block = pool.head[i];
+            pool.head[i] = block->next;
+            ::operator delete (block);
+          }
+        pool.count[i] = 0;
+      }
+    pool.stats.cached = 0;
+    pool.destroyed = true;
+  }
+};
+
+/** Registers the per-thread release of g_eventImplPool. */
+thread_local EventImplPoolReleaser g_eventImplPoolReleaser;
+
+/**
+ * \param [in] size An allocation size.
+ * \returns The size class of \pname{size}, or EVENT_IMPL_SIZE_CLASSES
+ *          if it is too large to be recycled.
+ */
+inline std::size_t
+SizeClass (std::size_t size)
+{
+  std::size_t sizeClass = (size + EVENT_IMPL_SIZE_STEP - 1) / EVENT_IMPL_SIZE_STEP;
+  if (sizeClass == 0 || sizeClass > EVENT_IMPL_SIZE_CLASSES)
+    {
+      return EVENT_IMPL_SIZE_CLASSES;
+    }
+  return sizeClass - 1;
+}
+
+} // unnamed namespace
+
+void *
+EventImpl::operator new (std::size_t size)
+{
+  // Do not add function logging here: this is called for every event.
+  EventImplPool &pool = g_eventImplPool;
+  std::size_t sizeClass = SizeClass (size);
+  if (sizeClass == EVENT_IMPL_SIZE_CLASSES || pool.destroyed)
+    {
+      return ::operator new (size);
+    }
+  FreeBlock *block = pool.head[sizeClass];
+  if (block != 0)
+    {
+      pool.head[sizeClass] = block->next;
+      pool.count[sizeClass]--;
+      pool.stats.cached--;
+      pool.stats.recycled++;
+      return block;
+    }
+  if (!pool.armed)
+    {
+      g_eventImplPoolReleaser.Arm ();
+    }
+  pool.stats.allocated++;
+  // Allocate the full size class so the block can be reused by
+  // any other event of the same class.
+  return ::operator new ((sizeClass + 1) * EVENT_IMPL_SIZE_STEP);
+}
+
+void
+EventImpl::operator delete (void *p, std::size_t size)
+{
+  if (p == 0)
+    {
+      return;
+    }
+  EventImplPool &pool = g_eventImplPool;
+  std::size_t sizeClass = SizeClass (size);
+  if (sizeClass == EVENT_IMPL_SIZE_CLASSES
+      || pool.destroyed
+      || pool.count[sizeClass] >= EVENT_IMPL_MAX_FREE)
+    {
+      if (sizeClass != EVENT_IMPL_SIZE_CLASSES)
+        {
+          pool.stats.released++;
+        }
+      ::operator delete (p);
+      return;
+    }
+  if (!pool.armed)
+    {
+      // The block was allocated by another thread: make sure
+      // this thread releases its free lists when it exits.
+      g_eventImplPoolReleaser.Arm ();
+    }
+  FreeBlock *block = static_cast<FreeBlock *> (p);
+  block->next = pool.head[sizeClass];
+  pool.head[sizeClass] = block;
+  pool.count[sizeClass]++;
+  pool.stats.cached++;
+}
+
+#else /* EVENT_IMPL_FREE_LIST */
+
+void *
+EventImpl::operator new (std::size_t size)
+{
+  return ::operator new (size);
+}
+
+void
+EventImpl::operator delete (void *p, [[maybe_unused]] std::size_t size)
+{
+  ::operator delete (p);
+}
+
+#endif /* EVENT_IMPL_FREE_LIST */
+
+EventImpl::PoolStats
+EventImpl::GetPoolStats (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+#ifdef EVENT_IMPL_FREE_LIST
+  return g_eventImplPool.stats;
+#else /* EVENT_IMPL_FREE_LIST */
+  PoolStats stats = {0, 0, 0, 0};
+  return stats;
+#endif /* EVENT_IMPL_FREE_LIST */
+}
+
 EventImpl::~EventImpl ()
 {
   NS_LOG_FUNCTION (this);
@@ -21,6 +21,7 @@
 #define EVENT_IMPL_H
 
 #include <stdint.h>
+#include <cstddef>
 #include "simple-ref-count.h"
 
 /**
@@ -66,6 +67,45 @@ public:
    */
   bool IsCancelled (void);
 
+  /**
+   * Statistics of the EventImpl recycling allocator.
+   *
+   * The free lists are kept per thread, so these counters describe
+   * the allocations and releases performed by the calling thread only.
+   */
+  struct PoolStats
+  {
+    uint64_t allocated;  //!< Blocks obtained from the system allocator.
+    uint64_t recycled;   //!< Allocations served from a free list.
+    uint64_t released;   //!< Blocks handed back to the system allocator.
+    uint64_t cached;     //!< Blocks currently held in the free lists.
+  };
+  /**
+   * \returns The recycling statistics of the calling thread.
+   */
+  static PoolStats GetPoolStats (void);
+
+  /**
+   * Allocate storage for an event.
+   *
+   * Events are allocated and released at a very high rate, so
+   * released blocks are kept in per-thread free lists, one per
+   * size class, and handed out again by later allocations.
+   * Blocks larger than the biggest size class go directly
+   * to the system allocator.
+   *
+   * \param [in] size The size of the object to allocate.
+   * \returns The storage for the event.
+   */
+  static void * operator new (std::size_t size);
+  /**
+   * Release the storage of an event.
+   *
+   * \param [in] p The storage to release.
+   * \param [in] size The size of the object which was stored.
+   */
+  static void operator delete (void *p, std::size_t size);
+
 protected:
   /**
    * Implementation for Invoke().
@@ -0,0 +1,328 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "event-profiler.h"
+#include "event-impl.h"
+#include "simulator.h"
+#include "log.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <map>
+#include <sstream>
+
+#if (__GNUC__ >= 3)
+#include <cstdlib>
+#include <cxxabi.h>
+#endif
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::EventProfiler implementation.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("EventProfiler");
+
+namespace {
+
+/**
+ * Demangle a type name.
+ *
+ * \param [in] type The type.
+ * \returns The demangled type name, or the mangled one on failure.
+ */
+std::string
+Demangle (std::type_index type)
+{
+  std::string name = type.name ();
+#if (__GNUC__ >= 3)
+  int status;
+  char *demangled = abi::__cxa_demangle (name.c_str (), NULL, NULL, &status);
+  if (status == 0)
+    {
+      name = demangled;
+    }
+  std::free (demangled);
+#endif
+  return name;
+}
+
+/**
+ * Get the first argument of a list starting at a given position,
+ * skipping nested brackets.
+ *
+ * \param [in] s The string.
+ * \param [in] start The position of the first character of the argument.
+ * \returns The argument, or an empty string if the list is not terminated.
+ */
+std::string
+FirstArgument (const std::string &s, std::size_t start)
+{
+  int depth = 0;
+  for (std::size_t i = start; i < s.size (); ++i)
+    {
+      char c = s[i];
+      if (c == '(' || c == '<' || c == '[' || c == '{')
+        {
+          depth++;
+        }
+      else if (c == ')' || c == '>' || c == ']' || c == '}')
+        {
+          if (depth == 0)
+            {
+              return s.substr (start, i - start);
+            }
+          depth--;
+        }
+      else if (c == ',' && depth == 0)
+        {
+          return s.substr (start, i - start);
+        }
+    }
+  return "";
+}
+
+/**
+ * Format a duration.
+ *
+ * \param [in] nanoseconds The duration, in nanoseconds.
+ * \returns The duration, in microseconds.
+ */
+std::string
+Micro (double nanoseconds)
+{
+  std::ostringstream oss;
+  oss << std::fixed << std::setprecision (3) << nanoseconds / 1000;
+  return oss.str ();
+}
+
+/**
+ * Write a report line.
+ *
+ * \param [in,out] os The output stream.
+ * \param [in] stats The statistics.
+ * \param [in] total The total duration of all the events, in nanoseconds.
+ * \param [in] label The line label.
+ */
+void
+WriteLine (std::ostream &os, const EventProfiler::Stats &stats, int64_t total,
+           const std::string &label)
+{
+  double share = total > 0 ? 100.0 * stats.total / total : 0;
+  os << Micro (static_cast<double> (stats.total)) << '\t'
+     << std::fixed << std::setprecision (2) << share << '\t'
+     << stats.count << '\t'
+     << Micro (stats.GetMean ()) << '\t'
+     << Micro (static_cast<double> (stats.GetPercentile (99))) << '\t'
+     << Micro (static_cast<double> (stats.max)) << '\t'
+     << label << '\n';
+}
+
+/**
+ * Sort statistics by decreasing total duration.
+ *
+ * \tparam K \deduced The key type.
+ * \param [in] a The first entry.
+ * \param [in] b The second entry.
+ * \returns \c true if \pname{a} took longer than \pname{b}.
+ */
+template <typename K>
+bool
+TakesLonger (const std::pair<K, EventProfiler::Stats> &a,
+             const std::pair<K, EventProfiler::Stats> &b)
+{
+  if (a.second.total != b.second.total)
+    {
+      return a.second.total > b.second.total;
+    }
+  return a.first < b.first;
+}
+
+} // unnamed namespace
+
+EventProfiler::Stats::Stats ()
+  : count (0),
+    total (0),
+    max (0)
+{
+  histogram.fill (0);
+}
+
+void
+EventProfiler::Stats::Add (int64_t nanoseconds)
+{
+  count++;
+  total += nanoseconds;
+  max = std::max (max, nanoseconds);
+  std::size_t bin = 0;
+  while (bin < HISTOGRAM_BINS - 1 && (int64_t (1) << bin) <= nanoseconds)
+    {
+      bin++;
+    }
+  histogram[bin]++;
+}
+
+void
+EventProfiler::Stats::Merge (const Stats &other)
+{
+  count += other.count;
+  total += other.total;
+  max = std::max (max, other.max);
+  for (std::size_t bin = 0; bin < HISTOGRAM_BINS; ++bin)
+    {
+      histogram[bin] += other.histogram[bin];
+    }
+}
+
+double
+EventProfiler::Stats::GetMean (void) const
+{
+  return count > 0 ? static_cast<double> (total) / count : 0;
+}
+
+int64_t
+EventProfiler::Stats::GetPercentile (double p) const
+{
+  uint64_t seen = 0;
+  for (std::size_t bin = 0; bin < HISTOGRAM_BINS; ++bin)
+    {
+      seen += histogram[bin];
+      if (seen > 0 && seen >= p / 100 * count)
+        {
+          return std::min (int64_t (1) << bin, max);
+        }
+    }
+  return max;
+}
+
+EventProfiler::EventProfiler ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+EventProfiler::Record (const EventImpl *event, uint32_t context, int64_t nanoseconds)
+{
+  m_byType[std::type_index (typeid (*event))].Add (nanoseconds);
+  m_byContext[context].Add (nanoseconds);
+}
+
+void
+EventProfiler::Clear (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_byType.clear ();
+  m_byContext.clear ();
+}
+
+std::string
+EventProfiler::GetLabel (std::type_index type)
+{
+  std::string name = Demangle (type);
+  // The events made by MakeEvent() are local classes of the MakeEvent
+  // template, whose first parameter is the function called.
+  std::string::size_type pos = name.find ("MakeEvent<");
+  if (pos == std::string::npos)
+    {
+      return name;
+    }
+  pos += std::string ("MakeEvent<").size ();
+  std::size_t depth = 1;
+  while (pos < name.size () && depth > 0)
+    {
+      if (name[pos] == '<')
+        {
+          depth++;
+        }
+      else if (name[pos] == '>')
+        {
+          depth--;
+        }
+      pos++;
+    }
+  if (pos >= name.size () || name[pos] != '(')
+    {
+      return name;
+    }
+  std::string function = FirstArgument (name, pos + 1);
+  return function.empty () ? name : function;
+}
+
+std::vector<std::pair<std::string, EventProfiler::Stats> >
+EventProfiler::GetByType (void) const
+{
+  // Different event types can have the same label.
+  std::map<std::string, Stats> byLabel;
+  for (const auto &entry : m_byType)
+    {
+      byLabel[GetLabel (entry.first)].Merge (entry.second);
+    }
+  std::vector<std::pair<std::string, Stats> > result (byLabel.begin (), byLabel.end ());
+  std::sort (result.begin (), result.end (), &TakesLonger<std::string>);
+  return result;
+}
+
+std::vector<std::pair<uint32_t, EventProfiler::Stats> >
+EventProfiler::GetByContext (void) const
+{
+  std::vector<std::pair<uint32_t, Stats> > result (m_byContext.begin (), m_byContext.end ());
+  std::sort (result.begin (), result.end (), &TakesLonger<uint32_t>);
+  return result;
+}
+
+EventProfiler::Stats
+EventProfiler::GetTotal (void) const
+{
+  Stats total;
+  for (const auto &entry : m_byContext)
+    {
+      total.Merge (entry.second);
+    }
+  return total;
+}
+
+void
+EventProfiler::Report (std::ostream &os) const
+{
+  NS_LOG_FUNCTION (this);
+  Stats total = GetTotal ();
+  os << "# Event profile: " << total.count << " events, "
+     << Micro (static_cast<double> (total.total)) << " us\n"
+     << "# total(us)\tshare(%)\tcount\tmean(us)\tp99(us)\tmax(us)\tevent type\n";
+  for (const auto &entry : GetByType ())
+    {
+      WriteLine (os, entry.second, total.total, entry.first);
+    }
+  os << "# total(us)\tshare(%)\tcount\tmean(us)\tp99(us)\tmax(us)\tcontext\n";
+  for (const auto &entry : GetByContext ())
+    {
+      std::ostringstream label;
+      if (entry.first == Simulator::NO_CONTEXT)
+        {
+          label << "none";
+        }
+      else
+        {
+          label << entry.first;
+        }
+      WriteLine (os, entry.second, total.total, label.str ());
+    }
+}
+
+} // namespace ns3
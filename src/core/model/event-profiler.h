@@ -0,0 +1,149 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef EVENT_PROFILER_H
+#define EVENT_PROFILER_H
+
+#include <array>
+#include <ostream>
+#include <stdint.h>
+#include <string>
+#include <typeindex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::EventProfiler declaration.
+ */
+
+namespace ns3 {
+
+class EventImpl;
+
+/**
+ * \ingroup simulator
+ *
+ * \brief Wall-clock time and count of the events run, by event type
+ * and by context.
+ *
+ * The event type is the dynamic type of the EventImpl.  For the events
+ * made by MakeEvent(), e.g. by Simulator::Schedule(), it is labeled
+ * with the type of the function called: the class and signature of a
+ * member function, the signature of a function, or the lambda.
+ *
+ * DefaultSimulatorImpl records each event in an EventProfiler when its
+ * \c EventProfiling attribute is \c true, and writes the report at
+ * Simulator::Destroy().  When the attribute is \c false, the event
+ * loop does not read the clock at all.
+ */
+class EventProfiler
+{
+public:
+  /** Number of duration histogram bins. */
+  static const std::size_t HISTOGRAM_BINS = 40;
+
+  /** The statistics of a set of events. */
+  struct Stats
+  {
+    Stats ();
+    /**
+     * Add an event.
+     *
+     * \param [in] nanoseconds The event wall-clock duration.
+     */
+    void Add (int64_t nanoseconds);
+    /**
+     * Add the events of other statistics.
+     *
+     * \param [in] other The other statistics.
+     */
+    void Merge (const Stats &other);
+    /** \returns The mean duration, in nanoseconds. */
+    double GetMean (void) const;
+    /**
+     * Estimate a percentile of the durations from the histogram.
+     *
+     * \param [in] p The percentile, between 0 and 100.
+     * \returns The upper bound of the histogram bin, in nanoseconds.
+     */
+    int64_t GetPercentile (double p) const;
+
+    uint64_t count;  //!< Number of events.
+    int64_t total;   //!< Total duration, in nanoseconds.
+    int64_t max;     //!< Longest duration, in nanoseconds.
+    /**
+     * Event count by duration: bin \c i counts the events which took
+     * less than \f$ 2^i \f$ ns, and at least \f$ 2^{i-1} \f$ ns.
+     */
+    std::array<uint64_t, HISTOGRAM_BINS> histogram;
+  };
+
+  /** Constructor. */
+  EventProfiler ();
+
+  /**
+   * Record an event.
+   *
+   * \param [in] event The event.
+   * \param [in] context The event context.
+   * \param [in] nanoseconds The wall-clock time spent running the event.
+   */
+  void Record (const EventImpl *event, uint32_t context, int64_t nanoseconds);
+  /** Forget all the events recorded. */
+  void Clear (void);
+
+  /**
+   * \returns The statistics by event type label, by decreasing total
+   *          duration.
+   */
+  std::vector<std::pair<std::string, Stats> > GetByType (void) const;
+  /**
+   * \returns The statistics by context, by decreasing total duration.
+   */
+  std::vector<std::pair<uint32_t, Stats> > GetByContext (void) const;
+  /** \returns The statistics of all the events. */
+  Stats GetTotal (void) const;
+
+  /**
+   * Write the report: one line per event type, then one line per
+   * context, by decreasing total duration.  The columns are separated
+   * by tabulations, so the report can be re-sorted with \c sort.
+   *
+   * \param [in,out] os The output stream.
+   */
+  void Report (std::ostream &os) const;
+
+  /**
+   * Get the label of an event type.
+   *
+   * \param [in] type The dynamic type of the event.
+   * \returns The label.
+   */
+  static std::string GetLabel (std::type_index type);
+
+private:
+  /** Statistics by dynamic type of the event. */
+  std::unordered_map<std::type_index, Stats> m_byType;
+  /** Statistics by context. */
+  std::unordered_map<uint32_t, Stats> m_byContext;
+};
+
+} // namespace ns3
+
+#endif /* EVENT_PROFILER_H */
@@ -28,6 +28,10 @@
 
 #include <stdint.h>
 #include <cmath>  // pow
+#include <cstring>  // memcpy
+#include <limits>
+
+#include "abort.h"
 
 #if defined(HAVE___UINT128_T) && !defined(HAVE_UINT128_T)
 /**
@@ -74,6 +78,10 @@ class int64x64_t
    * this define.
    */
 #define HP_MAX_64    (std::pow (2.0L, 64))
+  /// HP_MAX_64, as a double.
+  static constexpr double HP_MAX_64_D = 18446744073709551616.0;
+  /// 2^52, the smallest double without fractional bits.
+  static constexpr double HP_2_52_D = 4503599627370496.0;
 
 public:
   /**
@@ -94,7 +102,7 @@ public:
   static const enum impl_type implementation = int128_impl;
 
   /// Default constructor.
-  inline int64x64_t ()
+  inline constexpr int64x64_t ()
     : _v (0)
   {}
   /**
@@ -108,8 +116,33 @@ public:
    */
   inline int64x64_t (const double value)
   {
-    const int64x64_t tmp ((long double)value);
-    _v = tmp._v;
+    const bool negative = value < 0;
+    const double v = negative ? -value : value;
+    // The conversion through long double below is exact for a double
+    // when long double has at least 64 bits of mantissa, so the same
+    // result can be computed with integer and double operations,
+    // without the long double library calls.
+    if (std::numeric_limits<long double>::digits >= 64 && v < HP_MAX_64_D / 2)
+      {
+        const int64_t hi = static_cast<int64_t> (v);
+        // Exact: the fractional part scaled by a power of two.
+        const double flo = (v - hi) * HP_MAX_64_D;
+        uint64_t lo = static_cast<uint64_t> (flo);
+        // Round half up, as the long double conversion does: only
+        // fractions below 2^52 have fractional bits.
+        if (flo < HP_2_52_D && flo - lo >= 0.5)
+          {
+            ++lo;
+          }
+        _v = (int128_t)hi << 64;
+        _v |= lo;
+        _v = negative ? -_v : _v;
+      }
+    else
+      {
+        const int64x64_t tmp ((long double)value);
+        _v = tmp._v;
+      }
   }
   inline int64x64_t (const long double value)
   {
@@ -150,37 +183,25 @@ public:
    *
    * \param [in] v Integer value to represent.
    */
-  inline int64x64_t (const int v)
-    : _v (v)
-  {
-    _v <<= 64;
-  }
-  inline int64x64_t (const long int v)
-    : _v (v)
-  {
-    _v <<= 64;
-  }
-  inline int64x64_t (const long long int v)
-    : _v (v)
-  {
-    _v <<= 64;
-  }
-  inline int64x64_t (const unsigned int v)
-    : _v (v)
-  {
-    _v <<= 64;
-  }
-  inline int64x64_t (const unsigned long int v)
-    : _v (v)
-  {
-    _v <<= 64;
-  }
-  inline int64x64_t (const unsigned long long int v)
-    : _v (v)
-  {
-    _v <<= 64;
-  }
-  inline int64x64_t (const int128_t v)
+  inline constexpr int64x64_t (const int v)
+    : _v ((int128_t)v << 64)
+  {}
+  inline constexpr int64x64_t (const long int v)
+    : _v ((int128_t)v << 64)
+  {}
+  inline constexpr int64x64_t (const long long int v)
+    : _v ((int128_t)v << 64)
+  {}
+  inline constexpr int64x64_t (const unsigned int v)
+    : _v ((int128_t)v << 64)
+  {}
+  inline constexpr int64x64_t (const unsigned long int v)
+    : _v ((int128_t)v << 64)
+  {}
+  inline constexpr int64x64_t (const unsigned long long int v)
+    : _v ((int128_t)v << 64)
+  {}
+  inline constexpr int64x64_t (const int128_t v)
     : _v (v)
   {}
   /**@}*/
@@ -191,18 +212,16 @@ public:
    * \param [in] hi Integer portion.
    * \param [in] lo Fractional portion, already scaled to HP_MAX_64.
    */
-  explicit inline int64x64_t (const int64_t hi, const uint64_t lo)
-  {
-    _v = (int128_t)hi << 64;
-    _v |= lo;
-  }
+  explicit inline constexpr int64x64_t (const int64_t hi, const uint64_t lo)
+    : _v (((int128_t)hi << 64) | lo)
+  {}
 
   /**
    * Copy constructor.
    *
    * \param [in] o Value to copy.
    */
-  inline int64x64_t (const int64x64_t & o)
+  inline constexpr int64x64_t (const int64x64_t & o)
     : _v (o._v)
   {}
   /**
@@ -232,6 +251,11 @@ public:
   {
     const bool negative = _v < 0;
     const uint128_t value = negative ? -_v : _v;
+    if (std::numeric_limits<long double>::digits == 64)
+      {
+        const double retval = RoundToDouble (value);
+        return negative ? -retval : retval;
+      }
     const long double fhi = value >> 64;
     const long double flo = (value & HP_MASK_LO) / HP_MAX_64;
     long double retval = fhi;
@@ -299,7 +323,14 @@ public:
    *
    * \see Invert()
    */
-  void MulByInvert (const int64x64_t & o);
+  inline void MulByInvert (const int64x64_t & o)
+  {
+    bool negResult = _v < 0;
+    uint128_t a = negResult ? -_v : _v;
+    uint128_t result = UmulByInvert (a, o._v);
+
+    _v = negResult ? -result : result;
+  }
 
   /**
    * Compute the inverse of an integer value.
@@ -377,7 +408,15 @@ private:
    *
    * \param [in] o The other factor.
    */
-  void Mul (const int64x64_t & o);
+  inline void Mul (const int64x64_t & o)
+  {
+    bool negA = _v < 0;
+    bool negB = o._v < 0;
+    uint128_t a = negA ? -_v : _v;
+    uint128_t b = negB ? -o._v : o._v;
+    uint128_t result = Umul (a, b);
+    _v = negA != negB ? -result : result;
+  }
   /**
    * Implement `/=`.
    *
@@ -408,7 +447,44 @@ private:
    * high and low 64 bits.  To achieve this, we carry out the multiplication
    * explicitly with 64-bit operands and 128-bit intermediate results.
    */
-  static uint128_t Umul         (const uint128_t a, const uint128_t b);
+  static inline uint128_t Umul (const uint128_t a, const uint128_t b)
+  {
+    uint128_t aL = a & HP_MASK_LO;
+    uint128_t bL = b & HP_MASK_LO;
+    uint128_t aH = (a >> 64) & HP_MASK_LO;
+    uint128_t bH = (b >> 64) & HP_MASK_LO;
+
+    uint128_t result;
+    uint128_t hiPart, loPart, midPart;
+    uint128_t res1, res2;
+
+    // Multiplying (a.h 2^64 + a.l) x (b.h 2^64 + b.l) =
+    //			2^128 a.h b.h + 2^64*(a.h b.l+b.h a.l) + a.l b.l
+    // get the low part a.l b.l
+    // multiply the fractional part
+    loPart = aL * bL;
+    // compute the middle part 2^64*(a.h b.l+b.h a.l)
+    midPart = aL * bH + aH * bL;
+    // compute the high part 2^128 a.h b.h
+    hiPart = aH * bH;
+    // if the high part is not zero, put a warning
+    NS_ABORT_MSG_IF ((hiPart & HP_MASK_HI) != 0,
+                     "High precision 128 bits multiplication error: multiplication overflow.");
+
+    // Adding 64-bit terms to get 128-bit results, with carries
+    res1 = loPart >> 64;
+    res2 = midPart & HP_MASK_LO;
+    result = res1 + res2;
+
+    res1 = midPart >> 64;
+    res2 = hiPart & HP_MASK_LO;
+    res1 += res2;
+    res1 <<= 64;
+
+    result += res1;
+
+    return result;
+  }
   /**
    * Unsigned division of Q64.64 values.
    *
@@ -426,7 +502,78 @@ private:
    *
    * \see Invert()
    */
-  static uint128_t UmulByInvert (const uint128_t a, const uint128_t b);
+  static inline uint128_t UmulByInvert (const uint128_t a, const uint128_t b)
+  {
+    uint128_t result, ah, bh, al, bl;
+    uint128_t hi, mid;
+    ah = a >> 64;
+    bh = b >> 64;
+    al = a & HP_MASK_LO;
+    bl = b & HP_MASK_LO;
+    hi = ah * bh;
+    mid = ah * bl + al * bh;
+    mid >>= 64;
+    result = hi + mid;
+    return result;
+  }
+  /**
+   * Round a Q64.64 magnitude to a double, as GetDouble() does through
+   * a 64 bit mantissa long double: round to nearest even to 64
+   * significant bits, then to 53.
+   *
+   * \param [in] value The unsigned Q64.64 value.
+   * \return The rounded value.
+   */
+  static inline double RoundToDouble (uint128_t value)
+  {
+    // Value is mantissa * 2^(exponent - 64).
+    int exponent = 0;
+    int bits = Width (value);
+    if (bits > 64)
+      {
+        value = RoundShift (value, bits - 64);
+        exponent = bits - 64;
+        bits = Width (value);
+      }
+    if (bits > 53)
+      {
+        value = RoundShift (value, bits - 53);
+        exponent += bits - 53;
+      }
+    // Scale by 2^(exponent - 64), built from its bit pattern.
+    const uint64_t scaleBits = static_cast<uint64_t> (1023 + exponent - 64) << 52;
+    double scale;
+    std::memcpy (&scale, &scaleBits, sizeof (scale));
+    return static_cast<double> (static_cast<uint64_t> (value)) * scale;
+  }
+  /**
+   * \param [in] v A value.
+   * \return The number of significant bits of \pname{v}.
+   */
+  static inline int Width (const uint128_t v)
+  {
+    const uint64_t hi = v >> 64;
+    const uint64_t lo = v;
+    return hi ? 128 - __builtin_clzll (hi) : (lo ? 64 - __builtin_clzll (lo) : 0);
+  }
+  /**
+   * Shift right, rounding to nearest even.
+   *
+   * \param [in] v The value.
+   * \param [in] shift The shift, between 1 and 127.
+   * \return The rounded, shifted value.
+   */
+  static inline uint128_t RoundShift (const uint128_t v, const int shift)
+  {
+    const uint128_t half = ((uint128_t)1) << (shift - 1);
+    const uint128_t rest = v & ((half << 1) - 1);
+    uint128_t q = v >> shift;
+    if (rest > half || (rest == half && (q & 1)))
+      {
+        ++q;
+      }
+    return q;
+  }
 
   int128_t _v;  //!< The Q64.64 value.
 
@@ -0,0 +1,315 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ladder-scheduler.h"
+#include "event-impl.h"
+#include "uinteger.h"
+#include "assert.h"
+#include "log.h"
+
+#include <algorithm>
+#include <functional>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * ns3::LadderScheduler class implementation.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LadderScheduler");
+
+NS_OBJECT_ENSURE_REGISTERED (LadderScheduler);
+
+TypeId
+LadderScheduler::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::LadderScheduler")
+    .SetParent<Scheduler> ()
+    .SetGroupName ("Core")
+    .AddConstructor<LadderScheduler> ()
+    .AddAttribute ("BucketThreshold",
+                   "Number of events in a bucket above which the bucket "
+                   "is expanded into a new rung instead of being sorted",
+                   TypeId::ATTR_CONSTRUCT,
+                   UintegerValue (50),
+                   MakeUintegerAccessor (&LadderScheduler::m_threshold),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("MaxRungs",
+                   "Maximum number of rungs in the ladder",
+                   TypeId::ATTR_CONSTRUCT,
+                   UintegerValue (8),
+                   MakeUintegerAccessor (&LadderScheduler::SetMaxRungs),
+                   MakeUintegerChecker<uint32_t> (1, 64))
+    .AddAttribute ("MaxBuckets",
+                   "Maximum number of buckets in a rung",
+                   TypeId::ATTR_CONSTRUCT,
+                   UintegerValue (65536),
+                   MakeUintegerAccessor (&LadderScheduler::m_maxBuckets),
+                   MakeUintegerChecker<uint32_t> (2))
+  ;
+  return tid;
+}
+
+LadderScheduler::LadderScheduler ()
+  : m_topMin (UINT64_MAX),
+    m_topMax (0),
+    m_topStart (0),
+    m_nRungs (0),
+    m_threshold (50),
+    m_maxBuckets (65536)
+{
+  NS_LOG_FUNCTION (this);
+  SetMaxRungs (8);
+}
+
+LadderScheduler::~LadderScheduler ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+LadderScheduler::SetMaxRungs (uint32_t maxRungs)
+{
+  NS_LOG_FUNCTION (this << maxRungs);
+  NS_ASSERT (m_nRungs == 0);
+  m_rungs.resize (maxRungs);
+}
+
+uint32_t
+LadderScheduler::FindRung (uint64_t ts) const
+{
+  uint32_t i = 0;
+  while (i < m_nRungs)
+    {
+      const Rung &rung = m_rungs[i];
+      if (ts >= rung.start + rung.current * rung.width)
+        {
+          break;
+        }
+      i++;
+    }
+  return i;
+}
+
+LadderScheduler::Rung &
+LadderScheduler::InitRung (uint32_t index, uint64_t start, uint64_t width, uint32_t nBuckets)
+{
+  NS_LOG_FUNCTION (this << index << start << width << nBuckets);
+  Rung &rung = m_rungs[index];
+  if (rung.buckets.size () < nBuckets)
+    {
+      rung.buckets.resize (nBuckets);
+    }
+  rung.nBuckets = nBuckets;
+  rung.current = 0;
+  rung.start = start;
+  rung.width = width;
+  return rung;
+}
+
+void
+LadderScheduler::TransferTop (void)
+{
+  NS_LOG_FUNCTION (this << m_top.size ());
+  NS_ASSERT (m_nRungs == 0 && !m_top.empty ());
+  uint64_t span = m_topMax - m_topMin;
+  uint64_t nBuckets = std::min<uint64_t> (m_top.size (), m_maxBuckets);
+  nBuckets = std::min (nBuckets, span + 1);
+  // nBuckets * width > span, so every event fits in the rung.
+  uint64_t width = span / nBuckets + 1;
+  Rung &rung = InitRung (0, m_topMin, width, static_cast<uint32_t> (nBuckets));
+  for (Bucket::const_iterator i = m_top.begin (); i != m_top.end (); ++i)
+    {
+      rung.buckets[(i->key.m_ts - rung.start) / width].push_back (*i);
+    }
+  m_top.clear ();
+  m_nRungs = 1;
+  m_topStart = rung.start + nBuckets * width;
+  m_topMin = UINT64_MAX;
+  m_topMax = 0;
+}
+
+void
+LadderScheduler::FillBottom (void)
+{
+  NS_LOG_FUNCTION (this);
+  while (m_bottom.empty ())
+    {
+      if (m_nRungs == 0)
+        {
+          if (m_top.empty ())
+            {
+              return;
+            }
+          TransferTop ();
+        }
+      Rung &rung = m_rungs[m_nRungs - 1];
+      while (rung.current < rung.nBuckets
+             && rung.buckets[rung.current].empty ())
+        {
+          rung.current++;
+        }
+      if (rung.current == rung.nBuckets)
+        {
+          // This rung is exhausted, go back to the one above.
+          m_nRungs--;
+          continue;
+        }
+      Bucket &bucket = rung.buckets[rung.current];
+      uint64_t bucketStart = rung.start + rung.current * rung.width;
+      rung.current++;
+      if (bucket.size () > m_threshold
+          && rung.width > 1
+          && m_nRungs < m_rungs.size ())
+        {
+          // Spread the bucket over a finer-grained rung.
+          uint64_t nBuckets = std::min<uint64_t> (bucket.size (), m_maxBuckets);
+          uint64_t width = (rung.width + nBuckets - 1) / nBuckets;
+          nBuckets = (rung.width + width - 1) / width;
+          NS_LOG_LOGIC ("spawn rung " << m_nRungs << " width=" << width);
+          Rung &child = InitRung (m_nRungs, bucketStart, width,
+                                  static_cast<uint32_t> (nBuckets));
+          m_nRungs++;
+          for (Bucket::const_iterator i = bucket.begin (); i != bucket.end (); ++i)
+            {
+              child.buckets[(i->key.m_ts - bucketStart) / width].push_back (*i);
+            }
+          bucket.clear ();
+        }
+      else
+        {
+          // Swap storage rather than copy: the bucket gets the
+          // (empty) buffer of the bottom.
+          m_bottom.swap (bucket);
+          std::make_heap (m_bottom.begin (), m_bottom.end (),
+                          std::greater<Scheduler::Event> ());
+        }
+    }
+}
+
+bool
+LadderScheduler::RemoveFromBucket (Bucket &bucket, const Scheduler::Event &ev)
+{
+  for (Bucket::iterator i = bucket.begin (); i != bucket.end (); ++i)
+    {
+      if (i->key.m_uid == ev.key.m_uid)
+        {
+          NS_ASSERT (ev.impl == i->impl);
+          *i = bucket.back ();
+          bucket.pop_back ();
+          return true;
+        }
+    }
+  return false;
+}
+
+void
+LadderScheduler::Insert (const Event &ev)
+{
+  NS_LOG_FUNCTION (this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+  uint64_t ts = ev.key.m_ts;
+  if (ts >= m_topStart)
+    {
+      m_top.push_back (ev);
+      m_topMin = std::min (m_topMin, ts);
+      m_topMax = std::max (m_topMax, ts);
+      if (m_bottom.empty ())
+        {
+          FillBottom ();
+        }
+      return;
+    }
+  uint32_t i = FindRung (ts);
+  if (i < m_nRungs)
+    {
+      Rung &rung = m_rungs[i];
+      rung.buckets[(ts - rung.start) / rung.width].push_back (ev);
+      if (m_bottom.empty ())
+        {
+          FillBottom ();
+        }
+      return;
+    }
+  m_bottom.push_back (ev);
+  std::push_heap (m_bottom.begin (), m_bottom.end (),
+                  std::greater<Scheduler::Event> ());
+}
+
+bool
+LadderScheduler::IsEmpty (void) const
+{
+  NS_LOG_FUNCTION (this);
+  // The bottom is refilled as soon as it is drained.
+  return m_bottom.empty ();
+}
+
+Scheduler::Event
+LadderScheduler::PeekNext (void) const
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (!IsEmpty ());
+  return m_bottom.front ();
+}
+
+Scheduler::Event
+LadderScheduler::RemoveNext (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (!IsEmpty ());
+  std::pop_heap (m_bottom.begin (), m_bottom.end (),
+                 std::greater<Scheduler::Event> ());
+  Scheduler::Event ev = m_bottom.back ();
+  m_bottom.pop_back ();
+  if (m_bottom.empty ())
+    {
+      FillBottom ();
+    }
+  return ev;
+}
+
+void
+LadderScheduler::Remove (const Event &ev)
+{
+  NS_LOG_FUNCTION (this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+  NS_ASSERT (!IsEmpty ());
+  uint64_t ts = ev.key.m_ts;
+  if (ts >= m_topStart)
+    {
+      bool found [[maybe_unused]] = RemoveFromBucket (m_top, ev);
+      NS_ASSERT (found);
+      return;
+    }
+  uint32_t i = FindRung (ts);
+  if (i < m_nRungs)
+    {
+      Rung &rung = m_rungs[i];
+      bool found [[maybe_unused]] = RemoveFromBucket (rung.buckets[(ts - rung.start) / rung.width], ev);
+      NS_ASSERT (found);
+      return;
+    }
+  bool found [[maybe_unused]] = RemoveFromBucket (m_bottom, ev);
+  NS_ASSERT (found);
+  std::make_heap (m_bottom.begin (), m_bottom.end (),
+                  std::greater<Scheduler::Event> ());
+  if (m_bottom.empty ())
+    {
+      FillBottom ();
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,182 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LADDER_SCHEDULER_H
+#define LADDER_SCHEDULER_H
+
+#include "scheduler.h"
+#include <stdint.h>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * ns3::LadderScheduler class declaration.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup scheduler
+ * \brief a ladder queue event scheduler
+ *
+ * This event scheduler is an implementation of the multi-tier
+ * calendar structure known as a ladder queue, published in
+ * ["Ladder Queue: An O(1) Priority Queue Structure for Large-Scale
+ * Discrete Event Simulation" by Wai Teng Tang, Rick Siow Mong Goh
+ * and Ian Li-Jin Thng][Tang].
+ *
+ * [Tang]: https://doi.org/10.1145/1103323.1103324 "Tang"
+ *
+ * The event list is split in three tiers:
+ *  - the *top* holds, unsorted, all the events beyond the time
+ *    span covered by the ladder;
+ *  - the *ladder* is a stack of rungs, each an array of buckets of
+ *    uniform width.  The first rung is built from the top when the
+ *    ladder is empty, with a bucket width derived from the time span of
+ *    the events it holds.  Whenever the next bucket to be consumed holds
+ *    more than `BucketThreshold` events, it is expanded into a new
+ *    finer-grained rung rather than sorted, up to `MaxRungs` rungs;
+ *  - the *bottom* holds the earliest events as a binary heap on a
+ *    `std::vector`, from which RemoveNext() pops.
+ *
+ * Unlike CalendarScheduler there is no global resize: the bucket width
+ * is chosen independently for each rung, from the events that land in
+ * it, so bursts of events at the same time stamp and a long tail of
+ * far-future events do not degrade each other.  Buckets are
+ * `std::vector`s and rung storage is reused, so the steady state
+ * performs no memory allocation.
+ *
+ * \par Time Complexity
+ *
+ * Operation    | Amortized %Time | Reason
+ * :----------- | :-------------- | :-----
+ * Insert()     | ~Constant       | Append to top or rung bucket; heap insert in bottom
+ * IsEmpty()    | Constant        | Bottom is empty only when the queue is
+ * PeekNext()   | Constant        | Bottom heap root
+ * Remove()     | ~Constant       | Search within bucket; heap rebuild in bottom
+ * RemoveNext() | ~Constant       | Bottom heap pop; amortized bucket transfer
+ *
+ * \par Memory Complexity
+ *
+ * Category  | Memory                           | Reason
+ * :-------- | :------------------------------- | :-----
+ * Overhead  | `MaxRungs` x 48 + 120 bytes      | Rungs, top and bottom vectors
+ * Per Event | 0                                | Events stored in `std::vector` directly
+ *
+ * \note Events with identical time stamps always share a bucket and are
+ * ordered by the bottom heap, so large bursts of simultaneous events
+ * cost a logarithmic heap operation each.
+ */
+class LadderScheduler : public Scheduler
+{
+public:
+  /**
+   *  Register this type.
+   *  \return The object TypeId.
+   */
+  static TypeId GetTypeId (void);
+
+  /** Constructor. */
+  LadderScheduler ();
+  /** Destructor. */
+  virtual ~LadderScheduler ();
+
+  // Inherited
+  virtual void Insert (const Scheduler::Event &ev);
+  virtual bool IsEmpty (void) const;
+  virtual Scheduler::Event PeekNext (void) const;
+  virtual Scheduler::Event RemoveNext (void);
+  virtual void Remove (const Scheduler::Event &ev);
+
+private:
+  /** Bucket type: an unsorted vector of Events. */
+  typedef std::vector<Scheduler::Event> Bucket;
+
+  /** A ladder rung: an array of buckets of uniform width. */
+  struct Rung
+  {
+    std::vector<Bucket> buckets; /**< The buckets; only the first nBuckets are in use. */
+    uint32_t nBuckets;           /**< Number of buckets in use. */
+    uint32_t current;            /**< Index of the next bucket to consume. */
+    uint64_t start;              /**< Time stamp of the start of the first bucket. */
+    uint64_t width;              /**< Duration of a bucket, in dimensionless time units. */
+  };
+
+  /**
+   * Find the rung covering a time stamp.
+   *
+   * \param [in] ts The dimensionless time stamp.
+   * \returns The rung index, or m_nRungs if the time stamp is before
+   *          the current bucket of the last rung and belongs to the bottom.
+   */
+  uint32_t FindRung (uint64_t ts) const;
+  /**
+   * Prepare a rung for use.
+   *
+   * \param [in] index The index of the rung.
+   * \param [in] start The start time stamp of the first bucket.
+   * \param [in] width The bucket width.
+   * \param [in] nBuckets The number of buckets.
+   * \returns The rung.
+   */
+  Rung & InitRung (uint32_t index, uint64_t start, uint64_t width, uint32_t nBuckets);
+  /** Move all events in the top to a new first rung. */
+  void TransferTop (void);
+  /** Refill the bottom from the ladder, if it is empty. */
+  void FillBottom (void);
+  /**
+   * Remove an event from an unsorted bucket.
+   *
+   * \param [in,out] bucket The bucket to search.
+   * \param [in] ev The event to remove.
+   * \returns \c true if the event was found.
+   */
+  bool RemoveFromBucket (Bucket &bucket, const Scheduler::Event &ev);
+
+  /**
+   * Set the maximum number of rungs.
+   *
+   * This can only be used at construction, as invoked by the
+   * Attribute MaxRungs.
+   *
+   * \param [in] maxRungs The maximum number of rungs.
+   */
+  void SetMaxRungs (uint32_t maxRungs);
+
+  /** Unsorted events beyond the ladder. */
+  Bucket m_top;
+  /** Smallest time stamp inserted in the top since the last transfer. */
+  uint64_t m_topMin;
+  /** Largest time stamp inserted in the top since the last transfer. */
+  uint64_t m_topMax;
+  /** Events with a time stamp at or after this go to the top. */
+  uint64_t m_topStart;
+  /** The rungs; only the first m_nRungs are in use. */
+  std::vector<Rung> m_rungs;
+  /** Number of rungs in use. */
+  uint32_t m_nRungs;
+  /** The earliest events, as a min-heap. */
+  std::vector<Scheduler::Event> m_bottom;
+  /** Bucket size above which a bucket is expanded into a new rung. */
+  uint32_t m_threshold;
+  /** Maximum number of buckets per rung. */
+  uint32_t m_maxBuckets;
+};
+
+} // namespace ns3
+
+#endif /* LADDER_SCHEDULER_H */
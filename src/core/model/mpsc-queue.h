@@ -0,0 +1,292 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MPSC_QUEUE_H
+#define MPSC_QUEUE_H
+
+#include "system-mutex.h"
+#include "assert.h"
+
+#include <atomic>
+#include <stdint.h>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup thread
+ * ns3::MpscQueue declaration and template implementation.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup thread
+ * \brief A multi-producer, single-consumer FIFO queue.
+ *
+ * Any number of threads may Push() items concurrently, while a single
+ * consumer thread Pop()s them.  Items pushed by a given producer are
+ * popped in the order they were pushed; there is no ordering between
+ * items of different producers.
+ *
+ * The queue is a bounded ring of cells, each tagged with a sequence
+ * number, as described by Dmitry Vyukov.  A producer claims a cell with
+ * a single compare-and-swap on the tail index, and publishes the item
+ * with a release store of the cell sequence number; the consumer
+ * never writes the tail.  Neither side takes a lock, and the ring is
+ * allocated once, at construction.
+ *
+ * When the ring is full, producers fall back on an overflow
+ * `std::vector` protected by a SystemMutex, so Push() never fails nor
+ * blocks waiting for the consumer.  While the overflow is in use all
+ * producers append to it, and the consumer only takes it over once the
+ * ring is drained, which preserves the per-producer ordering.
+ *
+ * \tparam T \explicit The item type.  It must be default constructible
+ *         and copy assignable, and should be small: items are copied in
+ *         and out of the ring.
+ */
+template <typename T>
+class MpscQueue
+{
+public:
+  /**
+   * Constructor.
+   *
+   * \param [in] capacity The number of items the ring can hold before
+   *             producers use the overflow; rounded up to a power of two.
+   */
+  explicit MpscQueue (uint32_t capacity = 1024);
+
+  /**
+   * Add an item at the end of the queue.
+   *
+   * This can be called from any thread.
+   *
+   * \param [in] item The item to add.
+   */
+  void Push (const T &item);
+  /**
+   * Remove the item at the head of the queue.
+   *
+   * This must only be called from the consumer thread.  It can return
+   * \c false while a producer is in the middle of a Push(); the item
+   * will be available to a later call.
+   *
+   * \param [out] item The item removed.
+   * \returns \c true if an item was removed.
+   */
+  bool Pop (T &item);
+  /**
+   * Check if the queue is empty.
+   *
+   * This must only be called from the consumer thread.  A concurrent
+   * Push() may make the result stale as soon as it is returned.
+   *
+   * \returns \c true if there is nothing to Pop().
+   */
+  bool IsEmpty (void) const;
+
+private:
+  /** A ring cell. */
+  struct Cell
+  {
+    /**
+     * The ring position this cell is ready for: equal to the position
+     * when the cell is free, and to the position plus one once an item
+     * has been published in it.
+     */
+    std::atomic<uint64_t> sequence;
+    /** The item. */
+    T item;
+  };
+
+  /**
+   * Try to add an item to the ring.
+   *
+   * \param [in] item The item to add.
+   * \returns \c false if the ring is full.
+   */
+  bool TryPushRing (const T &item);
+  /**
+   * Take over the overflow items, if the ring is empty.
+   *
+   * \returns \c true if m_batch now holds items to Pop().
+   */
+  bool TakeOverflow (void);
+
+  /** The ring. */
+  std::vector<Cell> m_cells;
+  /** Ring size minus one, to compute cell indices. */
+  uint64_t m_mask;
+  /** Next ring position to claim; written by producers. */
+  alignas (64) std::atomic<uint64_t> m_tail;
+  /** Next ring position to pop; consumer only. */
+  alignas (64) uint64_t m_head;
+  /** Overflow items taken over by the consumer; consumer only. */
+  std::vector<T> m_batch;
+  /** Index of the next item to pop in m_batch; consumer only. */
+  std::size_t m_batchNext;
+  /** Flag \c true while producers must append to m_overflow. */
+  std::atomic<bool> m_overflowing;
+  /** Items pushed while the ring was full. */
+  std::vector<T> m_overflow;
+  /** Mutex protecting m_overflow. */
+  SystemMutex m_overflowMutex;
+
+};  // class MpscQueue
+
+
+} // namespace ns3
+
+
+/********************************************************************
+ *  Implementation of the templates declared above.
+ ********************************************************************/
+
+namespace ns3 {
+
+template <typename T>
+MpscQueue<T>::MpscQueue (uint32_t capacity)
+  : m_tail (0),
+    m_head (0),
+    m_batchNext (0),
+    m_overflowing (false)
+{
+  uint64_t size = 1;
+  while (size < capacity)
+    {
+      size <<= 1;
+    }
+  m_cells = std::vector<Cell> (size);
+  m_mask = size - 1;
+  for (uint64_t i = 0; i < size; ++i)
+    {
+      m_cells[i].sequence.store (i, std::memory_order_relaxed);
+    }
+}
+
+template <typename T>
+bool
+MpscQueue<T>::TryPushRing (const T &item)
+{
+  uint64_t pos = m_tail.load (std::memory_order_relaxed);
+  for (;;)
+    {
+      Cell &cell = m_cells[pos & m_mask];
+      uint64_t seq = cell.sequence.load (std::memory_order_acquire);
+      int64_t diff = static_cast<int64_t> (seq - pos);
+      if (diff == 0)
+        {
+          if (m_tail.compare_exchange_weak (pos, pos + 1,
+                                            std::memory_order_relaxed))
+            {
+              cell.item = item;
+              cell.sequence.store (pos + 1, std::memory_order_release);
+              return true;
+            }
+          // pos was reloaded by the failed compare_exchange_weak.
+        }
+      else if (diff < 0)
+        {
+          // The cell still holds the item from the previous lap.
+          return false;
+        }
+      else
+        {
+          pos = m_tail.load (std::memory_order_relaxed);
+        }
+    }
+}
+
+template <typename T>
+void
+MpscQueue<T>::Push (const T &item)
+{
+  if (!m_overflowing.load (std::memory_order_acquire)
+      && TryPushRing (item))
+    {
+      return;
+    }
+  CriticalSection cs (m_overflowMutex);
+  m_overflow.push_back (item);
+  m_overflowing.store (true, std::memory_order_release);
+}
+
+template <typename T>
+bool
+MpscQueue<T>::TakeOverflow (void)
+{
+  NS_ASSERT (m_batchNext == m_batch.size ());
+  if (!m_overflowing.load (std::memory_order_acquire))
+    {
+      return false;
+    }
+  m_batch.clear ();
+  m_batchNext = 0;
+  CriticalSection cs (m_overflowMutex);
+  // A producer may have claimed a ring cell before pushing to the
+  // overflow: that item must be popped first.
+  if (m_tail.load (std::memory_order_acquire) != m_head)
+    {
+      return false;
+    }
+  m_batch.swap (m_overflow);
+  m_overflowing.store (false, std::memory_order_release);
+  return !m_batch.empty ();
+}
+
+template <typename T>
+bool
+MpscQueue<T>::Pop (T &item)
+{
+  if (m_batchNext < m_batch.size ())
+    {
+      item = m_batch[m_batchNext++];
+      return true;
+    }
+  Cell &cell = m_cells[m_head & m_mask];
+  if (cell.sequence.load (std::memory_order_acquire) == m_head + 1)
+    {
+      item = cell.item;
+      cell.sequence.store (m_head + m_mask + 1, std::memory_order_release);
+      ++m_head;
+      return true;
+    }
+  if (m_tail.load (std::memory_order_acquire) != m_head)
+    {
+      // A producer has claimed the cell but not published the item yet.
+      return false;
+    }
+  if (TakeOverflow ())
+    {
+      item = m_batch[m_batchNext++];
+      return true;
+    }
+  return false;
+}
+
+template <typename T>
+bool
+MpscQueue<T>::IsEmpty (void) const
+{
+  return m_batchNext == m_batch.size ()
+         && m_tail.load (std::memory_order_acquire) == m_head
+         && !m_overflowing.load (std::memory_order_acquire);
+}
+
+} // namespace ns3
+
+#endif /* MPSC_QUEUE_H */
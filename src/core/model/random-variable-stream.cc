@@ -33,9 +33,11 @@
 #include "log.h"
 #include "rng-stream.h"
 #include "rng-seed-manager.h"
+#include "system-mutex.h"
 #include <cmath>
 #include <iostream>
 #include <algorithm>    // upper_bound
+#include <set>
 
 /**
  * \file
@@ -49,6 +51,39 @@ NS_LOG_COMPONENT_DEFINE ("RandomVariableStream");
 
 NS_OBJECT_ENSURE_REGISTERED (RandomVariableStream);
 
+namespace {
+
+/**
+ * \ingroup randomvariable
+ * Get the set of the existing streams, for RandomVariableStream::RestartAll.
+ *
+ * The set is never deleted, so that the streams destroyed at the
+ * program exit can still remove themselves from it.
+ *
+ * \returns The set of the existing streams.
+ */
+std::set<RandomVariableStream *> &
+GetStreams (void)
+{
+  static std::set<RandomVariableStream *> *streams = new std::set<RandomVariableStream *> ();
+  return *streams;
+}
+
+/**
+ * \ingroup randomvariable
+ * Get the mutex protecting the set of the existing streams.
+ *
+ * \returns The mutex.
+ */
+SystemMutex &
+GetStreamsMutex (void)
+{
+  static SystemMutex *mutex = new SystemMutex ();
+  return *mutex;
+}
+
+}  // unnamed namespace
+
 TypeId
 RandomVariableStream::GetTypeId (void)
 {
@@ -76,10 +111,16 @@ RandomVariableStream::RandomVariableStream ()
   : m_rng (0)
 {
   NS_LOG_FUNCTION (this);
+  CriticalSection cs (GetStreamsMutex ());
+  GetStreams ().insert (this);
 }
 RandomVariableStream::~RandomVariableStream ()
 {
   NS_LOG_FUNCTION (this);
+  {
+    CriticalSection cs (GetStreamsMutex ());
+    GetStreams ().erase (this);
+  }
   delete m_rng;
 }
 
@@ -108,9 +149,7 @@ RandomVariableStream::SetStream (int64_t stream)
       // number assignment.
       uint64_t nextStream = RngSeedManager::GetNextStreamIndex ();
       NS_ASSERT (nextStream <= ((1ULL) << 63));
-      m_rng = new RngStream (RngSeedManager::GetSeed (),
-                             nextStream,
-                             RngSeedManager::GetRun ());
+      m_rngIndex = nextStream;
     }
   else
     {
@@ -118,10 +157,11 @@ RandomVariableStream::SetStream (int64_t stream)
       // number assignment.
       uint64_t base = ((1ULL) << 63);
       uint64_t target = base + stream;
-      m_rng = new RngStream (RngSeedManager::GetSeed (),
-                             target,
-                             RngSeedManager::GetRun ());
+      m_rngIndex = target;
     }
+  m_rng = new RngStream (RngSeedManager::GetSeed (),
+                         m_rngIndex,
+                         RngSeedManager::GetRun ());
   m_stream = stream;
 }
 int64_t
@@ -131,6 +171,23 @@ RandomVariableStream::GetStream (void) const
   return m_stream;
 }
 
+void
+RandomVariableStream::RestartAll (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  uint32_t seed = RngSeedManager::GetSeed ();
+  uint64_t run = RngSeedManager::GetRun ();
+  CriticalSection cs (GetStreamsMutex ());
+  for (RandomVariableStream *stream : GetStreams ())
+    {
+      if (stream->m_rng != 0)
+        {
+          delete stream->m_rng;
+          stream->m_rng = new RngStream (seed, stream->m_rngIndex, run);
+        }
+    }
+}
+
 RngStream *
 RandomVariableStream::Peek (void) const
 {
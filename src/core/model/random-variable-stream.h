@@ -137,6 +137,17 @@ public:
    */
   bool IsAntithetic (void) const;
 
+  /**
+   * \brief Restart all the existing streams with the current seed and run.
+   *
+   * Each stream keeps its stream number, and restarts at the beginning
+   * of the substream selected by the current \ref GlobalValueRngRun
+   * "RngRun", as if it had been created with the current RngSeed and
+   * RngRun.  This gives independent replications of a simulation
+   * forked after its start, e.g. with Checkpoint::Fork().
+   */
+  static void RestartAll (void);
+
   /**
    * \brief Get the next random value as a double drawn from the distribution.
    * \return A floating point random value.
@@ -187,6 +198,9 @@ private:
   /** The stream number for the RngStream. */
   int64_t m_stream;
 
+  /** The index of the underlying RngStream. */
+  uint64_t m_rngIndex;
+
 };  // class RandomVariableStream
 
 
@@ -33,6 +33,7 @@
 #include "enum.h"
 
 
+#include <algorithm>
 #include <cmath>
 
 
@@ -103,6 +104,7 @@ void
 RealtimeSimulatorImpl::DoDispose (void)
 {
   NS_LOG_FUNCTION (this);
+  ProcessEventsWithContext ();
   while (!m_events->IsEmpty ())
     {
       Scheduler::Event next = m_events->RemoveNext ();
@@ -204,6 +206,15 @@ RealtimeSimulatorImpl::ProcessOneEvent (void)
 
       {
         CriticalSection cs (m_mutex);
+        //
+        // This resets the synchronizer so that any future event will cause it
+        // to interrupt the wait below.  It must be done before looking for
+        // events pushed by other threads, which do not take m_mutex: those
+        // pushed after we looked will Signal() after this reset.
+        //
+        m_synchronizer->SetCondition (false);
+        ProcessEventsWithContext ();
+
         //
         // Since we are in realtime mode, the time to delay has got to be the
         // difference between the current realtime and the timestamp of the next
@@ -249,10 +260,9 @@ RealtimeSimulatorImpl::ProcessOneEvent (void)
         // We've figured out how long we need to delay in order to pace the
         // simulation time with the real time.  We're going to sleep, but need
         // to work with the synchronizer to make sure we're awakened if something
-        // external happens (like a packet is received).  This next line resets
-        // the synchronizer so that any future event will cause it to interrupt.
+        // external happens (like a packet is received).  This is why the
+        // synchronizer condition was reset above.
         //
-        m_synchronizer->SetCondition (false);
       }
 
       //
@@ -322,6 +332,7 @@ RealtimeSimulatorImpl::ProcessOneEvent (void)
     // event we're working on won't be on the list and so subsequent operations won't
     // mess with us.
     //
+    ProcessEventsWithContext ();
     NS_ASSERT_MSG (m_events->IsEmpty () == false,
                    "RealtimeSimulatorImpl::ProcessOneEvent(): event queue is empty");
     next = m_events->RemoveNext ();
@@ -400,7 +411,7 @@ RealtimeSimulatorImpl::IsFinished (void) const
   bool rc;
   {
     CriticalSection cs (m_mutex);
-    rc = m_events->IsEmpty () || m_stop;
+    rc = (m_events->IsEmpty () && m_eventsWithContext.IsEmpty ()) || m_stop;
   }
 
   return rc;
@@ -418,6 +429,40 @@ RealtimeSimulatorImpl::NextTs (void) const
   return ev.key.m_ts;
 }
 
+//
+// Moves the events pushed by other threads into the event list.  Should be
+// called from the main thread with critical section locked.
+//
+void
+RealtimeSimulatorImpl::ProcessEventsWithContext (void)
+{
+  EventWithContext event;
+  while (m_eventsWithContext.Pop (event))
+    {
+      uint64_t ts;
+      if (event.realtime)
+        {
+          //
+          // The realtime clock was read without the lock, possibly before
+          // the last event started; don't let time move backward.
+          //
+          ts = std::max (event.timestamp, m_currentTs);
+        }
+      else
+        {
+          ts = m_currentTs + event.timestamp;
+        }
+      Scheduler::Event ev;
+      ev.impl = event.event;
+      ev.key.m_ts = ts;
+      ev.key.m_context = event.context;
+      ev.key.m_uid = m_uid;
+      m_uid++;
+      m_unscheduledEvents++;
+      m_events->Insert (ev);
+    }
+}
+
 void
 RealtimeSimulatorImpl::Run (void)
 {
@@ -443,6 +488,7 @@ RealtimeSimulatorImpl::Run (void)
       {
         CriticalSection cs (m_mutex);
 
+        ProcessEventsWithContext ();
         if (!m_events->IsEmpty ())
           {
             process = true;
@@ -543,24 +589,32 @@ RealtimeSimulatorImpl::ScheduleWithContext (uint32_t context, Time const &delay,
 {
   NS_LOG_FUNCTION (this << context << delay << impl);
 
+  if (!SystemThread::Equals (m_main))
+    {
+      //
+      // Other threads hand the event over to the main thread without
+      // taking the lock.  If the simulator is running, we're pacing and
+      // have a meaningful realtime clock.  If we're not, the delay is
+      // added to m_currentTs, where we stopped, when the event is moved
+      // to the event list.
+      //
+      EventWithContext ev;
+      ev.context = context;
+      ev.realtime = m_running;
+      ev.timestamp = delay.GetTimeStep ();
+      if (ev.realtime)
+        {
+          ev.timestamp += m_synchronizer->GetCurrentRealtime ();
+        }
+      ev.event = impl;
+      m_eventsWithContext.Push (ev);
+      m_synchronizer->Signal ();
+      return;
+    }
+
   {
     CriticalSection cs (m_mutex);
-    uint64_t ts;
-
-    if (SystemThread::Equals (m_main))
-      {
-        ts = m_currentTs + delay.GetTimeStep ();
-      }
-    else
-      {
-        //
-        // If the simulator is running, we're pacing and have a meaningful
-        // realtime clock.  If we're not, then m_currentTs is where we stopped.
-        //
-        ts = m_running ? m_synchronizer->GetCurrentRealtime () : m_currentTs;
-        ts += delay.GetTimeStep ();
-      }
-
+    uint64_t ts = m_currentTs + delay.GetTimeStep ();
     NS_ASSERT_MSG (ts >= m_currentTs, "RealtimeSimulatorImpl::ScheduleRealtime(): schedule for time < m_currentTs");
     Scheduler::Event ev;
     ev.impl = impl;
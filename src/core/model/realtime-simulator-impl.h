@@ -30,7 +30,9 @@
 #include "assert.h"
 #include "log.h"
 #include "system-mutex.h"
+#include "mpsc-queue.h"
 
+#include <atomic>
 #include <list>
 
 /**
@@ -183,6 +185,11 @@ private:
   uint64_t NextTs (void) const;
   /** Process the next event. */
   void ProcessOneEvent (void);
+  /**
+   * Move events from a different thread into the main event queue.
+   * Must be called from the main thread, with #m_mutex locked.
+   */
+  void ProcessEventsWithContext (void);
   /** Destructor implementation. */
   virtual void DoDispose (void);
 
@@ -193,7 +200,28 @@ private:
   /** Has the stopping condition been reached? */
   bool m_stop;
   /** Is the simulator currently running. */
-  bool m_running;
+  std::atomic<bool> m_running;
+
+  /** Wrap an event scheduled from a different thread. */
+  struct EventWithContext
+  {
+    /** The event context. */
+    uint32_t context;
+    /**
+     * Flag \c true if #timestamp is absolute, taken from the realtime
+     * clock, and \c false if it is relative to #m_currentTs.
+     */
+    bool realtime;
+    /** Event timestamp. */
+    uint64_t timestamp;
+    /** The event implementation. */
+    EventImpl *event;
+  };
+  /**
+   * The events scheduled from a different thread, pushed without
+   * taking #m_mutex.
+   */
+  MpscQueue<EventWithContext> m_eventsWithContext;
 
   /**
    * \name Mutex-protected variables.
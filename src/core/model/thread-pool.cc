@@ -0,0 +1,166 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "thread-pool.h"
+#include "assert.h"
+#include "log.h"
+
+#include <algorithm>
+#include <unistd.h>
+
+/**
+ * \file
+ * \ingroup thread
+ * ns3::ThreadPool implementation.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("ThreadPool");
+
+ThreadPool::ThreadPool (uint32_t threads)
+  : m_threads (threads),
+    m_workers (0),
+    m_running (false)
+{
+  NS_LOG_FUNCTION (this << threads);
+  if (m_threads == 0)
+    {
+      m_threads = std::max (std::thread::hardware_concurrency (), 1U);
+    }
+}
+
+ThreadPool::~ThreadPool ()
+{
+  NS_LOG_FUNCTION (this);
+  if (m_workers == 0 || m_workers->pid != getpid ())
+    {
+      // the workers of the parent of a forked process are abandoned
+      return;
+    }
+  {
+    std::unique_lock<std::mutex> lock (m_workers->mutex);
+    m_workers->stop = true;
+    m_workers->start.notify_all ();
+  }
+  for (auto &thread : m_workers->threads)
+    {
+      thread.join ();
+    }
+  delete m_workers;
+}
+
+uint32_t
+ThreadPool::GetNThreads (void) const
+{
+  return m_threads;
+}
+
+ThreadPool::Workers *
+ThreadPool::GetWorkers (void)
+{
+  if (m_workers != 0 && m_workers->pid == getpid ())
+    {
+      return m_workers;
+    }
+  NS_LOG_LOGIC ("starting " << m_threads - 1 << " worker threads");
+  m_workers = new Workers ();
+  m_workers->pid = getpid ();
+  m_workers->loop = 0;
+  m_workers->busy = 0;
+  m_workers->stop = false;
+  m_workers->function = 0;
+  m_workers->n = 0;
+  m_workers->next = 0;
+  for (uint32_t i = 1; i < m_threads; ++i)
+    {
+      m_workers->threads.emplace_back (&ThreadPool::Work, m_workers);
+    }
+  return m_workers;
+}
+
+void
+ThreadPool::Run (uint32_t n, const std::function<void (uint32_t)> &function)
+{
+  NS_LOG_FUNCTION (this << n);
+  if (m_threads == 1 || n < 2 || m_running.exchange (true))
+    {
+      for (uint32_t i = 0; i < n; ++i)
+        {
+          function (i);
+        }
+      return;
+    }
+  Workers *workers = GetWorkers ();
+  {
+    std::unique_lock<std::mutex> lock (workers->mutex);
+    workers->function = &function;
+    workers->n = n;
+    workers->next = 0;
+    workers->busy = workers->threads.size ();
+    workers->loop++;
+    workers->start.notify_all ();
+  }
+  RunIndices (workers);
+  {
+    std::unique_lock<std::mutex> lock (workers->mutex);
+    while (workers->busy > 0)
+      {
+        workers->done.wait (lock);
+      }
+    workers->function = 0;
+  }
+  m_running = false;
+}
+
+void
+ThreadPool::Work (Workers *workers)
+{
+  uint64_t loop = 0;
+  std::unique_lock<std::mutex> lock (workers->mutex);
+  while (true)
+    {
+      while (!workers->stop && workers->loop == loop)
+        {
+          workers->start.wait (lock);
+        }
+      if (workers->stop)
+        {
+          return;
+        }
+      loop = workers->loop;
+      lock.unlock ();
+      RunIndices (workers);
+      lock.lock ();
+      if (--workers->busy == 0)
+        {
+          workers->done.notify_one ();
+        }
+    }
+}
+
+void
+ThreadPool::RunIndices (Workers *workers)
+{
+  uint32_t n = workers->n;
+  const std::function<void (uint32_t)> &function = *workers->function;
+  for (uint32_t i = workers->next++; i < n; i = workers->next++)
+    {
+      function (i);
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,126 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include "simple-ref-count.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <stdint.h>
+#include <sys/types.h>
+#include <thread>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup thread
+ * ns3::ThreadPool declaration.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup thread
+ * \brief A set of worker threads running the iterations of a loop.
+ *
+ * Run() calls a function for each index of a range, from the worker
+ * threads and from the calling thread, and returns when all the calls
+ * are done.  The indices are handed out one by one, so the calls may
+ * happen in any order: the function must only write data private to
+ * its index.  Since the reference counts of ns-3 objects are not
+ * atomic (unless ns-3 is built with NS3_MTP), the function should not
+ * copy nor release the Ptr of an object shared with the other indices.
+ *
+ * The worker threads wait for the next Run() on a condition variable,
+ * so an idle pool does not use the processor.  Run() may be called from
+ * several threads: the calls which find the pool busy run all their
+ * indices in the calling thread.  After a fork (e.g.,
+ * Checkpoint::Fork), the child process starts its own worker threads.
+ */
+class ThreadPool : public SimpleRefCount<ThreadPool>
+{
+public:
+  /**
+   * Create a pool.
+   *
+   * \param [in] threads The number of threads running the loops,
+   *             including the thread calling Run(), or 0 for the
+   *             number of hardware threads.
+   */
+  ThreadPool (uint32_t threads);
+  ~ThreadPool ();
+
+  /** \returns The number of threads running the loops, including the caller. */
+  uint32_t GetNThreads (void) const;
+
+  /**
+   * Call a function for each index in [0, n).
+   *
+   * \param [in] n The number of indices.
+   * \param [in] function The function to call.
+   */
+  void Run (uint32_t n, const std::function<void (uint32_t)> &function);
+
+private:
+  /**
+   * The worker threads of a process, and their synchronization.
+   *
+   * The threads do not survive a fork: the child abandons the workers
+   * of its parent, whose mutex and condition variables may be in any
+   * state, and starts new ones.
+   */
+  struct Workers
+  {
+    std::vector<std::thread> threads;         //!< The worker threads.
+    pid_t pid;                                //!< The process running the threads.
+    std::mutex mutex;                         //!< Protects the fields below.
+    std::condition_variable start;            //!< Signals a new loop, or the end of the pool.
+    std::condition_variable done;             //!< Signals the end of the work of a worker.
+    uint64_t loop;                            //!< Number of the current loop.
+    uint32_t busy;                            //!< Number of workers running the current loop.
+    bool stop;                                //!< Whether the workers must exit.
+    const std::function<void (uint32_t)> *function; //!< The function of the current loop.
+    uint32_t n;                               //!< Number of indices of the current loop.
+    std::atomic<uint32_t> next;               //!< The next index to run.
+  };
+
+  /**
+   * \returns The worker threads of this process, started if needed.
+   */
+  Workers *GetWorkers (void);
+  /**
+   * Wait for and run the loops, until the pool is destroyed.
+   * \param [in] workers The worker threads.
+   */
+  static void Work (Workers *workers);
+  /**
+   * Run the remaining indices of the current loop.
+   * \param [in] workers The worker threads.
+   */
+  static void RunIndices (Workers *workers);
+
+  uint32_t m_threads;   //!< Number of threads, including the caller.
+  Workers *m_workers;   //!< The worker threads, or 0 if not started.
+  std::atomic<bool> m_running; //!< Whether a loop runs on the pool.
+};
+
+} // namespace ns3
+
+#endif /* THREAD_POOL_H */
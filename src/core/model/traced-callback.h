@@ -21,8 +21,10 @@
 #ifndef TRACED_CALLBACK_H
 #define TRACED_CALLBACK_H
 
-#include <list>
+#include <vector>
 #include "callback.h"
+#include "ptr.h"
+#include "simple-ref-count.h"
 
 /**
  * \file
@@ -46,6 +48,22 @@ namespace ns3 {
  * calling the \c operator() form with the appropriate
  * number of arguments.
  *
+ * Most trace sources are not connected.  Firing one then only tests
+ * a pointer; call sites which have to build the arguments can skip
+ * that work with IsEmpty():
+ * \code
+ *   if (!m_txTrace.IsEmpty ())
+ *     {
+ *       m_txTrace (packet->Copy ());
+ *     }
+ * \endcode
+ *
+ * The Callbacks are stored contiguously.  The chain is shared with
+ * the calls in progress, and copied if it is modified during a call,
+ * so a Callback can connect or disconnect Callbacks to the
+ * TracedCallback calling it: the change takes effect at the next
+ * call.
+ *
  * \tparam Ts \explicit Types of the functor arguments.
  */
 template<typename... Ts>
@@ -94,6 +112,8 @@ public:
    * \return true if the Callbacks list is empty.
    */
   bool IsEmpty () const;
+  /** \return The number of Callbacks in the chain. */
+  std::size_t GetSize () const;
 
   /**
    *  TracedCallback signature for POD.
@@ -112,9 +132,21 @@ private:
    *
    * \tparam Ts \deduced Types of the functor arguments.
    */
-  typedef std::list<Callback<void,Ts...> > CallbackList;
-  /** The chain of Callbacks. */
-  CallbackList m_callbackList;
+  typedef std::vector<Callback<void,Ts...> > CallbackList;
+  /** A chain of Callbacks, shared with the calls in progress. */
+  struct CallbackChain : public SimpleRefCount<CallbackChain>
+  {
+    CallbackList callbacks;             //!< The Callbacks.
+  };
+  /**
+   * \return The chain of Callbacks, ready to be modified: a copy if it
+   *         is shared with a call in progress.
+   */
+  CallbackList & GetListForWrite ();
+  /** Forget the chain of Callbacks if it is empty. */
+  void Trim ();
+  /** The chain of Callbacks, or null if there are none. */
+  Ptr<CallbackChain> m_chain;
 };
 
 } // namespace ns3
@@ -128,9 +160,34 @@ namespace ns3 {
 
 template<typename... Ts>
 TracedCallback<Ts...>::TracedCallback ()
-  : m_callbackList ()
+  : m_chain ()
 {}
 template<typename... Ts>
+typename TracedCallback<Ts...>::CallbackList &
+TracedCallback<Ts...>::GetListForWrite ()
+{
+  if (m_chain == 0)
+    {
+      m_chain = Create<CallbackChain> ();
+    }
+  else if (m_chain->GetReferenceCount () > 1)
+    {
+      Ptr<CallbackChain> chain = Create<CallbackChain> ();
+      chain->callbacks = m_chain->callbacks;
+      m_chain = chain;
+    }
+  return m_chain->callbacks;
+}
+template<typename... Ts>
+void
+TracedCallback<Ts...>::Trim ()
+{
+  if (m_chain != 0 && m_chain->callbacks.empty ())
+    {
+      m_chain = 0;
+    }
+}
+template<typename... Ts>
 void
 TracedCallback<Ts...>::ConnectWithoutContext (const CallbackBase & callback)
 {
@@ -139,7 +196,7 @@ TracedCallback<Ts...>::ConnectWithoutContext (const CallbackBase & callback)
     {
       NS_FATAL_ERROR_NO_MSG ();
     }
-  m_callbackList.push_back (cb);
+  GetListForWrite ().push_back (cb);
 }
 template<typename... Ts>
 void
@@ -151,24 +208,30 @@ TracedCallback<Ts...>::Connect (const CallbackBase & callback, std::string path)
       NS_FATAL_ERROR ("when connecting to " << path);
     }
   Callback<void,Ts...> realCb = cb.Bind (path);
-  m_callbackList.push_back (realCb);
+  GetListForWrite ().push_back (realCb);
 }
 template<typename... Ts>
 void
 TracedCallback<Ts...>::DisconnectWithoutContext (const CallbackBase & callback)
 {
-  for (typename CallbackList::iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); /* empty */)
+  if (m_chain == 0)
+    {
+      return;
+    }
+  CallbackList &callbacks = GetListForWrite ();
+  for (typename CallbackList::iterator i = callbacks.begin ();
+       i != callbacks.end (); /* empty */)
     {
       if ((*i).IsEqual (callback))
         {
-          i = m_callbackList.erase (i);
+          i = callbacks.erase (i);
         }
       else
         {
           i++;
         }
     }
+  Trim ();
 }
 template<typename... Ts>
 void
@@ -186,8 +249,14 @@ template<typename... Ts>
 void
 TracedCallback<Ts...>::operator() (Ts... args) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  if (m_chain == 0)
+    {
+      return;
+    }
+  // Keep the chain alive, and unchanged, while the Callbacks run.
+  Ptr<const CallbackChain> chain = m_chain;
+  for (typename CallbackList::const_iterator i = chain->callbacks.begin ();
+       i != chain->callbacks.end (); i++)
     {
       (*i)(args...);
     }
@@ -197,7 +266,14 @@ template <typename... Ts>
 bool
 TracedCallback<Ts...>::IsEmpty () const
 {
-  return m_callbackList.empty ();
+  return m_chain == 0;
+}
+
+template <typename... Ts>
+std::size_t
+TracedCallback<Ts...>::GetSize () const
+{
+  return m_chain == 0 ? 0 : m_chain->callbacks.size ();
 }
 
 } // namespace ns3
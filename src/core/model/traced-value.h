@@ -211,6 +211,15 @@ public:
   {
     m_cb.Disconnect (cb, path);
   }
+  /**
+   * Check if a Callback is connected.
+   *
+   * \returns \c true if no Callback is connected.
+   */
+  bool IsEmpty (void) const
+  {
+    return m_cb.IsEmpty ();
+  }
   /**
    * Set the value of the underlying variable.
    *
@@ -221,7 +230,10 @@ public:
   {
     if (m_v != v)
       {
-        m_cb (m_v, v);
+        if (!m_cb.IsEmpty ())
+          {
+            m_cb (m_v, v);
+          }
         m_v = v;
       }
   }
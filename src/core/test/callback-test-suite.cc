@@ -18,7 +18,9 @@
 
 #include "ns3/test.h"
 #include "ns3/callback.h"
+#include "ns3/simple-ref-count.h"
 #include <stdint.h>
+#include <string>
 
 using namespace ns3;
 
@@ -918,6 +920,111 @@ MakeCallbackTemplatesTestCase::DoRun (void)
   that.CheckParentalRights ();
 }
 
+/**
+ * \ingroup callback-tests
+ *
+ * Check the copies of Callbacks stored inline and on the heap.
+ */
+class CallbackStorageTestCase : public TestCase
+{
+public:
+  CallbackStorageTestCase ();
+  virtual ~CallbackStorageTestCase ()
+  {}
+
+  /** Reference counted callback target. */
+  class Target : public SimpleRefCount<Target>
+  {
+  public:
+    /**
+     * Add to the sum.
+     * \param [in] a The value to add.
+     */
+    void Add (int a)
+    {
+      sum += a;
+    }
+    int sum = 0; //!< The sum of the values added.
+  };
+
+  /**
+   * Bound callback target.
+   * \param [in] a The first string.
+   * \param [in] b The second string.
+   * \param [in] c The third string.
+   * \param [in] d The fourth string.
+   * \returns The concatenated strings.
+   */
+  static std::string Concatenate (std::string a, std::string b, std::string c, std::string d)
+  {
+    return a + b + c + d;
+  }
+
+private:
+  virtual void DoRun (void);
+};
+
+CallbackStorageTestCase::CallbackStorageTestCase ()
+  : TestCase ("Check the copies of Callbacks stored inline and on the heap")
+{}
+
+void
+CallbackStorageTestCase::DoRun (void)
+{
+  Ptr<Target> target = Create<Target> ();
+  NS_TEST_ASSERT_MSG_EQ (target->GetReferenceCount (), 1, "Wrong initial reference count");
+
+  // An object and a member function pointer are stored inline.
+  Callback<void, int> a = MakeCallback (&Target::Add, target);
+  NS_TEST_EXPECT_MSG_EQ (target->GetReferenceCount (), 2, "Callback does not hold the target");
+  Callback<void, int> b = a;
+  NS_TEST_EXPECT_MSG_NE (a.PeekImpl (), b.PeekImpl (), "Inline implementation is shared");
+  NS_TEST_EXPECT_MSG_EQ (target->GetReferenceCount (), 3, "Copy does not hold the target");
+  NS_TEST_EXPECT_MSG_EQ (a.IsEqual (b), true, "Copy is not equal");
+  a.Nullify ();
+  NS_TEST_EXPECT_MSG_EQ (target->GetReferenceCount (), 2, "Nullify did not release the target");
+  b (3);
+  NS_TEST_EXPECT_MSG_EQ (target->sum, 3, "Copy did not fire");
+  a = b;
+  a (4);
+  NS_TEST_EXPECT_MSG_EQ (target->sum, 7, "Assigned Callback did not fire");
+
+  // Adopt an inline implementation through a CallbackBase.
+  CallbackBase base = a;
+  Callback<void, int> c;
+  NS_TEST_EXPECT_MSG_EQ (c.CheckType (base), true, "Wrong type check");
+  NS_TEST_EXPECT_MSG_EQ (c.Assign (base), true, "Assign failed");
+  NS_TEST_EXPECT_MSG_EQ (c.IsEqual (a), true, "Assigned Callback is not equal");
+  c (5);
+  NS_TEST_EXPECT_MSG_EQ (target->sum, 12, "Assigned Callback did not fire");
+
+  // GetImpl() of an inline implementation is a heap copy.
+  typedef CallbackImpl<void, int, empty, empty, empty, empty, empty, empty, empty, empty> Impl;
+  Callback<void, int> d (DynamicCast<Impl> (a.GetImpl ()));
+  NS_TEST_EXPECT_MSG_EQ (d.IsEqual (a), true, "Heap copy is not equal");
+  NS_TEST_EXPECT_MSG_EQ (a.IsEqual (d), true, "Heap copy is not equal");
+  d (6);
+  NS_TEST_EXPECT_MSG_EQ (target->sum, 18, "Heap copy did not fire");
+
+  a.Nullify ();
+  b.Nullify ();
+  c.Nullify ();
+  base = CallbackBase ();
+  NS_TEST_EXPECT_MSG_EQ (target->GetReferenceCount (), 2, "Callbacks leak the target");
+  d.Nullify ();
+  NS_TEST_EXPECT_MSG_EQ (target->GetReferenceCount (), 1, "Callbacks leak the target");
+
+  // Too many bound arguments to fit inline: the copies share the heap
+  // implementation.
+  Callback<std::string, std::string> e =
+    MakeBoundCallback (&CallbackStorageTestCase::Concatenate,
+                       std::string ("a"), std::string ("b"), std::string ("c"));
+  Callback<std::string, std::string> f = e;
+  NS_TEST_EXPECT_MSG_EQ (e.PeekImpl (), f.PeekImpl (), "Heap implementation is not shared");
+  NS_TEST_EXPECT_MSG_EQ (f ("d"), "abcd", "Bound Callback did not fire");
+  NS_TEST_EXPECT_MSG_EQ (e.IsEqual (f), true, "Copy is not equal");
+}
+
 /**
  * \ingroup callback-tests
  *  
@@ -937,6 +1044,7 @@ CallbackTestSuite::CallbackTestSuite ()
   AddTestCase (new MakeBoundCallbackTestCase, TestCase::QUICK);
   AddTestCase (new NullifyCallbackTestCase, TestCase::QUICK);
   AddTestCase (new MakeCallbackTemplatesTestCase, TestCase::QUICK);
+  AddTestCase (new CallbackStorageTestCase, TestCase::QUICK);
 }
 
 static CallbackTestSuite g_gallbackTestSuite; //!< Static variable for test initialization
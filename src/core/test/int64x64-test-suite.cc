@@ -25,6 +25,7 @@
 #include <cmath>    // fabs, round
 #include <iomanip>
 #include <limits>   // numeric_limits<>::epsilon ()
+#include <random>
 
 using namespace ns3;
 
@@ -1531,6 +1532,94 @@ Int64x64DoubleTestCase::DoRun (void)
 }
 
 
+/**
+ * \ingroup int64x64-tests
+ *
+ * Test: the double conversions give the same results as the long double
+ * conversions.
+ */
+class Int64x64ExactDoubleTestCase : public TestCase
+{
+public:
+  Int64x64ExactDoubleTestCase ();
+  virtual void DoRun (void);
+
+  /**
+   * Check the conversions of a value.
+   * \param value The value.
+   */
+  void Check (const double value);
+};
+
+Int64x64ExactDoubleTestCase::Int64x64ExactDoubleTestCase ()
+  : TestCase ("Conversions from and to double match long double")
+{}
+
+void
+Int64x64ExactDoubleTestCase::Check (const double value)
+{
+  const int64x64_t fromDouble (value);
+  const int64x64_t fromLongDouble ((long double)value);
+  NS_TEST_ASSERT_MSG_EQ (fromDouble.GetHigh (), fromLongDouble.GetHigh (),
+                         "Wrong integer part for " << std::hexfloat << value);
+  NS_TEST_ASSERT_MSG_EQ (fromDouble.GetLow (), fromLongDouble.GetLow (),
+                         "Wrong fraction for " << std::hexfloat << value);
+
+  // GetDouble of a value made of the double bits, and of all the bits
+  // below the 53 significant ones.
+  const int64x64_t values[] = {fromDouble, int64x64_t (fromDouble.GetHigh (), ~fromDouble.GetLow ())};
+  for (const int64x64_t &v : values)
+    {
+      const bool negative = v < 0;
+      const int64x64_t magnitude = negative ? -v : v;
+      long double expected = static_cast<uint64_t> (magnitude.GetHigh ());
+      expected += magnitude.GetLow () / std::pow (2.0L, 64);
+      const double expectedDouble = negative ? -expected : expected;
+      NS_TEST_ASSERT_MSG_EQ (v.GetDouble (), expectedDouble,
+                             "Wrong double for " << v);
+    }
+}
+
+void
+Int64x64ExactDoubleTestCase::DoRun (void)
+{
+  std::cout << std::endl;
+  std::cout << GetParent ()->GetName () << " Exact double: " << GetName ()
+            << std::endl;
+
+  if (int64x64_t::implementation != int64x64_t::int128_impl
+      || std::numeric_limits<long double>::digits != 64)
+    {
+      std::cout << "skipped: no 64 bit mantissa long double" << std::endl;
+      return;
+    }
+
+  const double edges[] = {
+    0, 0.5, 1, 1.5, 2.5, 1e-9, 1e-6, 1e-3, 0.1, 1.0 / 3, 123.456,
+    std::ldexp (1.0, -64), std::ldexp (1.0, -65), std::ldexp (3.0, -66),
+    std::ldexp (1.0, -70), 0.5 - std::ldexp (1.0, -54),
+    1 - std::ldexp (1.0, -53), std::ldexp (1.0, 52) - 0.5,
+    std::ldexp (1.0, 52), std::ldexp (1.0, 53) + 2, std::ldexp (1.0, 62) + 1024,
+    std::ldexp (1.0, 63) - 1024
+  };
+  for (const double edge : edges)
+    {
+      Check (edge);
+      Check (-edge);
+    }
+
+  // Random mantissas, with exponents in the range of the type.
+  std::mt19937_64 rng (1);
+  for (uint32_t i = 0; i < 100000; ++i)
+    {
+      const double mantissa = std::ldexp (static_cast<double> (rng () >> 11), -53);
+      const int exponent = static_cast<int> (rng () % 138) - 75;
+      Check (std::ldexp (mantissa, exponent));
+      Check (-std::ldexp (mantissa, exponent));
+    }
+}
+
+
 /**
  * \ingroup int64x64-tests
  * 
@@ -1618,6 +1707,7 @@ public:
     AddTestCase (new Int64x64Bug1786TestCase (), TestCase::QUICK);
     AddTestCase (new Int64x64InvertTestCase (), TestCase::QUICK);
     AddTestCase (new Int64x64DoubleTestCase (), TestCase::QUICK);
+    AddTestCase (new Int64x64ExactDoubleTestCase (), TestCase::QUICK);
   }
 };
 
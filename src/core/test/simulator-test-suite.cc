@@ -19,11 +19,28 @@
  */
 #include "ns3/test.h"
 #include "ns3/simulator.h"
+#include "ns3/event-impl.h"
 #include "ns3/list-scheduler.h"
 #include "ns3/heap-scheduler.h"
 #include "ns3/map-scheduler.h"
 #include "ns3/calendar-scheduler.h"
+#include "ns3/compact-heap-scheduler.h"
+#include "ns3/ladder-scheduler.h"
 #include "ns3/priority-queue-scheduler.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/default-simulator-impl.h"
+#include "ns3/event-profiler.h"
+#include "ns3/checkpoint.h"
+#include "ns3/rng-seed-manager.h"
+#include "ns3/config.h"
+#include "ns3/boolean.h"
+#include "ns3/string.h"
+
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+#include <unistd.h>
 
 using namespace ns3;
 
@@ -531,6 +548,381 @@ SimulatorTemplateTestCase::DoRun (void)
 }
 
 
+/**
+ * \ingroup simulator-tests
+ *
+ * \brief Check the event order with bursts of simultaneous events
+ * mixed with a long tail of far-future events.
+ */
+class SimulatorSkewedEventsTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor.
+   * \param schedulerFactory Scheduler factory.
+   */
+  SimulatorSkewedEventsTestCase (ObjectFactory schedulerFactory);
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Test Event.
+   * \param seq The scheduling sequence number of the event.
+   */
+  void Event (uint32_t seq);
+
+  uint64_t m_lastTs;              //!< Time stamp of the last executed event.
+  uint32_t m_lastSeq;             //!< Sequence number of the last executed event.
+  uint32_t m_executed;            //!< Number of executed events.
+  bool m_ordered;                 //!< All events were executed in order.
+  ObjectFactory m_schedulerFactory; //!< Scheduler factory.
+};
+
+SimulatorSkewedEventsTestCase::SimulatorSkewedEventsTestCase (ObjectFactory schedulerFactory)
+  : TestCase ("Check the event order with a skewed time stamp distribution with " +
+              schedulerFactory.GetTypeId ().GetName ()),
+    m_schedulerFactory (schedulerFactory)
+{}
+
+void
+SimulatorSkewedEventsTestCase::Event (uint32_t seq)
+{
+  uint64_t ts = Simulator::Now ().GetTimeStep ();
+  if (ts < m_lastTs || (ts == m_lastTs && m_executed > 0 && seq <= m_lastSeq))
+    {
+      m_ordered = false;
+    }
+  m_lastTs = ts;
+  m_lastSeq = seq;
+  m_executed++;
+}
+
+void
+SimulatorSkewedEventsTestCase::DoRun (void)
+{
+  m_lastTs = 0;
+  m_lastSeq = 0;
+  m_executed = 0;
+  m_ordered = true;
+
+  Simulator::SetScheduler (m_schedulerFactory);
+
+  Ptr<UniformRandomVariable> uniform = CreateObject<UniformRandomVariable> ();
+  uniform->SetStream (1);
+  const uint32_t nEvents = 20000;
+  std::vector<EventId> ids;
+  ids.reserve (nEvents);
+  for (uint32_t seq = 0; seq < nEvents; ++seq)
+    {
+      Time delay;
+      double draw = uniform->GetValue ();
+      if (draw < 0.5)
+        {
+          // Bursts at a few subframe boundaries.
+          delay = MilliSeconds (uniform->GetInteger (1, 4));
+        }
+      else if (draw < 0.9)
+        {
+          delay = NanoSeconds (uniform->GetInteger (0, 10000000));
+        }
+      else
+        {
+          // Long tail of far-future timers.
+          delay = Seconds (uniform->GetValue (1, 1000));
+        }
+      ids.push_back (Simulator::Schedule (delay, &SimulatorSkewedEventsTestCase::Event,
+                                          this, seq));
+    }
+  uint32_t removed = 0;
+  for (uint32_t seq = 0; seq < nEvents; seq += 7)
+    {
+      Simulator::Remove (ids[seq]);
+      removed++;
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  NS_TEST_EXPECT_MSG_EQ (m_executed, nEvents - removed, "Wrong number of events executed");
+  NS_TEST_EXPECT_MSG_EQ (m_ordered, true, "Events were not executed in order");
+}
+
+/**
+ * \ingroup simulator-tests
+ *
+ * \brief Check that the storage of executed events is recycled.
+ */
+class SimulatorEventRecyclingTestCase : public TestCase
+{
+public:
+  SimulatorEventRecyclingTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Reschedule itself until \pname{remaining} reaches zero.
+   * \param remaining Number of events left to schedule.
+   */
+  void Reschedule (uint32_t remaining);
+  uint32_t m_executed; //!< Number of executed events.
+};
+
+SimulatorEventRecyclingTestCase::SimulatorEventRecyclingTestCase ()
+  : TestCase ("Check that the storage of executed events is recycled"),
+    m_executed (0)
+{}
+
+void
+SimulatorEventRecyclingTestCase::Reschedule (uint32_t remaining)
+{
+  m_executed++;
+  if (remaining > 0)
+    {
+      Simulator::Schedule (MicroSeconds (1), &SimulatorEventRecyclingTestCase::Reschedule,
+                           this, remaining - 1);
+    }
+}
+
+void
+SimulatorEventRecyclingTestCase::DoRun (void)
+{
+  const uint32_t events = 1000;
+  // Make sure the simulator itself is created before taking the reference.
+  Simulator::Now ();
+  EventImpl::PoolStats before = EventImpl::GetPoolStats ();
+  Simulator::Schedule (MicroSeconds (1), &SimulatorEventRecyclingTestCase::Reschedule,
+                       this, events - 1);
+  Simulator::Run ();
+  EventImpl::PoolStats after = EventImpl::GetPoolStats ();
+  Simulator::Destroy ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_executed, events, "Not all events were executed");
+  // Each event is scheduled while its predecessor is still running,
+  // so at most two blocks are live at any time.
+  NS_TEST_EXPECT_MSG_LT_OR_EQ (after.allocated - before.allocated, 2u,
+                               "Event storage was not recycled");
+  NS_TEST_EXPECT_MSG_GT_OR_EQ (after.recycled - before.recycled, events - 2,
+                               "Event storage was not recycled");
+}
+
+/**
+ * \ingroup simulator-tests
+ *
+ * \brief Check the event profiler.
+ */
+class SimulatorEventProfilingTestCase : public TestCase
+{
+public:
+  SimulatorEventProfilingTestCase ();
+
+private:
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+  /** Event without argument. */
+  void Short (void);
+  /**
+   * Event with an argument.
+   * \param n An argument.
+   */
+  void Long (uint32_t n);
+};
+
+SimulatorEventProfilingTestCase::SimulatorEventProfilingTestCase ()
+  : TestCase ("Check the event profiler")
+{}
+
+void
+SimulatorEventProfilingTestCase::Short (void)
+{}
+
+void
+SimulatorEventProfilingTestCase::Long (uint32_t n)
+{
+  // Spin for a measurable time.
+  volatile uint32_t sum = 0;
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      sum += i;
+    }
+}
+
+void
+SimulatorEventProfilingTestCase::DoRun (void)
+{
+  // Stats
+  EventProfiler::Stats stats;
+  stats.Add (0);
+  stats.Add (100);
+  stats.Add (3000);
+  NS_TEST_EXPECT_MSG_EQ (stats.count, 3, "Wrong count");
+  NS_TEST_EXPECT_MSG_EQ (stats.total, 3100, "Wrong total");
+  NS_TEST_EXPECT_MSG_EQ (stats.max, 3000, "Wrong max");
+  NS_TEST_EXPECT_MSG_EQ (stats.GetPercentile (50), 128, "Wrong median");
+  NS_TEST_EXPECT_MSG_EQ (stats.GetPercentile (99), 3000, "Wrong 99th percentile");
+
+  // Profiling through the attributes
+  std::string file = CreateTempDirFilename ("event-profile.txt");
+  Config::SetDefault ("ns3::DefaultSimulatorImpl::EventProfiling", BooleanValue (true));
+  Config::SetDefault ("ns3::DefaultSimulatorImpl::EventProfilingFile", StringValue (file));
+  for (uint32_t i = 0; i < 10; ++i)
+    {
+      Simulator::Schedule (MicroSeconds (i), &SimulatorEventProfilingTestCase::Short, this);
+      Simulator::ScheduleWithContext (7, MicroSeconds (i), &SimulatorEventProfilingTestCase::Long,
+                                      this, 100000);
+    }
+  Simulator::Run ();
+
+  Ptr<DefaultSimulatorImpl> impl = DynamicCast<DefaultSimulatorImpl> (Simulator::GetImplementation ());
+  NS_TEST_ASSERT_MSG_NE (impl, 0, "Not the default simulator");
+  const EventProfiler &profiler = impl->GetEventProfiler ();
+  NS_TEST_EXPECT_MSG_EQ (profiler.GetTotal ().count, 20, "Wrong total event count");
+
+  std::vector<std::pair<std::string, EventProfiler::Stats> > byType = profiler.GetByType ();
+  NS_TEST_ASSERT_MSG_EQ (byType.size (), 2, "Wrong number of event types");
+  // The longer events come first.
+  NS_TEST_EXPECT_MSG_EQ (byType[0].first, "void (SimulatorEventProfilingTestCase::*)(unsigned int)",
+                         "Wrong event type label");
+  NS_TEST_EXPECT_MSG_EQ (byType[0].second.count, 10, "Wrong event count");
+  NS_TEST_EXPECT_MSG_EQ (byType[1].first, "void (SimulatorEventProfilingTestCase::*)()",
+                         "Wrong event type label");
+  NS_TEST_EXPECT_MSG_EQ (byType[1].second.count, 10, "Wrong event count");
+
+  std::vector<std::pair<uint32_t, EventProfiler::Stats> > byContext = profiler.GetByContext ();
+  NS_TEST_ASSERT_MSG_EQ (byContext.size (), 2, "Wrong number of contexts");
+  NS_TEST_EXPECT_MSG_EQ (byContext[0].first, 7, "Wrong context order");
+  NS_TEST_EXPECT_MSG_EQ (byContext[1].first, Simulator::NO_CONTEXT, "Wrong context order");
+
+  Simulator::Destroy ();
+
+  std::ifstream report (file.c_str ());
+  NS_TEST_ASSERT_MSG_EQ (report.is_open (), true, "No report written");
+  std::ostringstream contents;
+  contents << report.rdbuf ();
+  NS_TEST_EXPECT_MSG_NE (contents.str ().find ("# Event profile: 20 events"), std::string::npos,
+                         "Wrong report header");
+  NS_TEST_EXPECT_MSG_NE (contents.str ().find ("\tnone\n"), std::string::npos,
+                         "No report line for the events without context");
+}
+
+void
+SimulatorEventProfilingTestCase::DoTeardown (void)
+{
+  Config::SetDefault ("ns3::DefaultSimulatorImpl::EventProfiling", BooleanValue (false));
+  Config::SetDefault ("ns3::DefaultSimulatorImpl::EventProfilingFile", StringValue (""));
+}
+
+/**
+ * \ingroup simulator-tests
+ *
+ * \brief Check that forked branches continue the simulation.
+ */
+class SimulatorCheckpointTestCase : public TestCase
+{
+public:
+  SimulatorCheckpointTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Configure a branch; the branch 2 uses another run number.
+   * \param branch The branch index.
+   */
+  void Configure (uint32_t branch);
+  /** Draw a value, and write it to the file of the branch. */
+  void Record (void);
+  /**
+   * Get the file name of a branch.
+   * \param branch The branch index.
+   * \returns The file name.
+   */
+  std::string GetFilename (uint32_t branch);
+
+  Ptr<UniformRandomVariable> m_random; //!< The random variable.
+  uint32_t m_configured;               //!< The configured branch.
+  uint64_t m_run;                      //!< The run number of the branch 2.
+};
+
+SimulatorCheckpointTestCase::SimulatorCheckpointTestCase ()
+  : TestCase ("Check that forked branches continue the simulation")
+{}
+
+void
+SimulatorCheckpointTestCase::Configure (uint32_t branch)
+{
+  m_configured = branch;
+  if (branch == 2)
+    {
+      RngSeedManager::SetRun (m_run);
+      RandomVariableStream::RestartAll ();
+    }
+}
+
+std::string
+SimulatorCheckpointTestCase::GetFilename (uint32_t branch)
+{
+  std::ostringstream oss;
+  oss << "checkpoint-" << branch << ".txt";
+  return CreateTempDirFilename (oss.str ());
+}
+
+void
+SimulatorCheckpointTestCase::Record (void)
+{
+  uint32_t branch = Checkpoint::GetBranch ();
+  double value = m_random->GetValue ();
+  {
+    std::ofstream file (GetFilename (branch).c_str ());
+    file.precision (17);
+    file << m_configured << " " << Simulator::Now ().GetSeconds () << " " << value << std::endl;
+  }
+  if (branch != 0)
+    {
+      // Leave before the branch returns into the test framework.
+      _exit (0);
+    }
+}
+
+void
+SimulatorCheckpointTestCase::DoRun (void)
+{
+  uint64_t run = RngSeedManager::GetRun ();
+  m_run = run + 10;
+  m_configured = 100;
+  m_random = CreateObject<UniformRandomVariable> ();
+  m_random->SetStream (5);
+  m_random->GetValue ();
+
+  Simulator::Schedule (Seconds (1), &Checkpoint::Fork, 3,
+                       MakeCallback (&SimulatorCheckpointTestCase::Configure, this));
+  Simulator::Schedule (Seconds (2), &SimulatorCheckpointTestCase::Record, this);
+  Simulator::Run ();
+  // Wait for the other branches.
+  Simulator::Destroy ();
+  NS_TEST_EXPECT_MSG_EQ (Checkpoint::GetBranch (), 0, "Wrong branch index");
+
+  // The value the branch 2 draws first from its restarted stream.
+  RngSeedManager::SetRun (m_run);
+  Ptr<UniformRandomVariable> restarted = CreateObject<UniformRandomVariable> ();
+  restarted->SetStream (5);
+  double restartedValue = restarted->GetValue ();
+  RngSeedManager::SetRun (run);
+
+  double values[3];
+  for (uint32_t branch = 0; branch < 3; ++branch)
+    {
+      std::ifstream file (GetFilename (branch).c_str ());
+      NS_TEST_ASSERT_MSG_EQ (file.is_open (), true, "No output from branch " << branch);
+      uint32_t configured = 100;
+      double now = 0;
+      file >> configured >> now >> values[branch];
+      NS_TEST_EXPECT_MSG_EQ (configured, branch, "Branch not configured");
+      NS_TEST_EXPECT_MSG_EQ (now, 2, "Wrong time in branch " << branch);
+    }
+  NS_TEST_EXPECT_MSG_EQ (values[1], values[0], "Branches should share the random numbers");
+  NS_TEST_EXPECT_MSG_NE (values[2], values[0], "Restarted stream should not be shared");
+  NS_TEST_EXPECT_MSG_EQ (values[2], restartedValue, "Stream not restarted");
+  m_random = 0;
+}
+
 /**
  * \ingroup simulator-tests
  *  
@@ -554,6 +946,27 @@ public:
     AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
     factory.SetTypeId (PriorityQueueScheduler::GetTypeId ());
     AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (LadderScheduler::GetTypeId ());
+    AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (CompactHeapScheduler::GetTypeId ());
+    AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
+    AddTestCase (new SimulatorEventRecyclingTestCase (), TestCase::QUICK);
+    AddTestCase (new SimulatorEventProfilingTestCase (), TestCase::QUICK);
+    AddTestCase (new SimulatorCheckpointTestCase (), TestCase::QUICK);
+
+    std::string schedulerTypes[] = {
+      "ns3::MapScheduler",
+      "ns3::HeapScheduler",
+      "ns3::CalendarScheduler",
+      "ns3::PriorityQueueScheduler",
+      "ns3::LadderScheduler",
+      "ns3::CompactHeapScheduler"
+    };
+    for (const std::string &schedulerType : schedulerTypes)
+      {
+        factory.SetTypeId (schedulerType);
+        AddTestCase (new SimulatorSkewedEventsTestCase (factory), TestCase::QUICK);
+      }
   }
 };
 
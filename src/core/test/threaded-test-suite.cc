@@ -26,12 +26,15 @@
 #include "ns3/config.h"
 #include "ns3/string.h"
 #include "ns3/system-thread.h"
+#include "ns3/mpsc-queue.h"
+#include "ns3/thread-pool.h"
 
 #include <chrono>  // seconds, milliseconds
 #include <ctime>
 #include <list>
 #include <thread>  // sleep_for
 #include <utility>
+#include <vector>
 
 using namespace ns3;
 
@@ -276,6 +279,173 @@ ThreadedSimulatorEventsTestCase::DoRun (void)
   NS_TEST_EXPECT_MSG_EQ (m_a, m_d, "Bad scheduling");
 }
 
+/**
+ * \ingroup threaded-tests
+ *
+ * \brief Check that MpscQueue preserves the order of each producer.
+ */
+class MpscQueueTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor.
+   *
+   * \param threads The number of producer threads.
+   * \param capacity The queue ring capacity.
+   */
+  MpscQueueTestCase (unsigned int threads, uint32_t capacity);
+
+  /** A queue item. */
+  struct Item
+  {
+    unsigned int producer;  //!< The producer thread number.
+    uint32_t seq;           //!< The producer sequence number.
+  };
+
+  /**
+   * Push items to the queue.
+   * \param context The test case and the producer thread number.
+   */
+  static void ProducingThread (std::pair<MpscQueueTestCase *, unsigned int> context);
+
+private:
+  virtual void DoRun (void);
+
+  unsigned int m_threads;   //!< The number of producer threads.
+  uint32_t m_capacity;      //!< The queue ring capacity.
+  MpscQueue<Item> *m_queue; //!< The queue under test.
+  /** Number of items pushed by each producer. */
+  static const uint32_t ITEMS = 20000;
+};
+
+MpscQueueTestCase::MpscQueueTestCase (unsigned int threads, uint32_t capacity)
+  : TestCase ("Check MpscQueue ordering with " + std::to_string (threads) +
+              " producers and a ring of " + std::to_string (capacity) + " items"),
+    m_threads (threads),
+    m_capacity (capacity),
+    m_queue (0)
+{}
+
+void
+MpscQueueTestCase::ProducingThread (std::pair<MpscQueueTestCase *, unsigned int> context)
+{
+  MpscQueueTestCase *me = context.first;
+  Item item;
+  item.producer = context.second;
+  for (item.seq = 0; item.seq < ITEMS; ++item.seq)
+    {
+      me->m_queue->Push (item);
+    }
+}
+
+void
+MpscQueueTestCase::DoRun (void)
+{
+  MpscQueue<Item> queue (m_capacity);
+  m_queue = &queue;
+  std::vector<Ptr<SystemThread> > threads;
+  for (unsigned int i = 0; i < m_threads; ++i)
+    {
+      threads.push_back (Create<SystemThread> (MakeBoundCallback (
+        &MpscQueueTestCase::ProducingThread,
+        std::pair<MpscQueueTestCase *, unsigned int> (this, i))));
+      threads.back ()->Start ();
+    }
+
+  std::vector<uint32_t> next (m_threads, 0);
+  uint64_t popped = 0;
+  bool ordered = true;
+  while (popped < uint64_t (m_threads) * ITEMS)
+    {
+      Item item;
+      if (!queue.Pop (item))
+        {
+          std::this_thread::yield ();
+          continue;
+        }
+      ++popped;
+      if (item.producer >= m_threads || item.seq != next[item.producer])
+        {
+          ordered = false;
+          break;
+        }
+      ++next[item.producer];
+    }
+
+  for (unsigned int i = 0; i < threads.size (); ++i)
+    {
+      threads[i]->Join ();
+    }
+  m_queue = 0;
+  NS_TEST_EXPECT_MSG_EQ (ordered, true, "Items popped out of order");
+  NS_TEST_EXPECT_MSG_EQ (queue.IsEmpty (), true, "Items left in the queue");
+}
+
+/**
+ * \ingroup threaded-tests
+ *
+ * \brief Check that ThreadPool runs each index of its loops exactly once.
+ */
+class ThreadPoolTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor.
+   *
+   * \param threads The number of threads of the pool.
+   */
+  ThreadPoolTestCase (uint32_t threads);
+
+private:
+  virtual void DoRun (void);
+
+  uint32_t m_threads; //!< The number of threads of the pool.
+};
+
+ThreadPoolTestCase::ThreadPoolTestCase (uint32_t threads)
+  : TestCase ("Check ThreadPool with " + std::to_string (threads) + " threads"),
+    m_threads (threads)
+{}
+
+void
+ThreadPoolTestCase::DoRun (void)
+{
+  Ptr<ThreadPool> pool = Create<ThreadPool> (m_threads);
+  NS_TEST_ASSERT_MSG_EQ (pool->GetNThreads (), m_threads, "Wrong number of threads");
+  for (uint32_t n : {0, 1, 2, 7, 1000, 20000})
+    {
+      std::vector<uint32_t> runs (n, 0);
+      std::vector<uint64_t> squares (n, 0);
+      pool->Run (n, [&runs, &squares] (uint32_t i)
+        {
+          runs[i]++;
+          squares[i] = uint64_t (i) * i;
+        });
+      bool ok = true;
+      for (uint32_t i = 0; i < n; ++i)
+        {
+          ok &= runs[i] == 1 && squares[i] == uint64_t (i) * i;
+        }
+      NS_TEST_EXPECT_MSG_EQ (ok, true, "Index not run exactly once, n=" << n);
+    }
+
+  // a loop run from within a loop runs in the calling thread
+  std::vector<uint32_t> sums (8, 0);
+  pool->Run (sums.size (), [&pool, &sums] (uint32_t i)
+    {
+      uint32_t sum = 0;
+      pool->Run (i + 1, [&sum] (uint32_t j)
+        {
+          sum += j;
+        });
+      sums[i] = sum;
+    });
+  for (uint32_t i = 0; i < sums.size (); ++i)
+    {
+      NS_TEST_EXPECT_MSG_EQ (sums[i], i * (i + 1) / 2, "Bad nested loop " << i);
+    }
+}
+
 /**
  * \ingroup threaded-tests
  *  
@@ -297,7 +467,9 @@ public:
       "ns3::ListScheduler",
       "ns3::HeapScheduler",
       "ns3::MapScheduler",
-      "ns3::CalendarScheduler"
+      "ns3::CalendarScheduler",
+      "ns3::LadderScheduler",
+      "ns3::CompactHeapScheduler"
     };
     unsigned int threadcounts[] = {
       0,
@@ -318,6 +490,12 @@ public:
               }
           }
       }
+    // A tiny ring forces producers to use the overflow.
+    AddTestCase (new MpscQueueTestCase (1, 1024), TestCase::QUICK);
+    AddTestCase (new MpscQueueTestCase (4, 1024), TestCase::QUICK);
+    AddTestCase (new MpscQueueTestCase (4, 4), TestCase::QUICK);
+    AddTestCase (new ThreadPoolTestCase (1), TestCase::QUICK);
+    AddTestCase (new ThreadPoolTestCase (4), TestCase::QUICK);
   }
 };
 
@@ -18,6 +18,7 @@
 
 #include "ns3/test.h"
 #include "ns3/traced-callback.h"
+#include "ns3/traced-value.h"
 
 using namespace ns3;
 
@@ -134,6 +135,120 @@ BasicTracedCallbackTestCase::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ (m_two, true, "Callback CbTwo not called");
 }
 
+/**
+ * \ingroup tracedcallback-tests
+ *
+ * TracedCallback Test case, check IsEmpty() and the changes to the
+ * chain of Callbacks made by a Callback of this chain.
+ */
+class ReentrantTracedCallbackTestCase : public TestCase
+{
+public:
+  ReentrantTracedCallbackTestCase ();
+  virtual ~ReentrantTracedCallbackTestCase ()
+  {}
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Callback disconnecting itself, and connecting CbCount().
+   * \param a The parameter.
+   */
+  void CbSwap (uint32_t a);
+  /**
+   * Callback counting its calls.
+   * \param a The parameter.
+   */
+  void CbCount (uint32_t a);
+  /**
+   * TracedValue Callback counting its calls.
+   * \param oldValue The old value.
+   * \param newValue The new value.
+   */
+  void CbValue (uint32_t oldValue, uint32_t newValue);
+
+  TracedCallback<uint32_t> m_trace; //!< The traced callback.
+  uint32_t m_swaps;                 //!< Number of calls to CbSwap().
+  uint32_t m_count;                 //!< Number of calls to CbCount() and CbValue().
+};
+
+ReentrantTracedCallbackTestCase::ReentrantTracedCallbackTestCase ()
+  : TestCase ("Check TracedCallback changes during a call")
+{}
+
+void
+ReentrantTracedCallbackTestCase::CbSwap ([[maybe_unused]] uint32_t a)
+{
+  m_swaps++;
+  m_trace.DisconnectWithoutContext (MakeCallback (&ReentrantTracedCallbackTestCase::CbSwap, this));
+  m_trace.ConnectWithoutContext (MakeCallback (&ReentrantTracedCallbackTestCase::CbCount, this));
+}
+
+void
+ReentrantTracedCallbackTestCase::CbCount ([[maybe_unused]] uint32_t a)
+{
+  m_count++;
+}
+
+void
+ReentrantTracedCallbackTestCase::CbValue ([[maybe_unused]] uint32_t oldValue,
+                                          [[maybe_unused]] uint32_t newValue)
+{
+  m_count++;
+}
+
+void
+ReentrantTracedCallbackTestCase::DoRun (void)
+{
+  m_swaps = 0;
+  m_count = 0;
+  NS_TEST_ASSERT_MSG_EQ (m_trace.IsEmpty (), true, "New TracedCallback is not empty");
+  m_trace (1);
+
+  m_trace.ConnectWithoutContext (MakeCallback (&ReentrantTracedCallbackTestCase::CbSwap, this));
+  m_trace.ConnectWithoutContext (MakeCallback (&ReentrantTracedCallbackTestCase::CbCount, this));
+  NS_TEST_ASSERT_MSG_EQ (m_trace.IsEmpty (), false, "Connected TracedCallback is empty");
+  NS_TEST_ASSERT_MSG_EQ (m_trace.GetSize (), 2, "Wrong number of Callbacks");
+
+  //
+  // The changes made by CbSwap only take effect at the next call.
+  //
+  m_trace (1);
+  NS_TEST_ASSERT_MSG_EQ (m_swaps, 1, "CbSwap not called once");
+  NS_TEST_ASSERT_MSG_EQ (m_count, 1, "CbCount not called once");
+  NS_TEST_ASSERT_MSG_EQ (m_trace.GetSize (), 2, "Wrong number of Callbacks");
+  m_trace (1);
+  NS_TEST_ASSERT_MSG_EQ (m_swaps, 1, "CbSwap called after its disconnection");
+  NS_TEST_ASSERT_MSG_EQ (m_count, 3, "CbCount not called twice");
+
+  //
+  // Disconnecting CbCount removes both of its connections.
+  //
+  m_trace.DisconnectWithoutContext (MakeCallback (&ReentrantTracedCallbackTestCase::CbCount, this));
+  NS_TEST_ASSERT_MSG_EQ (m_trace.IsEmpty (), true, "Disconnected TracedCallback is not empty");
+  m_trace (1);
+  NS_TEST_ASSERT_MSG_EQ (m_count, 3, "CbCount called after its disconnection");
+
+  //
+  // TracedValue only calls its Callbacks when the value changes.
+  //
+  m_count = 0;
+  TracedValue<uint32_t> value = 0;
+  NS_TEST_ASSERT_MSG_EQ (value.IsEmpty (), true, "New TracedValue is not empty");
+  value = 1;
+  value.ConnectWithoutContext (MakeCallback (&ReentrantTracedCallbackTestCase::CbValue, this));
+  NS_TEST_ASSERT_MSG_EQ (value.IsEmpty (), false, "Connected TracedValue is empty");
+  value = 1;
+  value = 2;
+  NS_TEST_ASSERT_MSG_EQ (m_count, 1, "CbValue not called once");
+  value.DisconnectWithoutContext (MakeCallback (&ReentrantTracedCallbackTestCase::CbValue, this));
+  NS_TEST_ASSERT_MSG_EQ (value.IsEmpty (), true, "Disconnected TracedValue is not empty");
+  value = 3;
+  NS_TEST_ASSERT_MSG_EQ (value.Get (), 3, "Wrong TracedValue");
+  NS_TEST_ASSERT_MSG_EQ (m_count, 1, "CbValue called after its disconnection");
+}
+
 /**
  * \ingroup tracedcallback-tests
  *  
@@ -149,6 +264,7 @@ TracedCallbackTestSuite::TracedCallbackTestSuite ()
   : TestSuite ("traced-callback", UNIT)
 {
   AddTestCase (new BasicTracedCallbackTestCase, TestCase::QUICK);
+  AddTestCase (new ReentrantTracedCallbackTestCase, TestCase::QUICK);
 }
 
 static TracedCallbackTestSuite g_tracedCallbackTestSuite; //!< Static variable for test initialization
@@ -585,7 +585,10 @@ Ipv4L3Protocol::Receive ( Ptr<NetDevice> device, Ptr<const Packet> p, uint16_t p
 
   if (ipv4Interface->IsUp ())
     {
-      m_rxTrace (packet, this, interface);
+      if (!m_rxTrace.IsEmpty ())
+        {
+          m_rxTrace (packet, this, interface);
+        }
     }
   else
     {
@@ -806,7 +809,10 @@ Ipv4L3Protocol::Send (Ptr<Packet> packet,
       // 1b) with a valid gateway
       NS_LOG_LOGIC ("Ipv4L3Protocol::Send case 1b:  passed in with route and valid gateway");
       int32_t interface = GetInterfaceForDevice (route->GetOutputDevice ());
-      m_sendOutgoingTrace (ipHeader, packet, interface);
+      if (!m_sendOutgoingTrace.IsEmpty ())
+        {
+          m_sendOutgoingTrace (ipHeader, packet, interface);
+        }
       if (m_enableDpd && ipHeader.GetDestination ().IsMulticast ())
         {
           UpdateDuplicate (packet, ipHeader);
@@ -1046,7 +1052,10 @@ Ipv4L3Protocol::IpMulticastForward (Ptr<Ipv4MulticastRoute> mrtentry, Ptr<const
       rtentry->SetGateway (Ipv4Address::GetAny ());
       rtentry->SetOutputDevice (GetNetDevice (interface));
       
-      m_multicastForwardTrace (ipHeader, packet, interface);
+      if (!m_multicastForwardTrace.IsEmpty ())
+        {
+          m_multicastForwardTrace (ipHeader, packet, interface);
+        }
       SendRealOut (rtentry, packet, ipHeader);
       continue;
     }
@@ -1087,7 +1096,10 @@ Ipv4L3Protocol::IpForward (Ptr<Ipv4Route> rtentry, Ptr<const Packet> p, const Ip
       packet->AddPacketTag (priorityTag);
     }
 
-  m_unicastForwardTrace (ipHeader, packet, interface);
+  if (!m_unicastForwardTrace.IsEmpty ())
+    {
+      m_unicastForwardTrace (ipHeader, packet, interface);
+    }
   SendRealOut (rtentry, packet, ipHeader);
 }
 
@@ -1112,7 +1124,10 @@ Ipv4L3Protocol::LocalDeliver (Ptr<const Packet> packet, Ipv4Header const&ip, uin
       ipHeader.SetPayloadSize (p->GetSize ());
     }
 
-  m_localDeliverTrace (ipHeader, p, iif);
+  if (!m_localDeliverTrace.IsEmpty ())
+    {
+      m_localDeliverTrace (ipHeader, p, iif);
+    }
 
   Ptr<IpL4Protocol> protocol = GetProtocol (ipHeader.GetProtocol (), iif);
   if (protocol != 0)
@@ -695,21 +695,24 @@ LteEnbPhy::StartSubFrame (void)
                   mask = (mask << 1);
                 }
               // fire trace of DL Tx PHY stats
-              for (uint8_t i = 0; i < dci->GetDci ().m_mcs.size (); i++)
+              if (!m_dlPhyTransmission.IsEmpty ())
                 {
-                  PhyTransmissionStatParameters params;
-                  params.m_cellId = m_cellId;
-                  params.m_imsi = 0; // it will be set by DlPhyTransmissionCallback in LteHelper
-                  params.m_timestamp = Simulator::Now ().GetMilliSeconds ();
-                  params.m_rnti = dci->GetDci ().m_rnti;
-                  params.m_txMode = 0; // TBD
-                  params.m_layer = i;
-                  params.m_mcs = dci->GetDci ().m_mcs.at (i);
-                  params.m_size = dci->GetDci ().m_tbsSize.at (i);
-                  params.m_rv = dci->GetDci ().m_rv.at (i);
-                  params.m_ndi = dci->GetDci ().m_ndi.at (i);
-                  params.m_ccId = m_componentCarrierId;
-                  m_dlPhyTransmission (params);
+                  for (uint8_t i = 0; i < dci->GetDci ().m_mcs.size (); i++)
+                    {
+                      PhyTransmissionStatParameters params;
+                      params.m_cellId = m_cellId;
+                      params.m_imsi = 0; // it will be set by DlPhyTransmissionCallback in LteHelper
+                      params.m_timestamp = Simulator::Now ().GetMilliSeconds ();
+                      params.m_rnti = dci->GetDci ().m_rnti;
+                      params.m_txMode = 0; // TBD
+                      params.m_layer = i;
+                      params.m_mcs = dci->GetDci ().m_mcs.at (i);
+                      params.m_size = dci->GetDci ().m_tbsSize.at (i);
+                      params.m_rv = dci->GetDci ().m_rv.at (i);
+                      params.m_ndi = dci->GetDci ().m_ndi.at (i);
+                      params.m_ccId = m_componentCarrierId;
+                      m_dlPhyTransmission (params);
+                    }
                 }
 
             }
@@ -850,11 +853,14 @@ void
 LteEnbPhy::ReportInterference (const SpectrumValue& interf)
 {
   NS_LOG_FUNCTION (this << interf);
-  Ptr<SpectrumValue> interfCopy = Create<SpectrumValue> (interf);
   m_interferenceSampleCounter++;
   if (m_interferenceSampleCounter == m_interferenceSamplePeriod)
     {
-      m_reportInterferenceTrace (m_cellId, interfCopy);
+      if (!m_reportInterferenceTrace.IsEmpty ())
+        {
+          Ptr<SpectrumValue> interfCopy = Create<SpectrumValue> (interf);
+          m_reportInterferenceTrace (m_cellId, interfCopy);
+        }
       m_interferenceSampleCounter = 0;
     }
 }
@@ -1021,29 +1021,32 @@ LteSpectrumPhy::EndRxData ()
           (*itTb).second.corrupt = !(m_random->GetValue () > tbStats.tbler);
           NS_LOG_DEBUG (this << "RNTI " << (*itTb).first.m_rnti << " size " << (*itTb).second.size << " mcs " << (uint32_t)(*itTb).second.mcs << " bitmap " << (*itTb).second.rbBitmap.size () << " layer " << (uint16_t)(*itTb).first.m_layer << " TBLER " << tbStats.tbler << " corrupted " << (*itTb).second.corrupt);
           // fire traces on DL/UL reception PHY stats
-          PhyReceptionStatParameters params;
-          params.m_timestamp = Simulator::Now ().GetMilliSeconds ();
-          params.m_cellId = m_cellId;
-          params.m_imsi = 0; // it will be set by DlPhyTransmissionCallback in LteHelper
-          params.m_rnti = (*itTb).first.m_rnti;
-          params.m_txMode = m_transmissionMode;
-          params.m_layer =  (*itTb).first.m_layer;
-          params.m_mcs = (*itTb).second.mcs;
-          params.m_size = (*itTb).second.size;
-          params.m_rv = (*itTb).second.rv;
-          params.m_ndi = (*itTb).second.ndi;
-          params.m_correctness = (uint8_t) !(*itTb).second.corrupt;
-          params.m_ccId = m_componentCarrierId;
-          if ((*itTb).second.downlink)
+          if (!m_dlPhyReception.IsEmpty () || !m_ulPhyReception.IsEmpty ())
             {
-              // DL
-              m_dlPhyReception (params);
-            }
-          else
-            {
-              // UL
-              params.m_rv = harqInfoList.size ();
-              m_ulPhyReception (params);
+              PhyReceptionStatParameters params;
+              params.m_timestamp = Simulator::Now ().GetMilliSeconds ();
+              params.m_cellId = m_cellId;
+              params.m_imsi = 0; // it will be set by DlPhyTransmissionCallback in LteHelper
+              params.m_rnti = (*itTb).first.m_rnti;
+              params.m_txMode = m_transmissionMode;
+              params.m_layer =  (*itTb).first.m_layer;
+              params.m_mcs = (*itTb).second.mcs;
+              params.m_size = (*itTb).second.size;
+              params.m_rv = (*itTb).second.rv;
+              params.m_ndi = (*itTb).second.ndi;
+              params.m_correctness = (uint8_t) !(*itTb).second.corrupt;
+              params.m_ccId = m_componentCarrierId;
+              if ((*itTb).second.downlink)
+                {
+                  // DL
+                  m_dlPhyReception (params);
+                }
+              else
+                {
+                  // UL
+                  params.m_rv = harqInfoList.size ();
+                  m_ulPhyReception (params);
+                }
             }
         }
 
@@ -1106,20 +1106,23 @@ LteUePhy::ReceiveLteControlMessageList (std::list<Ptr<LteControlMessage> > msgLi
           m_reportUlPhyResourceBlocks (m_rnti, ulRb);
           QueueSubChannelsForTransmission (ulRb);
           // fire trace of UL Tx PHY stats
-          HarqProcessInfoList_t harqInfoList = m_harqPhyModule->GetHarqProcessInfoUl (m_rnti, 0);
-          PhyTransmissionStatParameters params;
-          params.m_cellId = m_cellId;
-          params.m_imsi = 0; // it will be set by DlPhyTransmissionCallback in LteHelper
-          params.m_timestamp = Simulator::Now ().GetMilliSeconds () + UL_PUSCH_TTIS_DELAY;
-          params.m_rnti = m_rnti;
-          params.m_txMode = 0; // always SISO for UE
-          params.m_layer = 0;
-          params.m_mcs = dci.m_mcs;
-          params.m_size = dci.m_tbSize;
-          params.m_rv = harqInfoList.size ();
-          params.m_ndi = dci.m_ndi;
-          params.m_ccId = m_componentCarrierId;
-          m_ulPhyTransmission (params);
+          if (!m_ulPhyTransmission.IsEmpty ())
+            {
+              HarqProcessInfoList_t harqInfoList = m_harqPhyModule->GetHarqProcessInfoUl (m_rnti, 0);
+              PhyTransmissionStatParameters params;
+              params.m_cellId = m_cellId;
+              params.m_imsi = 0; // it will be set by DlPhyTransmissionCallback in LteHelper
+              params.m_timestamp = Simulator::Now ().GetMilliSeconds () + UL_PUSCH_TTIS_DELAY;
+              params.m_rnti = m_rnti;
+              params.m_txMode = 0; // always SISO for UE
+              params.m_layer = 0;
+              params.m_mcs = dci.m_mcs;
+              params.m_size = dci.m_tbSize;
+              params.m_rv = harqInfoList.size ();
+              params.m_ndi = dci.m_ndi;
+              params.m_ccId = m_componentCarrierId;
+              m_ulPhyTransmission (params);
+            }
           // pass the info to the MAC
           m_uePhySapUser->ReceiveLteControlMessage (msg);
         }
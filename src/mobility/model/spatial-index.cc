@@ -0,0 +1,265 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "spatial-index.h"
+#include "mobility-model.h"
+#include "ns3/assert.h"
+#include "ns3/double.h"
+#include "ns3/log.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("SpatialIndex");
+
+NS_OBJECT_ENSURE_REGISTERED (SpatialIndex);
+
+TypeId
+SpatialIndex::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::SpatialIndex")
+    .SetParent<Object> ()
+    .SetGroupName ("Mobility")
+    .AddConstructor<SpatialIndex> ()
+    .AddAttribute ("CellSize",
+                   "The size of the square cells of the grid, in meters.",
+                   DoubleValue (1000),
+                   MakeDoubleAccessor (&SpatialIndex::m_cellSize),
+                   MakeDoubleChecker<double> (1e-3))
+  ;
+  return tid;
+}
+
+SpatialIndex::SpatialIndex ()
+  : m_cellSize (1000),
+    m_nextKey (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+SpatialIndex::~SpatialIndex ()
+{
+  NS_LOG_FUNCTION (this);
+  Clear ();
+}
+
+void
+SpatialIndex::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  Clear ();
+  Object::DoDispose ();
+}
+
+void
+SpatialIndex::Clear (void)
+{
+  // the trace sources of the mobility models hold a pointer to this index
+  for (auto &item : m_items)
+    {
+      if (item.second.mobility != 0
+          && m_keysByMobility.erase (PeekPointer (item.second.mobility)) > 0)
+        {
+          item.second.mobility->TraceDisconnectWithoutContext
+            ("CourseChange", MakeCallback (&SpatialIndex::CourseChanged, this));
+        }
+    }
+  m_items.clear ();
+  m_cells.clear ();
+  m_unplaced.clear ();
+  m_keysByMobility.clear ();
+}
+
+std::size_t
+SpatialIndex::CellHash::operator() (const Cell &cell) const
+{
+  return std::hash<int64_t> () (cell.first * 0x9e3779b97f4a7c15ULL ^ cell.second);
+}
+
+SpatialIndex::Cell
+SpatialIndex::GetCell (const Vector &position) const
+{
+  return Cell (static_cast<int64_t> (std::floor (position.x / m_cellSize)),
+               static_cast<int64_t> (std::floor (position.y / m_cellSize)));
+}
+
+uint32_t
+SpatialIndex::Add (Ptr<MobilityModel> mobility)
+{
+  NS_LOG_FUNCTION (this << mobility);
+  uint32_t key = m_nextKey++;
+  Item &item = m_items[key];
+  item.mobility = mobility;
+  if (mobility != 0)
+    {
+      std::vector<uint32_t> &keys = m_keysByMobility[PeekPointer (mobility)];
+      if (keys.empty ())
+        {
+          mobility->TraceConnectWithoutContext ("CourseChange",
+                                                MakeCallback (&SpatialIndex::CourseChanged, this));
+        }
+      keys.push_back (key);
+    }
+  Place (key, item);
+  return key;
+}
+
+void
+SpatialIndex::Remove (uint32_t key)
+{
+  NS_LOG_FUNCTION (this << key);
+  auto it = m_items.find (key);
+  NS_ASSERT_MSG (it != m_items.end (), "Unknown key " << key);
+  Unplace (key, it->second);
+  Ptr<MobilityModel> mobility = it->second.mobility;
+  if (mobility != 0)
+    {
+      auto keys = m_keysByMobility.find (PeekPointer (mobility));
+      NS_ASSERT (keys != m_keysByMobility.end ());
+      keys->second.erase (std::find (keys->second.begin (), keys->second.end (), key));
+      if (keys->second.empty ())
+        {
+          m_keysByMobility.erase (keys);
+          mobility->TraceDisconnectWithoutContext ("CourseChange",
+                                                   MakeCallback (&SpatialIndex::CourseChanged, this));
+        }
+    }
+  m_items.erase (it);
+}
+
+uint32_t
+SpatialIndex::GetN (void) const
+{
+  return m_items.size ();
+}
+
+void
+SpatialIndex::Place (uint32_t key, Item &item)
+{
+  item.placed = false;
+  if (item.mobility != 0)
+    {
+      Vector velocity = item.mobility->GetVelocity ();
+      if (velocity.x == 0 && velocity.y == 0 && velocity.z == 0)
+        {
+          item.position = item.mobility->GetPosition ();
+          item.cell = GetCell (item.position);
+          item.placed = true;
+          m_cells[item.cell].push_back (key);
+          return;
+        }
+    }
+  m_unplaced.insert (key);
+}
+
+void
+SpatialIndex::Unplace (uint32_t key, const Item &item)
+{
+  if (!item.placed)
+    {
+      m_unplaced.erase (key);
+      return;
+    }
+  auto cell = m_cells.find (item.cell);
+  NS_ASSERT (cell != m_cells.end ());
+  std::vector<uint32_t> &keys = cell->second;
+  auto it = std::find (keys.begin (), keys.end (), key);
+  NS_ASSERT (it != keys.end ());
+  *it = keys.back ();
+  keys.pop_back ();
+  if (keys.empty ())
+    {
+      m_cells.erase (cell);
+    }
+}
+
+void
+SpatialIndex::CourseChanged (Ptr<const MobilityModel> mobility)
+{
+  NS_LOG_FUNCTION (this << mobility);
+  auto keys = m_keysByMobility.find (PeekPointer (mobility));
+  NS_ASSERT (keys != m_keysByMobility.end ());
+  for (uint32_t key : keys->second)
+    {
+      Item &item = m_items[key];
+      Unplace (key, item);
+      Place (key, item);
+    }
+}
+
+void
+SpatialIndex::GetCandidates (const Vector &position, double range, std::vector<uint32_t> &keys) const
+{
+  NS_LOG_FUNCTION (this << position << range);
+  keys.clear ();
+  if (!(range < m_cellSize * 1e6))
+    {
+      // the range is infinite, or too large for the grid to be of use
+      for (const auto &item : m_items)
+        {
+          keys.push_back (item.first);
+        }
+      return;
+    }
+  Cell low = GetCell (Vector (position.x - range, position.y - range, 0));
+  Cell high = GetCell (Vector (position.x + range, position.y + range, 0));
+  // visit the occupied cells rather than the range when it is larger
+  double rangeCells = static_cast<double> (high.first - low.first + 1) * (high.second - low.second + 1);
+  if (rangeCells > m_cells.size ())
+    {
+      for (const auto &cell : m_cells)
+        {
+          if (cell.first.first >= low.first && cell.first.first <= high.first
+              && cell.first.second >= low.second && cell.first.second <= high.second)
+            {
+              for (uint32_t key : cell.second)
+                {
+                  if (CalculateDistance (m_items.at (key).position, position) <= range)
+                    {
+                      keys.push_back (key);
+                    }
+                }
+            }
+        }
+    }
+  else
+    {
+      for (int64_t x = low.first; x <= high.first; ++x)
+        {
+          for (int64_t y = low.second; y <= high.second; ++y)
+            {
+              auto cell = m_cells.find (Cell (x, y));
+              if (cell == m_cells.end ())
+                {
+                  continue;
+                }
+              for (uint32_t key : cell->second)
+                {
+                  if (CalculateDistance (m_items.at (key).position, position) <= range)
+                    {
+                      keys.push_back (key);
+                    }
+                }
+            }
+        }
+    }
+  keys.insert (keys.end (), m_unplaced.begin (), m_unplaced.end ());
+  std::sort (keys.begin (), keys.end ());
+}
+
+} // namespace ns3
@@ -0,0 +1,168 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef SPATIAL_INDEX_H
+#define SPATIAL_INDEX_H
+
+#include "ns3/object.h"
+#include "ns3/vector.h"
+
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <vector>
+#include <stdint.h>
+
+namespace ns3 {
+
+class MobilityModel;
+
+/**
+ * \ingroup mobility
+ * \brief Uniform grid of the positions of a set of MobilityModel objects.
+ *
+ * The SpatialIndex lists the items which may be within a given
+ * distance of a position, e.g., the receivers which may be within the
+ * range of a transmitter, without visiting the items which are known
+ * to be farther away.  The items are identified by the keys returned by
+ * Add(), which increase with each addition: a channel keeping its
+ * receivers in the order in which they were added can visit the
+ * candidates in the same order as all its receivers.
+ *
+ * The items whose MobilityModel has a zero velocity are placed in the
+ * square cells of a grid of the x and y coordinates; their position is
+ * updated by the CourseChange trace source of their MobilityModel.  The
+ * moving items, and the items without a MobilityModel, are always
+ * listed as candidates.  The index thus relies on the MobilityModel
+ * objects to report a non-zero velocity while they move, and to notify
+ * a course change when they stop or start moving: this excludes a
+ * WaypointMobilityModel with the LazyNotify attribute set.
+ */
+class SpatialIndex : public Object
+{
+public:
+  /**
+   * Register this type.
+   * \return The object TypeId.
+   */
+  static TypeId GetTypeId (void);
+
+  SpatialIndex ();
+  virtual ~SpatialIndex ();
+
+  /**
+   * Add an item.
+   *
+   * \param [in] mobility The MobilityModel of the item, or 0.
+   * \return The key of the item, larger than the keys of all the
+   *         items added before.
+   */
+  uint32_t Add (Ptr<MobilityModel> mobility);
+
+  /**
+   * Remove an item.
+   *
+   * \param [in] key The key of the item.
+   */
+  void Remove (uint32_t key);
+
+  /**
+   * \return The number of items.
+   */
+  uint32_t GetN (void) const;
+
+  /**
+   * List the items which may be within a distance of a position.
+   *
+   * The list includes all the items within the distance, the moving
+   * items and the items without a MobilityModel.
+   *
+   * \param [in] position The position.
+   * \param [in] range The distance, in meters, which may be infinite.
+   * \param [out] keys The keys of the items, in increasing order.
+   */
+  void GetCandidates (const Vector &position, double range, std::vector<uint32_t> &keys) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /** The coordinates of a cell of the grid. */
+  typedef std::pair<int64_t, int64_t> Cell;
+
+  /** Hash of the coordinates of a cell. */
+  struct CellHash
+  {
+    /**
+     * \param [in] cell The coordinates of a cell.
+     * \return The hash of the coordinates.
+     */
+    std::size_t operator() (const Cell &cell) const;
+  };
+
+  /** An item of the index. */
+  struct Item
+  {
+    Ptr<MobilityModel> mobility; //!< The MobilityModel, or 0.
+    Vector position;             //!< The position of a static item.
+    bool placed;                 //!< Whether the item is in a cell.
+    Cell cell;                   //!< The cell of a static item.
+  };
+
+  /** Remove all the items and disconnect from their MobilityModel. */
+  void Clear (void);
+
+  /**
+   * \param [in] position A position.
+   * \return The cell containing the position.
+   */
+  Cell GetCell (const Vector &position) const;
+
+  /**
+   * Place an item in its cell, or in the list of moving items.
+   *
+   * \param [in] key The key of the item.
+   * \param [in,out] item The item.
+   */
+  void Place (uint32_t key, Item &item);
+
+  /**
+   * Remove an item from its cell, or from the list of moving items.
+   *
+   * \param [in] key The key of the item.
+   * \param [in] item The item.
+   */
+  void Unplace (uint32_t key, const Item &item);
+
+  /**
+   * Move the items of a MobilityModel which changed course.
+   *
+   * \param [in] mobility The MobilityModel.
+   */
+  void CourseChanged (Ptr<const MobilityModel> mobility);
+
+  double m_cellSize;                    //!< The size of the cells, in meters.
+  uint32_t m_nextKey;                   //!< The key of the next item.
+  std::map<uint32_t, Item> m_items;     //!< The items, by key.
+  /** The keys of the static items, by cell. */
+  std::unordered_map<Cell, std::vector<uint32_t>, CellHash> m_cells;
+  std::set<uint32_t> m_unplaced;        //!< The moving items and the items without mobility.
+  /** The keys of the items, by MobilityModel. */
+  std::unordered_map<const MobilityModel *, std::vector<uint32_t> > m_keysByMobility;
+};
+
+} // namespace ns3
+
+#endif /* SPATIAL_INDEX_H */
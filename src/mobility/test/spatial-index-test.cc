@@ -0,0 +1,197 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/test.h>
+#include <ns3/constant-position-mobility-model.h>
+#include <ns3/constant-velocity-mobility-model.h>
+#include <ns3/double.h>
+#include <ns3/random-variable-stream.h>
+#include <ns3/spatial-index.h>
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup mobility-test
+ * \ingroup tests
+ *
+ * \brief Check the candidates of the SpatialIndex against an exhaustive
+ * search, for static, moving and removed items.
+ */
+class SpatialIndexTestCase : public TestCase
+{
+public:
+  SpatialIndexTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Check the candidates of a query against an exhaustive search.
+   *
+   * \param index The index.
+   * \param position The position of the query.
+   * \param range The range of the query.
+   */
+  void CheckQuery (Ptr<SpatialIndex> index, const Vector &position, double range);
+
+  std::vector<Ptr<MobilityModel> > m_mobility; //!< The mobility of the items, by key.
+  std::vector<bool> m_present;                 //!< Whether each key is in the index.
+};
+
+SpatialIndexTestCase::SpatialIndexTestCase ()
+  : TestCase ("Check the candidates of the SpatialIndex")
+{}
+
+void
+SpatialIndexTestCase::CheckQuery (Ptr<SpatialIndex> index, const Vector &position, double range)
+{
+  std::vector<uint32_t> keys;
+  index->GetCandidates (position, range, keys);
+  for (std::size_t i = 1; i < keys.size (); ++i)
+    {
+      NS_TEST_ASSERT_MSG_LT (keys[i - 1], keys[i], "The candidates are not sorted");
+    }
+  uint32_t expected = 0;
+  for (uint32_t key = 0; key < m_mobility.size (); ++key)
+    {
+      bool candidate = std::binary_search (keys.begin (), keys.end (), key);
+      if (!m_present[key])
+        {
+          NS_TEST_ASSERT_MSG_EQ (candidate, false, "Removed item " << key << " listed");
+          continue;
+        }
+      ++expected;
+      if (m_mobility[key] == 0
+          || CalculateDistance (m_mobility[key]->GetPosition (), position) <= range)
+        {
+          NS_TEST_ASSERT_MSG_EQ (candidate, true, "Item " << key << " within range not listed");
+        }
+    }
+  NS_TEST_ASSERT_MSG_EQ (index->GetN (), expected, "Wrong number of items");
+}
+
+void
+SpatialIndexTestCase::DoRun (void)
+{
+  Ptr<SpatialIndex> index = CreateObject<SpatialIndex> ();
+  index->SetAttribute ("CellSize", DoubleValue (100));
+  Ptr<UniformRandomVariable> rng = CreateObject<UniformRandomVariable> ();
+  rng->SetStream (1);
+
+  for (uint32_t i = 0; i < 200; ++i)
+    {
+      Ptr<MobilityModel> mobility;
+      if (i % 20 == 7)
+        {
+          // an item without mobility
+        }
+      else if (i % 10 == 3)
+        {
+          Ptr<ConstantVelocityMobilityModel> moving = CreateObject<ConstantVelocityMobilityModel> ();
+          // setting the position stops the model
+          moving->SetPosition (Vector (rng->GetValue (-1000, 1000), rng->GetValue (-1000, 1000), 0));
+          moving->SetVelocity (Vector (1, 0, 0));
+          mobility = moving;
+        }
+      else
+        {
+          mobility = CreateObject<ConstantPositionMobilityModel> ();
+          mobility->SetPosition (Vector (rng->GetValue (-1000, 1000), rng->GetValue (-1000, 1000),
+                                         rng->GetValue (0, 30)));
+        }
+      uint32_t key = index->Add (mobility);
+      NS_TEST_ASSERT_MSG_EQ (key, m_mobility.size (), "Unexpected key");
+      m_mobility.push_back (mobility);
+      m_present.push_back (true);
+    }
+
+  for (double range : {0.0, 50.0, 150.0, 700.0, 5000.0, std::numeric_limits<double>::infinity ()})
+    {
+      for (uint32_t q = 0; q < 20; ++q)
+        {
+          CheckQuery (index, Vector (rng->GetValue (-1200, 1200), rng->GetValue (-1200, 1200), 10), range);
+        }
+    }
+
+  // the moving items are always candidates, wherever they are
+  std::vector<uint32_t> keys;
+  index->GetCandidates (Vector (1e5, 1e5, 0), 1, keys);
+  NS_TEST_ASSERT_MSG_EQ (keys.size (), 30u, "Expected the moving items and the items without mobility");
+
+  // move, stop and start some items, then remove a few
+  for (uint32_t key = 0; key < m_mobility.size (); key += 3)
+    {
+      if (m_mobility[key] == 0)
+        {
+          continue;
+        }
+      // this stops the moving items
+      m_mobility[key]->SetPosition (Vector (rng->GetValue (-1000, 1000), rng->GetValue (-1000, 1000), 0));
+    }
+  for (uint32_t key = 0; key < m_mobility.size (); key += 11)
+    {
+      index->Remove (key);
+      m_present[key] = false;
+    }
+  for (double range : {0.0, 50.0, 150.0, 700.0})
+    {
+      for (uint32_t q = 0; q < 20; ++q)
+        {
+          CheckQuery (index, Vector (rng->GetValue (-1200, 1200), rng->GetValue (-1200, 1200), 10), range);
+        }
+    }
+
+  // the same mobility model added twice
+  uint32_t first = index->Add (m_mobility[1]);
+  uint32_t second = index->Add (m_mobility[1]);
+  m_mobility.push_back (m_mobility[1]);
+  m_mobility.push_back (m_mobility[1]);
+  m_present.push_back (true);
+  m_present.push_back (true);
+  index->Remove (first);
+  m_present[first] = false;
+  m_mobility[1]->SetPosition (Vector (5000, 5000, 0));
+  CheckQuery (index, Vector (5000, 5000, 0), 10);
+  index->GetCandidates (Vector (5000, 5000, 0), 10, keys);
+  NS_TEST_ASSERT_MSG_EQ (std::binary_search (keys.begin (), keys.end (), second), true,
+                         "Moved item not listed");
+
+  index->Dispose ();
+}
+
+/**
+ * \ingroup mobility-test
+ * \ingroup tests
+ *
+ * \brief Spatial Index Test Suite
+ */
+class SpatialIndexTestSuite : public TestSuite
+{
+public:
+  SpatialIndexTestSuite ();
+};
+
+SpatialIndexTestSuite::SpatialIndexTestSuite ()
+  : TestSuite ("spatial-index", UNIT)
+{
+  AddTestCase (new SpatialIndexTestCase, TestCase::QUICK);
+}
+
+static SpatialIndexTestSuite g_spatialIndexTestSuite; //!< Static variable for test initialization
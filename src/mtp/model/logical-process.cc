@@ -0,0 +1,291 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "logical-process.h"
+
+#include "ns3/assert.h"
+#include "ns3/event-impl.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+
+#include <algorithm>
+
+/**
+ * \file
+ * \ingroup mtp
+ * ns3::LogicalProcess implementation.
+ */
+
+namespace ns3 {
+
+// Logging in this file is largely avoided, as in DefaultSimulatorImpl.
+NS_LOG_COMPONENT_DEFINE ("LogicalProcess");
+
+LogicalProcess::LogicalProcess (uint32_t id, Ptr<Scheduler> events)
+  : m_id (id),
+    m_events (events),
+    m_minSent (UINT64_MAX),
+    m_sent (0),
+    m_uid (EventId::UID::VALID),
+    m_currentUid (EventId::UID::INVALID),
+    m_currentTs (0),
+    m_currentContext (Simulator::NO_CONTEXT),
+    m_eventCount (0),
+    m_unscheduledEvents (0)
+{
+  NS_LOG_FUNCTION (this << id << events);
+}
+
+LogicalProcess::~LogicalProcess ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+uint32_t
+LogicalProcess::GetId (void) const
+{
+  return m_id;
+}
+
+void
+LogicalProcess::SetScheduler (Ptr<Scheduler> events)
+{
+  NS_LOG_FUNCTION (this << events);
+  while (!m_events->IsEmpty ())
+    {
+      events->Insert (m_events->RemoveNext ());
+    }
+  m_events = events;
+}
+
+void
+LogicalProcess::SetClock (uint64_t ts, uint32_t uid, uint32_t nextUid)
+{
+  NS_LOG_FUNCTION (this << ts << uid << nextUid);
+  m_currentTs = ts;
+  m_currentUid = uid;
+  m_uid = nextUid;
+}
+
+EventId
+LogicalProcess::Schedule (uint64_t ts, uint32_t context, EventImpl *event)
+{
+  NS_ASSERT (ts >= m_currentTs);
+  Scheduler::Event ev;
+  ev.impl = event;
+  ev.key.m_ts = ts;
+  ev.key.m_context = context;
+  ev.key.m_uid = m_uid;
+  m_uid++;
+  m_unscheduledEvents++;
+  m_events->Insert (ev);
+  return EventId (event, ev.key.m_ts, ev.key.m_context, ev.key.m_uid);
+}
+
+void
+LogicalProcess::Insert (const Scheduler::Event &ev)
+{
+  NS_ASSERT (ev.key.m_uid < m_uid);
+  m_unscheduledEvents++;
+  m_events->Insert (ev);
+}
+
+Scheduler::Event
+LogicalProcess::RemoveNext (void)
+{
+  m_unscheduledEvents--;
+  return m_events->RemoveNext ();
+}
+
+void
+LogicalProcess::Post (LogicalProcess *sender, uint64_t ts, uint32_t context, EventImpl *event)
+{
+  Mail mail;
+  mail.ts = ts;
+  mail.context = context;
+  mail.sender = sender->m_id;
+  mail.sequence = sender->m_sent++;
+  mail.event = event;
+  sender->m_minSent = std::min (sender->m_minSent, ts);
+  m_mailbox.Push (mail);
+}
+
+bool
+LogicalProcess::IsMailLess (const Mail &a, const Mail &b)
+{
+  if (a.ts != b.ts)
+    {
+      return a.ts < b.ts;
+    }
+  if (a.sender != b.sender)
+    {
+      return a.sender < b.sender;
+    }
+  return a.sequence < b.sequence;
+}
+
+void
+LogicalProcess::ReceiveMail (void)
+{
+  Mail mail;
+  while (m_mailbox.Pop (mail))
+    {
+      m_inbox.push_back (mail);
+    }
+  if (m_inbox.empty ())
+    {
+      return;
+    }
+  std::sort (m_inbox.begin (), m_inbox.end (), &LogicalProcess::IsMailLess);
+  for (std::vector<Mail>::const_iterator i = m_inbox.begin (); i != m_inbox.end (); ++i)
+    {
+      Schedule (i->ts, i->context, i->event);
+    }
+  m_inbox.clear ();
+}
+
+uint64_t
+LogicalProcess::GetMinSent (void) const
+{
+  return m_minSent;
+}
+
+void
+LogicalProcess::ResetMinSent (void)
+{
+  m_minSent = UINT64_MAX;
+}
+
+void
+LogicalProcess::ProcessEvents (uint64_t end, const std::atomic<bool> &stop)
+{
+  while (!m_events->IsEmpty ()
+         && m_events->PeekNext ().key.m_ts < end
+         && !stop.load (std::memory_order_relaxed))
+    {
+      ProcessOneEvent ();
+    }
+}
+
+void
+LogicalProcess::ProcessOneEvent (void)
+{
+  Scheduler::Event next = m_events->RemoveNext ();
+  NS_ASSERT (next.key.m_ts >= m_currentTs);
+  m_unscheduledEvents--;
+  m_eventCount++;
+  m_currentTs = next.key.m_ts;
+  m_currentContext = next.key.m_context;
+  m_currentUid = next.key.m_uid;
+  next.impl->Invoke ();
+  next.impl->Unref ();
+}
+
+uint64_t
+LogicalProcess::GetNextTs (void) const
+{
+  if (m_events->IsEmpty ())
+    {
+      return UINT64_MAX;
+    }
+  return m_events->PeekNext ().key.m_ts;
+}
+
+bool
+LogicalProcess::IsEmpty (void) const
+{
+  return m_events->IsEmpty () && m_mailbox.IsEmpty ();
+}
+
+void
+LogicalProcess::Remove (const EventId &id)
+{
+  if (IsExpired (id))
+    {
+      return;
+    }
+  Scheduler::Event event;
+  event.impl = id.PeekEventImpl ();
+  event.key.m_ts = id.GetTs ();
+  event.key.m_context = id.GetContext ();
+  event.key.m_uid = id.GetUid ();
+  m_events->Remove (event);
+  event.impl->Cancel ();
+  // whenever we remove an event from the event list, we have to unref it.
+  event.impl->Unref ();
+  m_unscheduledEvents--;
+}
+
+bool
+LogicalProcess::IsExpired (const EventId &id) const
+{
+  return id.PeekEventImpl () == 0
+         || id.GetTs () < m_currentTs
+         || (id.GetTs () == m_currentTs && id.GetUid () <= m_currentUid)
+         || id.PeekEventImpl ()->IsCancelled ();
+}
+
+uint64_t
+LogicalProcess::GetCurrentTs (void) const
+{
+  return m_currentTs;
+}
+
+void
+LogicalProcess::SetCurrentTs (uint64_t ts)
+{
+  NS_ASSERT (ts >= m_currentTs && ts <= GetNextTs ());
+  m_currentTs = ts;
+}
+
+uint32_t
+LogicalProcess::GetContext (void) const
+{
+  return m_currentContext;
+}
+
+uint32_t
+LogicalProcess::GetNextUid (void) const
+{
+  return m_uid;
+}
+
+uint64_t
+LogicalProcess::GetEventCount (void) const
+{
+  return m_eventCount;
+}
+
+int
+LogicalProcess::GetUnscheduledEvents (void) const
+{
+  return m_unscheduledEvents;
+}
+
+void
+LogicalProcess::Clear (void)
+{
+  NS_LOG_FUNCTION (this);
+  ReceiveMail ();
+  while (!m_events->IsEmpty ())
+    {
+      Scheduler::Event next = m_events->RemoveNext ();
+      next.impl->Unref ();
+    }
+  m_unscheduledEvents = 0;
+}
+
+} // namespace ns3
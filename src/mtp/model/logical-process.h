@@ -0,0 +1,236 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LOGICAL_PROCESS_H
+#define LOGICAL_PROCESS_H
+
+#include "ns3/event-id.h"
+#include "ns3/mpsc-queue.h"
+#include "ns3/ptr.h"
+#include "ns3/scheduler.h"
+#include "ns3/simple-ref-count.h"
+
+#include <atomic>
+#include <stdint.h>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup mtp
+ * ns3::LogicalProcess declaration.
+ */
+
+namespace ns3 {
+
+class EventImpl;
+
+/**
+ * \ingroup mtp
+ *
+ * \brief A partition of the simulation run by MultithreadedSimulatorImpl.
+ *
+ * A logical process owns the events of a set of contexts (nodes): its
+ * own event list, clock, event uids and event count, so that it can
+ * run its events without synchronizing with the other logical
+ * processes, up to the end of the time window granted by the
+ * simulator.
+ *
+ * Events scheduled by other logical processes are posted to a
+ * lock-free mailbox, and moved to the event list at the start of the
+ * next window, by ReceiveMail().  They are inserted in (time stamp,
+ * sender, sender sequence number) order, so the result does not depend
+ * on the order in which the threads happened to post them.
+ */
+class LogicalProcess : public SimpleRefCount<LogicalProcess>
+{
+public:
+  /**
+   * Constructor.
+   *
+   * \param [in] id The logical process index.
+   * \param [in] events The event list.
+   */
+  LogicalProcess (uint32_t id, Ptr<Scheduler> events);
+  /** Destructor. */
+  ~LogicalProcess ();
+
+  /** \returns The logical process index. */
+  uint32_t GetId (void) const;
+  /**
+   * Replace the event list, moving the pending events to the new one.
+   *
+   * \param [in] events The new event list.
+   */
+  void SetScheduler (Ptr<Scheduler> events);
+  /**
+   * Set the clock, the current event and the next event uid, for
+   * example to carry on from another logical process.
+   *
+   * \param [in] ts The current time stamp.
+   * \param [in] uid The current event uid.
+   * \param [in] nextUid The uid of the next event to schedule.
+   */
+  void SetClock (uint64_t ts, uint32_t uid, uint32_t nextUid);
+
+  /**
+   * Schedule an event of this logical process.
+   *
+   * This must only be called by the thread running this logical
+   * process, or while no logical process runs.
+   *
+   * \param [in] ts The absolute event time stamp.
+   * \param [in] context The event context.
+   * \param [in] event The event.
+   * \returns The event id.
+   */
+  EventId Schedule (uint64_t ts, uint32_t context, EventImpl *event);
+  /**
+   * Insert an event with an existing key.
+   *
+   * \param [in] ev The event.
+   */
+  void Insert (const Scheduler::Event &ev);
+  /**
+   * Remove the next event, without running it.
+   *
+   * \returns The event.
+   */
+  Scheduler::Event RemoveNext (void);
+  /**
+   * Post an event scheduled by another logical process.
+   *
+   * This can be called from any thread.
+   *
+   * \param [in] sender The logical process which schedules the event.
+   * \param [in] ts The absolute event time stamp.
+   * \param [in] context The event context.
+   * \param [in] event The event.
+   */
+  void Post (LogicalProcess *sender, uint64_t ts, uint32_t context, EventImpl *event);
+  /** Move the posted events to the event list. */
+  void ReceiveMail (void);
+  /**
+   * \returns The time stamp of the earliest event posted by this
+   *          logical process since the last call to ResetMinSent().
+   */
+  uint64_t GetMinSent (void) const;
+  /** Forget the events posted by this logical process. */
+  void ResetMinSent (void);
+
+  /**
+   * Run the events up to, but excluding, a time stamp.
+   *
+   * \param [in] end The end of the time window.
+   * \param [in] stop Flag set to stop the simulation early.
+   */
+  void ProcessEvents (uint64_t end, const std::atomic<bool> &stop);
+  /** Run the next event. */
+  void ProcessOneEvent (void);
+
+  /**
+   * \returns The time stamp of the next event, or \c UINT64_MAX if
+   *          the event list is empty.
+   */
+  uint64_t GetNextTs (void) const;
+  /** \returns \c true if there are no pending nor posted events. */
+  bool IsEmpty (void) const;
+  /**
+   * Remove an event of this logical process.
+   *
+   * \param [in] id The event.
+   */
+  void Remove (const EventId &id);
+  /**
+   * Check if an event of this logical process has run or was cancelled.
+   *
+   * \param [in] id The event.
+   * \returns \c true if the event has expired.
+   */
+  bool IsExpired (const EventId &id) const;
+  /** \returns The time stamp of the current event. */
+  uint64_t GetCurrentTs (void) const;
+  /**
+   * Move the clock forward, while no event runs.
+   *
+   * \param [in] ts The new time stamp.
+   */
+  void SetCurrentTs (uint64_t ts);
+  /** \returns The context of the current event. */
+  uint32_t GetContext (void) const;
+  /** \returns The uid of the next event to schedule. */
+  uint32_t GetNextUid (void) const;
+  /** \returns The number of events run. */
+  uint64_t GetEventCount (void) const;
+  /**
+   * \returns The number of events inserted and not run yet; this is
+   *          used for validation.
+   */
+  int GetUnscheduledEvents (void) const;
+  /** Discard all the pending and posted events. */
+  void Clear (void);
+
+private:
+  /** An event posted by another logical process. */
+  struct Mail
+  {
+    uint64_t ts;        /**< Absolute event time stamp. */
+    uint32_t context;   /**< Event context. */
+    uint32_t sender;    /**< Index of the sender logical process. */
+    uint64_t sequence;  /**< Sender sequence number. */
+    EventImpl *event;   /**< The event. */
+  };
+  /**
+   * Compare (less than) two posted events.
+   *
+   * \param [in] a The first event.
+   * \param [in] b The second event.
+   * \returns \c true if \c a must be inserted before \c b
+   */
+  static bool IsMailLess (const Mail &a, const Mail &b);
+
+  /** The logical process index. */
+  uint32_t m_id;
+  /** The event list. */
+  Ptr<Scheduler> m_events;
+  /** Events posted by other logical processes. */
+  MpscQueue<Mail> m_mailbox;
+  /** Posted events being sorted by ReceiveMail(). */
+  std::vector<Mail> m_inbox;
+  /** Time stamp of the earliest event posted by this logical process. */
+  uint64_t m_minSent;
+  /** Sequence number of the next event posted by this logical process. */
+  uint64_t m_sent;
+
+  /** Next event unique id. */
+  uint32_t m_uid;
+  /** Unique id of the current event. */
+  uint32_t m_currentUid;
+  /** Timestamp of the current event. */
+  uint64_t m_currentTs;
+  /** Execution context of the current event. */
+  uint32_t m_currentContext;
+  /** The event count. */
+  uint64_t m_eventCount;
+  /**
+   * Number of events that have been inserted but not yet scheduled;
+   * this is used for validation.
+   */
+  int m_unscheduledEvents;
+};
+
+} // namespace ns3
+
+#endif /* LOGICAL_PROCESS_H */
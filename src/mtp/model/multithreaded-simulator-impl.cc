@@ -0,0 +1,665 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "multithreaded-simulator-impl.h"
+
+#include "ns3/assert.h"
+#include "ns3/channel.h"
+#include "ns3/event-impl.h"
+#include "ns3/log.h"
+#include "ns3/net-device.h"
+#include "ns3/node.h"
+#include "ns3/node-list.h"
+#include "ns3/nstime.h"
+#include "ns3/scheduler.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+#include <map>
+#include <set>
+#include <thread>
+
+/**
+ * \file
+ * \ingroup mtp
+ * ns3::MultithreadedSimulatorImpl implementation.
+ */
+
+namespace ns3 {
+
+// Logging in this file is largely avoided, as in DefaultSimulatorImpl.
+NS_LOG_COMPONENT_DEFINE ("MultithreadedSimulatorImpl");
+
+NS_OBJECT_ENSURE_REGISTERED (MultithreadedSimulatorImpl);
+
+namespace {
+
+/**
+ * The logical process run by the current thread, or null outside of
+ * the time windows.
+ */
+thread_local LogicalProcess *g_currentLp = 0;
+
+} // unnamed namespace
+
+TypeId
+MultithreadedSimulatorImpl::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MultithreadedSimulatorImpl")
+    .SetParent<SimulatorImpl> ()
+    .SetGroupName ("Mtp")
+    .AddConstructor<MultithreadedSimulatorImpl> ()
+    .AddAttribute ("MaxThreads",
+                   "Maximum number of threads running the logical processes; "
+                   "0 to use all the cores.  Without multithreaded "
+                   "simulation support (NS3_MTP), a single thread is used.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&MultithreadedSimulatorImpl::m_maxThreads),
+                   MakeUintegerChecker<uint32_t> ())
+  ;
+  return tid;
+}
+
+MultithreadedSimulatorImpl::MultithreadedSimulatorImpl ()
+  : m_partitioned (false),
+    m_lookahead (UINT64_MAX),
+    m_maxThreads (0),
+    m_stop (false),
+    m_stopTs (UINT64_MAX),
+    m_windowEnd (0),
+    m_round (0),
+    m_nextLp (0),
+    m_completed (0),
+    m_exit (false)
+{
+  NS_LOG_FUNCTION (this);
+  m_main = SystemThread::Self ();
+}
+
+MultithreadedSimulatorImpl::~MultithreadedSimulatorImpl ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+MultithreadedSimulatorImpl::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  StopWorkers ();
+  for (std::size_t i = 0; i < m_lps.size (); ++i)
+    {
+      m_lps[i]->Clear ();
+    }
+  m_lps.clear ();
+  m_lpOfContext.clear ();
+  SimulatorImpl::DoDispose ();
+}
+
+void
+MultithreadedSimulatorImpl::Destroy ()
+{
+  NS_LOG_FUNCTION (this);
+  while (true)
+    {
+      Ptr<EventImpl> ev;
+      {
+        CriticalSection cs (m_destroyEventsMutex);
+        if (m_destroyEvents.empty ())
+          {
+            break;
+          }
+        ev = m_destroyEvents.front ().PeekEventImpl ();
+        m_destroyEvents.pop_front ();
+      }
+      NS_LOG_LOGIC ("handle destroy " << ev);
+      if (!ev->IsCancelled ())
+        {
+          ev->Invoke ();
+        }
+    }
+}
+
+void
+MultithreadedSimulatorImpl::SetScheduler (ObjectFactory schedulerFactory)
+{
+  NS_LOG_FUNCTION (this << schedulerFactory);
+  m_schedulerFactory = schedulerFactory;
+  if (m_lps.empty ())
+    {
+      m_lps.push_back (Create<LogicalProcess> (0, schedulerFactory.Create<Scheduler> ()));
+      return;
+    }
+  for (std::size_t i = 0; i < m_lps.size (); ++i)
+    {
+      m_lps[i]->SetScheduler (schedulerFactory.Create<Scheduler> ());
+    }
+}
+
+// System ID for non-distributed simulation is always zero
+uint32_t
+MultithreadedSimulatorImpl::GetSystemId (void) const
+{
+  return 0;
+}
+
+LogicalProcess *
+MultithreadedSimulatorImpl::GetCurrentLp (void) const
+{
+  if (g_currentLp != 0)
+    {
+      return g_currentLp;
+    }
+  return PeekPointer (m_lps[0]);
+}
+
+LogicalProcess *
+MultithreadedSimulatorImpl::GetLp (uint32_t context) const
+{
+  if (context < m_lpOfContext.size ())
+    {
+      return PeekPointer (m_lps[m_lpOfContext[context]]);
+    }
+  return PeekPointer (m_lps[0]);
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetLogicalProcessCount (void) const
+{
+  return m_lps.size ();
+}
+
+Time
+MultithreadedSimulatorImpl::GetLookahead (void) const
+{
+  if (m_lookahead == UINT64_MAX)
+    {
+      return Time::Max ();
+    }
+  return TimeStep (m_lookahead);
+}
+
+void
+MultithreadedSimulatorImpl::Partition (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_partitioned = true;
+  uint32_t nNodes = NodeList::GetNNodes ();
+  if (nNodes == 0)
+    {
+      return;
+    }
+
+  // Union-find over the nodes: the channels which cannot be cut merge
+  // the sets of their nodes.
+  std::vector<uint32_t> parent (nNodes);
+  for (uint32_t i = 0; i < nNodes; ++i)
+    {
+      parent[i] = i;
+    }
+  auto find = [&parent] (uint32_t i)
+    {
+      while (parent[i] != i)
+        {
+          parent[i] = parent[parent[i]];
+          i = parent[i];
+        }
+      return i;
+    };
+
+  /** A channel between two partitions. */
+  struct Cut
+  {
+    uint32_t a;      //!< The node at one end.
+    uint32_t b;      //!< The node at the other end.
+    uint64_t delay;  //!< The channel delay.
+  };
+  std::vector<Cut> cuts;
+  std::set<uint32_t> channels;
+  for (uint32_t i = 0; i < nNodes; ++i)
+    {
+      Ptr<Node> node = NodeList::GetNode (i);
+      for (uint32_t j = 0; j < node->GetNDevices (); ++j)
+        {
+          Ptr<Channel> channel = node->GetDevice (j)->GetChannel ();
+          if (channel == 0 || !channels.insert (channel->GetId ()).second)
+            {
+              continue;
+            }
+          std::size_t nDevices = channel->GetNDevices ();
+          TimeValue delay;
+          if (nDevices == 2
+              && channel->GetDevice (0)->IsPointToPoint ()
+              && channel->GetDevice (1)->IsPointToPoint ()
+              && channel->GetAttributeFailSafe ("Delay", delay)
+              && delay.Get ().IsStrictlyPositive ())
+            {
+              Cut cut;
+              cut.a = channel->GetDevice (0)->GetNode ()->GetId ();
+              cut.b = channel->GetDevice (1)->GetNode ()->GetId ();
+              cut.delay = delay.Get ().GetTimeStep ();
+              cuts.push_back (cut);
+              continue;
+            }
+          uint32_t root = find (channel->GetDevice (0)->GetNode ()->GetId ());
+          for (std::size_t k = 1; k < nDevices; ++k)
+            {
+              uint32_t other = find (channel->GetDevice (k)->GetNode ()->GetId ());
+              parent[other] = root;
+            }
+        }
+    }
+
+  // One logical process per set, numbered in node order.
+  Ptr<LogicalProcess> global = m_lps[0];
+  std::map<uint32_t, uint32_t> lpOfRoot;
+  m_lpOfContext.resize (nNodes);
+  for (uint32_t i = 0; i < nNodes; ++i)
+    {
+      uint32_t root = find (i);
+      std::map<uint32_t, uint32_t>::const_iterator it = lpOfRoot.find (root);
+      if (it == lpOfRoot.end ())
+        {
+          uint32_t id = m_lps.size ();
+          Ptr<LogicalProcess> lp = Create<LogicalProcess> (id, m_schedulerFactory.Create<Scheduler> ());
+          lp->SetClock (global->GetCurrentTs (), EventId::UID::INVALID, global->GetNextUid ());
+          m_lps.push_back (lp);
+          it = lpOfRoot.insert (std::make_pair (root, id)).first;
+        }
+      m_lpOfContext[i] = it->second;
+    }
+  for (std::vector<Cut>::const_iterator i = cuts.begin (); i != cuts.end (); ++i)
+    {
+      if (find (i->a) != find (i->b))
+        {
+          m_lookahead = std::min (m_lookahead, i->delay);
+        }
+    }
+  NS_LOG_INFO (m_lps.size () - 1 << " logical processes, lookahead " << GetLookahead ());
+
+  // Move the events already scheduled to their logical process.
+  std::vector<Scheduler::Event> events;
+  while (global->GetNextTs () != UINT64_MAX)
+    {
+      events.push_back (global->RemoveNext ());
+    }
+  for (std::vector<Scheduler::Event>::const_iterator i = events.begin (); i != events.end (); ++i)
+    {
+      GetLp (i->key.m_context)->Insert (*i);
+    }
+}
+
+void
+MultithreadedSimulatorImpl::ProcessLps (void)
+{
+  uint32_t n = m_lps.size ();
+  uint32_t i;
+  while ((i = m_nextLp.fetch_add (1, std::memory_order_acq_rel)) < n)
+    {
+      LogicalProcess *lp = PeekPointer (m_lps[i]);
+      g_currentLp = lp;
+      lp->ReceiveMail ();
+      lp->ResetMinSent ();
+      lp->ProcessEvents (m_windowEnd, m_stop);
+      g_currentLp = 0;
+      m_completed.fetch_add (1, std::memory_order_release);
+    }
+}
+
+void
+MultithreadedSimulatorImpl::RunWindow (uint64_t end)
+{
+  m_windowEnd = end;
+  m_completed.store (0, std::memory_order_relaxed);
+  // Publish the window to the worker threads.
+  m_nextLp.store (1, std::memory_order_release);
+  m_round.fetch_add (1, std::memory_order_release);
+  ProcessLps ();
+  while (m_completed.load (std::memory_order_acquire) < m_lps.size () - 1)
+    {
+      std::this_thread::yield ();
+    }
+}
+
+void
+MultithreadedSimulatorImpl::DoWork (void)
+{
+  uint64_t round = m_round.load (std::memory_order_acquire);
+  while (true)
+    {
+      uint64_t next = m_round.load (std::memory_order_acquire);
+      if (next == round)
+        {
+          if (m_exit.load (std::memory_order_acquire))
+            {
+              return;
+            }
+          std::this_thread::yield ();
+          continue;
+        }
+      // If this thread missed a window, the others did its share.
+      round = next;
+      ProcessLps ();
+    }
+}
+
+void
+MultithreadedSimulatorImpl::StartWorkers (uint32_t n)
+{
+  NS_LOG_FUNCTION (this << n);
+  m_exit.store (false, std::memory_order_release);
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      Ptr<SystemThread> worker = Create<SystemThread> (MakeCallback (&MultithreadedSimulatorImpl::DoWork, this));
+      worker->Start ();
+      m_workers.push_back (worker);
+    }
+}
+
+void
+MultithreadedSimulatorImpl::StopWorkers (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_exit.store (true, std::memory_order_release);
+  for (std::size_t i = 0; i < m_workers.size (); ++i)
+    {
+      m_workers[i]->Join ();
+    }
+  m_workers.clear ();
+}
+
+bool
+MultithreadedSimulatorImpl::IsFinished (void) const
+{
+  if (m_stop.load (std::memory_order_relaxed))
+    {
+      return true;
+    }
+  for (std::size_t i = 0; i < m_lps.size (); ++i)
+    {
+      if (!m_lps[i]->IsEmpty ())
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
+void
+MultithreadedSimulatorImpl::Run (void)
+{
+  NS_LOG_FUNCTION (this);
+  // Set the current threadId as the main threadId
+  m_main = SystemThread::Self ();
+  if (!m_partitioned)
+    {
+      Partition ();
+    }
+  m_stop.store (false, std::memory_order_relaxed);
+
+  uint32_t nLps = m_lps.size () - 1;
+  uint32_t threads = m_maxThreads;
+#ifdef NS3_MTP
+  if (threads == 0)
+    {
+      threads = std::max (std::thread::hardware_concurrency (), 1U);
+    }
+#else
+  if (threads > 1)
+    {
+      NS_LOG_WARN ("ns-3 was built without multithreaded simulation support, "
+                   "running on a single thread");
+    }
+  threads = 1;
+#endif
+  threads = std::min (threads, nLps);
+  if (threads > 1)
+    {
+      StartWorkers (threads - 1);
+    }
+
+  LogicalProcess *global = PeekPointer (m_lps[0]);
+  uint64_t endTs = global->GetCurrentTs ();
+  while (!m_stop.load (std::memory_order_relaxed))
+    {
+      global->ReceiveMail ();
+      uint64_t tGlobal = global->GetNextTs ();
+      uint64_t tMin = UINT64_MAX;
+      for (uint32_t i = 1; i < m_lps.size (); ++i)
+        {
+          tMin = std::min (tMin, std::min (m_lps[i]->GetNextTs (), m_lps[i]->GetMinSent ()));
+        }
+      uint64_t stopTs = m_stopTs.load (std::memory_order_relaxed);
+      if (std::min (tGlobal, tMin) >= stopTs)
+        {
+          // Nothing left to run, or reached the stop time.
+          if (stopTs != UINT64_MAX)
+            {
+              endTs = stopTs;
+              m_stopTs.store (UINT64_MAX, std::memory_order_relaxed);
+            }
+          break;
+        }
+      if (tGlobal <= tMin)
+        {
+          // The global events can touch any node: run them alone.
+          for (uint32_t i = 1; i < m_lps.size (); ++i)
+            {
+              m_lps[i]->ReceiveMail ();
+              m_lps[i]->ResetMinSent ();
+            }
+          global->ProcessOneEvent ();
+          continue;
+        }
+      uint64_t end = std::min (tGlobal, stopTs);
+      if (m_lookahead < UINT64_MAX - tMin)
+        {
+          end = std::min (end, tMin + m_lookahead);
+        }
+      RunWindow (end);
+    }
+  StopWorkers ();
+
+  // Leave the clock of the main thread at the latest event.
+  int unscheduledEvents = 0;
+  for (uint32_t i = 0; i < m_lps.size (); ++i)
+    {
+      endTs = std::max (endTs, m_lps[i]->GetCurrentTs ());
+      unscheduledEvents += m_lps[i]->GetUnscheduledEvents ();
+    }
+  global->SetCurrentTs (endTs);
+
+  // If the simulator stopped naturally by lack of events, make a
+  // consistency test to check that we didn't lose any events along the way.
+  NS_ASSERT (!IsFinished () || m_stop || unscheduledEvents == 0);
+}
+
+void
+MultithreadedSimulatorImpl::Stop (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_stop.store (true, std::memory_order_relaxed);
+}
+
+void
+MultithreadedSimulatorImpl::Stop (Time const &delay)
+{
+  NS_LOG_FUNCTION (this << delay.GetTimeStep ());
+  NS_ASSERT_MSG (delay.IsPositive (), "MultithreadedSimulatorImpl::Stop(): Negative delay");
+  uint64_t ts = GetCurrentLp ()->GetCurrentTs () + delay.GetTimeStep ();
+  uint64_t stopTs = m_stopTs.load (std::memory_order_relaxed);
+  while (ts < stopTs
+         && !m_stopTs.compare_exchange_weak (stopTs, ts, std::memory_order_relaxed))
+    {
+    }
+}
+
+//
+// Schedule an event for a _relative_ time in the future.
+//
+EventId
+MultithreadedSimulatorImpl::Schedule (Time const &delay, EventImpl *event)
+{
+  NS_LOG_FUNCTION (this << delay.GetTimeStep () << event);
+  NS_ASSERT_MSG (g_currentLp != 0 || SystemThread::Equals (m_main), "Simulator::Schedule Thread-unsafe invocation!");
+  NS_ASSERT_MSG (delay.IsPositive (), "MultithreadedSimulatorImpl::Schedule(): Negative delay");
+  LogicalProcess *lp = GetCurrentLp ();
+  return lp->Schedule (lp->GetCurrentTs () + delay.GetTimeStep (), lp->GetContext (), event);
+}
+
+void
+MultithreadedSimulatorImpl::ScheduleWithContext (uint32_t context, Time const &delay, EventImpl *event)
+{
+  NS_LOG_FUNCTION (this << context << delay.GetTimeStep () << event);
+  NS_ASSERT_MSG (g_currentLp != 0 || SystemThread::Equals (m_main), "Simulator::ScheduleWithContext Thread-unsafe invocation!");
+  LogicalProcess *current = GetCurrentLp ();
+  LogicalProcess *target = GetLp (context);
+  uint64_t ts = current->GetCurrentTs () + delay.GetTimeStep ();
+  if (target == current || g_currentLp == 0)
+    {
+      // Same logical process, or no window running.
+      target->Schedule (ts, context, event);
+      return;
+    }
+  if (ts < m_windowEnd)
+    {
+      NS_FATAL_ERROR ("Event scheduled in logical process " << target->GetId ()
+                      << " from logical process " << current->GetId ()
+                      << " with a delay of " << delay.As (Time::S)
+                      << ", shorter than the lookahead " << GetLookahead ().As (Time::S));
+    }
+  target->Post (current, ts, context, event);
+}
+
+EventId
+MultithreadedSimulatorImpl::ScheduleNow (EventImpl *event)
+{
+  return Schedule (Time (0), event);
+}
+
+EventId
+MultithreadedSimulatorImpl::ScheduleDestroy (EventImpl *event)
+{
+  EventId id (Ptr<EventImpl> (event, false), GetCurrentLp ()->GetCurrentTs (), 0xffffffff, EventId::UID::DESTROY);
+  CriticalSection cs (m_destroyEventsMutex);
+  m_destroyEvents.push_back (id);
+  return id;
+}
+
+Time
+MultithreadedSimulatorImpl::Now (void) const
+{
+  // Do not add function logging here, to avoid stack overflow
+  return TimeStep (GetCurrentLp ()->GetCurrentTs ());
+}
+
+Time
+MultithreadedSimulatorImpl::GetDelayLeft (const EventId &id) const
+{
+  if (IsExpired (id))
+    {
+      return TimeStep (0);
+    }
+  else
+    {
+      return TimeStep (id.GetTs () - GetCurrentLp ()->GetCurrentTs ());
+    }
+}
+
+void
+MultithreadedSimulatorImpl::Remove (const EventId &id)
+{
+  if (id.GetUid () == EventId::UID::DESTROY)
+    {
+      // destroy events.
+      CriticalSection cs (m_destroyEventsMutex);
+      for (DestroyEvents::iterator i = m_destroyEvents.begin (); i != m_destroyEvents.end (); i++)
+        {
+          if (*i == id)
+            {
+              m_destroyEvents.erase (i);
+              break;
+            }
+        }
+      return;
+    }
+  LogicalProcess *lp = GetLp (id.GetContext ());
+  if (g_currentLp != 0 && lp != g_currentLp)
+    {
+      // The event list of another logical process is in use.
+      Cancel (id);
+      return;
+    }
+  lp->Remove (id);
+}
+
+void
+MultithreadedSimulatorImpl::Cancel (const EventId &id)
+{
+  if (!IsExpired (id))
+    {
+      id.PeekEventImpl ()->Cancel ();
+    }
+}
+
+bool
+MultithreadedSimulatorImpl::IsExpired (const EventId &id) const
+{
+  if (id.GetUid () == EventId::UID::DESTROY)
+    {
+      if (id.PeekEventImpl () == 0
+          || id.PeekEventImpl ()->IsCancelled ())
+        {
+          return true;
+        }
+      // destroy events.
+      CriticalSection cs (m_destroyEventsMutex);
+      for (DestroyEvents::const_iterator i = m_destroyEvents.begin (); i != m_destroyEvents.end (); i++)
+        {
+          if (*i == id)
+            {
+              return false;
+            }
+        }
+      return true;
+    }
+  return GetLp (id.GetContext ())->IsExpired (id);
+}
+
+Time
+MultithreadedSimulatorImpl::GetMaximumSimulationTime (void) const
+{
+  return TimeStep (0x7fffffffffffffffLL);
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetContext (void) const
+{
+  return GetCurrentLp ()->GetContext ();
+}
+
+uint64_t
+MultithreadedSimulatorImpl::GetEventCount (void) const
+{
+  uint64_t count = 0;
+  for (std::size_t i = 0; i < m_lps.size (); ++i)
+    {
+      count += m_lps[i]->GetEventCount ();
+    }
+  return count;
+}
+
+} // namespace ns3
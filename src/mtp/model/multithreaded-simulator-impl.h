@@ -0,0 +1,213 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MULTITHREADED_SIMULATOR_IMPL_H
+#define MULTITHREADED_SIMULATOR_IMPL_H
+
+#include "logical-process.h"
+
+#include "ns3/object-factory.h"
+#include "ns3/simulator-impl.h"
+#include "ns3/system-mutex.h"
+#include "ns3/system-thread.h"
+
+#include <atomic>
+#include <list>
+#include <stdint.h>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup mtp
+ * ns3::MultithreadedSimulatorImpl declaration.
+ */
+
+namespace ns3 {
+
+/**
+ * \defgroup mtp Multithreaded Parallel Simulation
+ *
+ * Conservative parallel simulation on the cores of a single machine.
+ */
+
+/**
+ * \ingroup mtp
+ * \ingroup simulator
+ *
+ * \brief A conservative parallel simulator implementation running on
+ * several threads of a single process.
+ *
+ * At the first Run(), the nodes are partitioned in logical processes:
+ * two nodes connected by a channel end up in the same logical process,
+ * unless the channel is a point to point channel (two devices for
+ * which NetDevice::IsPointToPoint() is \c true) with a positive
+ * "Delay" attribute.  The smallest such delay between two logical
+ * processes is the lookahead.  The events are assigned to logical
+ * processes by context, i.e. by node id; events without context, or
+ * whose context is not a node, belong to a global logical process.
+ *
+ * The simulation then proceeds in rounds.  If the next global event is
+ * not later than the next event of every other logical process, it is
+ * run alone on the main thread, and it can touch any node.  Otherwise
+ * all the logical processes run their events up to the end of a time
+ * window, the earliest next event plus the lookahead, in parallel on
+ * the worker threads.  Events scheduled in another logical process
+ * during a window are posted to its lock-free mailbox, and they are
+ * necessarily beyond the window end: that is what the lookahead
+ * guarantees.
+ *
+ * Models only need to be thread-safe across logical processes: nodes
+ * of different logical processes should not share state, except
+ * through the point to point channels described above.  Scheduling an
+ * event in another logical process with a delay shorter than the
+ * lookahead is a fatal error.
+ *
+ * The results do not depend on the number of threads.  They are the
+ * same as with DefaultSimulatorImpl, except for the relative order of
+ * events of different logical processes with the same time stamp.
+ *
+ * Worker threads are only started when ns-3 is built with
+ * multithreaded simulation support (`NS3_MTP`), which also makes the
+ * reference counts of packets and events atomic.  Otherwise the
+ * logical processes run one after the other on the main thread.
+ *
+ * Other differences with DefaultSimulatorImpl:
+ *  - Simulator::Stop() lets the other logical processes finish the
+ *    current window;
+ *  - Simulator::Stop(delay) stops before the events at the stop time;
+ *  - Simulator::Remove() of an event of another logical process during
+ *    a window only cancels it;
+ *  - events can only be scheduled from the simulation threads.
+ */
+class MultithreadedSimulatorImpl : public SimulatorImpl
+{
+public:
+  /**
+   *  Register this type.
+   *  \return The object TypeId.
+   */
+  static TypeId GetTypeId (void);
+
+  /** Constructor. */
+  MultithreadedSimulatorImpl ();
+  /** Destructor. */
+  ~MultithreadedSimulatorImpl ();
+
+  // Inherited
+  virtual void Destroy ();
+  virtual bool IsFinished (void) const;
+  virtual void Stop (void);
+  virtual void Stop (const Time &delay);
+  virtual EventId Schedule (const Time &delay, EventImpl *event);
+  virtual void ScheduleWithContext (uint32_t context, const Time &delay, EventImpl *event);
+  virtual EventId ScheduleNow (EventImpl *event);
+  virtual EventId ScheduleDestroy (EventImpl *event);
+  virtual void Remove (const EventId &id);
+  virtual void Cancel (const EventId &id);
+  virtual bool IsExpired (const EventId &id) const;
+  virtual void Run (void);
+  virtual Time Now (void) const;
+  virtual Time GetDelayLeft (const EventId &id) const;
+  virtual Time GetMaximumSimulationTime (void) const;
+  virtual void SetScheduler (ObjectFactory schedulerFactory);
+  virtual uint32_t GetSystemId (void) const;
+  virtual uint32_t GetContext (void) const;
+  virtual uint64_t GetEventCount (void) const;
+
+  /** \returns The number of logical processes, including the global one. */
+  uint32_t GetLogicalProcessCount (void) const;
+  /** \returns The lookahead between logical processes. */
+  Time GetLookahead (void) const;
+
+private:
+  virtual void DoDispose (void);
+
+  /** \returns The logical process of the calling thread. */
+  LogicalProcess *GetCurrentLp (void) const;
+  /**
+   * \param [in] context An event context.
+   * \returns The logical process which owns the events of \pname{context}.
+   */
+  LogicalProcess *GetLp (uint32_t context) const;
+  /**
+   * Partition the nodes in logical processes, and move their events
+   * from the global logical process.
+   */
+  void Partition (void);
+  /**
+   * Run all the logical processes up to a time stamp.
+   *
+   * \param [in] end The end of the time window.
+   */
+  void RunWindow (uint64_t end);
+  /** Run the logical processes not taken by another thread yet. */
+  void ProcessLps (void);
+  /** Worker thread body. */
+  void DoWork (void);
+  /**
+   * Start the worker threads.
+   *
+   * \param [in] n The number of worker threads.
+   */
+  void StartWorkers (uint32_t n);
+  /** Stop the worker threads. */
+  void StopWorkers (void);
+
+  /** The logical processes; the first one is the global one. */
+  std::vector<Ptr<LogicalProcess> > m_lps;
+  /** Index of the logical process of each context. */
+  std::vector<uint32_t> m_lpOfContext;
+  /** Flag \c true once the nodes have been partitioned. */
+  bool m_partitioned;
+  /** The lookahead, in time steps, or \c UINT64_MAX if unbounded. */
+  uint64_t m_lookahead;
+  /** The scheduler factory, to create the event lists. */
+  ObjectFactory m_schedulerFactory;
+  /** Maximum number of threads, or zero to use all the cores. */
+  uint32_t m_maxThreads;
+
+  /** Container type for the events to run at Simulator::Destroy() */
+  typedef std::list<EventId> DestroyEvents;
+  /** The container of events to run at Destroy. */
+  DestroyEvents m_destroyEvents;
+  /** Mutex protecting m_destroyEvents. */
+  mutable SystemMutex m_destroyEventsMutex;
+
+  /** Flag calling for the end of the simulation. */
+  std::atomic<bool> m_stop;
+  /** Time stamp at which to stop the simulation, or \c UINT64_MAX. */
+  std::atomic<uint64_t> m_stopTs;
+  /** End of the current time window. */
+  uint64_t m_windowEnd;
+
+  /** The worker threads. */
+  std::vector<Ptr<SystemThread> > m_workers;
+  /** Incremented to start a new window on the worker threads. */
+  std::atomic<uint64_t> m_round;
+  /** Index of the next logical process to run in the current window. */
+  std::atomic<uint32_t> m_nextLp;
+  /** Number of logical processes done with the current window. */
+  std::atomic<uint32_t> m_completed;
+  /** Flag calling for the worker threads to exit. */
+  std::atomic<bool> m_exit;
+
+  /** Main execution thread. */
+  SystemThread::ThreadId m_main;
+};
+
+} // namespace ns3
+
+#endif /* MULTITHREADED_SIMULATOR_IMPL_H */
@@ -0,0 +1,263 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/config.h"
+#include "ns3/boolean.h"
+#include "ns3/data-rate.h"
+#include "ns3/mac48-address.h"
+#include "ns3/multithreaded-simulator-impl.h"
+#include "ns3/node.h"
+#include "ns3/nstime.h"
+#include "ns3/packet.h"
+#include "ns3/simple-channel.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+
+#include <sstream>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup mtp-tests
+ * MultithreadedSimulatorImpl test suite.
+ */
+
+/**
+ * \ingroup mtp
+ * \defgroup mtp-tests Multithreaded simulation tests
+ */
+
+using namespace ns3;
+
+/**
+ * \ingroup mtp-tests
+ *
+ * Forward packets between nodes and check that the multithreaded
+ * simulator gives the same results as the default simulator.
+ *
+ * Nodes 0 to 5 form a line of point to point links, and nodes 4, 5 and
+ * 6 also share a broadcast channel, so there are five logical
+ * processes besides the global one: {0}, {1}, {2}, {3} and {4, 5, 6}.
+ * Each packet received on a point to point link is forwarded, one byte
+ * shorter, on the next device of the node.
+ */
+class MtpForwardingTestCase : public TestCase
+{
+public:
+  /** Constructor. */
+  MtpForwardingTestCase ();
+
+private:
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+
+  /**
+   * Run the scenario.
+   *
+   * \param [in] simulatorType The simulator implementation.
+   * \param [in] maxThreads The MultithreadedSimulatorImpl::MaxThreads attribute.
+   * \returns The receive log of each node.
+   */
+  std::vector<std::string> RunScenario (std::string simulatorType, uint32_t maxThreads);
+  /**
+   * Create a channel between nodes.
+   *
+   * \param [in] nodes The nodes to connect.
+   * \param [in] pointToPoint Flag \c true for a point to point channel.
+   */
+  void Connect (std::vector<Ptr<Node> > nodes, bool pointToPoint);
+  /**
+   * Device receive callback.
+   *
+   * \param [in] device The receiving device.
+   * \param [in] packet The packet.
+   * \param [in] protocol The protocol number.
+   * \param [in] from The sender address.
+   * \returns \c true
+   */
+  bool Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol, const Address &from);
+  /**
+   * Send a packet.
+   *
+   * \param [in] device The device.
+   * \param [in] size The packet size.
+   */
+  void Send (Ptr<NetDevice> device, uint32_t size);
+  /** Event which must never run. */
+  void Fail (void);
+
+  /** Receive log of each node. */
+  std::vector<std::ostringstream> m_logs;
+  /** Number of Fail() events run. */
+  uint32_t m_failed;
+  /** Flag \c true once the destroy event has run. */
+  bool m_destroyed;
+};
+
+MtpForwardingTestCase::MtpForwardingTestCase ()
+  : TestCase ("Check packet forwarding across logical processes")
+{}
+
+void
+MtpForwardingTestCase::Connect (std::vector<Ptr<Node> > nodes, bool pointToPoint)
+{
+  Ptr<SimpleChannel> channel = CreateObject<SimpleChannel> ();
+  channel->SetAttribute ("Delay", TimeValue (MilliSeconds (2)));
+  for (std::size_t i = 0; i < nodes.size (); ++i)
+    {
+      Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice> ();
+      device->SetAttribute ("PointToPointMode", BooleanValue (pointToPoint));
+      device->SetAttribute ("DataRate", DataRateValue (DataRate ("1Mbps")));
+      device->SetAddress (Mac48Address::Allocate ());
+      device->SetChannel (channel);
+      nodes[i]->AddDevice (device);
+      device->SetReceiveCallback (MakeCallback (&MtpForwardingTestCase::Receive, this));
+    }
+}
+
+bool
+MtpForwardingTestCase::Receive (Ptr<NetDevice> device, Ptr<const Packet> packet,
+                                uint16_t protocol, const Address &from)
+{
+  Ptr<Node> node = device->GetNode ();
+  m_logs[node->GetId ()] << Simulator::Now ().GetNanoSeconds ()
+                         << " dev " << device->GetIfIndex ()
+                         << " size " << packet->GetSize () << "\n";
+  NS_TEST_EXPECT_MSG_EQ (Simulator::GetContext (), node->GetId (), "Wrong context");
+  if (device->IsPointToPoint () && packet->GetSize () > 20)
+    {
+      uint32_t next = (device->GetIfIndex () + 1) % node->GetNDevices ();
+      Send (node->GetDevice (next), packet->GetSize () - 1);
+    }
+  return true;
+}
+
+void
+MtpForwardingTestCase::Send (Ptr<NetDevice> device, uint32_t size)
+{
+  device->Send (Create<Packet> (size), device->GetBroadcast (), 0x800);
+  // Scheduled and removed in the logical process of the device.
+  EventId id = Simulator::Schedule (MicroSeconds (500), &MtpForwardingTestCase::Fail, this);
+  Simulator::Remove (id);
+}
+
+void
+MtpForwardingTestCase::Fail (void)
+{
+  m_failed++;
+}
+
+std::vector<std::string>
+MtpForwardingTestCase::RunScenario (std::string simulatorType, uint32_t maxThreads)
+{
+  Config::SetGlobal ("SimulatorImplementationType", StringValue (simulatorType));
+  Config::SetDefault ("ns3::MultithreadedSimulatorImpl::MaxThreads", UintegerValue (maxThreads));
+  m_failed = 0;
+  m_destroyed = false;
+  m_logs = std::vector<std::ostringstream> (7);
+
+  std::vector<Ptr<Node> > nodes;
+  for (uint32_t i = 0; i < 7; ++i)
+    {
+      nodes.push_back (CreateObject<Node> ());
+    }
+  for (uint32_t i = 0; i < 5; ++i)
+    {
+      Connect ({nodes[i], nodes[i + 1]}, true);
+    }
+  Connect ({nodes[4], nodes[5], nodes[6]}, false);
+
+  for (uint32_t i = 0; i < 4; ++i)
+    {
+      Simulator::ScheduleWithContext (i, MilliSeconds (1 + i), &MtpForwardingTestCase::Send,
+                                      this, nodes[i]->GetDevice (0), 40 + i);
+    }
+  // A global event sending from a node.
+  Simulator::Schedule (MilliSeconds (7), &MtpForwardingTestCase::Send,
+                       this, nodes[2]->GetDevice (1), 30);
+  EventId cancelled = Simulator::Schedule (MilliSeconds (8), &MtpForwardingTestCase::Fail, this);
+  Simulator::Cancel (cancelled);
+  Simulator::ScheduleDestroy ([this] () { m_destroyed = true; });
+  Simulator::Stop (MilliSeconds (60));
+  Simulator::Run ();
+
+  NS_TEST_EXPECT_MSG_EQ (Simulator::Now (), MilliSeconds (60), "Wrong stop time");
+  NS_TEST_EXPECT_MSG_EQ (m_failed, 0, "Removed events have run");
+  Ptr<MultithreadedSimulatorImpl> impl = DynamicCast<MultithreadedSimulatorImpl> (Simulator::GetImplementation ());
+  if (impl != 0)
+    {
+      NS_TEST_EXPECT_MSG_EQ (impl->GetLogicalProcessCount (), 6, "Wrong partition");
+      NS_TEST_EXPECT_MSG_EQ (impl->GetLookahead (), MilliSeconds (2), "Wrong lookahead");
+    }
+  Simulator::Destroy ();
+  NS_TEST_EXPECT_MSG_EQ (m_destroyed, true, "Destroy event has not run");
+
+  std::vector<std::string> logs;
+  for (std::size_t i = 0; i < m_logs.size (); ++i)
+    {
+      logs.push_back (m_logs[i].str ());
+    }
+  return logs;
+}
+
+void
+MtpForwardingTestCase::DoRun (void)
+{
+  std::vector<std::string> expected = RunScenario ("ns3::DefaultSimulatorImpl", 0);
+  for (std::size_t i = 0; i < expected.size (); ++i)
+    {
+      NS_TEST_ASSERT_MSG_NE (expected[i], "", "Node " << i << " has received nothing");
+    }
+  for (uint32_t threads = 1; threads <= 4; threads += 3)
+    {
+      std::vector<std::string> logs = RunScenario ("ns3::MultithreadedSimulatorImpl", threads);
+      for (std::size_t i = 0; i < expected.size (); ++i)
+        {
+          NS_TEST_EXPECT_MSG_EQ (logs[i], expected[i],
+                                 "Node " << i << " differs with " << threads << " threads");
+        }
+    }
+}
+
+void
+MtpForwardingTestCase::DoTeardown (void)
+{
+  Config::SetGlobal ("SimulatorImplementationType", StringValue ("ns3::DefaultSimulatorImpl"));
+  Config::SetDefault ("ns3::MultithreadedSimulatorImpl::MaxThreads", UintegerValue (0));
+}
+
+/**
+ * \ingroup mtp-tests
+ *
+ * MultithreadedSimulatorImpl test suite.
+ */
+class MtpTestSuite : public TestSuite
+{
+public:
+  /** Constructor. */
+  MtpTestSuite ();
+};
+
+MtpTestSuite::MtpTestSuite ()
+  : TestSuite ("mtp", UNIT)
+{
+  AddTestCase (new MtpForwardingTestCase, TestCase::QUICK);
+}
+
+static MtpTestSuite g_mtpTestSuite; //!< Static variable for test initialization
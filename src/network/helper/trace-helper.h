@@ -97,6 +97,11 @@ public:
 
   /**
    * @brief Create and initialize a pcap file.
+   *
+   * The format and the writing of the file follow the attributes of
+   * ns3::PcapFileWrapper, e.g. Config::SetDefault
+   * ("ns3::PcapFileWrapper::BufferSize", UintegerValue (1 << 20)) has all
+   * the pcap traces written in batches by a background thread.
    * 
    * @param filename file name
    * @param filemode file mode
@@ -18,6 +18,7 @@
  * Author: Mathieu Lacage <mathieu.lacage@sophia.inria.fr>
  */
 #include "buffer.h"
+#include "packet-allocator.h"
 #include "ns3/assert.h"
 #include "ns3/log.h"
 
@@ -50,7 +51,11 @@ namespace ns3 {
 NS_LOG_COMPONENT_DEFINE ("Buffer");
 
 
+#ifdef NS3_MTP
+thread_local uint32_t Buffer::g_recommendedStart = 0;
+#else
 uint32_t Buffer::g_recommendedStart = 0;
+#endif
 #ifdef BUFFER_FREE_LIST
 /* The following macros are pretty evil but they are needed to allow us to
  * keep track of 3 possible states for the g_freeList variable:
@@ -99,8 +104,14 @@ Buffer::Recycle (struct Buffer::Data *data)
 {
   NS_LOG_FUNCTION (data);
   NS_ASSERT (data->m_count == 0);
-  NS_ASSERT (!IS_UNINITIALIZED (g_freeList));
   g_maxSize = std::max (g_maxSize, data->m_size);
+  if (PacketAllocator::IsEnabled ())
+    {
+      // The packet arena replaces the free list.
+      Buffer::Deallocate (data);
+      return;
+    }
+  NS_ASSERT (!IS_UNINITIALIZED (g_freeList));
   /* feed into free list */
   if (data->m_size < g_maxSize ||
       IS_DESTROYED (g_freeList) ||
@@ -119,6 +130,12 @@ Buffer::Data *
 Buffer::Create (uint32_t dataSize)
 {
   NS_LOG_FUNCTION (dataSize);
+  if (PacketAllocator::IsEnabled ())
+    {
+      // Like the buffers of the free list, leave room for the
+      // largest buffer seen so far.
+      return Buffer::Allocate (std::max (dataSize, g_maxSize));
+    }
   /* try to find a buffer correctly sized. */
   if (IS_UNINITIALIZED (g_freeList))
     {
@@ -169,8 +186,8 @@ Buffer::Allocate (uint32_t reqSize)
     }
   NS_ASSERT (reqSize >= 1);
   uint32_t size = reqSize - 1 + sizeof (struct Buffer::Data);
-  uint8_t *b = new uint8_t [size];
-  struct Buffer::Data *data = reinterpret_cast<struct Buffer::Data*>(b);
+  void *b = PacketAllocator::Allocate (size);
+  struct Buffer::Data *data = static_cast<struct Buffer::Data*>(b);
   data->m_size = reqSize;
   data->m_count = 1;
   return data;
@@ -181,8 +198,7 @@ Buffer::Deallocate (struct Buffer::Data *data)
 {
   NS_LOG_FUNCTION (data);
   NS_ASSERT (data->m_count == 0);
-  uint8_t *buf = reinterpret_cast<uint8_t *> (data);
-  delete [] buf;
+  PacketAllocator::Deallocate (data, data->m_size - 1 + sizeof (struct Buffer::Data));
 }
 
 Buffer::Buffer ()
@@ -262,8 +278,7 @@ Buffer::operator = (Buffer const&o)
   if (m_data != o.m_data) 
     {
       // not assignment to self.
-      m_data->m_count--;
-      if (m_data->m_count == 0) 
+      if (--m_data->m_count == 0) 
         {
           Recycle (m_data);
         }
@@ -285,8 +300,7 @@ Buffer::~Buffer ()
   NS_LOG_FUNCTION (this);
   NS_ASSERT (CheckInternalState ());
   g_recommendedStart = std::max (g_recommendedStart, m_maxZeroAreaStart);
-  m_data->m_count--;
-  if (m_data->m_count == 0) 
+  if (--m_data->m_count == 0) 
     {
       Recycle (m_data);
     }
@@ -310,7 +324,12 @@ Buffer::AddAtStart (uint32_t start)
 {
   NS_LOG_FUNCTION (this << start);
   NS_ASSERT (CheckInternalState ());
+#ifdef NS3_MTP
+  // Other references may be extending the data from other threads.
+  bool isDirty = m_data->m_count > 1;
+#else
   bool isDirty = m_data->m_count > 1 && m_start > m_data->m_dirtyStart;
+#endif
   if (m_start >= start && !isDirty)
     {
       /* enough space in the buffer and not dirty. 
@@ -328,8 +347,7 @@ Buffer::AddAtStart (uint32_t start)
       uint32_t newSize = GetInternalSize () + start;
       struct Buffer::Data *newData = Buffer::Create (newSize);
       memcpy (newData->m_data + start, m_data->m_data + m_start, GetInternalSize ());
-      m_data->m_count--;
-      if (m_data->m_count == 0)
+      if (--m_data->m_count == 0)
         {
           Buffer::Recycle (m_data);
         }
@@ -355,7 +373,12 @@ Buffer::AddAtEnd (uint32_t end)
 {
   NS_LOG_FUNCTION (this << end);
   NS_ASSERT (CheckInternalState ());
+#ifdef NS3_MTP
+  // Other references may be extending the data from other threads.
+  bool isDirty = m_data->m_count > 1;
+#else
   bool isDirty = m_data->m_count > 1 && m_end < m_data->m_dirtyEnd;
+#endif
   if (GetInternalEnd () + end <= m_data->m_size && !isDirty)
     {
       /* enough space in buffer and not dirty
@@ -373,8 +396,7 @@ Buffer::AddAtEnd (uint32_t end)
       uint32_t newSize = GetInternalSize () + end;
       struct Buffer::Data *newData = Buffer::Create (newSize);
       memcpy (newData->m_data, m_data->m_data + m_start, GetInternalSize ());
-      m_data->m_count--;
-      if (m_data->m_count == 0) 
+      if (--m_data->m_count == 0) 
         {
           Buffer::Recycle (m_data);
         }
@@ -401,6 +423,13 @@ Buffer::AddAtEnd (const Buffer &o)
 {
   NS_LOG_FUNCTION (this << &o);
 
+  if (&o == this)
+    {
+      Buffer copy = o;
+      AddAtEnd (copy);
+      return;
+    }
+
   if (m_data->m_count == 1 &&
       (m_end == m_zeroAreaEnd || m_zeroAreaStart == m_zeroAreaEnd) &&
       m_end == m_data->m_dirtyEnd &&
@@ -431,11 +460,44 @@ Buffer::AddAtEnd (const Buffer &o)
       return;
     }
 
-  *this = CreateFullCopy ();
+  /**
+   * Otherwise, only one of the two zero areas can stay virtual: keep the
+   * larger one, and write the bytes of the other one.
+   */
+  uint32_t zeroSize = m_zeroAreaEnd - m_zeroAreaStart;
+  uint32_t oZeroSize = o.m_zeroAreaEnd - o.m_zeroAreaStart;
+  uint32_t oDataStart = o.m_zeroAreaStart - o.m_start;
+  uint32_t oDataEnd = o.m_end - o.m_zeroAreaEnd;
+  if (oZeroSize > zeroSize)
+    {
+      /* Keep the zero area of o
+       * Before: |**000*| + |**00000**|
+       * After:  |*******00000**|
+       */
+      Buffer tmp (oZeroSize);
+      tmp.AddAtStart (GetSize () + oDataStart);
+      Buffer::Iterator i = tmp.Begin ();
+      i.Write (Begin (), End ());
+      i.Write (o.m_data->m_data + o.m_start, oDataStart);
+      tmp.AddAtEnd (oDataEnd);
+      i = tmp.End ();
+      i.Prev (oDataEnd);
+      i.Write (o.m_data->m_data + o.m_zeroAreaStart, oDataEnd);
+      *this = tmp;
+      NS_ASSERT (CheckInternalState ());
+      return;
+    }
+
+  /* Keep our zero area
+   * Before: |**00000**| + |**000*|
+   * After:  |**00000********|
+   */
   AddAtEnd (o.GetSize ());
-  Buffer::Iterator destStart = End ();
-  destStart.Prev (o.GetSize ());
-  destStart.Write (o.Begin (), o.End ());
+  Buffer::Iterator i = End ();
+  i.Prev (o.GetSize ());
+  i.Write (o.m_data->m_data + o.m_start, oDataStart);
+  i.WriteU8 (0, oZeroSize);
+  i.Write (o.m_data->m_data + o.m_zeroAreaStart, oDataEnd);
   NS_ASSERT (CheckInternalState ());
 }
 
@@ -844,25 +906,36 @@ Buffer::Iterator::Write (Iterator start, Iterator end)
   uint32_t size = end.m_current - start.m_current;
   NS_ASSERT_MSG (CheckNoZero (m_current, m_current + size),
                  GetWriteErrorMessage ());
+  // the destination is either before or after the zero area
+  uint8_t *to;
+  if (m_current <= m_zeroStart)
+    {
+      to = &m_data[m_current];
+    }
+  else
+    {
+      to = &m_data[m_current - (m_zeroEnd - m_zeroStart)];
+    }
   if (start.m_current <= start.m_zeroStart)
     {
       uint32_t toCopy = std::min (size, start.m_zeroStart - start.m_current);
-      memcpy (&m_data[m_current], &start.m_data[start.m_current], toCopy);
+      memcpy (to, &start.m_data[start.m_current], toCopy);
       start.m_current += toCopy;
+      to += toCopy;
       m_current += toCopy;
       size -= toCopy;
     }
   if (start.m_current <= start.m_zeroEnd)
     {
       uint32_t toCopy = std::min (size, start.m_zeroEnd - start.m_current);
-      memset (&m_data[m_current], 0, toCopy);
+      memset (to, 0, toCopy);
       start.m_current += toCopy;
+      to += toCopy;
       m_current += toCopy;
       size -= toCopy;
     }
   uint32_t toCopy = std::min (size, start.m_dataEnd - start.m_current);
   uint8_t *from = &start.m_data[start.m_current - (start.m_zeroEnd-start.m_zeroStart)];
-  uint8_t *to = &m_data[m_current];
   memcpy (to, from, toCopy);
   m_current += toCopy;
 }
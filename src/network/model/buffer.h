@@ -24,8 +24,15 @@
 #include <vector>
 #include <ostream>
 #include "ns3/assert.h"
+#ifdef NS3_MTP
+#include <atomic>
+#endif
 
+// The free list is shared by all Buffers: it is only used when the
+// buffers cannot be used from multiple threads.
+#ifndef NS3_MTP
 #define BUFFER_FREE_LIST 1
+#endif
 
 namespace ns3 {
 
@@ -527,6 +534,10 @@ private:
    * Add bytes at the end of the Buffer.
    * Any call to this method invalidates any Iterator
    * pointing to this Buffer.
+   *
+   * A Buffer has a single zero area: when both buffers have one, the
+   * larger zero area stays virtual, and the other one is written as
+   * real bytes.
    */
   void AddAtEnd (const Buffer &o);
   /**
@@ -663,7 +674,11 @@ private:
      * The reference count of an instance of this data structure.
      * Each buffer which references an instance holds a count.
      */
+#ifdef NS3_MTP
+    std::atomic<uint32_t> m_count;
+#else
     uint32_t m_count;
+#endif
     /**
      * the size of the m_data field below.
      */
@@ -767,7 +782,11 @@ private:
    * writing data. i.e., m_start should be initialized to this 
    * value.
    */
+#ifdef NS3_MTP
+  static thread_local uint32_t g_recommendedStart;
+#else
   static uint32_t g_recommendedStart;
+#endif
 
   /**
    * offset to the start of the virtual zero area from the start
@@ -18,12 +18,19 @@
  * Author: Mathieu Lacage <mathieu.lacage@sophia.inria.fr>
  */
 #include "byte-tag-list.h"
+#include "packet-allocator.h"
 #include "ns3/log.h"
 #include <vector>
 #include <cstring>
 #include <limits>
+#ifdef NS3_MTP
+#include <atomic>
+#endif
 
+#ifndef NS3_MTP
+// The free list is shared by all threads.
 #define USE_FREE_LIST 1
+#endif
 #define FREE_LIST_SIZE 1000
 #define OFFSET_MAX (std::numeric_limits<int32_t>::max ())
 
@@ -40,7 +47,11 @@ NS_LOG_COMPONENT_DEFINE ("ByteTagList");
  */
 struct ByteTagListData {
   uint32_t size;   //!< size of the data
+#ifdef NS3_MTP
+  std::atomic<uint32_t> count;  //!< use counter (for smart deallocation)
+#else
   uint32_t count;  //!< use counter (for smart deallocation)
+#endif
   uint32_t dirty;  //!< number of bytes actually in use
   uint8_t data[4]; //!< data
 };
@@ -199,8 +210,14 @@ ByteTagList::Add (TypeId tid, uint32_t bufferSize, int32_t start, int32_t end)
       m_data = Allocate (spaceNeeded);
       m_used = 0;
     } 
+#ifdef NS3_MTP
+  // Other references may be appending to the data from other threads.
+  else if (m_data->size < spaceNeeded ||
+           m_data->count != 1)
+#else
   else if (m_data->size < spaceNeeded ||
            (m_data->count != 1 && m_data->dirty != m_used))
+#endif
     {
       struct ByteTagListData *newData = Allocate (spaceNeeded);
       std::memcpy (&newData->data, &m_data->data, m_used);
@@ -345,6 +362,19 @@ struct ByteTagListData *
 ByteTagList::Allocate (uint32_t size)
 {
   NS_LOG_FUNCTION (this << size);
+  if (PacketAllocator::IsEnabled ())
+    {
+      // The packet arena replaces the free list.  Like the blocks of
+      // the free list, leave room for the largest list seen so far.
+      std::size_t bytes = PacketAllocator::GetUsableSize (std::max (size, g_maxSize)
+                                                          + sizeof (struct ByteTagListData) - 4);
+      void *buffer = PacketAllocator::Allocate (bytes);
+      struct ByteTagListData *data = static_cast<struct ByteTagListData *> (buffer);
+      data->count = 1;
+      data->size = bytes - (sizeof (struct ByteTagListData) - 4);
+      data->dirty = 0;
+      return data;
+    }
   while (!g_freeList.empty ())
     {
       struct ByteTagListData *data = g_freeList.back ();
@@ -376,8 +406,15 @@ ByteTagList::Deallocate (struct ByteTagListData *data)
       return;
     }
   g_maxSize = std::max (g_maxSize, data->size);
-  data->count--;
-  if (data->count == 0)
+  if (PacketAllocator::IsEnabled ())
+    {
+      if (--data->count == 0)
+        {
+          PacketAllocator::Deallocate (data, data->size + sizeof (struct ByteTagListData) - 4);
+        }
+      return;
+    }
+  if (--data->count == 0)
     {
       if (g_freeList.size () > FREE_LIST_SIZE ||
           data->size < g_maxSize)
@@ -398,10 +435,11 @@ struct ByteTagListData *
 ByteTagList::Allocate (uint32_t size)
 {
   NS_LOG_FUNCTION (this << size);
-  uint8_t *buffer = new uint8_t [size + sizeof (struct ByteTagListData) - 4];
-  struct ByteTagListData *data = (struct ByteTagListData *)buffer;
+  std::size_t bytes = PacketAllocator::GetUsableSize (size + sizeof (struct ByteTagListData) - 4);
+  void *buffer = PacketAllocator::Allocate (bytes);
+  struct ByteTagListData *data = static_cast<struct ByteTagListData *> (buffer);
   data->count = 1;
-  data->size = size;
+  data->size = bytes - (sizeof (struct ByteTagListData) - 4);
   data->dirty = 0;
   return data;
 }
@@ -414,11 +452,9 @@ ByteTagList::Deallocate (struct ByteTagListData *data)
     {
       return;
     }
-  data->count--;
-  if (data->count == 0)
+  if (--data->count == 0)
     {
-      uint8_t *buffer = (uint8_t *)data;
-      delete [] buffer;
+      PacketAllocator::Deallocate (data, data->size + sizeof (struct ByteTagListData) - 4);
     }
 }
 
@@ -0,0 +1,240 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "packet-allocator.h"
+#include "ns3/boolean.h"
+#include "ns3/global-value.h"
+#include "ns3/log.h"
+
+#include <atomic>
+#include <new>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("PacketAllocator");
+
+/**
+ * \ingroup packet
+ * \anchor GlobalValuePacketArena
+ * Enable the packet arena.
+ *
+ * This is accessible as "--PacketArena" from CommandLine.
+ */
+static GlobalValue g_packetArena ("PacketArena",
+                                  "Allocate the packets from per-thread slabs",
+                                  BooleanValue (false),
+                                  MakeBooleanChecker ());
+
+namespace {
+
+/** Granularity of the small size classes, in bytes. */
+const std::size_t SMALL_STEP = 16;
+/** Largest small size class, in bytes. */
+const std::size_t SMALL_MAX = 256;
+/** Granularity of the large size classes, in bytes. */
+const std::size_t LARGE_STEP = 256;
+/** Largest size class, in bytes. */
+const std::size_t LARGE_MAX = 4096;
+/** Number of size classes. */
+const std::size_t SIZE_CLASSES = SMALL_MAX / SMALL_STEP + (LARGE_MAX - SMALL_MAX) / LARGE_STEP;
+/** Number of blocks of the first slab of a size class. */
+const uint32_t MIN_SLAB_BLOCKS = 8;
+/** Maximum size of a slab, in bytes. */
+const std::size_t MAX_SLAB_SIZE = 1 << 18;
+
+/** A released block, linked into its free list. */
+struct FreeBlock
+{
+  FreeBlock *next; //!< Next released block of the same size class.
+};
+
+/**
+ * Per-thread slabs and free lists.
+ *
+ * This is a trivially destructible aggregate so that it can be used
+ * safely at any time during thread and process teardown.
+ */
+struct Arena
+{
+  FreeBlock *head[SIZE_CLASSES];        //!< Free list heads.
+  uint8_t *next[SIZE_CLASSES];          //!< Next unused block of the current slab.
+  uint8_t *end[SIZE_CLASSES];           //!< End of the current slab.
+  uint32_t slabBlocks[SIZE_CLASSES];    //!< Number of blocks of the last slab.
+  PacketAllocator::Stats stats;         //!< Statistics.
+};
+
+/** The arena of the current thread. */
+thread_local Arena g_arena;
+
+/** Arena state: 0 until the first allocation, then 1 if disabled, 2 if enabled. */
+std::atomic<int> g_state (0);
+
+/**
+ * \param [in] size An allocation size.
+ * \returns The size class of \pname{size}, or SIZE_CLASSES if it is
+ *          too large for the arena.
+ */
+inline std::size_t
+SizeClass (std::size_t size)
+{
+  if (size <= SMALL_MAX)
+    {
+      return size == 0 ? 0 : (size - 1) / SMALL_STEP;
+    }
+  if (size <= LARGE_MAX)
+    {
+      return SMALL_MAX / SMALL_STEP + (size - SMALL_MAX - 1) / LARGE_STEP;
+    }
+  return SIZE_CLASSES;
+}
+
+/**
+ * \param [in] sizeClass A size class.
+ * \returns The size of the blocks of \pname{sizeClass}.
+ */
+inline std::size_t
+BlockSize (std::size_t sizeClass)
+{
+  if (sizeClass < SMALL_MAX / SMALL_STEP)
+    {
+      return (sizeClass + 1) * SMALL_STEP;
+    }
+  return SMALL_MAX + (sizeClass + 1 - SMALL_MAX / SMALL_STEP) * LARGE_STEP;
+}
+
+/**
+ * Add a slab to a size class of an arena.
+ *
+ * Each new slab of a size class is twice as large as the previous
+ * one, so that the sizes in use get large slabs.
+ *
+ * \param [in] arena The arena.
+ * \param [in] sizeClass The size class.
+ */
+void
+AddSlab (Arena *arena, std::size_t sizeClass)
+{
+  std::size_t blockSize = BlockSize (sizeClass);
+  uint32_t blocks = arena->slabBlocks[sizeClass] * 2;
+  if (blocks < MIN_SLAB_BLOCKS)
+    {
+      blocks = MIN_SLAB_BLOCKS;
+    }
+  if (blocks * blockSize > MAX_SLAB_SIZE)
+    {
+      blocks = MAX_SLAB_SIZE / blockSize;
+    }
+  arena->slabBlocks[sizeClass] = blocks;
+  std::size_t slabSize = blocks * blockSize;
+  uint8_t *slab = static_cast<uint8_t *> (::operator new (slabSize));
+  NS_LOG_LOGIC ("new slab of " << blocks << " blocks of " << blockSize << " bytes");
+  arena->next[sizeClass] = slab;
+  arena->end[sizeClass] = slab + slabSize;
+  arena->stats.slabs++;
+  arena->stats.slabBytes += slabSize;
+}
+
+} // unnamed namespace
+
+bool
+PacketAllocator::IsEnabled (void)
+{
+  int state = g_state.load (std::memory_order_relaxed);
+  if (state == 0)
+    {
+      BooleanValue enabled;
+      g_packetArena.GetValue (enabled);
+      state = enabled.Get () ? 2 : 1;
+      g_state.store (state, std::memory_order_relaxed);
+    }
+  return state == 2;
+}
+
+void *
+PacketAllocator::Allocate (std::size_t size)
+{
+  // Do not add function logging here: this is called for every packet.
+  if (g_state.load (std::memory_order_relaxed) != 2 && !IsEnabled ())
+    {
+      return ::operator new (size);
+    }
+  Arena *arena = &g_arena;
+  std::size_t sizeClass = SizeClass (size);
+  if (sizeClass == SIZE_CLASSES)
+    {
+      arena->stats.large++;
+      return ::operator new (size);
+    }
+  FreeBlock *block = arena->head[sizeClass];
+  if (block != 0)
+    {
+      arena->head[sizeClass] = block->next;
+      arena->stats.cached--;
+      arena->stats.recycled++;
+      return block;
+    }
+  if (arena->next[sizeClass] == arena->end[sizeClass])
+    {
+      AddSlab (arena, sizeClass);
+    }
+  void *p = arena->next[sizeClass];
+  arena->next[sizeClass] += BlockSize (sizeClass);
+  arena->stats.allocated++;
+  return p;
+}
+
+void
+PacketAllocator::Deallocate (void *p, std::size_t size)
+{
+  if (p == 0)
+    {
+      return;
+    }
+  std::size_t sizeClass = SizeClass (size);
+  if (sizeClass == SIZE_CLASSES
+      || (g_state.load (std::memory_order_relaxed) != 2 && !IsEnabled ()))
+    {
+      ::operator delete (p);
+      return;
+    }
+  // The block may come from the slab of another thread: it then
+  // moves to the free list of this thread.
+  Arena *arena = &g_arena;
+  FreeBlock *block = static_cast<FreeBlock *> (p);
+  block->next = arena->head[sizeClass];
+  arena->head[sizeClass] = block;
+  arena->stats.cached++;
+}
+
+std::size_t
+PacketAllocator::GetUsableSize (std::size_t size)
+{
+  std::size_t sizeClass = SizeClass (size);
+  if (sizeClass == SIZE_CLASSES || !IsEnabled ())
+    {
+      return size;
+    }
+  return BlockSize (sizeClass);
+}
+
+PacketAllocator::Stats
+PacketAllocator::GetStats (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  return g_arena.stats;
+}
+
+} // namespace ns3
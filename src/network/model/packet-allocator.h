@@ -0,0 +1,106 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PACKET_ALLOCATOR_H
+#define PACKET_ALLOCATOR_H
+
+#include <cstddef>
+#include <stdint.h>
+
+namespace ns3 {
+
+/**
+ * \ingroup packet
+ *
+ * \brief Arena allocator for the packet data structures.
+ *
+ * When the \c PacketArena global value is true, the Packet objects and
+ * the storage of their Buffer, PacketMetadata, PacketTagList and
+ * ByteTagList are allocated from per-thread slabs instead of the
+ * system allocator, and the released blocks are kept in per-thread
+ * free lists, one per size class.  The slabs of a size class grow
+ * with its use, so that the frequent sizes are allocated from large,
+ * contiguous slabs.  The arena replaces the global free lists of these
+ * classes, which are not thread-safe: packets can then be created and
+ * released from any thread, e.g. the reader threads of the realtime
+ * emulation devices.
+ *
+ * The slabs are never returned to the system: they are reused by the
+ * packets of the next simulations run by the same process.  The
+ * allocations larger than the largest size class go directly to the
+ * system allocator.
+ *
+ * The \c PacketArena global value is read once, at the first packet
+ * allocation: it must be set before any packet is created, e.g. on the
+ * command line with \c --PacketArena=1.
+ */
+class PacketAllocator
+{
+public:
+  /**
+   * Statistics of the packet arena.
+   *
+   * The free lists are kept per thread, so these counters describe
+   * the allocations and releases performed by the calling thread only.
+   */
+  struct Stats
+  {
+    uint64_t allocated;  //!< Blocks obtained from the slabs.
+    uint64_t recycled;   //!< Allocations served from a free list.
+    uint64_t cached;     //!< Blocks currently held in the free lists.
+    uint64_t large;      //!< Allocations sent to the system allocator.
+    uint64_t slabs;      //!< Slabs obtained from the system allocator.
+    uint64_t slabBytes;  //!< Total size of these slabs, in bytes.
+  };
+
+  /**
+   * \returns \c true if the packet arena is enabled.
+   */
+  static bool IsEnabled (void);
+  /**
+   * Allocate storage for a packet data structure.
+   *
+   * \param [in] size The size to allocate, in bytes.
+   * \returns The storage.
+   */
+  static void * Allocate (std::size_t size);
+  /**
+   * Release storage obtained from Allocate().
+   *
+   * \param [in] p The storage to release.
+   * \param [in] size The size which was passed to Allocate().
+   */
+  static void Deallocate (void *p, std::size_t size);
+  /**
+   * Get the usable size of the storage returned by Allocate().
+   *
+   * Allocate() rounds the sizes up to the block size of their size
+   * class: the data structures which grow in place can use this extra
+   * space.
+   *
+   * \param [in] size The size to allocate, in bytes.
+   * \returns The usable size of the storage, in bytes.
+   */
+  static std::size_t GetUsableSize (std::size_t size);
+  /**
+   * \returns The arena statistics of the calling thread.
+   */
+  static Stats GetStats (void);
+};
+
+} // namespace ns3
+
+#endif /* PACKET_ALLOCATOR_H */
@@ -20,284 +20,258 @@
 
 /**
 \file   packet-tag-list.cc
-\brief  Implements a linked list of Packet tags, including copy-on-write semantics.
+\brief  Implements a flat list of Packet tags, including copy-on-write semantics.
 */
 
 #include "packet-tag-list.h"
+#include "packet-allocator.h"
 #include "tag-buffer.h"
 #include "tag.h"
 #include "ns3/fatal-error.h"
 #include "ns3/log.h"
+#include <algorithm>
 #include <cstring>
+#include <limits>
+#include <memory>
+#include <new>
+#include <vector>
 
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("PacketTagList");
 
-PacketTagList::TagData *
-PacketTagList::CreateTagData (size_t dataSize)
-{
-  NS_ASSERT_MSG (dataSize
-                 < std::numeric_limits<decltype(TagData::size)>::max (),
-                 "Requested TagData size " << dataSize
-                 << " exceeds maximum "
-                 << std::numeric_limits<decltype(TagData::size)>::max () );
-
-  void * p = std::malloc (sizeof (TagData) + dataSize - 1);
-  // The matching frees are in RemoveAll and RemoveWriter
+/**
+ * \ingroup packet
+ * Minimum number of entries of a TagBlock.
+ */
+static const uint32_t MIN_TAG_BLOCK_CAPACITY = 4;
+/**
+ * \ingroup packet
+ * Minimum size of the data area of a TagBlock.
+ */
+static const uint32_t MIN_TAG_BLOCK_DATA_SIZE = 32;
 
-  TagData * tag = new (p) TagData;
-  tag->size = dataSize;
-  return tag;
+PacketTagList::TagBlock *
+PacketTagList::CreateTagBlock (uint32_t capacity, uint32_t dataSize)
+{
+  NS_LOG_FUNCTION (capacity << dataSize);
+  void * p = PacketAllocator::Allocate (sizeof (TagBlock)
+                                        + capacity * sizeof (TagData)
+                                        + dataSize);
+  // The matching free is in FreeTagBlock
+
+  TagBlock * block = new (p) TagBlock;
+  block->count = 1;
+  block->dirty = 0;
+  block->capacity = capacity;
+  block->dataSize = dataSize;
+  return block;
 }
 
-bool
-PacketTagList::COWTraverse (Tag & tag, PacketTagList::COWWriter Writer)
+uint32_t
+PacketTagList::Find (TypeId tid) const
 {
-  TypeId tid = tag.GetInstanceTypeId ();
-  NS_LOG_FUNCTION (this << tid);
-  NS_LOG_INFO     ("looking for " << tid);
-
-  // trivial case when list is empty
-  if (m_next == 0)
+  if (m_block == 0)
     {
-      return false;
+      return 0;
     }
-
-  bool found = false;
-
-  struct TagData ** prevNext = &m_next; // previous node's next pointer
-  struct TagData  * cur      =  m_next; // cursor to current node
-  struct TagData  * it = 0;             // utility
-
-  // Search from the head of the list until we find tid or a merge
-  while (cur != 0)
+  const TagData *entries = GetEntries (m_block);
+  for (uint32_t i = 0; i < m_size; ++i)
     {
-      if (cur->count > 1)
+      if (entries[i].tid == tid)
         {
-          // found merge
-          NS_LOG_INFO ("found initial merge before tid");
-          break;
+          return i;
         }
-      else if (cur->tid == tid)
-        {
-          NS_LOG_INFO ("found tid before initial merge, calling writer");
-          found = (this->*Writer)(tag, true, cur, prevNext);
-          break;
-        }
-      else
-        {
-          // no merge or tid found yet, move on
-          prevNext = &cur->next;
-          cur      =  cur->next;
-        }
-    }  // while !found && !cow
+    }
+  return m_size;
+}
 
-  // did we find it or run out of tags?
-  if (cur == 0 || found)
+uint32_t
+PacketTagList::GetDataEnd (void) const
+{
+  if (m_size == 0)
     {
-      NS_LOG_INFO ("returning after header with found: " << found);
-      return found;
+      return 0;
     }
+  // The serialized tags are stored in the order of their entries.
+  const TagData &last = GetEntries (m_block)[m_size - 1];
+  return last.offset + last.size;
+}
 
-  // From here on out, we have to copy the list
-  // until we find tid, then link past it
-
-  // Before we do all that work, let's make sure tid really exists
-  for (it = cur; it != 0; it = it->next)
+void
+PacketTagList::Reserve (uint32_t capacity, uint32_t dataSize, bool append)
+{
+  if (m_block != 0
+      && capacity <= m_block->capacity
+      && dataSize <= m_block->dataSize)
     {
-      if (it->tid == tid)
+      if (m_block->count == 1)
         {
-          break;
+          return;
         }
+#ifndef NS3_MTP
+      // Other lists only see the entries they hold: this list can
+      // write past them, unless another list already did.
+      if (append && m_block->dirty == m_size)
+        {
+          return;
+        }
+#endif
     }
-  if (it == 0)
+
+  // Copy the tags of this list into a new block.
+  uint32_t dataEnd = GetDataEnd ();
+  if (m_block != 0)
     {
-      // got to end of list without finding tid
-      NS_LOG_INFO ("tid not found after first merge");
-      return found;
+      capacity = std::max (capacity, m_block->capacity);
+      dataSize = std::max (dataSize, m_block->dataSize);
+      if (capacity > m_block->capacity)
+        {
+          capacity = std::max (capacity, 2 * m_block->capacity);
+        }
+      if (dataSize > m_block->dataSize)
+        {
+          dataSize = std::max (dataSize, 2 * m_block->dataSize);
+        }
     }
-
-  // At this point cur is a merge, but untested for tid
-  NS_ASSERT (cur != 0);
-  NS_ASSERT (cur->count > 1);
-
-  /*
-     Walk the remainder of the list, copying, until we find tid
-     As we put a copy of the cur node onto our list,
-     we move the merge point down the list.
-
-     Starting position                  End position
-       T1 is a merge                     T1.count decremented
-                                         T2 is a merge
-                                         T1' is a copy of T1
-
-          other                             other
-               \                                 \
-      Prev  ->  T1  ->  T2  -> ...                T1  ->  T2  -> ...
-           /   /                                         /|
-      pNext cur                         Prev  ->  T1' --/ |
-                                                     /    |
-                                                pNext   cur
-
-     When we reach tid, we link past it, decrement count, and we're done.
-  */
-
-  // Should normally check for null cur pointer,
-  // but since we know tid exists, we'll skip this test
-  while ( /* cur && */ cur->tid != tid)
+  capacity = std::max (capacity, MIN_TAG_BLOCK_CAPACITY);
+  dataSize = std::max (dataSize, MIN_TAG_BLOCK_DATA_SIZE);
+  TagBlock *block = CreateTagBlock (capacity, dataSize);
+  if (m_size != 0)
     {
-      NS_ASSERT (cur != 0);
-      NS_ASSERT (cur->count > 1);
-      cur->count--;                       // unmerge cur
-      struct TagData * copy = CreateTagData (cur->size);
-      copy->tid = cur->tid;
-      copy->count = 1;
-      copy->size = cur->size;
-      memcpy (copy->data, cur->data, copy->size);
-      copy->next = cur->next;             // merge into tail
-      copy->next->count++;                // mark new merge
-      *prevNext = copy;                   // point prior list at copy
-      prevNext = &copy->next;             // advance
-      cur      =  copy->next;
+      std::uninitialized_copy (GetEntries (m_block), GetEntries (m_block) + m_size,
+                               GetEntries (block));
+      std::memcpy (GetDataArea (block), GetDataArea (m_block), dataEnd);
     }
-  // Sanity check:
-  NS_ASSERT (cur != 0);                 // cur should be non-zero
-  NS_ASSERT (cur->tid == tid);          // cur->tid should be tid
-  NS_ASSERT (cur->count > 1);           // cur should be a merge
-
-  // link around tid, removing it from our list
-  found = (this->*Writer)(tag, false, cur, prevNext);
-  return found;
+  block->dirty = m_size;
+  uint32_t size = m_size;
+  RemoveAll ();
+  m_block = block;
+  m_size = size;
+}
 
+uint8_t *
+PacketTagList::Append (TypeId tid, uint32_t size)
+{
+  NS_ASSERT_MSG (size
+                 < std::numeric_limits<decltype(TagData::size)>::max (),
+                 "Requested tag size " << size
+                 << " exceeds maximum "
+                 << std::numeric_limits<decltype(TagData::size)>::max () );
+  uint32_t dataEnd = GetDataEnd ();
+  Reserve (m_size + 1, dataEnd + size, true);
+  TagData *entry = new (GetEntries (m_block) + m_size) TagData;
+  entry->tid = tid;
+  entry->size = size;
+  entry->offset = dataEnd;
+  m_size++;
+  m_block->dirty = m_size;
+  return GetDataArea (m_block) + dataEnd;
 }
 
-bool
-PacketTagList::Remove (Tag & tag)
+void
+PacketTagList::Erase (uint32_t index)
 {
-  return COWTraverse (tag, &PacketTagList::RemoveWriter);
+  NS_ASSERT (index < m_size);
+  NS_ASSERT (m_block->count == 1);
+  TagData *entries = GetEntries (m_block);
+  uint8_t *data = GetDataArea (m_block);
+  uint32_t offset = entries[index].offset;
+  uint32_t size = entries[index].size;
+  uint32_t dataEnd = GetDataEnd ();
+  std::memmove (data + offset, data + offset + size, dataEnd - offset - size);
+  for (uint32_t i = index + 1; i < m_size; ++i)
+    {
+      entries[i - 1] = entries[i];
+      entries[i - 1].offset -= size;
+    }
+  m_size--;
+  m_block->dirty = m_size;
 }
 
-// COWWriter implementing Remove
 bool
-PacketTagList::RemoveWriter (Tag & tag, bool preMerge,
-                             struct PacketTagList::TagData  * cur,
-                             struct PacketTagList::TagData ** prevNext)
+PacketTagList::Remove (Tag & tag)
 {
-  NS_LOG_FUNCTION_NOARGS ();
-
-  // found tid
-  bool found = true;
-  tag.Deserialize (TagBuffer (cur->data, cur->data + cur->size));
-  *prevNext = cur->next;            // link around cur
-
-  if (preMerge)
+  TypeId tid = tag.GetInstanceTypeId ();
+  NS_LOG_FUNCTION (this << tid);
+  uint32_t index = Find (tid);
+  if (index == m_size)
     {
-      // found tid before first merge, so delete cur
-      cur->~TagData ();
-      std::free (cur);
+      NS_LOG_INFO ("tid not found");
+      return false;
     }
-  else
+  const TagData &entry = GetEntries (m_block)[index];
+  uint8_t *data = GetDataArea (m_block) + entry.offset;
+  tag.Deserialize (TagBuffer (data, data + entry.size));
+  if (m_size == 1 && m_block->count > 1)
     {
-      // cur is always a merge at this point
-      // unmerge cur, since we linked around it already
-      cur->count--;
-      if (cur->next != 0)
-        {
-          // there's a next, so make it a merge
-          cur->next->count++;
-        }
+      // no need to copy an empty list
+      RemoveAll ();
+      return true;
     }
-  return found;
+  Reserve (m_size, GetDataEnd (), false);
+  Erase (index);
+  return true;
 }
 
 bool
 PacketTagList::Replace (Tag & tag)
 {
-  bool found = COWTraverse (tag, &PacketTagList::ReplaceWriter);
-  if (!found)
+  TypeId tid = tag.GetInstanceTypeId ();
+  NS_LOG_FUNCTION (this << tid);
+  uint32_t index = Find (tid);
+  if (index == m_size)
     {
       Add (tag);
+      return false;
     }
-  return found;
-}
-
-// COWWriter implementing Replace
-bool
-PacketTagList::ReplaceWriter (Tag & tag, bool preMerge,
-                              struct PacketTagList::TagData  * cur,
-                              struct PacketTagList::TagData ** prevNext)
-{
-  NS_LOG_FUNCTION_NOARGS ();
-
-  // found tid
-  bool found = true;
-  if (preMerge)
+  uint32_t size = tag.GetSerializedSize ();
+  Reserve (m_size, GetDataEnd (), false);
+  TagData &entry = GetEntries (m_block)[index];
+  if (entry.size == size)
     {
-      // found tid before first merge, so just rewrite
-      tag.Serialize (TagBuffer (cur->data, cur->data + cur->size));
+      // rewrite in place
+      uint8_t *data = GetDataArea (m_block) + entry.offset;
+      tag.Serialize (TagBuffer (data, data + size));
     }
   else
     {
-      // cur is always a merge at this point
-      // need to copy, replace, and link past cur
-      cur->count--;                     // unmerge cur
-      struct TagData * copy = CreateTagData (tag.GetSerializedSize ());
-      copy->tid = tag.GetInstanceTypeId ();
-      copy->count = 1;
-      tag.Serialize (TagBuffer (copy->data, copy->data + copy->size));
-      copy->next = cur->next;           // merge into tail
-      if (copy->next != 0)
-        {
-          copy->next->count++;          // mark new merge
-        }
-      *prevNext = copy;                 // point prior list at copy
+      Erase (index);
+      uint8_t *data = Append (tid, size);
+      tag.Serialize (TagBuffer (data, data + size));
     }
-  return found;
+  return true;
 }
 
 void
 PacketTagList::Add (const Tag &tag) const
 {
-  NS_LOG_FUNCTION (this << tag.GetInstanceTypeId ());
+  TypeId tid = tag.GetInstanceTypeId ();
+  NS_LOG_FUNCTION (this << tid);
   // ensure this id was not yet added
-  for (struct TagData *cur = m_next; cur != 0; cur = cur->next)
-    {
-      NS_ASSERT_MSG (cur->tid != tag.GetInstanceTypeId (),
-                     "Error: cannot add the same kind of tag twice.");
-    }
-  struct TagData * head = CreateTagData (tag.GetSerializedSize ());
-  head->count = 1;
-  head->next = 0;
-  head->tid = tag.GetInstanceTypeId ();
-  head->next = m_next;
-  tag.Serialize (TagBuffer (head->data, head->data + head->size));
-
-  const_cast<PacketTagList *> (this)->m_next = head;
+  NS_ASSERT_MSG (Find (tid) == m_size,
+                 "Error: cannot add the same kind of tag twice.");
+  uint32_t size = tag.GetSerializedSize ();
+  uint8_t *data = const_cast<PacketTagList *> (this)->Append (tid, size);
+  tag.Serialize (TagBuffer (data, data + size));
 }
 
 bool
 PacketTagList::Peek (Tag &tag) const
 {
-  NS_LOG_FUNCTION (this << tag.GetInstanceTypeId ());
   TypeId tid = tag.GetInstanceTypeId ();
-  for (struct TagData *cur = m_next; cur != 0; cur = cur->next)
+  NS_LOG_FUNCTION (this << tid);
+  uint32_t index = Find (tid);
+  if (index == m_size)
     {
-      if (cur->tid == tid)
-        {
-          /* found tag */
-          tag.Deserialize (TagBuffer (cur->data, cur->data + cur->size));
-          return true;
-        }
+      /* no tag found */
+      return false;
     }
-  /* no tag found */
-  return false;
-}
-
-const struct PacketTagList::TagData *
-PacketTagList::Head (void) const
-{
-  return m_next;
+  /* found tag */
+  const TagData &entry = GetEntries (m_block)[index];
+  uint8_t *data = GetDataArea (m_block) + entry.offset;
+  tag.Deserialize (TagBuffer (data, data + entry.size));
+  return true;
 }
 
 uint32_t
@@ -309,7 +283,7 @@ PacketTagList::GetSerializedSize (void) const
 
   size = 4; // numberOfTags
 
-  for (struct TagData *cur = m_next; cur != 0; cur = cur->next)
+  for (const TagData *cur = Begin (); cur != End (); ++cur)
     {
       size += 4; // TagData -> size
 
@@ -346,8 +320,11 @@ PacketTagList::Serialize (uint32_t* buffer, uint32_t maxSize) const
       return 0;
     }
 
-  for (struct TagData *cur = m_next; cur != 0; cur = cur->next)
+  // The tags are serialized from the most recent one, as they were
+  // when the list was a linked list.
+  for (const TagData *cur = End (); cur != Begin (); )
     {
+      --cur;
       if (size + 4 <= maxSize)
         {
           *p++ = cur->size;
@@ -378,7 +355,7 @@ PacketTagList::Serialize (uint32_t* buffer, uint32_t maxSize) const
       uint32_t tagWordSize = (cur->size+3) & (~3);
       if (size + tagWordSize <= maxSize)
         {
-          memcpy (p, cur->data, cur->size);
+          memcpy (p, GetData (cur), cur->size);
           size += tagWordSize;
           p += tagWordSize / 4;
         }
@@ -407,48 +384,46 @@ PacketTagList::Deserialize (const uint32_t* buffer, uint32_t size)
 
   NS_LOG_INFO("Deserializing number of tags " << numberOfTags);
 
-  struct TagData * prevTag = 0;
+  // The most recent tag comes first: find all the tags before
+  // appending them from the oldest one.
+  std::vector<const uint32_t *> tags;
+  tags.reserve (numberOfTags);
   for (uint32_t i = 0; i < numberOfTags; ++i)
     {
+      tags.push_back (p);
+
       NS_ASSERT (sizeCheck >= 4);
       uint32_t tagSize = *p++;
       sizeCheck -= 4;
 
       uint32_t hashSize = (sizeof (TypeId::hash_t)+3) & (~3);
       NS_ASSERT (sizeCheck >= hashSize);
-      TypeId::hash_t hash;
-      memcpy (&hash, p, sizeof (TypeId::hash_t));
       p += hashSize / 4;
       sizeCheck -= hashSize;
 
-      TypeId tid = TypeId::LookupByHash(hash);
-
-      NS_LOG_INFO ("Deserializing tag of type " << tid);
-
-      struct TagData * newTag = CreateTagData (tagSize);
-      newTag->count = 1;
-      newTag->next = 0;
-      newTag->tid = tid;
-
-      NS_ASSERT (sizeCheck >= tagSize);
-      memcpy (newTag->data, p, tagSize);
-
       // ensure 4 byte boundary
       uint32_t tagWordSize = (tagSize+3) & (~3);
+      NS_ASSERT (sizeCheck >= tagWordSize);
       p += tagWordSize / 4;
       sizeCheck -= tagWordSize;
+    }
 
-      // Set link list pointers.
-      if (i==0)
-        {
-          m_next = newTag;
-        }
-      else
-        {
-          prevTag->next = newTag;
-        }
+  RemoveAll ();
+  for (auto it = tags.rbegin (); it != tags.rend (); ++it)
+    {
+      const uint32_t *tag = *it;
+      uint32_t tagSize = *tag++;
 
-      prevTag = newTag;
+      TypeId::hash_t hash;
+      memcpy (&hash, tag, sizeof (TypeId::hash_t));
+      tag += ((sizeof (TypeId::hash_t)+3) & (~3)) / 4;
+
+      TypeId tid = TypeId::LookupByHash(hash);
+
+      NS_LOG_INFO ("Deserializing tag of type " << tid);
+
+      uint8_t *data = Append (tid, tagSize);
+      memcpy (data, tag, tagSize);
     }
 
   NS_ASSERT (sizeCheck == 0);
@@ -460,4 +435,3 @@ PacketTagList::Deserialize (const uint32_t* buffer, uint32_t size)
 
 
 } /* namespace ns3 */
-
@@ -22,12 +22,16 @@
 
 /**
 \file   packet-tag-list.h
-\brief  Defines a linked list of Packet tags, including copy-on-write semantics.
+\brief  Defines a flat list of Packet tags, including copy-on-write semantics.
 */
 
 #include <stdint.h>
 #include <ostream>
+#ifdef NS3_MTP
+#include <atomic>
+#endif
 #include "ns3/type-id.h"
+#include "packet-allocator.h"
 
 namespace ns3 {
 
@@ -43,110 +47,69 @@ class Tag;
  *
  * \internal
  *
- * The implementation of this class is a bit tricky.  Refer to this
- * diagram in the discussion that follows.
- *
- * \dot
- *    digraph {
- *        rankdir = "LR";
- *        clusterrank = local;
- *        node [ shape = record, fontname="FreeSans", fontsize="10" ];
- *        oth  [ label="<l> Other branch | <n> next | <c> ..." ];
- *        PTL1 [ label="<l> PacketTagList A | <n> m_next" , shape=Mrecord];
- *        PTL2 [ label="<l> PacketTagList B | <n> m_next" , shape=Mrecord];
- *        oth:n  -> T7:l ;
- *        PTL2:n -> T6:l ;
- *        PTL1:n -> T5:l ;
- *        T1   [ label="<l> T1  | <n> next | <c> count = 1" ];
- *        T2   [ label="<l> T2  | <n> next | <c> count = 1" ];
- *        T3   [ label="<l> T3  | <n> next | <c> count = 2" ];
- *        T4   [ label="<l> T4  | <n> next | <c> count = 1" ];
- *        T5   [ label="<l> T5  | <n> next | <c> count = 2" ];
- *        T6   [ label="<l> T6  | <n> next | <c> count = 1" ];
- *        T7   [ label="<l> T7  | <n> next | <c> count = 1" ];
- *        NULL [ label="0", shape = ellipse ];
- *        subgraph cluster_list {
- *          penwidth = 0;
- *          T6:n -> T5:l ;
- *          T5:n -> T4:l ;
- *          T4:n -> T3:l ;
- *          T7:n -> T3:l ;
- *          T3:n -> T2:l ;
- *          T2:n -> T1:l ;
- *          T1:n -> NULL ;
- *        };
- *      }
- * \enddot
- *
- *   - Tags are stored in serialized form in a tree of TagData
- *     structures. (<tt>T1-T7</tt> in the diagram)
- *
- *   - Each TagData points (\c next pointers in the diagram)
- *     toward the root of the tree, which is a null pointer.
- *
- *   - \c count is the number of incoming pointers to this
- *     TagData.  Branch points, where branches merge or join, have
- *     <tt>count \> 1</tt> (\c T3, \c T5); successive links along
- *     a branch have <tt>count = 1</tt> (\c T1, \c T2, \c T4, \c T6, \c T7).
- *
- *   - Each PacketTagList points to a specific TagData,
- *     which is the most recent Tag added to the packet. (<tt>T5-T7</tt>)
- *
- *   - Conceptually, therefore, each Packet has a PacketTagList which
- *     points to a singly-linked list of TagData.
+ * The tags are stored in serialized form in a single TagBlock: an
+ * array of TagData entries, one per tag, followed by the serialized
+ * tags, in the order in which they were added.  A packet carries few
+ * tags (e.g. the bearer, PDCP, RLC and PHY tags of the LTE stack), so
+ * a lookup by TypeId is a scan of a few contiguous entries, and
+ * reading or writing a tag touches one or two cache lines instead of
+ * following a linked list.
  *
  * \par <b> Copy-on-write </b> is implemented as follows:
  *
- *   - #Add prepends the new tag to the list (growing that branch of the tree,
- *     as \c T6). This is a constant time operation, and does not affect
- *     any other #PacketTagList's, hence this is a \c const function.
+ *   - The copy constructor and the assignment share the TagBlock of the
+ *     copied list, incrementing its \c count.  Each PacketTagList
+ *     records how many entries of the block it holds.
  *
- *   - Copy constructor (PacketTagList(const PacketTagList & o))
- *     and assignment (#operator=(const PacketTagList & o))
- *     simply join the tree at the same place as the original
- *     PacketTagList \c o, incrementing the \c count.
- *     For assignment, the old branch is deleted, up to
- *     the first branch point, which has its \c count decremented.
- *     (PacketTagList \c B started as a copy of PacketTagList \c A,
- *     before \c T6 was added to \c B).
+ *   - #Add appends the new tag at the end of the block, in place, if
+ *     the block is not shared or if no other list appended to it since
+ *     this list was copied (the block \c dirty count is the number of
+ *     entries written into it, like the \c dirty size of ByteTagList).
+ *     Otherwise, the entries of this list are first copied into a new
+ *     block.  Copying a packet and adding a tag to the copy is then
+ *     still a constant time operation.
  *
- *   - #Remove and #Replace are a little tricky, depending on where the
- *     target tag is found relative to the first branch point:
- *     - \e Target before <em> the first branch point: </em> \n
- *       The target is just dealt with in place (linked around and deleted,
- *       in the case of #Remove; rewritten in the case of #Replace).
- *     - \e Target at or after <em> the first branch point: </em> \n
- *       The portion of the list between the first branch and the target is
- *       shared. This portion is copied before the #Remove or #Replace is
- *       performed.
+ *   - #Remove and #Replace modify the block in place if it is not
+ *     shared, and copy the entries of this list into a new block
+ *     otherwise.
  */
 class PacketTagList 
 {
 public:
   /**
-   * Tree node for sharing serialized tags.
-   *
-   * See PacketTagList for a discussion of the data structure.
+   * Entry of a tag in a TagBlock.
    *
    * \internal
    * Unfortunately this has to be public, because
-   * PacketTagIterator::Item::GetTag() needs the data and size values.
+   * PacketTagIterator::Item::GetTag() needs the size and the type.
    * The Item nested class can't be forward declared, so friending isn't
    * possible.
-   *
-   * We use placement new so we can allocate enough room for the Tag
-   * type which will be serialized into data.  See Object::Aggregates
-   * for a similar construction.
    */
   struct TagData
   {
-    struct TagData * next;      /**< Pointer to next in list */
-    uint32_t count;             /**< Number of incoming links */
-    TypeId tid;                 /**< Type of the tag serialized into #data */
-    uint32_t size;              /**< Size of the \c data buffer */
-    uint8_t data[1];            /**< Serialization buffer */
+    TypeId tid;                 /**< Type of the serialized tag */
+    uint32_t size;              /**< Size of the serialized tag */
+    uint32_t offset;            /**< Offset of the serialized tag in the data area of the block */
   };  /* struct TagData */
 
+  /**
+   * Shared storage of the tags.
+   *
+   * The block is followed by \c capacity TagData entries, and then by
+   * the data area holding the serialized tags.
+   */
+  struct TagBlock
+  {
+#ifdef NS3_MTP
+    std::atomic<uint32_t> count; /**< Number of PacketTagList sharing this block */
+#else
+    uint32_t count;             /**< Number of PacketTagList sharing this block */
+#endif
+    uint32_t dirty;             /**< Number of entries written into this block */
+    uint32_t capacity;          /**< Number of entries of this block */
+    uint32_t dataSize;          /**< Size of the data area */
+  };  /* struct TagBlock */
+
   /**
    * Create a new PacketTagList.
    */
@@ -156,8 +119,8 @@ public:
    *
    * \param [in] o The PacketTagList to copy.
    *
-   * This makes a light-weight copy by #RemoveAll, then
-   * pointing to the same \ref TagData as \pname{o}.
+   * This makes a light-weight copy, sharing the \ref TagBlock
+   * of \pname{o}.
    */
   inline PacketTagList (PacketTagList const &o);
   /**
@@ -167,18 +130,18 @@ public:
    * \returns the copied object
    *
    * This makes a light-weight copy by #RemoveAll, then
-   * pointing to the same \ref TagData as \pname{o}.
+   * sharing the \ref TagBlock of \pname{o}.
    */
   inline PacketTagList &operator = (PacketTagList const &o);
   /**
    * Destructor
    *
-   * #RemoveAll's the tags up to the first merge.
+   * #RemoveAll's the tags.
    */
   inline ~PacketTagList ();
 
   /**
-   * Add a tag to the head of this branch.
+   * Add a tag to the end of the list.
    *
    * \param [in] tag The tag to add
    */
@@ -210,13 +173,22 @@ public:
    */
   bool Peek (Tag &tag) const;
   /**
-   * Remove all tags from this list (up to the first merge).
+   * Remove all tags from this list.
    */
   inline void RemoveAll (void);
   /**
-   * \returns pointer to head of tag list
+   * \returns pointer to the first tag of the list
+   */
+  inline const struct PacketTagList::TagData *Begin (void) const;
+  /**
+   * \returns pointer past the last tag of the list
    */
-  const struct PacketTagList::TagData *Head (void) const;
+  inline const struct PacketTagList::TagData *End (void) const;
+  /**
+   * \param [in] tag A tag of the list.
+   * \returns pointer to the serialized value of \pname{tag}
+   */
+  inline const uint8_t *GetData (const struct PacketTagList::TagData *tag) const;
   /**
    * Returns number of bytes required for packet serialization.
    *
@@ -244,68 +216,79 @@ public:
 
 private:
   /**
-   * Allocate and construct a TagData struct, sizing the data area
-   * large enough to serialize dataSize bytes from a Tag.
+   * Allocate and construct a TagBlock.
    *
-   * \param [in] dataSize The serialized size of the Tag.
-   * \returns The newly constructed TagData object.
+   * \param [in] capacity The number of entries of the block.
+   * \param [in] dataSize The size of the data area of the block.
+   * \returns The newly constructed TagBlock object.
    */
   static
-  TagData * CreateTagData (size_t dataSize);
-  
+  TagBlock * CreateTagBlock (uint32_t capacity, uint32_t dataSize);
   /**
-   * Typedef of method function pointer for copy-on-write operations
+   * Destroy and release a TagBlock allocated by CreateTagBlock.
    *
-   * \param [in] tag The tag type to operate on.
-   * \param [in] preMerge True if \pname{tag} was found before the first merge,
-   *             false otherwise.
-   * \param [in] cur Pointer to the tag.
-   * \param [in] prevNext Pointer to the struct TagData.next pointer
-   *          pointing to \pname{cur}.
-   * \returns True if operation successful, false otherwise
+   * \param [in] block The TagBlock object.
+   */
+  static inline
+  void FreeTagBlock (TagBlock *block);
+  /**
+   * \param [in] block A TagBlock.
+   * \returns The entries of \pname{block}.
+   */
+  static inline
+  TagData * GetEntries (TagBlock *block);
+  /**
+   * \param [in] block A TagBlock.
+   * \returns The data area of \pname{block}.
+   */
+  static inline
+  uint8_t * GetDataArea (TagBlock *block);
+
+  /**
+   * \param [in] tid The type of a tag.
+   * \returns The index of the tag of type \pname{tid}, or m_size if
+   *          there is no such tag in the list.
    */
-  typedef bool (PacketTagList::*COWWriter)
-    (Tag       & tag, bool         preMerge,
-    struct TagData * cur, struct TagData ** prevNext);
+  uint32_t Find (TypeId tid) const;
   /**
-   * Traverse the list implementing copy-on-write, using \pname{Writer}.
+   * \returns The size of the serialized tags of this list.
+   */
+  uint32_t GetDataEnd (void) const;
+  /**
+   * Make sure that the block of this list can hold \pname{capacity}
+   * entries and \pname{dataSize} bytes of serialized tags, and that
+   * it is not shared, copying the tags of this list into a new block
+   * if needed.
    *
-   * \param [in] tag The tag type to operate on.
-   * \param [in] Writer The copy-on-write function to use.
-   * \returns True if \pname{tag} found, false otherwise.
+   * \param [in] capacity The number of entries needed.
+   * \param [in] dataSize The size of the serialized tags needed.
+   * \param [in] append True if the block only needs to be writable
+   *             past the tags of this list.
    */
-  bool COWTraverse   (Tag & tag, PacketTagList::COWWriter Writer);
+  void Reserve (uint32_t capacity, uint32_t dataSize, bool append);
   /**
-   * Copy-on-write implementing Remove.
+   * Append an entry to the list.
    *
-   * \param [in] tag The target tag type to remove.
-   * \param [in] preMerge True if \pname{tag} was found before the first merge,
-   *             false otherwise.
-   * \param [in] cur Pointer to the tag.
-   * \param [in] prevNext Pointer to the struct TagData.next pointer
-   *          pointing to \pname{cur}.
-   * \returns True, since tag will definitely be removed.
+   * \param [in] tid The type of the tag.
+   * \param [in] size The size of the serialized tag.
+   * \returns The buffer where the tag must be serialized.
    */
-  bool RemoveWriter  (Tag & tag, bool preMerge,
-                      struct TagData * cur, struct TagData ** prevNext);
+  uint8_t * Append (TypeId tid, uint32_t size);
   /**
-   * Copy-on-write implementing Replace
+   * Remove an entry from the list, which must not be shared.
    *
-   * \param [in] tag The target tag type to replace
-   * \param [in] preMerge True if \pname{tag} was found before the first merge,
-   *          false otherwise.
-   * \param [in] cur Pointer to the tag
-   * \param [in] prevNext Pointer to the struct TagData.next pointer
-   *          pointing to \pname{cur}.
-   * \returns True, since tag value will definitely be replaced.
+   * \param [in] index The index of the entry.
    */
-  bool ReplaceWriter (Tag & tag, bool preMerge,
-                      struct TagData * cur, struct TagData ** prevNext);
+  void Erase (uint32_t index);
 
   /**
-   * Pointer to first \ref TagData on the list
+   * Shared storage of the tags, or 0 if the list is empty
+   */
+  struct TagBlock *m_block;
+  /**
+   * Number of tags of this list, at the start of \ref m_block
    */
-  struct TagData *m_next;
+  uint32_t m_size;
 };
 
 } // namespace ns3
@@ -317,32 +300,36 @@ private:
 namespace ns3 {
 
 PacketTagList::PacketTagList ()
-  : m_next ()
+  : m_block (0),
+    m_size (0)
 {
 }
 
 PacketTagList::PacketTagList (PacketTagList const &o)
-  : m_next (o.m_next)
+  : m_block (o.m_block),
+    m_size (o.m_size)
 {
-  if (m_next != 0)
+  if (m_block != 0)
     {
-      m_next->count++;
+      m_block->count++;
     }
 }
 
 PacketTagList &
 PacketTagList::operator = (PacketTagList const &o)
 {
-  // self assignment
-  if (m_next == o.m_next) 
+  // self assignment, or assignment of a list sharing the same block
+  if (m_block == o.m_block) 
     {
+      m_size = o.m_size;
       return *this;
     }
   RemoveAll ();
-  m_next = o.m_next;
-  if (m_next != 0) 
+  m_block = o.m_block;
+  m_size = o.m_size;
+  if (m_block != 0) 
     {
-      m_next->count++;
+      m_block->count++;
     }
   return *this;
 }
@@ -352,30 +339,53 @@ PacketTagList::~PacketTagList ()
   RemoveAll ();
 }
 
+void
+PacketTagList::FreeTagBlock (struct TagBlock *block)
+{
+  std::size_t size = sizeof (TagBlock) + block->capacity * sizeof (TagData) + block->dataSize;
+  block->~TagBlock ();
+  PacketAllocator::Deallocate (block, size);
+}
+
+PacketTagList::TagData *
+PacketTagList::GetEntries (struct TagBlock *block)
+{
+  return reinterpret_cast<TagData *> (block + 1);
+}
+
+uint8_t *
+PacketTagList::GetDataArea (struct TagBlock *block)
+{
+  return reinterpret_cast<uint8_t *> (GetEntries (block) + block->capacity);
+}
+
 void
 PacketTagList::RemoveAll (void)
 {
-  struct TagData *prev = 0;
-  for (struct TagData *cur = m_next; cur != 0; cur = cur->next)
-    {
-      cur->count--;
-      if (cur->count > 0) 
-        {
-          break;
-        }
-      if (prev != 0) 
-        {
-          prev->~TagData ();
-          std::free (prev);
-        }
-      prev = cur;
-    }
-  if (prev != 0) 
+  if (m_block != 0 && --m_block->count == 0)
     {
-      prev->~TagData ();
-      std::free (prev);
+      FreeTagBlock (m_block);
     }
-  m_next = 0;
+  m_block = 0;
+  m_size = 0;
+}
+
+const struct PacketTagList::TagData *
+PacketTagList::Begin (void) const
+{
+  return m_block == 0 ? 0 : GetEntries (m_block);
+}
+
+const struct PacketTagList::TagData *
+PacketTagList::End (void) const
+{
+  return m_block == 0 ? 0 : GetEntries (m_block) + m_size;
+}
+
+const uint8_t *
+PacketTagList::GetData (const struct PacketTagList::TagData *tag) const
+{
+  return GetDataArea (m_block) + tag->offset;
 }
 
 } // namespace ns3
@@ -21,6 +21,9 @@
 #define PACKET_H
 
 #include <stdint.h>
+#ifdef NS3_MTP
+#include <atomic>
+#endif
 #include "buffer.h"
 #include "header.h"
 #include "trailer.h"
@@ -28,6 +31,7 @@
 #include "tag.h"
 #include "byte-tag-list.h"
 #include "packet-tag-list.h"
+#include "packet-allocator.h"
 #include "nix-vector.h"
 #include "ns3/mac48-address.h"
 #include "ns3/callback.h"
@@ -155,10 +159,12 @@ private:
     friend class PacketTagIterator;
     /**
      * Constructor
-     * \param data the data to copy.
+     * \param data the tag entry.
+     * \param buffer the serialized tag.
      */
-    Item (const struct PacketTagList::TagData *data);
+    Item (const struct PacketTagList::TagData *data, const uint8_t *buffer);
     const struct PacketTagList::TagData *m_data; //!< the tag data
+    const uint8_t *m_buffer; //!< the serialized tag
   };
   /**
    * \returns true if calling Next is safe, false otherwise.
@@ -173,9 +179,10 @@ private:
   friend class Packet;
   /**
    * Constructor
-   * \param head head of the items
+   * \param list the tag list
    */
-  PacketTagIterator (const struct PacketTagList::TagData *head);
+  PacketTagIterator (const PacketTagList &list);
+  const PacketTagList *m_list;  //!< the tag list
   const struct PacketTagList::TagData *m_current;  //!< actual position over the set of tags in a packet
 };
 
@@ -469,6 +476,10 @@ public:
    * sequence numbers, or other packet or frame counters at other
    * protocol layers.
    *
+   * When ns-3 is built with multithreaded simulation support
+   * (NS3_MTP), packets created concurrently by different threads
+   * get their uids in a nondeterministic order.
+   *
    * \returns an integer identifier which uniquely
    *          identifies this packet.
    */
@@ -531,6 +542,33 @@ public:
    */
   static void EnableChecking (void);
 
+  /**
+   * \brief Get the statistics of the packet arena.
+   *
+   * The packet arena is enabled by the \ref GlobalValuePacketArena
+   * "PacketArena" global value.
+   *
+   * \returns The arena statistics of the calling thread.
+   * \see PacketAllocator
+   */
+  static PacketAllocator::Stats GetAllocatorStats (void);
+
+  /**
+   * Allocate the storage of a Packet, from the packet arena when it
+   * is enabled.
+   *
+   * \param [in] size The size of the Packet.
+   * \returns The storage for the Packet.
+   */
+  static void * operator new (std::size_t size);
+  /**
+   * Release the storage of a Packet.
+   *
+   * \param [in] p The storage to release.
+   * \param [in] size The size of the Packet.
+   */
+  static void operator delete (void *p, std::size_t size);
+
   /**
    * \brief Returns number of bytes required for packet
    * serialization.
@@ -791,7 +829,11 @@ private:
   /* Please see comments above about nix-vector */
   mutable Ptr<NixVector> m_nixVector; //!< the packet's Nix vector
 
+#ifdef NS3_MTP
+  static std::atomic<uint32_t> m_globalUid; //!< Global counter of packets Uid
+#else
   static uint32_t m_globalUid; //!< Global counter of packets Uid
+#endif
 };
 
 /**
@@ -23,6 +23,8 @@
 #include "ns3/double.h"
 #include "ns3/test.h"
 
+#include <vector>
+
 using namespace ns3;
 
 /**
@@ -385,6 +387,81 @@ BufferTest::DoRun (void)
   val2 <<= 8;
   val2 |= i.ReadU8 ();
   NS_TEST_ASSERT_MSG_EQ (val1, val2, "Bad ReadNtohU16()");
+
+  // Concatenations keep the larger of the zero areas virtual.
+  Buffer a (1000);
+  a.AddAtStart (2);
+  i = a.Begin ();
+  i.WriteU8 (0x1);
+  i.WriteU8 (0x2);
+  Buffer b (2000);
+  b.AddAtStart (2);
+  i = b.Begin ();
+  i.WriteU8 (0x3);
+  i.WriteU8 (0x4);
+  b.AddAtEnd (1);
+  i = b.End ();
+  i.Prev (1);
+  i.WriteU8 (0x5);
+  std::vector<uint8_t> aBytes (1002, 0);
+  aBytes[0] = 0x1;
+  aBytes[1] = 0x2;
+  std::vector<uint8_t> bBytes (2003, 0);
+  bBytes[0] = 0x3;
+  bBytes[1] = 0x4;
+  bBytes[2002] = 0x5;
+
+  std::vector<std::pair<Buffer, std::vector<uint8_t> > > concatenations;
+  Buffer ab = a;
+  ab.AddAtEnd (b);
+  std::vector<uint8_t> abBytes (aBytes);
+  abBytes.insert (abBytes.end (), bBytes.begin (), bBytes.end ());
+  NS_TEST_EXPECT_MSG_LT (ab.GetSerializedSize (), 1100, "Zero area not virtual");
+  concatenations.push_back (std::make_pair (ab, abBytes));
+  Buffer ba = b;
+  ba.AddAtEnd (a);
+  std::vector<uint8_t> baBytes (bBytes);
+  baBytes.insert (baBytes.end (), aBytes.begin (), aBytes.end ());
+  NS_TEST_EXPECT_MSG_LT (ba.GetSerializedSize (), 1100, "Zero area not virtual");
+  concatenations.push_back (std::make_pair (ba, baBytes));
+  Buffer aa = a;
+  aa.AddAtEnd (aa);
+  std::vector<uint8_t> aaBytes (aBytes);
+  aaBytes.insert (aaBytes.end (), aBytes.begin (), aBytes.end ());
+  concatenations.push_back (std::make_pair (aa, aaBytes));
+  // A buffer without a zero area, and a buffer starting with its zero area.
+  Buffer c;
+  c.AddAtStart (2);
+  i = c.Begin ();
+  i.WriteU8 (0x6);
+  i.WriteU8 (0x7);
+  Buffer d (500);
+  d.AddAtEnd (3);
+  i = d.End ();
+  i.Prev (3);
+  i.WriteU8 (0x8);
+  i.WriteU8 (0x9);
+  i.WriteU8 (0xa);
+  std::vector<uint8_t> cdBytes (505, 0);
+  cdBytes[0] = 0x6;
+  cdBytes[1] = 0x7;
+  cdBytes[502] = 0x8;
+  cdBytes[503] = 0x9;
+  cdBytes[504] = 0xa;
+  c.AddAtEnd (d);
+  NS_TEST_EXPECT_MSG_LT (c.GetSerializedSize (), 100, "Zero area not virtual");
+  concatenations.push_back (std::make_pair (c, cdBytes));
+  concatenations.push_back (std::make_pair (a, aBytes));
+  concatenations.push_back (std::make_pair (b, bBytes));
+  for (const auto &concatenation : concatenations)
+    {
+      const Buffer &result = concatenation.first;
+      const std::vector<uint8_t> &expected = concatenation.second;
+      NS_TEST_ASSERT_MSG_EQ (result.GetSize (), expected.size (), "Bad concatenation size");
+      std::vector<uint8_t> got (result.GetSize ());
+      result.CopyData (got.data (), got.size ());
+      NS_TEST_EXPECT_MSG_EQ ((got == expected), true, "Bad concatenation content");
+    }
 }
 
 /**
@@ -26,6 +26,7 @@
 #include <iostream>
 #include <iomanip>
 #include <ctime>
+#include <vector>
 
 using namespace ns3;
 
@@ -732,6 +733,20 @@ PacketTest::DoRun (void)
     NS_TEST_EXPECT_MSG_EQ (b2.GetData (), 66, "trivial");
     NS_TEST_EXPECT_MSG_EQ (p2 -> PeekPacketTag(c2), true, "trivial");
     NS_TEST_EXPECT_MSG_EQ (c2.GetData (), 67, "trivial");
+
+    // Both packets list the most recent tag first.
+    PacketTagIterator i1 = p1->GetPacketTagIterator ();
+    PacketTagIterator i2 = p2->GetPacketTagIterator ();
+    TypeId expected[] = {ATestTag<12>::GetTypeId (), ATestTag<11>::GetTypeId (), ATestTag<10>::GetTypeId ()};
+    for (const TypeId &tid : expected)
+      {
+        NS_TEST_EXPECT_MSG_EQ (i1.HasNext (), true, "missing tag");
+        NS_TEST_EXPECT_MSG_EQ (i1.Next ().GetTypeId (), tid, "tag order");
+        NS_TEST_EXPECT_MSG_EQ (i2.HasNext (), true, "missing deserialized tag");
+        NS_TEST_EXPECT_MSG_EQ (i2.Next ().GetTypeId (), tid, "deserialized tag order");
+      }
+    NS_TEST_EXPECT_MSG_EQ (i1.HasNext (), false, "extra tag");
+    NS_TEST_EXPECT_MSG_EQ (i2.HasNext (), false, "extra deserialized tag");
   }
 
   /* Test Serialization and Deserialization of Packet with ByteTag data */
@@ -1150,6 +1165,74 @@ PacketTagListTest::DoRun (void)
 
 }
 
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Packet arena test.
+ *
+ * The arena is only enabled when the PacketArena global value is true
+ * at the first packet allocation, e.g. when running the test with the
+ * NS_GLOBAL_VALUE="PacketArena=1" environment variable.
+ */
+class PacketAllocatorTest : public TestCase
+{
+public:
+  PacketAllocatorTest ();
+  virtual void DoRun (void);
+};
+
+PacketAllocatorTest::PacketAllocatorTest ()
+  : TestCase ("Packet arena")
+{}
+
+void
+PacketAllocatorTest::DoRun (void)
+{
+  PacketAllocator::Stats before = Packet::GetAllocatorStats ();
+  {
+    std::vector<Ptr<Packet> > packets;
+    for (uint32_t i = 0; i < 100; i++)
+      {
+        Ptr<Packet> p = Create<Packet> (1000);
+        p->AddHeader (ATestHeader<10> ());
+        p->AddPacketTag (ATestTag<2> ());
+        p->AddByteTag (ATestTag<3> ());
+        Ptr<Packet> fragment = p->CreateFragment (0, 500);
+        fragment->AddAtEnd (p);
+        packets.push_back (p);
+        packets.push_back (fragment);
+      }
+    for (const auto &p : packets)
+      {
+        ATestTag<2> tag;
+        NS_TEST_EXPECT_MSG_EQ (p->PeekPacketTag (tag), true, "Missing packet tag");
+      }
+    NS_TEST_EXPECT_MSG_EQ (packets[1]->GetSize (), 1510, "Bad concatenation");
+  }
+  PacketAllocator::Stats after = Packet::GetAllocatorStats ();
+
+  if (!PacketAllocator::IsEnabled ())
+    {
+      NS_TEST_EXPECT_MSG_EQ (after.allocated, 0, "Arena used while disabled");
+      NS_TEST_EXPECT_MSG_EQ (after.recycled, 0, "Arena used while disabled");
+      NS_TEST_EXPECT_MSG_EQ (after.cached, 0, "Arena used while disabled");
+      return;
+    }
+  uint64_t allocations = (after.allocated + after.recycled) - (before.allocated + before.recycled);
+  NS_TEST_EXPECT_MSG_GT_OR_EQ (allocations, 200 * 3, "Packets not allocated from the arena");
+  // All the blocks taken from the slabs are back in the free lists.
+  NS_TEST_EXPECT_MSG_EQ (after.cached - before.cached, after.allocated - before.allocated,
+                         "Released blocks not kept in the free lists");
+  NS_TEST_EXPECT_MSG_GT (after.slabBytes, 0, "No slab allocated");
+
+  // The released blocks are reused.
+  Ptr<Packet> p = Create<Packet> (1000);
+  PacketAllocator::Stats reused = Packet::GetAllocatorStats ();
+  NS_TEST_EXPECT_MSG_EQ (reused.allocated, after.allocated, "Free lists not used");
+  NS_TEST_EXPECT_MSG_GT (reused.recycled, after.recycled, "Free lists not used");
+}
+
 /**
  * \ingroup network-test
  * \ingroup tests
@@ -1167,6 +1250,7 @@ PacketTestSuite::PacketTestSuite ()
 {
   AddTestCase (new PacketTest, TestCase::QUICK);
   AddTestCase (new PacketTagListTest, TestCase::QUICK);
+  AddTestCase (new PacketAllocatorTest, TestCase::QUICK);
 }
 
 static PacketTestSuite g_packetTestSuite; //!< Static variable for test initialization
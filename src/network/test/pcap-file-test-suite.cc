@@ -20,12 +20,17 @@
 #include <cstdio>
 #include <cstdlib>
 #include <sstream>
+#include <fstream>
 #include <cstring>
 
 #include "ns3/log.h"
 #include "ns3/test.h"
 #include "ns3/pcap-file.h"
 
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+
 using namespace ns3;
 
 NS_LOG_COMPONENT_DEFINE ("pcap-file-test-suite");
@@ -1144,6 +1149,189 @@ DiffTestCase::DoRun (void)
   NS_TEST_EXPECT_MSG_EQ (usec, 3696, "Files are different from 2.3696 seconds");
 }
 
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Test case to make sure that the files written by the background
+ * I/O thread are identical to the synchronously written files.
+ */
+class BufferedWriteTestCase : public TestCase
+{
+public:
+  BufferedWriteTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Write the test records to a file.
+   *
+   * \param filename The name of the file.
+   * \param bufferSize The size of the batches, or 0 to write synchronously.
+   * \param pcapng Whether to use the pcapng format.
+   * \param compress Whether to compress the file.
+   */
+  void WriteFile (std::string filename, uint32_t bufferSize, bool pcapng, bool compress);
+
+  /**
+   * \param filename The name of the file.
+   * \returns The content of the file.
+   */
+  std::string ReadFile (std::string filename);
+
+  /** Number of records written. */
+  static constexpr uint32_t N_RECORDS = 100;
+  /** Capture size, smaller than some of the records. */
+  static constexpr uint32_t SNAPLEN = 200;
+};
+
+BufferedWriteTestCase::BufferedWriteTestCase ()
+  : TestCase ("Check the files written by a background thread")
+{
+}
+
+void
+BufferedWriteTestCase::WriteFile (std::string filename, uint32_t bufferSize, bool pcapng, bool compress)
+{
+  PcapFile f;
+  if (bufferSize == 0)
+    {
+      f.Open (filename, std::ios::out);
+    }
+  else
+    {
+      f.OpenBuffered (filename, bufferSize, compress);
+    }
+  NS_TEST_ASSERT_MSG_EQ (f.Fail (), false, "Open (" << filename << ") returns error");
+  f.Init (1, SNAPLEN, PcapFile::ZONE_DEFAULT, false, false, pcapng);
+
+  uint8_t data[300];
+  for (uint32_t i = 0; i < N_RECORDS; ++i)
+    {
+      // sizes around the buffer size and the capture size, some of them
+      // not multiple of 4 to exercise the pcapng padding
+      uint32_t size = (i * 37) % sizeof (data);
+      for (uint32_t j = 0; j < size; ++j)
+        {
+          data[j] = i + j;
+        }
+      f.Write (i, i * 1000, data, size);
+      NS_TEST_ASSERT_MSG_EQ (f.Fail (), false, "Write must not fail");
+    }
+  f.Close ();
+  NS_TEST_ASSERT_MSG_EQ (f.Fail (), false, "Close must not fail");
+}
+
+std::string
+BufferedWriteTestCase::ReadFile (std::string filename)
+{
+  std::ifstream file (filename.c_str (), std::ios::binary);
+  std::ostringstream content;
+  content << file.rdbuf ();
+  return content.str ();
+}
+
+void
+BufferedWriteTestCase::DoRun (void)
+{
+  //
+  // The buffered files are identical to the synchronous files, whatever the
+  // size of the batches, including batches smaller than a record.
+  //
+  std::string reference = CreateTempDirFilename ("sync.pcap");
+  WriteFile (reference, 0, false, false);
+  std::string expected = ReadFile (reference);
+  NS_TEST_ASSERT_MSG_NE (expected.size (), 0, "Empty reference file");
+
+  uint32_t bufferSizes[] = {64, 1000, 1 << 20};
+  for (uint32_t bufferSize : bufferSizes)
+    {
+      std::string filename = CreateTempDirFilename ("buffered.pcap");
+      WriteFile (filename, bufferSize, false, false);
+      NS_TEST_EXPECT_MSG_EQ ((ReadFile (filename) == expected), true,
+                             "Buffered file differs with batches of " << bufferSize << " bytes");
+
+      // the buffered files are regular pcap files
+      PcapFile f;
+      f.Open (filename, std::ios::in);
+      NS_TEST_ASSERT_MSG_EQ (f.Fail (), false, "Cannot read " << filename);
+      uint8_t data[SNAPLEN];
+      uint32_t tsSec, tsUsec, inclLen, origLen, readLen;
+      for (uint32_t i = 0; i < N_RECORDS; ++i)
+        {
+          f.Read (data, sizeof (data), tsSec, tsUsec, inclLen, origLen, readLen);
+          NS_TEST_ASSERT_MSG_EQ (f.Fail (), false, "Read must not fail");
+          NS_TEST_EXPECT_MSG_EQ (tsSec, i, "Wrong timestamp");
+          NS_TEST_EXPECT_MSG_EQ (origLen, (i * 37) % 300, "Wrong original length");
+          NS_TEST_EXPECT_MSG_EQ (inclLen, std::min (origLen, SNAPLEN), "Wrong included length");
+        }
+      f.Close ();
+    }
+
+  //
+  // Check the blocks of a pcapng file.
+  //
+  std::string filename = CreateTempDirFilename ("buffered.pcapng");
+  WriteFile (filename, 1000, true, false);
+  std::string pcapng = ReadFile (filename);
+  const uint8_t *p = reinterpret_cast<const uint8_t *> (pcapng.data ());
+  uint32_t offset = 0;
+  uint32_t blocks = 0;
+  while (offset + 12 <= pcapng.size ())
+    {
+      uint32_t type, length, trailer;
+      std::memcpy (&type, p + offset, 4);
+      std::memcpy (&length, p + offset + 4, 4);
+      NS_TEST_ASSERT_MSG_EQ (length % 4, 0, "Block length must be a multiple of 4");
+      NS_TEST_ASSERT_MSG_LT_OR_EQ (offset + length, pcapng.size (), "Truncated block");
+      std::memcpy (&trailer, p + offset + length - 4, 4);
+      NS_TEST_EXPECT_MSG_EQ (trailer, length, "Block lengths differ");
+      if (blocks == 0)
+        {
+          NS_TEST_EXPECT_MSG_EQ (type, 0x0a0d0d0a, "Expected a section header block");
+        }
+      else if (blocks == 1)
+        {
+          NS_TEST_EXPECT_MSG_EQ (type, 1, "Expected an interface description block");
+        }
+      else
+        {
+          uint32_t record = blocks - 2;
+          uint32_t inclLen, origLen;
+          std::memcpy (&inclLen, p + offset + 20, 4);
+          std::memcpy (&origLen, p + offset + 24, 4);
+          NS_TEST_EXPECT_MSG_EQ (type, 6, "Expected an enhanced packet block");
+          NS_TEST_EXPECT_MSG_EQ (origLen, (record * 37) % 300, "Wrong original length");
+          NS_TEST_EXPECT_MSG_EQ (inclLen, std::min (origLen, SNAPLEN), "Wrong included length");
+          NS_TEST_EXPECT_MSG_EQ (length, 32 + ((inclLen + 3) & ~3), "Wrong block length");
+        }
+      offset += length;
+      ++blocks;
+    }
+  NS_TEST_EXPECT_MSG_EQ (offset, pcapng.size (), "Trailing bytes");
+  NS_TEST_EXPECT_MSG_EQ (blocks, N_RECORDS + 2, "Wrong number of blocks");
+
+#ifdef HAVE_ZLIB
+  //
+  // A compressed file holds the same bytes as the uncompressed file.
+  //
+  filename = CreateTempDirFilename ("buffered.pcap.gz");
+  WriteFile (filename, 1000, false, true);
+  gzFile gz = gzopen (filename.c_str (), "rb");
+  NS_TEST_ASSERT_MSG_NE (gz, 0, "Cannot open " << filename);
+  std::string content;
+  char chunk[4096];
+  int n;
+  while ((n = gzread (gz, chunk, sizeof (chunk))) > 0)
+    {
+      content.append (chunk, n);
+    }
+  gzclose (gz);
+  NS_TEST_EXPECT_MSG_EQ ((content == expected), true, "Compressed file differs");
+#endif
+}
+
 /**
  * \ingroup network-test
  * \ingroup tests
@@ -1167,6 +1355,7 @@ PcapFileTestSuite::PcapFileTestSuite ()
   AddTestCase (new RecordHeaderTestCase, TestCase::QUICK);
   AddTestCase (new ReadFileTestCase, TestCase::QUICK);
   AddTestCase (new DiffTestCase, TestCase::QUICK);
+  AddTestCase (new BufferedWriteTestCase, TestCase::QUICK);
 }
 
 static PcapFileTestSuite pcapFileTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,422 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "async-file-writer.h"
+#include "ns3/abort.h"
+#include "ns3/assert.h"
+#include "ns3/log.h"
+
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#include <unistd.h>
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("AsyncFileWriter");
+
+/**
+ * \ingroup network
+ * Maximum number of full buffers of a writer waiting for the I/O thread.
+ */
+static const uint32_t MAX_PENDING_BUFFERS = 4;
+
+/**
+ * \ingroup network
+ *
+ * The I/O thread shared by all the AsyncFileWriter objects.
+ */
+class AsyncFileWriterThread
+{
+public:
+  /** \returns The I/O thread. */
+  static AsyncFileWriterThread * Get (void);
+
+  /** Register a new open writer, starting the thread if needed. */
+  void Attach (void);
+  /** Unregister a closed writer, stopping the thread if it was the last one. */
+  void Detach (void);
+  /**
+   * Queue a buffer for writing.  This blocks while the writer has too
+   * many pending buffers.
+   *
+   * \param [in] writer The writer.
+   * \param [in,out] buffer The buffer, which is moved to the queue.
+   */
+  void Submit (AsyncFileWriter *writer, std::vector<uint8_t> &buffer);
+  /**
+   * Wait for all the pending buffers of a writer to be written.
+   *
+   * \param [in] writer The writer.
+   */
+  void Wait (AsyncFileWriter *writer);
+  /**
+   * Recycle a buffer written by the thread.
+   *
+   * \param [in] writer The writer.
+   * \param [out] buffer The buffer to replace.
+   * \returns true if a written buffer was available.
+   */
+  bool Recycle (AsyncFileWriter *writer, std::vector<uint8_t> &buffer);
+
+private:
+  AsyncFileWriterThread ();
+
+  /** Restart the thread in a process forked by a process using it. */
+  void CheckFork (void);
+  /** Write the queued buffers until Detach() stops the thread. */
+  void Run (void);
+
+  /** A buffer to write. */
+  struct Job
+  {
+    AsyncFileWriter *writer;        //!< The writer.
+    std::vector<uint8_t> buffer;    //!< The buffer.
+  };
+
+  std::mutex m_mutex;               //!< Protects the fields below and the writer queues.
+  std::condition_variable m_work;   //!< Signals new jobs, or the end of the thread.
+  std::condition_variable m_done;   //!< Signals the completion of jobs.
+  std::deque<Job> m_jobs;           //!< The queued buffers.
+  std::thread *m_thread;            //!< The thread, or 0 if it is not running.
+  uint32_t m_writers;               //!< Number of open writers.
+  bool m_stop;                      //!< Whether the thread must exit.
+  pid_t m_pid;                      //!< The process running the thread.
+};
+
+AsyncFileWriterThread *
+AsyncFileWriterThread::Get (void)
+{
+  // Never destroyed: writers may be closed during the static destruction.
+  static AsyncFileWriterThread *thread = new AsyncFileWriterThread ();
+  return thread;
+}
+
+AsyncFileWriterThread::AsyncFileWriterThread ()
+  : m_thread (0),
+    m_writers (0),
+    m_stop (false),
+    m_pid (getpid ())
+{
+}
+
+void
+AsyncFileWriterThread::CheckFork (void)
+{
+  if (m_pid == getpid ())
+    {
+      return;
+    }
+  // After a fork (e.g. Checkpoint::Fork), only the calling thread runs
+  // in the child: forget about the I/O thread of the parent and about
+  // the buffers it was going to write, which the parent writes.
+  NS_LOG_LOGIC ("restarting the I/O thread after a fork");
+  m_pid = getpid ();
+  m_thread = 0;
+  for (auto &job : m_jobs)
+    {
+      job.writer->m_pending--;
+    }
+  m_jobs.clear ();
+  if (m_writers > 0)
+    {
+      m_stop = false;
+      m_thread = new std::thread (&AsyncFileWriterThread::Run, this);
+    }
+}
+
+void
+AsyncFileWriterThread::Attach (void)
+{
+  CheckFork ();
+  std::unique_lock<std::mutex> lock (m_mutex);
+  if (m_writers++ == 0)
+    {
+      NS_ASSERT (m_thread == 0);
+      m_stop = false;
+      m_thread = new std::thread (&AsyncFileWriterThread::Run, this);
+    }
+}
+
+void
+AsyncFileWriterThread::Detach (void)
+{
+  CheckFork ();
+  std::thread *thread = 0;
+  {
+    std::unique_lock<std::mutex> lock (m_mutex);
+    NS_ASSERT (m_writers > 0);
+    if (--m_writers == 0)
+      {
+        m_stop = true;
+        thread = m_thread;
+        m_thread = 0;
+        m_work.notify_one ();
+      }
+  }
+  if (thread != 0)
+    {
+      thread->join ();
+      delete thread;
+    }
+}
+
+void
+AsyncFileWriterThread::Submit (AsyncFileWriter *writer, std::vector<uint8_t> &buffer)
+{
+  CheckFork ();
+  std::unique_lock<std::mutex> lock (m_mutex);
+  while (writer->m_pending >= MAX_PENDING_BUFFERS)
+    {
+      m_done.wait (lock);
+    }
+  writer->m_pending++;
+  m_jobs.push_back (Job {writer, std::move (buffer)});
+  m_work.notify_one ();
+}
+
+void
+AsyncFileWriterThread::Wait (AsyncFileWriter *writer)
+{
+  CheckFork ();
+  std::unique_lock<std::mutex> lock (m_mutex);
+  while (writer->m_pending > 0)
+    {
+      m_done.wait (lock);
+    }
+}
+
+bool
+AsyncFileWriterThread::Recycle (AsyncFileWriter *writer, std::vector<uint8_t> &buffer)
+{
+  std::unique_lock<std::mutex> lock (m_mutex);
+  if (writer->m_spare.empty ())
+    {
+      return false;
+    }
+  buffer = std::move (writer->m_spare.back ());
+  writer->m_spare.pop_back ();
+  return true;
+}
+
+void
+AsyncFileWriterThread::Run (void)
+{
+  std::unique_lock<std::mutex> lock (m_mutex);
+  while (true)
+    {
+      while (m_jobs.empty () && !m_stop)
+        {
+          m_work.wait (lock);
+        }
+      if (m_jobs.empty ())
+        {
+          // m_stop is only set once all the writers are closed.
+          return;
+        }
+      Job job = std::move (m_jobs.front ());
+      m_jobs.pop_front ();
+      lock.unlock ();
+      job.writer->WriteBuffer (job.buffer);
+      lock.lock ();
+      job.writer->m_pending--;
+      job.writer->m_spare.push_back (std::move (job.buffer));
+      m_done.notify_all ();
+    }
+}
+
+
+AsyncFileWriter::AsyncFileWriter ()
+  : m_file (0),
+    m_compress (false),
+    m_bufferSize (0),
+    m_used (0),
+    m_pending (0),
+    m_fail (false)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+AsyncFileWriter::~AsyncFileWriter ()
+{
+  NS_LOG_FUNCTION (this);
+  Close ();
+}
+
+bool
+AsyncFileWriter::IsCompressionSupported (void)
+{
+#ifdef HAVE_ZLIB
+  return true;
+#else
+  return false;
+#endif
+}
+
+void
+AsyncFileWriter::Open (std::string const &filename, uint32_t bufferSize, bool compress)
+{
+  NS_LOG_FUNCTION (this << filename << bufferSize << compress);
+  NS_ASSERT (!IsOpen ());
+  NS_ABORT_MSG_IF (compress && !IsCompressionSupported (),
+                   "Compressing " << filename << " requires ns-3 to be built with zlib");
+  m_filename = filename;
+  m_compress = compress;
+  m_bufferSize = bufferSize;
+  m_used = 0;
+  m_fail = false;
+#ifdef HAVE_ZLIB
+  if (compress)
+    {
+      m_file = gzopen (filename.c_str (), "wb");
+    }
+  else
+#endif
+    {
+      m_file = std::fopen (filename.c_str (), "wb");
+    }
+  if (m_file == 0)
+    {
+      NS_LOG_LOGIC ("cannot open " << filename);
+      m_fail = true;
+      return;
+    }
+  m_buffer.resize (bufferSize);
+  AsyncFileWriterThread::Get ()->Attach ();
+}
+
+void
+AsyncFileWriter::Close (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (!IsOpen ())
+    {
+      return;
+    }
+  Submit ();
+  AsyncFileWriterThread::Get ()->Wait (this);
+  AsyncFileWriterThread::Get ()->Detach ();
+#ifdef HAVE_ZLIB
+  if (m_compress)
+    {
+      if (gzclose (static_cast<gzFile> (m_file)) != Z_OK)
+        {
+          m_fail = true;
+        }
+    }
+  else
+#endif
+    {
+      if (std::fclose (static_cast<FILE *> (m_file)) != 0)
+        {
+          m_fail = true;
+        }
+    }
+  m_file = 0;
+  m_buffer.clear ();
+  m_spare.clear ();
+}
+
+bool
+AsyncFileWriter::Fail (void) const
+{
+  return m_fail;
+}
+
+bool
+AsyncFileWriter::IsOpen (void) const
+{
+  return m_file != 0;
+}
+
+uint8_t *
+AsyncFileWriter::Reserve (uint32_t size)
+{
+  NS_ASSERT (IsOpen ());
+  if (m_used + size > m_buffer.size ())
+    {
+      Submit ();
+      if (size > m_buffer.size ())
+        {
+          // a record larger than the buffers gets a buffer of its own
+          m_buffer.resize (size);
+        }
+    }
+  uint8_t *p = m_buffer.data () + m_used;
+  m_used += size;
+  return p;
+}
+
+void
+AsyncFileWriter::Write (const void *data, uint32_t size)
+{
+  std::memcpy (Reserve (size), data, size);
+}
+
+void
+AsyncFileWriter::Submit (void)
+{
+  if (m_used == 0)
+    {
+      return;
+    }
+  NS_LOG_LOGIC ("submit " << m_used << " bytes of " << m_filename);
+  m_buffer.resize (m_used);
+  AsyncFileWriterThread::Get ()->Submit (this, m_buffer);
+  if (!AsyncFileWriterThread::Get ()->Recycle (this, m_buffer))
+    {
+      m_buffer = std::vector<uint8_t> ();
+    }
+  m_buffer.resize (m_bufferSize);
+  m_used = 0;
+}
+
+void
+AsyncFileWriter::WriteBuffer (const std::vector<uint8_t> &buffer)
+{
+  // Called from the I/O thread: no logging.
+  if (m_fail)
+    {
+      return;
+    }
+#ifdef HAVE_ZLIB
+  if (m_compress)
+    {
+      if (gzwrite (static_cast<gzFile> (m_file), buffer.data (), buffer.size ())
+          != static_cast<int> (buffer.size ()))
+        {
+          m_fail = true;
+        }
+      return;
+    }
+#endif
+  if (std::fwrite (buffer.data (), 1, buffer.size (), static_cast<FILE *> (m_file))
+      != buffer.size ())
+    {
+      m_fail = true;
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,128 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef ASYNC_FILE_WRITER_H
+#define ASYNC_FILE_WRITER_H
+
+#include <atomic>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+namespace ns3 {
+
+/**
+ * \ingroup network
+ *
+ * \brief Write a file in large batches from a background thread.
+ *
+ * The data written to an AsyncFileWriter is accumulated into a buffer
+ * of the size given to Open().  When that buffer is full, it is handed
+ * to a background I/O thread, which writes it, optionally compressing
+ * it with gzip, while the simulation continues.  All the writers of a
+ * process share a single I/O thread, which is started by the first
+ * Open() and stopped by the last Close().
+ *
+ * A writer holds at most a few full buffers waiting for the I/O thread:
+ * beyond that, writing blocks until the I/O thread catches up.
+ *
+ * The data which was not handed to the I/O thread yet is lost if the
+ * process terminates without closing the writer, e.g. after a fatal
+ * error.
+ */
+class AsyncFileWriter
+{
+public:
+  AsyncFileWriter ();
+  ~AsyncFileWriter ();
+
+  /**
+   * \returns true if compression is supported, i.e. if ns-3 was built
+   *          with zlib.
+   */
+  static bool IsCompressionSupported (void);
+
+  /**
+   * Create a new file, truncating any existing file.
+   *
+   * \param [in] filename The name of the file.
+   * \param [in] bufferSize The size of the batches written by the I/O
+   *             thread, in bytes.
+   * \param [in] compress Whether to compress the file with gzip.
+   */
+  void Open (std::string const &filename, uint32_t bufferSize, bool compress);
+
+  /**
+   * Write all the data to the file and close it.  This waits for the
+   * I/O thread to write all the pending buffers of this writer.
+   */
+  void Close (void);
+
+  /**
+   * \returns true if the file could not be opened or written.
+   */
+  bool Fail (void) const;
+
+  /**
+   * \returns true if the file is open.
+   */
+  bool IsOpen (void) const;
+
+  /**
+   * Get contiguous room for the next \pname{size} bytes of the file.
+   *
+   * \param [in] size The number of bytes to write.
+   * \returns The buffer where these bytes must be written before the
+   *          next call to this writer.
+   */
+  uint8_t * Reserve (uint32_t size);
+
+  /**
+   * Write data to the file.
+   *
+   * \param [in] data The data to write.
+   * \param [in] size The size of \pname{data}.
+   */
+  void Write (const void *data, uint32_t size);
+
+private:
+  /// The I/O thread writes the buffers.
+  friend class AsyncFileWriterThread;
+
+  /** Hand the current buffer to the I/O thread. */
+  void Submit (void);
+
+  /**
+   * Write a buffer to the file, from the I/O thread.
+   *
+   * \param [in] buffer The buffer to write.
+   */
+  void WriteBuffer (const std::vector<uint8_t> &buffer);
+
+  std::string m_filename;               //!< The name of the file.
+  void *m_file;                         //!< The FILE or gzFile.
+  bool m_compress;                      //!< Whether m_file is a gzFile.
+  uint32_t m_bufferSize;                //!< The size of the buffers.
+  std::vector<uint8_t> m_buffer;        //!< The buffer being filled.
+  uint32_t m_used;                      //!< The size of the data in m_buffer.
+  std::vector<std::vector<uint8_t> > m_spare; //!< Buffers written by the I/O thread.
+  uint32_t m_pending;                   //!< Number of buffers waiting for the I/O thread.
+  std::atomic<bool> m_fail;             //!< Whether an error occurred.
+};
+
+} // namespace ns3
+
+#endif /* ASYNC_FILE_WRITER_H */
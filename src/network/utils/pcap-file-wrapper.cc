@@ -17,6 +17,7 @@
  */
 
 #include "ns3/log.h"
+#include "ns3/abort.h"
 #include "ns3/boolean.h"
 #include "ns3/uinteger.h"
 #include "ns3/buffer.h"
@@ -46,6 +47,25 @@ PcapFileWrapper::GetTypeId (void)
                    BooleanValue (false),
                    MakeBooleanAccessor (&PcapFileWrapper::m_nanosecMode),
                    MakeBooleanChecker())
+    .AddAttribute ("BufferSize",
+                   "Size of the batches in which a write-only file is written by "
+                   "a background thread, in bytes.  0 writes the packets synchronously.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&PcapFileWrapper::m_bufferSize),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("Pcapng",
+                   "Whether to write the file in the pcapng format instead of the pcap format. "
+                   "The pcapng files cannot be read back by ns-3.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&PcapFileWrapper::m_pcapng),
+                   MakeBooleanChecker ())
+    .AddAttribute ("Compress",
+                   "Whether to compress a write-only file with gzip, adding the .gz "
+                   "extension to its name.  This requires a non-zero BufferSize and "
+                   "ns-3 to be built with zlib.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&PcapFileWrapper::m_compress),
+                   MakeBooleanChecker ())
   ;
   return tid;
 }
@@ -93,6 +113,18 @@ void
 PcapFileWrapper::Open (std::string const &filename, std::ios::openmode mode)
 {
   NS_LOG_FUNCTION (this << filename << mode);
+  if ((mode & std::ios::in) == 0 && m_bufferSize > 0)
+    {
+      std::string name = filename;
+      if (m_compress && (name.size () < 3 || name.compare (name.size () - 3, 3, ".gz") != 0))
+        {
+          name += ".gz";
+        }
+      m_file.OpenBuffered (name, m_bufferSize, m_compress);
+      return;
+    }
+  NS_ABORT_MSG_IF (m_compress, "PcapFileWrapper: compressing " << filename
+                   << " requires a write-only file and a non-zero BufferSize");
   m_file.Open (filename, mode);
 }
 
@@ -107,11 +139,11 @@ PcapFileWrapper::Init (uint32_t dataLinkType, uint32_t snapLen, int32_t tzCorrec
   NS_LOG_FUNCTION (this << dataLinkType << snapLen << tzCorrection);
   if (snapLen != std::numeric_limits<uint32_t>::max ())
     {
-      m_file.Init (dataLinkType, snapLen, tzCorrection, false, m_nanosecMode);
+      m_file.Init (dataLinkType, snapLen, tzCorrection, false, m_nanosecMode, m_pcapng);
     } 
   else
     {
-      m_file.Init (dataLinkType, m_snapLen, tzCorrection, false, m_nanosecMode);
+      m_file.Init (dataLinkType, m_snapLen, tzCorrection, false, m_nanosecMode, m_pcapng);
     } 
 }
 
@@ -70,6 +70,11 @@ public:
    * selected as a binary file (fstream::binary is automatically ored with the mode
    * field).
    *
+   * If the "BufferSize" attribute is not zero and the file is opened for
+   * writing only, the file is written in batches of that size by a
+   * background thread (see PcapFile::OpenBuffered), and compressed with
+   * gzip if the "Compress" attribute is true.
+   *
    * \param filename String containing the name of the file.
    *
    * \param mode String containing the access mode for the file.
@@ -224,6 +229,9 @@ private:
   PcapFile m_file; //!< Pcap file
   uint32_t m_snapLen; //!< max length of saved packets
   bool     m_nanosecMode; //!< Timestamps in nanosecond mode
+  uint32_t m_bufferSize; //!< Size of the batches of the background writer, or 0
+  bool     m_pcapng; //!< Write the pcapng format
+  bool     m_compress; //!< Compress the file with gzip
 };
 
 } // namespace ns3
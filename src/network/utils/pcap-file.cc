@@ -27,6 +27,7 @@
 #include "ns3/header.h"
 #include "ns3/buffer.h"
 #include "pcap-file.h"
+#include "ns3/abort.h"
 #include "ns3/log.h"
 #include "ns3/build-profile.h"
 //
@@ -47,10 +48,17 @@ const uint32_t NS_SWAPPED_MAGIC = 0x4d3cb2a1; /**< Looks this way if byte swappi
 const uint16_t VERSION_MAJOR = 2;             /**< Major version of supported pcap file format */
 const uint16_t VERSION_MINOR = 4;             /**< Minor version of supported pcap file format */
 
+const uint32_t PCAPNG_SECTION_HEADER = 0x0a0d0d0a;  /**< Type of the pcapng Section Header Block */
+const uint32_t PCAPNG_INTERFACE = 1;                /**< Type of the pcapng Interface Description Block */
+const uint32_t PCAPNG_ENHANCED_PACKET = 6;          /**< Type of the pcapng Enhanced Packet Block */
+const uint32_t PCAPNG_BYTE_ORDER_MAGIC = 0x1a2b3c4d; /**< Identifies the byte order of a pcapng section */
+const uint16_t PCAPNG_IF_TSRESOL = 9;               /**< pcapng option giving the timestamp resolution */
+
 PcapFile::PcapFile ()
   : m_file (),
     m_swapMode (false),
-    m_nanosecMode (false)
+    m_nanosecMode (false),
+    m_pcapng (false)
 {
   NS_LOG_FUNCTION (this);
   FatalImpl::RegisterStream (&m_file);
@@ -68,7 +76,7 @@ bool
 PcapFile::Fail (void) const
 {
   NS_LOG_FUNCTION (this);
-  return m_file.fail ();
+  return m_file.fail () || m_writer.Fail ();
 }
 bool
 PcapFile::Eof (void) const
@@ -88,7 +96,14 @@ void
 PcapFile::Close (void)
 {
   NS_LOG_FUNCTION (this);
-  m_file.close ();
+  if (m_writer.IsOpen ())
+    {
+      m_writer.Close ();
+    }
+  else
+    {
+      m_file.close ();
+    }
 }
 
 uint32_t
@@ -198,6 +213,61 @@ PcapFile::Swap (PcapRecordHeader *from, PcapRecordHeader *to)
   to->m_origLen = Swap (from->m_origLen);
 }
 
+void
+PcapFile::WriteRaw (const void *data, uint32_t size)
+{
+  if (m_writer.IsOpen ())
+    {
+      m_writer.Write (data, size);
+    }
+  else
+    {
+      m_file.write ((const char *)data, size);
+    }
+}
+
+void
+PcapFile::WritePcapngHeader (void)
+{
+  NS_LOG_FUNCTION (this);
+  //
+  // A pcapng file starts with a Section Header Block, followed by the
+  // Interface Description Block of the single interface of the file.
+  // The blocks are written in the native byte order, which the readers
+  // find from the byte-order magic.
+  //
+  uint32_t blockType = PCAPNG_SECTION_HEADER;
+  uint32_t length = 28;
+  uint32_t magic = PCAPNG_BYTE_ORDER_MAGIC;
+  uint16_t versionMajor = 1;
+  uint16_t versionMinor = 0;
+  int64_t sectionLength = -1; // unknown
+  WriteRaw (&blockType, sizeof (blockType));
+  WriteRaw (&length, sizeof (length));
+  WriteRaw (&magic, sizeof (magic));
+  WriteRaw (&versionMajor, sizeof (versionMajor));
+  WriteRaw (&versionMinor, sizeof (versionMinor));
+  WriteRaw (&sectionLength, sizeof (sectionLength));
+  WriteRaw (&length, sizeof (length));
+
+  blockType = PCAPNG_INTERFACE;
+  length = m_nanosecMode ? 32 : 20;
+  uint16_t linkType = m_fileHeader.m_type;
+  uint16_t reserved = 0;
+  WriteRaw (&blockType, sizeof (blockType));
+  WriteRaw (&length, sizeof (length));
+  WriteRaw (&linkType, sizeof (linkType));
+  WriteRaw (&reserved, sizeof (reserved));
+  WriteRaw (&m_fileHeader.m_snapLen, sizeof (m_fileHeader.m_snapLen));
+  if (m_nanosecMode)
+    {
+      // if_tsresol = 9 (nanoseconds), then the end of the options
+      uint16_t option[] = {PCAPNG_IF_TSRESOL, 1, 9, 0, 0, 0};
+      WriteRaw (option, sizeof (option));
+    }
+  WriteRaw (&length, sizeof (length));
+}
+
 void
 PcapFile::WriteFileHeader (void)
 {
@@ -206,7 +276,16 @@ PcapFile::WriteFileHeader (void)
   // If we're initializing the file, we need to write the pcap file header
   // at the start of the file.
   //
-  m_file.seekp (0, std::ios::beg);
+  if (!m_writer.IsOpen ())
+    {
+      m_file.seekp (0, std::ios::beg);
+    }
+
+  if (m_pcapng)
+    {
+      WritePcapngHeader ();
+      return;
+    }
 
   //
   // We have the ability to write out the pcap file header in a foreign endian
@@ -234,13 +313,13 @@ PcapFile::WriteFileHeader (void)
   // Watch out for memory alignment differences between machines, so write
   // them all individually.
   //
-  m_file.write ((const char *)&headerOut->m_magicNumber, sizeof(headerOut->m_magicNumber));
-  m_file.write ((const char *)&headerOut->m_versionMajor, sizeof(headerOut->m_versionMajor));
-  m_file.write ((const char *)&headerOut->m_versionMinor, sizeof(headerOut->m_versionMinor));
-  m_file.write ((const char *)&headerOut->m_zone, sizeof(headerOut->m_zone));
-  m_file.write ((const char *)&headerOut->m_sigFigs, sizeof(headerOut->m_sigFigs));
-  m_file.write ((const char *)&headerOut->m_snapLen, sizeof(headerOut->m_snapLen));
-  m_file.write ((const char *)&headerOut->m_type, sizeof(headerOut->m_type));
+  WriteRaw (&headerOut->m_magicNumber, sizeof(headerOut->m_magicNumber));
+  WriteRaw (&headerOut->m_versionMajor, sizeof(headerOut->m_versionMajor));
+  WriteRaw (&headerOut->m_versionMinor, sizeof(headerOut->m_versionMinor));
+  WriteRaw (&headerOut->m_zone, sizeof(headerOut->m_zone));
+  WriteRaw (&headerOut->m_sigFigs, sizeof(headerOut->m_sigFigs));
+  WriteRaw (&headerOut->m_snapLen, sizeof(headerOut->m_snapLen));
+  WriteRaw (&headerOut->m_type, sizeof(headerOut->m_type));
 }
 
 void
@@ -342,9 +421,21 @@ PcapFile::Open (std::string const &filename, std::ios::openmode mode)
 }
 
 void
-PcapFile::Init (uint32_t dataLinkType, uint32_t snapLen, int32_t timeZoneCorrection, bool swapMode, bool nanosecMode)
+PcapFile::OpenBuffered (std::string const &filename, uint32_t bufferSize, bool compress)
+{
+  NS_LOG_FUNCTION (this << filename << bufferSize << compress);
+  NS_ASSERT (!m_file.is_open () && !m_writer.IsOpen ());
+  NS_ABORT_MSG_IF (bufferSize == 0, "Buffered pcap files need a non-zero buffer size");
+
+  m_filename = filename;
+  m_writer.Open (filename, bufferSize, compress);
+}
+
+void
+PcapFile::Init (uint32_t dataLinkType, uint32_t snapLen, int32_t timeZoneCorrection, bool swapMode, bool nanosecMode, bool pcapng)
 {
-  NS_LOG_FUNCTION (this << dataLinkType << snapLen << timeZoneCorrection << swapMode);
+  NS_LOG_FUNCTION (this << dataLinkType << snapLen << timeZoneCorrection << swapMode << pcapng);
+  m_pcapng = pcapng;
 
   //
   // Initialize the magic number and nanosecond mode flag
@@ -407,6 +498,28 @@ PcapFile::WritePacketHeader (uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen)
 
   uint32_t inclLen = totalLen > m_fileHeader.m_snapLen ? m_fileHeader.m_snapLen : totalLen;
 
+  if (m_pcapng)
+    {
+      //
+      // Enhanced Packet Block, with the timestamp in microseconds or in
+      // nanoseconds (if_tsresol) since the epoch.
+      //
+      uint32_t blockType = PCAPNG_ENHANCED_PACKET;
+      uint32_t length = 32 + ((inclLen + 3) & (~3));
+      uint32_t interfaceId = 0;
+      uint64_t timestamp = tsSec * (m_nanosecMode ? 1000000000ULL : 1000000ULL) + tsUsec;
+      uint32_t timestampHigh = timestamp >> 32;
+      uint32_t timestampLow = timestamp & 0xffffffff;
+      WriteRaw (&blockType, sizeof (blockType));
+      WriteRaw (&length, sizeof (length));
+      WriteRaw (&interfaceId, sizeof (interfaceId));
+      WriteRaw (&timestampHigh, sizeof (timestampHigh));
+      WriteRaw (&timestampLow, sizeof (timestampLow));
+      WriteRaw (&inclLen, sizeof (inclLen));
+      WriteRaw (&totalLen, sizeof (totalLen));
+      return inclLen;
+    }
+
   PcapRecordHeader header;
   header.m_tsSec = tsSec;
   header.m_tsUsec = tsUsec;
@@ -422,21 +535,37 @@ PcapFile::WritePacketHeader (uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen)
   // Watch out for memory alignment differences between machines, so write
   // them all individually.
   //
-  m_file.write ((const char *)&header.m_tsSec, sizeof(header.m_tsSec));
-  m_file.write ((const char *)&header.m_tsUsec, sizeof(header.m_tsUsec));
-  m_file.write ((const char *)&header.m_inclLen, sizeof(header.m_inclLen));
-  m_file.write ((const char *)&header.m_origLen, sizeof(header.m_origLen));
-  NS_BUILD_DEBUG(m_file.flush());
+  WriteRaw (&header.m_tsSec, sizeof(header.m_tsSec));
+  WriteRaw (&header.m_tsUsec, sizeof(header.m_tsUsec));
+  WriteRaw (&header.m_inclLen, sizeof(header.m_inclLen));
+  WriteRaw (&header.m_origLen, sizeof(header.m_origLen));
   return inclLen;
 }
 
+void
+PcapFile::WritePacketTrailer (uint32_t inclLen)
+{
+  if (m_pcapng)
+    {
+      // pad the packet data to 32 bits, and repeat the block length
+      uint32_t padding = 0;
+      WriteRaw (&padding, ((inclLen + 3) & (~3)) - inclLen);
+      uint32_t length = 32 + ((inclLen + 3) & (~3));
+      WriteRaw (&length, sizeof (length));
+    }
+  if (!m_writer.IsOpen ())
+    {
+      NS_BUILD_DEBUG(m_file.flush());
+    }
+}
+
 void
 PcapFile::Write (uint32_t tsSec, uint32_t tsUsec, uint8_t const * const data, uint32_t totalLen)
 {
   NS_LOG_FUNCTION (this << tsSec << tsUsec << &data << totalLen);
   uint32_t inclLen = WritePacketHeader (tsSec, tsUsec, totalLen);
-  m_file.write ((const char *)data, inclLen);
-  NS_BUILD_DEBUG(m_file.flush());
+  WriteRaw (data, inclLen);
+  WritePacketTrailer (inclLen);
 }
 
 void
@@ -444,8 +573,15 @@ PcapFile::Write (uint32_t tsSec, uint32_t tsUsec, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (this << tsSec << tsUsec << p);
   uint32_t inclLen = WritePacketHeader (tsSec, tsUsec, p->GetSize ());
-  p->CopyData (&m_file, inclLen);
-  NS_BUILD_DEBUG(m_file.flush());
+  if (m_writer.IsOpen ())
+    {
+      p->CopyData (m_writer.Reserve (inclLen), inclLen);
+    }
+  else
+    {
+      p->CopyData (&m_file, inclLen);
+    }
+  WritePacketTrailer (inclLen);
 }
 
 void
@@ -460,9 +596,19 @@ PcapFile::Write (uint32_t tsSec, uint32_t tsUsec, const Header &header, Ptr<cons
   headerBuffer.AddAtStart (headerSize);
   header.Serialize (headerBuffer.Begin ());
   uint32_t toCopy = std::min (headerSize, inclLen);
-  headerBuffer.CopyData (&m_file, toCopy);
-  inclLen -= toCopy;
-  p->CopyData (&m_file, inclLen);
+  uint32_t packetLen = inclLen - toCopy;
+  if (m_writer.IsOpen ())
+    {
+      uint8_t *data = m_writer.Reserve (inclLen);
+      headerBuffer.CopyData (data, toCopy);
+      p->CopyData (data + toCopy, packetLen);
+    }
+  else
+    {
+      headerBuffer.CopyData (&m_file, toCopy);
+      p->CopyData (&m_file, packetLen);
+    }
+  WritePacketTrailer (inclLen);
 }
 
 void
@@ -477,6 +623,7 @@ PcapFile::Read (
 {
   NS_LOG_FUNCTION (this << &data <<maxBytes << tsSec << tsUsec << inclLen << origLen << readLen);
   NS_ASSERT (m_file.good ());
+  NS_ASSERT (!m_writer.IsOpen ());
 
   PcapRecordHeader header;
 
@@ -25,6 +25,7 @@
 #include <fstream>
 #include <stdint.h>
 #include "ns3/ptr.h"
+#include "async-file-writer.h"
 
 namespace ns3 {
 
@@ -80,6 +81,17 @@ public:
    */
   void Open (std::string const &filename, std::ios::openmode mode);
 
+  /**
+   * Create a new pcap file, written in large batches by a background
+   * I/O thread (see AsyncFileWriter).  A file opened this way is
+   * write-only: it cannot be read back with this object.
+   *
+   * \param filename String containing the name of the file.
+   * \param bufferSize The size of the batches, in bytes.
+   * \param compress Whether to compress the file with gzip.
+   */
+  void OpenBuffered (std::string const &filename, uint32_t bufferSize, bool compress = false);
+
   /**
    * Close the underlying file.
    */
@@ -111,6 +123,10 @@ public:
    * \param nanosecMode Flag indicating the time resolution of the writing
    * system. Default to false.
    *
+   * \param pcapng Flag indicating whether to write the file in the pcapng
+   * format instead of the classic pcap format.  The pcapng files can be
+   * written, but not read, by this class.  Defaults to false.
+   *
    * \warning Calling this method on an existing file will result in the loss
    * any existing data.
    */
@@ -118,7 +134,8 @@ public:
              uint32_t snapLen = SNAPLEN_DEFAULT, 
              int32_t timeZoneCorrection = ZONE_DEFAULT,
              bool swapMode = false,
-             bool nanosecMode = false);
+             bool nanosecMode = false,
+             bool pcapng = false);
 
   /**
    * \brief Write next packet to file
@@ -358,6 +375,23 @@ private:
    * \returns the length of the packet to write in the Pcap file
    */
   uint32_t WritePacketHeader (uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen);
+  /**
+   * \brief Complete a packet record, after its data
+   *
+   * \param inclLen the length of the packet data written in the file
+   */
+  void WritePacketTrailer (uint32_t inclLen);
+  /**
+   * \brief Write the pcapng section header and interface description blocks
+   */
+  void WritePcapngHeader (void);
+  /**
+   * \brief Write data to the buffered writer or to the file stream
+   *
+   * \param data the data to write
+   * \param size the size of the data
+   */
+  void WriteRaw (const void *data, uint32_t size);
 
   /**
    * \brief Read and verify a Pcap file header
@@ -369,6 +403,8 @@ private:
   PcapFileHeader m_fileHeader;  //!< file header
   bool m_swapMode;              //!< swap mode
   bool m_nanosecMode;           //!< nanosecond timestamp mode
+  bool m_pcapng;                //!< pcapng format
+  AsyncFileWriter m_writer;     //!< buffered writer, used instead of m_file by OpenBuffered
 };
 
 } // namespace ns3
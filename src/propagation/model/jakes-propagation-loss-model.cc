@@ -21,6 +21,7 @@
 #include "jakes-propagation-loss-model.h"
 #include "ns3/double.h"
 #include "ns3/log.h"
+#include "ns3/uinteger.h"
 
 namespace ns3
 {
@@ -47,6 +48,41 @@ JakesPropagationLossModel::GetTypeId ()
     .SetParent<PropagationLossModel> ()
     .SetGroupName ("Propagation")
     .AddConstructor<JakesPropagationLossModel> ()
+    .AddAttribute ("CacheCapacity",
+                   "The maximum number of paths whose JakesProcess is kept, "
+                   "or 0 for no limit. The least recently used paths are "
+                   "evicted first, and get a new JakesProcess when they are "
+                   "used again.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&JakesPropagationLossModel::SetCacheCapacity,
+                                         &JakesPropagationLossModel::GetCacheCapacity),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("CacheSize",
+                   "The number of paths whose JakesProcess is kept.",
+                   TypeId::ATTR_GET,
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&JakesPropagationLossModel::GetCacheSize),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("CacheHits",
+                   "The number of Rx power computations which found the "
+                   "JakesProcess of their path.",
+                   TypeId::ATTR_GET,
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&JakesPropagationLossModel::GetCacheHits),
+                   MakeUintegerChecker<uint64_t> ())
+    .AddAttribute ("CacheMisses",
+                   "The number of Rx power computations which created the "
+                   "JakesProcess of their path.",
+                   TypeId::ATTR_GET,
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&JakesPropagationLossModel::GetCacheMisses),
+                   MakeUintegerChecker<uint64_t> ())
+    .AddAttribute ("CacheEvictions",
+                   "The number of paths whose JakesProcess was evicted.",
+                   TypeId::ATTR_GET,
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&JakesPropagationLossModel::GetCacheEvictions),
+                   MakeUintegerChecker<uint64_t> ())
   ;
   return tid;
 }
@@ -66,6 +102,42 @@ JakesPropagationLossModel::DoCalcRxPower (double txPowerDbm,
   return txPowerDbm + pathData->GetChannelGainDb ();
 }
 
+void
+JakesPropagationLossModel::SetCacheCapacity (uint32_t capacity)
+{
+  m_propagationCache.SetCapacity (capacity);
+}
+
+uint32_t
+JakesPropagationLossModel::GetCacheCapacity () const
+{
+  return m_propagationCache.GetCapacity ();
+}
+
+uint32_t
+JakesPropagationLossModel::GetCacheSize () const
+{
+  return m_propagationCache.GetSize ();
+}
+
+uint64_t
+JakesPropagationLossModel::GetCacheHits () const
+{
+  return m_propagationCache.GetHits ();
+}
+
+uint64_t
+JakesPropagationLossModel::GetCacheMisses () const
+{
+  return m_propagationCache.GetMisses ();
+}
+
+uint64_t
+JakesPropagationLossModel::GetCacheEvictions () const
+{
+  return m_propagationCache.GetEvictions ();
+}
+
 Ptr<UniformRandomVariable>
 JakesPropagationLossModel::GetUniformRandomVariable () const
 {
@@ -48,6 +48,32 @@ public:
   JakesPropagationLossModel (const JakesPropagationLossModel &) = delete;
   JakesPropagationLossModel & operator = (const JakesPropagationLossModel &) = delete;
 
+  /**
+   * Set the maximum number of paths whose JakesProcess is kept
+   * \param capacity the maximum number of paths, or 0 for no limit
+   */
+  void SetCacheCapacity (uint32_t capacity);
+  /**
+   * \return the maximum number of paths whose JakesProcess is kept, or 0 for no limit
+   */
+  uint32_t GetCacheCapacity () const;
+  /**
+   * \return the number of paths whose JakesProcess is kept
+   */
+  uint32_t GetCacheSize () const;
+  /**
+   * \return the number of Rx power computations which found the JakesProcess of their path
+   */
+  uint64_t GetCacheHits () const;
+  /**
+   * \return the number of Rx power computations which created the JakesProcess of their path
+   */
+  uint64_t GetCacheMisses () const;
+  /**
+   * \return the number of paths whose JakesProcess was evicted
+   */
+  uint64_t GetCacheEvictions () const;
+
 private:
   friend class JakesProcess;
 
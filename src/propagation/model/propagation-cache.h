@@ -21,7 +21,9 @@
 #define PROPAGATION_CACHE_H_
 
 #include "ns3/mobility-model.h"
-#include <map>
+#include <algorithm>
+#include <stdint.h>
+#include <vector>
 
 namespace ns3
 {
@@ -30,12 +32,32 @@ namespace ns3
  * \brief Constructs a cache of objects, where each object is responsible for a single propagation path loss calculations.
  * Propagation path a-->b and b-->a is the same thing. Propagation path is identified by
  * a couple of MobilityModels and a spectrum model UID
+ *
+ * The paths are kept in a hash table with open addressing and linear
+ * probing, keyed by the addresses of the two MobilityModels, in
+ * increasing order, and the spectrum model UID.  The cache holds a
+ * reference to the MobilityModels, so that an address is not reused
+ * by another path while its entry is in the cache.
+ *
+ * The cache is unbounded by default.  When a capacity is set, adding a
+ * path to a full cache evicts a path with the CLOCK algorithm, an
+ * approximation of the least recently used policy: each path has a
+ * reference bit, set when it is found by GetPathData; the clock hand
+ * sweeps the paths, clearing the bits which are set, and evicts the
+ * first path whose bit is clear.  The data of an evicted path is lost,
+ * e.g., a new JakesProcess is created for it if it is used again.
  */
 template<class T>
 class PropagationCache
 {
 public:
-  PropagationCache () {};
+  PropagationCache ()
+    : m_capacity (0),
+      m_hand (0),
+      m_hits (0),
+      m_misses (0),
+      m_evictions (0)
+  {};
   ~PropagationCache () {};
 
   /**
@@ -48,12 +70,16 @@ public:
   Ptr<T> GetPathData (Ptr<const MobilityModel> a, Ptr<const MobilityModel> b, uint32_t modelUid)
   {
     PropagationPathIdentifier key = PropagationPathIdentifier (a, b, modelUid);
-    typename PathCache::iterator it = m_pathCache.find (key);
-    if (it == m_pathCache.end ())
+    std::size_t slot = Find (key, Hash (key));
+    if (m_slots.empty () || m_slots[slot] == 0)
       {
+        ++m_misses;
         return 0;
       }
-    return it->second;
+    ++m_hits;
+    Entry &entry = m_entries[m_slots[slot] - 1];
+    entry.m_referenced = true;
+    return entry.m_data;
   };
 
   /**
@@ -66,61 +92,263 @@ public:
   void AddPathData (Ptr<T> data, Ptr<const MobilityModel> a, Ptr<const MobilityModel> b, uint32_t modelUid)
   {
     PropagationPathIdentifier key = PropagationPathIdentifier (a, b, modelUid);
-    NS_ASSERT (m_pathCache.find (key) == m_pathCache.end ());
-    m_pathCache.insert (std::make_pair (key, data)); 
+    if (m_capacity > 0 && m_entries.size () >= m_capacity)
+      {
+        Evict ();
+      }
+    if ((m_entries.size () + 1) * 2 > m_slots.size ())
+      {
+        Rehash (std::max<std::size_t> (16, m_slots.size () * 2));
+      }
+    std::size_t hash = Hash (key);
+    std::size_t slot = Find (key, hash);
+    NS_ASSERT (m_slots[slot] == 0);
+    Entry entry;
+    entry.m_key = key;
+    entry.m_hash = hash;
+    entry.m_data = data;
+    entry.m_referenced = false;
+    m_entries.push_back (entry);
+    m_slots[slot] = m_entries.size ();
+  };
+
+  /**
+   * Set the maximum number of paths in the cache, evicting the paths
+   * in excess
+   * \param capacity the maximum number of paths, or 0 for no limit
+   */
+  void SetCapacity (uint32_t capacity)
+  {
+    m_capacity = capacity;
+    while (m_capacity > 0 && m_entries.size () > m_capacity)
+      {
+        Evict ();
+      }
+  };
+
+  /**
+   * \return the maximum number of paths in the cache, or 0 for no limit
+   */
+  uint32_t GetCapacity (void) const
+  {
+    return m_capacity;
+  };
+
+  /**
+   * \return the number of paths in the cache
+   */
+  uint32_t GetSize (void) const
+  {
+    return m_entries.size ();
+  };
+
+  /**
+   * \return the number of calls to GetPathData which found the path
+   */
+  uint64_t GetHits (void) const
+  {
+    return m_hits;
+  };
+
+  /**
+   * \return the number of calls to GetPathData which did not find the path
+   */
+  uint64_t GetMisses (void) const
+  {
+    return m_misses;
+  };
+
+  /**
+   * \return the number of paths evicted from the cache
+   */
+  uint64_t GetEvictions (void) const
+  {
+    return m_evictions;
+  };
+
+  /**
+   * Remove all the paths, keeping the statistics
+   */
+  void Clear (void)
+  {
+    m_entries.clear ();
+    m_slots.clear ();
+    m_hand = 0;
   };
+
 private:
   /// Each path is identified by
   struct PropagationPathIdentifier
   {
     /**
      * Constructor
+     */
+    PropagationPathIdentifier ()
+      : m_spectrumModelUid (0)
+    {};
+    /**
+     * Constructor
+     *
+     * Links are supposed to be symmetrical: the mobility models are
+     * stored in increasing order of their address.
+     *
      * @param a 1st node mobility model
      * @param b 2nd node mobility model
      * @param modelUid model UID
      */
     PropagationPathIdentifier (Ptr<const MobilityModel> a, Ptr<const MobilityModel> b, uint32_t modelUid) :
-      m_srcMobility (a), m_dstMobility (b), m_spectrumModelUid (modelUid)
+      m_srcMobility (std::min (a, b)), m_dstMobility (std::max (a, b)), m_spectrumModelUid (modelUid)
     {};
-    Ptr<const MobilityModel> m_srcMobility; //!< 1st node mobility model
-    Ptr<const MobilityModel> m_dstMobility; //!< 2nd node mobility model
+    Ptr<const MobilityModel> m_srcMobility; //!< mobility model with the lower address
+    Ptr<const MobilityModel> m_dstMobility; //!< mobility model with the higher address
     uint32_t m_spectrumModelUid; //!< model UID
 
     /**
-     * Less-than operator.
-     *
-     * The goal of this operator is just to provide a stable comparison
-     * to be used in containers requiring a order (of any kind).
-     *
-     * If the models are different, the comparison is based on their Uid.
-     * Otherwise, the comparison is based on the pointers of the Mobility models.
+     * Equality operator.
      *
      * \param other Right value of the operator.
-     * \returns True if the Left value is less than the Right value.
+     * \returns True if both identify the same path.
      */
-    bool operator < (const PropagationPathIdentifier & other) const
+    bool operator == (const PropagationPathIdentifier & other) const
     {
-      if (m_spectrumModelUid != other.m_spectrumModelUid)
-        {
-          return m_spectrumModelUid < other.m_spectrumModelUid;
-        }
-      /// Links are supposed to be symmetrical!
-      if (std::min (m_dstMobility, m_srcMobility) != std::min (other.m_dstMobility, other.m_srcMobility))
-        {
-          return std::min (m_dstMobility, m_srcMobility) < std::min (other.m_dstMobility, other.m_srcMobility);
-        }
-      if (std::max (m_dstMobility, m_srcMobility) != std::max (other.m_dstMobility, other.m_srcMobility))
-        {
-          return std::max (m_dstMobility, m_srcMobility) < std::max (other.m_dstMobility, other.m_srcMobility);
-        }
-      return false;
+      return m_srcMobility == other.m_srcMobility
+        && m_dstMobility == other.m_dstMobility
+        && m_spectrumModelUid == other.m_spectrumModelUid;
     }
   };
 
-  /// Typedef: PropagationPathIdentifier, Ptr<T>
-  typedef std::map<PropagationPathIdentifier, Ptr<T> > PathCache;
-private:
-  PathCache m_pathCache; //!< Path cache
+  /// A path of the cache
+  struct Entry
+  {
+    PropagationPathIdentifier m_key; //!< the path
+    std::size_t m_hash;              //!< the hash of the path
+    Ptr<T> m_data;                   //!< the model associated with the path
+    bool m_referenced;               //!< whether the path was found since the clock hand last passed it
+  };
+
+  /**
+   * \param key a path
+   * \return the hash of the path
+   */
+  static std::size_t Hash (const PropagationPathIdentifier &key)
+  {
+    uint64_t h = reinterpret_cast<uintptr_t> (PeekPointer (key.m_srcMobility));
+    h = (h ^ (h >> 31)) * 0x9e3779b97f4a7c15ULL + reinterpret_cast<uintptr_t> (PeekPointer (key.m_dstMobility));
+    h = (h ^ (h >> 29)) * 0xbf58476d1ce4e5b9ULL + key.m_spectrumModelUid;
+    h = (h ^ (h >> 32)) * 0x94d049bb133111ebULL;
+    return static_cast<std::size_t> (h ^ (h >> 31));
+  };
+
+  /**
+   * Find the slot of a path, or the empty slot where it would be added
+   * \param key the path
+   * \param hash the hash of the path
+   * \return the index of the slot, undefined if there is no slot
+   */
+  std::size_t Find (const PropagationPathIdentifier &key, std::size_t hash) const
+  {
+    if (m_slots.empty ())
+      {
+        return 0;
+      }
+    std::size_t mask = m_slots.size () - 1;
+    std::size_t slot = hash & mask;
+    while (m_slots[slot] != 0)
+      {
+        const Entry &entry = m_entries[m_slots[slot] - 1];
+        if (entry.m_hash == hash && entry.m_key == key)
+          {
+            break;
+          }
+        slot = (slot + 1) & mask;
+      }
+    return slot;
+  };
+
+  /**
+   * Rebuild the slots of the hash table
+   * \param size the number of slots, a power of 2
+   */
+  void Rehash (std::size_t size)
+  {
+    m_slots.assign (size, 0);
+    std::size_t mask = size - 1;
+    for (std::size_t i = 0; i < m_entries.size (); ++i)
+      {
+        std::size_t slot = m_entries[i].m_hash & mask;
+        while (m_slots[slot] != 0)
+          {
+            slot = (slot + 1) & mask;
+          }
+        m_slots[slot] = i + 1;
+      }
+  };
+
+  /**
+   * Remove the slot of a path, moving the following slots of its probe
+   * sequence back into the hole (no tombstones are left).
+   * \param slot the index of the slot
+   */
+  void RemoveSlot (std::size_t slot)
+  {
+    std::size_t mask = m_slots.size () - 1;
+    std::size_t next = slot;
+    while (true)
+      {
+        next = (next + 1) & mask;
+        if (m_slots[next] == 0)
+          {
+            break;
+          }
+        std::size_t home = m_entries[m_slots[next] - 1].m_hash & mask;
+        // leave the entry where it is if its home slot is cyclically
+        // in (slot, next]
+        bool stays = (slot <= next) ? (slot < home && home <= next) : (slot < home || home <= next);
+        if (!stays)
+          {
+            m_slots[slot] = m_slots[next];
+            slot = next;
+          }
+      }
+    m_slots[slot] = 0;
+  };
+
+  /**
+   * Evict a path chosen by the CLOCK algorithm
+   */
+  void Evict (void)
+  {
+    NS_ASSERT (!m_entries.empty ());
+    if (m_hand >= m_entries.size ())
+      {
+        m_hand = 0;
+      }
+    while (m_entries[m_hand].m_referenced)
+      {
+        m_entries[m_hand].m_referenced = false;
+        m_hand = (m_hand + 1) % m_entries.size ();
+      }
+    std::size_t victim = m_hand;
+    RemoveSlot (Find (m_entries[victim].m_key, m_entries[victim].m_hash));
+    // move the last entry into the place of the victim
+    std::size_t last = m_entries.size () - 1;
+    if (victim != last)
+      {
+        m_slots[Find (m_entries[last].m_key, m_entries[last].m_hash)] = victim + 1;
+        m_entries[victim] = m_entries[last];
+      }
+    m_entries.pop_back ();
+    ++m_evictions;
+  };
+
+  uint32_t m_capacity;              //!< maximum number of paths, or 0
+  std::vector<Entry> m_entries;     //!< the paths
+  /// The slots of the hash table: index of a path in m_entries plus 1, or 0 if empty
+  std::vector<uint32_t> m_slots;
+  std::size_t m_hand;               //!< index of the clock hand in m_entries
+  uint64_t m_hits;                  //!< number of paths found
+  uint64_t m_misses;                //!< number of paths not found
+  uint64_t m_evictions;             //!< number of paths evicted
 };
 } // namespace ns3
 
@@ -28,7 +28,9 @@
 #include "ns3/double.h"
 #include "ns3/string.h"
 #include "ns3/pointer.h"
+#include <algorithm>
 #include <cmath>
+#include <limits>
 
 namespace ns3 {
 
@@ -94,6 +96,26 @@ PropagationLossModel::AssignStreams (int64_t stream)
   return (currentStream - stream);
 }
 
+double
+PropagationLossModel::GetMaxRange (double txPowerDbm, double minRxPowerDbm) const
+{
+  double range = DoGetMaxRange (txPowerDbm, minRxPowerDbm);
+  if (m_next != 0 && !std::isinf (range))
+    {
+      double nextRange = m_next->GetMaxRange (txPowerDbm, minRxPowerDbm);
+      // an unbounded model may amplify the input of the others
+      range = std::isinf (nextRange) ? nextRange : std::min (range, nextRange);
+    }
+  // allow for the rounding errors of DoCalcRxPower
+  return range * (1 + 1e-6);
+}
+
+double
+PropagationLossModel::DoGetMaxRange (double txPowerDbm, double minRxPowerDbm) const
+{
+  return std::numeric_limits<double>::infinity ();
+}
+
 // ------------------------------------------------------------------------- //
 
 NS_OBJECT_ENSURE_REGISTERED (RandomPropagationLossModel);
@@ -277,6 +299,22 @@ FriisPropagationLossModel::DoAssignStreams (int64_t stream)
   return 0;
 }
 
+double
+FriisPropagationLossModel::DoGetMaxRange (double txPowerDbm, double minRxPowerDbm) const
+{
+  if (m_minLoss < 0)
+    {
+      return std::numeric_limits<double>::infinity ();
+    }
+  double maxLossDb = txPowerDbm - minRxPowerDbm;
+  if (m_minLoss > maxLossDb)
+    {
+      return 0;
+    }
+  // invert the Friis equation for a loss of maxLossDb
+  return m_lambda / (4 * M_PI) * std::sqrt (std::pow (10, maxLossDb / 10) / m_systemLoss);
+}
+
 // ------------------------------------------------------------------------- //
 // -- Two-Ray Ground Model ported from NS-2 -- tomhewer@mac.com -- Nov09 //
 
@@ -540,6 +578,21 @@ LogDistancePropagationLossModel::DoAssignStreams (int64_t stream)
   return 0;
 }
 
+double
+LogDistancePropagationLossModel::DoGetMaxRange (double txPowerDbm, double minRxPowerDbm) const
+{
+  if (m_referenceLoss < 0 || m_exponent <= 0)
+    {
+      return std::numeric_limits<double>::infinity ();
+    }
+  double maxLossDb = txPowerDbm - minRxPowerDbm;
+  if (m_referenceLoss > maxLossDb)
+    {
+      return 0;
+    }
+  return m_referenceDistance * std::pow (10, (maxLossDb - m_referenceLoss) / (10 * m_exponent));
+}
+
 // ------------------------------------------------------------------------- //
 
 NS_OBJECT_ENSURE_REGISTERED (ThreeLogDistancePropagationLossModel);
@@ -930,6 +983,16 @@ RangePropagationLossModel::DoAssignStreams (int64_t stream)
   return 0;
 }
 
+double
+RangePropagationLossModel::DoGetMaxRange (double txPowerDbm, double minRxPowerDbm) const
+{
+  if (minRxPowerDbm <= -1000)
+    {
+      return std::numeric_limits<double>::infinity ();
+    }
+  return txPowerDbm < minRxPowerDbm ? 0 : m_range;
+}
+
 // ------------------------------------------------------------------------- //
 
 } // namespace ns3
@@ -115,6 +115,21 @@ public:
    */
   int64_t AssignStreams (int64_t stream);
 
+  /**
+   * Returns a distance beyond which the Rx power computed by CalcRxPower,
+   * taking into account all the PropagationLossModel(s) chained to the
+   * current one, is lower than a given threshold.  The channels use it
+   * to skip the receivers which a transmission cannot reach.
+   *
+   * The distance is infinite unless all the models of the chain bound
+   * their range: see DoGetMaxRange.
+   *
+   * \param txPowerDbm the transmission power (in dBm)
+   * \param minRxPowerDbm the threshold of the reception power (in dBm)
+   * \returns the distance (in meters), possibly infinite
+   */
+  double GetMaxRange (double txPowerDbm, double minRxPowerDbm) const;
+
 protected:
   /**
    * Assign a fixed random variable stream number to the random variables used by this model.
@@ -140,6 +155,22 @@ private:
                                 Ptr<MobilityModel> a,
                                 Ptr<MobilityModel> b) const = 0;
 
+  /**
+   * Returns a distance beyond which DoCalcRxPower returns a power lower
+   * than a given threshold.
+   *
+   * A model may return a finite distance only if the power it returns
+   * never exceeds the transmission power and does not decrease when the
+   * transmission power increases, so that the distances of the models of
+   * a chain bound the range of the whole chain.  The default
+   * implementation returns an infinite distance.
+   *
+   * \param txPowerDbm the transmission power (in dBm)
+   * \param minRxPowerDbm the threshold of the reception power (in dBm)
+   * \returns the distance (in meters), possibly infinite
+   */
+  virtual double DoGetMaxRange (double txPowerDbm, double minRxPowerDbm) const;
+
   Ptr<PropagationLossModel> m_next; //!< Next propagation loss model in the list
 };
 
@@ -305,6 +336,7 @@ private:
                         Ptr<MobilityModel> a,
                         Ptr<MobilityModel> b) const override;
   int64_t DoAssignStreams (int64_t stream) override;
+  double DoGetMaxRange (double txPowerDbm, double minRxPowerDbm) const override;
 
   /**
    * Transforms a Dbm value to Watt
@@ -494,6 +526,7 @@ private:
                         Ptr<MobilityModel> b) const override;
 
   int64_t DoAssignStreams (int64_t stream) override;
+  double DoGetMaxRange (double txPowerDbm, double minRxPowerDbm) const override;
 
   /**
    *  Creates a default reference loss model
@@ -773,6 +806,7 @@ private:
                         Ptr<MobilityModel> b) const override;
 
   int64_t DoAssignStreams (int64_t stream) override;
+  double DoGetMaxRange (double txPowerDbm, double minRxPowerDbm) const override;
 
   double m_range; //!< Maximum Transmission Range (meters)
 };
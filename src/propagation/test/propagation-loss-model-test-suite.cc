@@ -21,10 +21,18 @@
 #include "ns3/test.h"
 #include "ns3/config.h"
 #include "ns3/double.h"
+#include "ns3/uinteger.h"
 #include "ns3/propagation-loss-model.h"
+#include "ns3/propagation-cache.h"
+#include "ns3/jakes-propagation-loss-model.h"
 #include "ns3/constant-position-mobility-model.h"
+#include "ns3/random-variable-stream.h"
 #include "ns3/simulator.h"
 
+#include <cmath>
+#include <map>
+#include <tuple>
+
 using namespace ns3;
 
 NS_LOG_COMPONENT_DEFINE ("PropagationLossModelsTest");
@@ -473,6 +481,236 @@ RangePropagationLossModelTestCase::DoRun (void)
   Simulator::Destroy ();
 }
 
+/**
+ * \ingroup propagation-tests
+ *
+ * \brief PropagationLossModel::GetMaxRange Test
+ *
+ * Checks that the Rx power is below the threshold beyond the range,
+ * and reaches it just within the range.
+ */
+class PropagationLossModelMaxRangeTestCase : public TestCase
+{
+public:
+  PropagationLossModelMaxRangeTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Check the range of a loss model.
+   *
+   * \param model the loss model
+   * \param txPowerDbm the transmission power (dBm)
+   * \param minRxPowerDbm the threshold of the Rx power (dBm)
+   */
+  void CheckRange (Ptr<PropagationLossModel> model, double txPowerDbm, double minRxPowerDbm);
+};
+
+PropagationLossModelMaxRangeTestCase::PropagationLossModelMaxRangeTestCase ()
+  : TestCase ("Test PropagationLossModel::GetMaxRange")
+{
+}
+
+void
+PropagationLossModelMaxRangeTestCase::CheckRange (Ptr<PropagationLossModel> model,
+                                                  double txPowerDbm, double minRxPowerDbm)
+{
+  double range = model->GetMaxRange (txPowerDbm, minRxPowerDbm);
+  Ptr<MobilityModel> a = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<MobilityModel> b = CreateObject<ConstantPositionMobilityModel> ();
+  a->SetPosition (Vector (0, 0, 0));
+  b->SetPosition (Vector (range * 1.001 + 1e-3, 0, 0));
+  NS_TEST_EXPECT_MSG_LT (model->CalcRxPower (txPowerDbm, a, b), minRxPowerDbm,
+                         "Rx power above the threshold beyond the range " << range);
+  if (range > 0)
+    {
+      b->SetPosition (Vector (range * 0.999, 0, 0));
+      NS_TEST_EXPECT_MSG_GT_OR_EQ (model->CalcRxPower (txPowerDbm, a, b), minRxPowerDbm,
+                                   "Rx power below the threshold within the range " << range);
+    }
+}
+
+void
+PropagationLossModelMaxRangeTestCase::DoRun (void)
+{
+  Ptr<FriisPropagationLossModel> friis = CreateObject<FriisPropagationLossModel> ();
+  CheckRange (friis, 20, -90);
+  CheckRange (friis, 16, -101);
+  friis->SetSystemLoss (2);
+  CheckRange (friis, 20, -90);
+  // the minimum loss exceeds the budget
+  friis->SetMinLoss (120);
+  NS_TEST_EXPECT_MSG_EQ (friis->GetMaxRange (20, -90), 0, "Expected no range");
+  friis->SetMinLoss (0);
+
+  Ptr<LogDistancePropagationLossModel> logDistance = CreateObject<LogDistancePropagationLossModel> ();
+  CheckRange (logDistance, 20, -90);
+  logDistance->SetPathLossExponent (2.5);
+  CheckRange (logDistance, 10, -82);
+
+  Ptr<RangePropagationLossModel> range = CreateObject<RangePropagationLossModel> ();
+  range->SetAttribute ("MaxRange", DoubleValue (250));
+  CheckRange (range, 20, -90);
+  NS_TEST_EXPECT_MSG_EQ (range->GetMaxRange (-95, -90), 0, "Expected no range");
+  NS_TEST_EXPECT_MSG_EQ (std::isinf (range->GetMaxRange (20, -1000)), true, "Expected no bound");
+
+  // the range of a chain is the smallest of the ranges
+  friis->SetNext (logDistance);
+  double chained = friis->GetMaxRange (20, -90);
+  NS_TEST_EXPECT_MSG_LT_OR_EQ (chained, logDistance->GetMaxRange (20, -90) * (1 + 1e-6), "Chain range too large");
+  NS_TEST_EXPECT_MSG_LT_OR_EQ (chained, friis->GetMaxRange (20, -90), "Chain range too large");
+  Ptr<MobilityModel> a = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<MobilityModel> b = CreateObject<ConstantPositionMobilityModel> ();
+  b->SetPosition (Vector (chained * 1.001, 0, 0));
+  NS_TEST_EXPECT_MSG_LT (friis->CalcRxPower (20, a, b), -90, "Rx power above the threshold beyond the range");
+
+  // a model without a bound removes the bound of the whole chain
+  logDistance->SetNext (CreateObject<NakagamiPropagationLossModel> ());
+  NS_TEST_EXPECT_MSG_EQ (std::isinf (friis->GetMaxRange (20, -90)), true, "Expected no bound");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup propagation-tests
+ *
+ * \brief PropagationCache Test
+ *
+ * Checks the symmetry of the paths, the CLOCK eviction and the
+ * statistics of the cache against a reference map, and the cache
+ * attributes of the JakesPropagationLossModel.
+ */
+class PropagationCacheTestCase : public TestCase
+{
+public:
+  PropagationCacheTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+PropagationCacheTestCase::PropagationCacheTestCase ()
+  : TestCase ("Test PropagationCache")
+{
+}
+
+void
+PropagationCacheTestCase::DoRun (void)
+{
+  std::vector<Ptr<MobilityModel> > mobility;
+  for (uint32_t i = 0; i < 40; ++i)
+    {
+      mobility.push_back (CreateObject<ConstantPositionMobilityModel> ());
+    }
+
+  // symmetric paths, distinguished by the spectrum model
+  PropagationCache<Object> cache;
+  Ptr<Object> ab = CreateObject<Object> ();
+  Ptr<Object> ab1 = CreateObject<Object> ();
+  cache.AddPathData (ab, mobility[0], mobility[1], 0);
+  cache.AddPathData (ab1, mobility[1], mobility[0], 1);
+  NS_TEST_EXPECT_MSG_EQ (cache.GetPathData (mobility[1], mobility[0], 0), ab, "Path not symmetric");
+  NS_TEST_EXPECT_MSG_EQ (cache.GetPathData (mobility[0], mobility[1], 1), ab1, "Path not symmetric");
+  NS_TEST_EXPECT_MSG_EQ (cache.GetPathData (mobility[0], mobility[2], 0), 0, "Unexpected path");
+  NS_TEST_EXPECT_MSG_EQ (cache.GetHits (), 2, "Wrong number of hits");
+  NS_TEST_EXPECT_MSG_EQ (cache.GetMisses (), 1, "Wrong number of misses");
+
+  // the paths found since the clock hand last passed them are kept
+  cache.Clear ();
+  cache.SetCapacity (4);
+  std::vector<Ptr<Object> > data;
+  for (uint32_t i = 0; i < 5; ++i)
+    {
+      data.push_back (CreateObject<Object> ());
+    }
+  for (uint32_t i = 0; i < 4; ++i)
+    {
+      cache.AddPathData (data[i], mobility[i], mobility[i + 10], 0);
+    }
+  cache.GetPathData (mobility[0], mobility[10], 0);
+  cache.GetPathData (mobility[11], mobility[1], 0);
+  cache.AddPathData (data[4], mobility[4], mobility[14], 0);
+  NS_TEST_EXPECT_MSG_EQ (cache.GetSize (), 4, "Wrong number of paths");
+  NS_TEST_EXPECT_MSG_EQ (cache.GetEvictions (), 1, "Wrong number of evictions");
+  NS_TEST_EXPECT_MSG_EQ (cache.GetPathData (mobility[2], mobility[12], 0), 0, "Least recently used path not evicted");
+  for (uint32_t i : {0, 1, 3, 4})
+    {
+      NS_TEST_EXPECT_MSG_EQ (cache.GetPathData (mobility[i], mobility[i + 10], 0), data[i], "Path " << i << " evicted");
+    }
+
+  // random accesses, against a map of the paths which may be cached
+  Ptr<UniformRandomVariable> rng = CreateObject<UniformRandomVariable> ();
+  rng->SetStream (1);
+  for (uint32_t capacity : {0, 1, 7, 100})
+    {
+      PropagationCache<Object> bounded;
+      bounded.SetCapacity (capacity);
+      std::map<std::tuple<MobilityModel *, MobilityModel *, uint32_t>, Ptr<Object> > reference;
+      uint64_t added = 0;
+      for (uint32_t n = 0; n < 3000; ++n)
+        {
+          uint32_t i = rng->GetInteger (0, 39);
+          uint32_t j = rng->GetInteger (0, 39);
+          uint32_t uid = rng->GetInteger (0, 1);
+          auto key = std::make_tuple (PeekPointer (std::min (mobility[i], mobility[j])),
+                                      PeekPointer (std::max (mobility[i], mobility[j])), uid);
+          Ptr<Object> found = bounded.GetPathData (mobility[i], mobility[j], uid);
+          if (found == 0)
+            {
+              NS_TEST_ASSERT_MSG_EQ ((capacity > 0 || reference.find (key) == reference.end ()), true,
+                                     "Path lost without a capacity");
+              Ptr<Object> item = CreateObject<Object> ();
+              bounded.AddPathData (item, mobility[j], mobility[i], uid);
+              reference[key] = item;
+              ++added;
+            }
+          else
+            {
+              NS_TEST_ASSERT_MSG_EQ (found, reference[key], "Wrong path found, capacity " << capacity);
+            }
+          if (capacity > 0)
+            {
+              NS_TEST_ASSERT_MSG_LT_OR_EQ (bounded.GetSize (), capacity, "Capacity exceeded");
+            }
+        }
+      NS_TEST_EXPECT_MSG_EQ (bounded.GetHits () + bounded.GetMisses (), 3000, "Wrong statistics");
+      NS_TEST_EXPECT_MSG_EQ (bounded.GetMisses (), added, "Wrong number of misses");
+      NS_TEST_EXPECT_MSG_EQ (bounded.GetEvictions (), added - bounded.GetSize (), "Wrong number of evictions");
+      // all the paths left are found
+      uint32_t left = 0;
+      for (auto &path : reference)
+        {
+          if (bounded.GetPathData (std::get<0> (path.first), std::get<1> (path.first), std::get<2> (path.first)) == path.second)
+            {
+              ++left;
+            }
+        }
+      NS_TEST_EXPECT_MSG_EQ (left, bounded.GetSize (), "Paths not found, capacity " << capacity);
+    }
+
+  // the statistics of the JakesPropagationLossModel
+  Ptr<JakesPropagationLossModel> jakes = CreateObject<JakesPropagationLossModel> ();
+  jakes->SetAttribute ("CacheCapacity", UintegerValue (5));
+  for (uint32_t n = 0; n < 3; ++n)
+    {
+      for (uint32_t i = 0; i < 8; ++i)
+        {
+          jakes->CalcRxPower (0, mobility[i], mobility[i + 1]);
+        }
+    }
+  UintegerValue size, hits, misses, evictions;
+  jakes->GetAttribute ("CacheSize", size);
+  jakes->GetAttribute ("CacheHits", hits);
+  jakes->GetAttribute ("CacheMisses", misses);
+  jakes->GetAttribute ("CacheEvictions", evictions);
+  NS_TEST_EXPECT_MSG_EQ (size.Get (), 5, "Wrong number of paths");
+  NS_TEST_EXPECT_MSG_EQ (hits.Get () + misses.Get (), 24, "Wrong statistics");
+  NS_TEST_EXPECT_MSG_EQ (evictions.Get (), misses.Get () - 5, "Wrong number of evictions");
+
+  Simulator::Destroy ();
+}
+
 /**
  * \ingroup propagation-tests
  *
@@ -484,6 +722,8 @@ RangePropagationLossModelTestCase::DoRun (void)
  *   - LogDistancePropagationLossModel
  *   - MatrixPropagationLossModel
  *   - RangePropagationLossModel
+ *   - PropagationLossModel::GetMaxRange
+ *   - PropagationCache
  */
 class PropagationLossModelsTestSuite : public TestSuite
 {
@@ -499,6 +739,8 @@ PropagationLossModelsTestSuite::PropagationLossModelsTestSuite ()
   AddTestCase (new LogDistancePropagationLossModelTestCase, TestCase::QUICK);
   AddTestCase (new MatrixPropagationLossModelTestCase, TestCase::QUICK);
   AddTestCase (new RangePropagationLossModelTestCase, TestCase::QUICK);
+  AddTestCase (new PropagationLossModelMaxRangeTestCase, TestCase::QUICK);
+  AddTestCase (new PropagationCacheTestCase, TestCase::QUICK);
 }
 
 /// Static variable for test initialization
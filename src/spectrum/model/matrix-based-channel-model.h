@@ -23,11 +23,14 @@
 #define MATRIX_BASED_CHANNEL_H
 
 #include <complex.h>
+#include <ns3/assert.h>
 #include <ns3/object.h>
 #include <ns3/nstime.h>
 #include <ns3/vector.h>
 #include <ns3/phased-array-model.h>
+#include <complex>
 #include <tuple>
+#include <vector>
 
 namespace ns3 {
 
@@ -52,14 +55,122 @@ public:
   typedef std::vector<DoubleVector> Double2DVector; //!< type definition for matrices of doubles
   typedef std::vector<Double2DVector> Double3DVector; //!< type definition for 3D matrices of doubles
   typedef std::vector<PhasedArrayModel::ComplexVector> Complex2DVector; //!< type definition for complex matrices
-  typedef std::vector<Complex2DVector> Complex3DVector; //!< type definition for complex 3D matrices
+
+  /**
+   * A 3D matrix of complex numbers, stored in a single contiguous array.
+   *
+   * The matrix is a sequence of pages, each page being a matrix stored
+   * in column-major order: the element (row, col, page) is at the index
+   * row + numRows * (col + numCols * page) of the array.
+   */
+  class Complex3DVector
+  {
+  public:
+    /**
+     * Create an empty matrix.
+     */
+    Complex3DVector ()
+      : m_numRows (0),
+        m_numCols (0),
+        m_numPages (0)
+    {}
+
+    /**
+     * Create a matrix filled with zeros.
+     * \param numRows the number of rows
+     * \param numCols the number of columns
+     * \param numPages the number of pages
+     */
+    Complex3DVector (size_t numRows, size_t numCols, size_t numPages)
+      : m_numRows (numRows),
+        m_numCols (numCols),
+        m_numPages (numPages),
+        m_values (numRows * numCols * numPages)
+    {}
+
+    /**
+     * \param row the row index
+     * \param col the column index
+     * \param page the page index
+     * \return a reference to the element (row, col, page)
+     */
+    std::complex<double> &operator() (size_t row, size_t col, size_t page)
+    {
+      NS_ASSERT_MSG (row < m_numRows && col < m_numCols && page < m_numPages, "Index out of range");
+      return m_values[row + m_numRows * (col + m_numCols * page)];
+    }
+
+    /**
+     * \param row the row index
+     * \param col the column index
+     * \param page the page index
+     * \return a const reference to the element (row, col, page)
+     */
+    const std::complex<double> &operator() (size_t row, size_t col, size_t page) const
+    {
+      NS_ASSERT_MSG (row < m_numRows && col < m_numCols && page < m_numPages, "Index out of range");
+      return m_values[row + m_numRows * (col + m_numCols * page)];
+    }
+
+    /**
+     * \return the number of rows
+     */
+    size_t GetNumRows (void) const
+    {
+      return m_numRows;
+    }
+
+    /**
+     * \return the number of columns
+     */
+    size_t GetNumCols (void) const
+    {
+      return m_numCols;
+    }
+
+    /**
+     * \return the number of pages
+     */
+    size_t GetNumPages (void) const
+    {
+      return m_numPages;
+    }
+
+    /**
+     * \param page the page index
+     * \return a pointer to the first element of the page, whose
+     *         numRows * numCols elements are contiguous
+     */
+    std::complex<double> *GetPagePointer (size_t page)
+    {
+      NS_ASSERT_MSG (page < m_numPages, "Page index out of range");
+      return m_values.data () + m_numRows * m_numCols * page;
+    }
+
+    /**
+     * \param page the page index
+     * \return a const pointer to the first element of the page, whose
+     *         numRows * numCols elements are contiguous
+     */
+    const std::complex<double> *GetPagePointer (size_t page) const
+    {
+      NS_ASSERT_MSG (page < m_numPages, "Page index out of range");
+      return m_values.data () + m_numRows * m_numCols * page;
+    }
+
+  private:
+    size_t m_numRows;  //!< number of rows
+    size_t m_numCols;  //!< number of columns
+    size_t m_numPages; //!< number of pages
+    std::vector<std::complex<double> > m_values; //!< the elements
+  };
 
   /**
    * Data structure that stores a channel realization
    */
   struct ChannelMatrix : public SimpleRefCount<ChannelMatrix>
   {
-    Complex3DVector    m_channel; //!< channel matrix H[u][s][n].
+    Complex3DVector    m_channel; //!< channel matrix H[u][s][n], accessed as m_channel (u, s, n).
     Time               m_generatedTime; //!< generation time
     std::pair<uint32_t, uint32_t> m_antennaPair; //!< the first element is the ID of the antenna of the s-node (the antenna of the transmitter when the channel was generated), the second element is ID of the antenna of the u-node antenna (the antenna of the receiver when the channel was generated)
     std::pair<uint32_t, uint32_t> m_nodeIds; //!< the first element is the s-node ID (the transmitter when the channel was generated), the second element is the u-node ID (the receiver when the channel was generated)
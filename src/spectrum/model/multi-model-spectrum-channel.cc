@@ -29,6 +29,7 @@
 #include <ns3/net-device.h>
 #include <ns3/node.h>
 #include <ns3/double.h>
+#include <ns3/uinteger.h>
 #include <ns3/mobility-model.h>
 #include <ns3/spectrum-phy.h>
 #include <ns3/spectrum-converter.h>
@@ -79,7 +80,8 @@ RxSpectrumModelInfo::RxSpectrumModelInfo (Ptr<const SpectrumModel> rxSpectrumMod
 }
 
 MultiModelSpectrumChannel::MultiModelSpectrumChannel ()
-  : m_numDevices {0}
+  : m_numDevices {0},
+    m_rxThreads (1)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -90,6 +92,8 @@ MultiModelSpectrumChannel::DoDispose ()
   NS_LOG_FUNCTION (this);
   m_txSpectrumModelInfoMap.clear ();
   m_rxSpectrumModelInfoMap.clear ();
+  m_rxSpatialIndexMap.clear ();
+  m_threadPool = 0;
   SpectrumChannel::DoDispose ();
 }
 
@@ -100,7 +104,18 @@ MultiModelSpectrumChannel::GetTypeId (void)
     .SetParent<SpectrumChannel> ()
     .SetGroupName ("Spectrum")
     .AddConstructor<MultiModelSpectrumChannel> ()
-
+    .AddAttribute ("RxThreads",
+                   "The number of threads computing the received PSDs of a "
+                   "transmission, including the simulation thread, or 0 for "
+                   "the number of hardware threads.  With 1, the PSDs are "
+                   "computed sequentially.  Only the "
+                   "PhasedArraySpectrumPropagationLossModel instances supporting "
+                   "it (e.g., ThreeGppSpectrumPropagationLossModel) compute the "
+                   "PSDs in parallel; the received signals do not depend on the "
+                   "number of threads.",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&MultiModelSpectrumChannel::m_rxThreads),
+                   MakeUintegerChecker<uint32_t> ())
   ;
   return tid;
 }
@@ -121,6 +136,8 @@ MultiModelSpectrumChannel::RemoveRx (Ptr<SpectrumPhy> phy)
       auto phyIt = std::find (rxInfoIterator->second.m_rxPhys.begin(), rxInfoIterator->second.m_rxPhys.end(), phy);
       if (phyIt != rxInfoIterator->second.m_rxPhys.end ())
         {
+          RemoveFromSpatialIndex (m_rxSpatialIndexMap[rxInfoIterator->first],
+                                  phyIt - rxInfoIterator->second.m_rxPhys.begin ());
           rxInfoIterator->second.m_rxPhys.erase (phyIt);
           --m_numDevices;
           break; // there should be at most one entry
@@ -177,6 +194,7 @@ MultiModelSpectrumChannel::AddRx (Ptr<SpectrumPhy> phy)
       // spectrum model is already known, just add the device to the corresponding list
       rxInfoIterator->second.m_rxPhys.push_back (phy);
     }
+  AddToSpatialIndex (m_rxSpatialIndexMap[rxSpectrumModelUid], phy);
 }
 
 TxSpectrumModelInfoMap_t::const_iterator
@@ -228,8 +246,11 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
 
   NS_ASSERT (txParams->txPhy);
   NS_ASSERT (txParams->psd);
-  Ptr<SpectrumSignalParameters> txParamsTrace = txParams->Copy (); // copy it since traced value cannot be const (because of potential underlying DynamicCasts)
-  m_txSigParamsTrace (txParamsTrace);
+  if (!m_txSigParamsTrace.IsEmpty ())
+    {
+      Ptr<SpectrumSignalParameters> txParamsTrace = txParams->Copy (); // copy it since traced value cannot be const (because of potential underlying DynamicCasts)
+      m_txSigParamsTrace (txParamsTrace);
+    }
 
   Ptr<MobilityModel> txMobility = txParams->txPhy->GetMobility ();
   SpectrumModelUid_t txSpectrumModelUid = txParams->psd->GetSpectrumModelUid ();
@@ -243,6 +264,9 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
   NS_LOG_LOGIC ("converter map size: " << txInfoIteratorerator->second.m_spectrumConverterMap.size ());
   NS_LOG_LOGIC ("converter map first element: " << txInfoIteratorerator->second.m_spectrumConverterMap.begin ()->first);
 
+  // the received PSDs whose computation is completed in parallel
+  std::vector<std::function<void ()> > rxPsdTasks;
+
   for (RxSpectrumModelInfoMap_t::const_iterator rxInfoIterator = m_rxSpectrumModelInfoMap.begin ();
        rxInfoIterator != m_rxSpectrumModelInfoMap.end ();
        ++rxInfoIterator)
@@ -268,8 +292,15 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
           convertedTxPowerSpectrum = rxConverterIterator->second.Convert (txParams->psd);
         }
 
-      for (auto rxPhyIterator = rxInfoIterator->second.m_rxPhys.begin ();
-           rxPhyIterator != rxInfoIterator->second.m_rxPhys.end ();
+      // skip the receivers out of range, if they are indexed
+      std::vector<Ptr<SpectrumPhy> > candidates;
+      const std::vector<Ptr<SpectrumPhy> > &rxPhys =
+        GetRxCandidates (m_rxSpatialIndexMap[rxSpectrumModelUid], rxInfoIterator->second.m_rxPhys,
+                         txParams, txMobility, candidates)
+        ? candidates : rxInfoIterator->second.m_rxPhys;
+
+      for (auto rxPhyIterator = rxPhys.begin ();
+           rxPhyIterator != rxPhys.end ();
            ++rxPhyIterator)
         {
           NS_ASSERT_MSG ((*rxPhyIterator)->GetRxSpectrumModel ()->GetUid () == rxSpectrumModelUid,
@@ -290,23 +321,20 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
                     }
                 }
 
-              NS_LOG_LOGIC ("copying signal parameters " << txParams);
-              Ptr<SpectrumSignalParameters> rxParams = txParams->Copy ();
-              rxParams->psd = Copy<SpectrumValue> (convertedTxPowerSpectrum);
-              Time delay = MicroSeconds (0);
-
               Ptr<MobilityModel> receiverMobility = (*rxPhyIterator)->GetMobility ();
 
+              // check the range before copying the signal parameters
+              double pathGainLinear = 1;
               if (txMobility && receiverMobility)
                 {
                   double txAntennaGain = 0;
                   double rxAntennaGain = 0;
                   double propagationGainDb = 0;
                   double pathLossDb = 0;
-                  if (rxParams->txAntenna != 0)
+                  if (txParams->txAntenna != 0)
                     {
                       Angles txAngles (receiverMobility->GetPosition (), txMobility->GetPosition ());
-                      txAntennaGain = rxParams->txAntenna->GetGainDb (txAngles);
+                      txAntennaGain = txParams->txAntenna->GetGainDb (txAngles);
                       NS_LOG_LOGIC ("txAntennaGain = " << txAntennaGain << " dB");
                       pathLossDb -= txAntennaGain;
                     }
@@ -334,7 +362,18 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
                       // beyond range
                       continue;
                     }
-                  double pathGainLinear = std::pow (10.0, (-pathLossDb) / 10.0);
+                  pathGainLinear = std::pow (10.0, (-pathLossDb) / 10.0);
+                }
+
+              // the copies share the values of the PSD, which are copied
+              // and scaled in a single pass when they are first accessed
+              NS_LOG_LOGIC ("copying signal parameters " << txParams);
+              Ptr<SpectrumSignalParameters> rxParams = txParams->Copy ();
+              rxParams->psd = Copy<SpectrumValue> (convertedTxPowerSpectrum);
+              Time delay = MicroSeconds (0);
+
+              if (txMobility && receiverMobility)
+                {
                   *(rxParams->psd) *= pathGainLinear;              
 
                   if (m_spectrumPropagationLoss)
@@ -348,7 +387,21 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
 
                       NS_ASSERT_MSG (txPhasedArrayModel && rxPhasedArrayModel, "PhasedArrayModel instances should be installed at both TX and RX SpectrumPhy in order to use PhasedArraySpectrumPropagationLoss.");
 
-                      rxParams->psd = m_phasedArraySpectrumPropagationLoss->CalcRxPowerSpectralDensity (rxParams->psd, txMobility, receiverMobility, txPhasedArrayModel, rxPhasedArrayModel);
+                      std::function<void ()> task;
+                      if (m_rxThreads != 1)
+                        {
+                          // the PSD is completed by RunRxPsdTasks, before
+                          // the reception can start
+                          task = m_phasedArraySpectrumPropagationLoss->PrepareRxPowerSpectralDensity (rxParams->psd, txMobility, receiverMobility, txPhasedArrayModel, rxPhasedArrayModel);
+                        }
+                      if (task)
+                        {
+                          rxPsdTasks.push_back (task);
+                        }
+                      else
+                        {
+                          rxParams->psd = m_phasedArraySpectrumPropagationLoss->CalcRxPowerSpectralDensity (rxParams->psd, txMobility, receiverMobility, txPhasedArrayModel, rxPhasedArrayModel);
+                        }
                      }
 
                   if (m_propagationDelay)
@@ -375,6 +428,22 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
 
     }
 
+  RunRxPsdTasks (rxPsdTasks);
+}
+
+void
+MultiModelSpectrumChannel::RunRxPsdTasks (const std::vector<std::function<void ()> > &tasks)
+{
+  NS_LOG_FUNCTION (this << tasks.size ());
+  if (tasks.empty ())
+    {
+      return;
+    }
+  if (!m_threadPool)
+    {
+      m_threadPool = Create<ThreadPool> (m_rxThreads);
+    }
+  m_threadPool->Run (tasks.size (), [&tasks] (uint32_t i) { tasks[i] (); });
 }
 
 void
@@ -27,8 +27,11 @@
 #include <ns3/spectrum-channel.h>
 #include <ns3/spectrum-propagation-loss-model.h>
 #include <ns3/propagation-delay-model.h>
+#include <ns3/thread-pool.h>
+#include <functional>
 #include <map>
 #include <set>
+#include <vector>
 
 namespace ns3 {
 
@@ -102,6 +105,14 @@ typedef std::map<SpectrumModelUid_t, RxSpectrumModelInfo> RxSpectrumModelInfoMap
  * for this to work is that, after the SpectrumPhy switched its
  * SpectrumModel,  MultiModelSpectrumChannel::AddRx () is
  * called again passing the pointer to that SpectrumPhy.
+ *
+ * The received PSDs of a transmission can be computed in parallel
+ * by the PhasedArraySpectrumPropagationLossModel, with the
+ * RxThreads attribute: each PSD is prepared in the simulation thread,
+ * in the order of the receivers, and the rest of the computation
+ * (e.g., the beamforming gain of the 3GPP model) runs in a ThreadPool
+ * before StartTx returns.  The received signals do not depend on the
+ * number of threads.
  */
 class MultiModelSpectrumChannel : public SpectrumChannel
 {
@@ -150,6 +161,13 @@ private:
    */
   virtual void StartRx (Ptr<SpectrumSignalParameters> params, Ptr<SpectrumPhy> receiver);
 
+  /**
+   * Complete the received PSDs prepared by StartTx, in parallel.
+   *
+   * \param tasks The functions completing the PSDs.
+   */
+  void RunRxPsdTasks (const std::vector<std::function<void ()> > &tasks);
+
   /**
    * Data structure holding, for each TX SpectrumModel,  all the
    * converters to any RX SpectrumModel, and all the corresponding
@@ -165,11 +183,18 @@ private:
    */
   RxSpectrumModelInfoMap_t m_rxSpectrumModelInfoMap;
 
+  /**
+   * Spatial index of the SpectrumPhy instances of each RX spectrum model.
+   */
+  std::map<SpectrumModelUid_t, RxSpatialIndex> m_rxSpatialIndexMap;
+
   /**
    * Number of devices connected to the channel.
    */
   std::size_t m_numDevices;
 
+  uint32_t m_rxThreads;          //!< Number of threads computing the received PSDs.
+  Ptr<ThreadPool> m_threadPool;  //!< Threads computing the received PSDs, or 0 if not started.
 };
 
 
@@ -77,4 +77,28 @@ PhasedArraySpectrumPropagationLossModel::CalcRxPowerSpectralDensity (Ptr<const S
   return rxPsd;
 }
 
+std::function<void ()>
+PhasedArraySpectrumPropagationLossModel::PrepareRxPowerSpectralDensity (Ptr<SpectrumValue> rxPsd,
+                                                                        Ptr<const MobilityModel> a,
+                                                                        Ptr<const MobilityModel> b,
+                                                                        Ptr<const PhasedArrayModel> aPhasedArrayModel,
+                                                                        Ptr<const PhasedArrayModel> bPhasedArrayModel) const
+{
+  if (m_next != 0)
+    {
+      return std::function<void ()> ();
+    }
+  return DoPrepareRxPowerSpectralDensity (rxPsd, a, b, aPhasedArrayModel, bPhasedArrayModel);
+}
+
+std::function<void ()>
+PhasedArraySpectrumPropagationLossModel::DoPrepareRxPowerSpectralDensity (Ptr<SpectrumValue> rxPsd,
+                                                                          Ptr<const MobilityModel> a,
+                                                                          Ptr<const MobilityModel> b,
+                                                                          Ptr<const PhasedArrayModel> aPhasedArrayModel,
+                                                                          Ptr<const PhasedArrayModel> bPhasedArrayModel) const
+{
+  return std::function<void ()> ();
+}
+
 } // namespace ns3
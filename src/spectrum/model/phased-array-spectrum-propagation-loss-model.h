@@ -26,6 +26,8 @@
 #include <ns3/spectrum-value.h>
 #include <ns3/phased-array-model.h>
 
+#include <functional>
+
 namespace ns3 {
 
 
@@ -82,6 +84,38 @@ public:
                                                  Ptr<const PhasedArrayModel> aPhasedArrayModel,
                                                  Ptr<const PhasedArrayModel> bPhasedArrayModel) const;
 
+  /**
+   * Prepare the computation of a received PSD, so that it can be
+   * completed in another thread.
+   *
+   * This method runs in the simulation thread, where it can use random
+   * variables and update the state of the model, e.g., generate a new
+   * channel realization.  The function it returns completes the
+   * computation by modifying the values of \p rxPsd in place, and can
+   * run in any thread, concurrently with the functions returned for
+   * other receivers of the same transmission: it only writes data
+   * private to this receiver, and does not copy nor release the Ptr of
+   * the shared objects, whose reference counts are not atomic.  It must
+   * run before \p rxPsd is used.
+   *
+   * The models chained with SetNext are not prepared: an empty function
+   * is returned instead, as for the models which do not support it.
+   *
+   * @param rxPsd the PSD before this model, modified by the returned function
+   * @param a sender mobility
+   * @param b receiver mobility
+   * @param aPhasedArrayModel the instance of the phased antenna array of the sender
+   * @param bPhasedArrayModel the instance of the phased antenna array of the receiver
+   *
+   * @return the function completing the computation, or an empty
+   * function, in which case CalcRxPowerSpectralDensity must be used
+   */
+  std::function<void ()> PrepareRxPowerSpectralDensity (Ptr<SpectrumValue> rxPsd,
+                                                        Ptr<const MobilityModel> a,
+                                                        Ptr<const MobilityModel> b,
+                                                        Ptr<const PhasedArrayModel> aPhasedArrayModel,
+                                                        Ptr<const PhasedArrayModel> bPhasedArrayModel) const;
+
 protected:
   virtual void DoDispose ();
 
@@ -105,6 +139,25 @@ private:
                                                            Ptr<const PhasedArrayModel> aPhasedArrayModel,
                                                            Ptr<const PhasedArrayModel> bPhasedArrayModel) const = 0;
 
+  /**
+   * Prepare the computation of a received PSD, see
+   * PrepareRxPowerSpectralDensity.  The default implementation
+   * returns an empty function.
+   *
+   * @param rxPsd the PSD before this model, modified by the returned function
+   * @param a sender mobility
+   * @param b receiver mobility
+   * @param aPhasedArrayModel the instance of the phased antenna array of the sender
+   * @param bPhasedArrayModel the instance of the phased antenna array of the receiver
+   *
+   * @return the function completing the computation, or an empty function
+   */
+  virtual std::function<void ()> DoPrepareRxPowerSpectralDensity (Ptr<SpectrumValue> rxPsd,
+                                                                  Ptr<const MobilityModel> a,
+                                                                  Ptr<const MobilityModel> b,
+                                                                  Ptr<const PhasedArrayModel> aPhasedArrayModel,
+                                                                  Ptr<const PhasedArrayModel> bPhasedArrayModel) const;
+
   Ptr<PhasedArraySpectrumPropagationLossModel> m_next; //!< PhasedArraySpectrumPropagationLossModel chained to this one.
 };
 
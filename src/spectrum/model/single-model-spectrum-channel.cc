@@ -55,6 +55,7 @@ SingleModelSpectrumChannel::DoDispose ()
 {
   NS_LOG_FUNCTION (this);
   m_phyList.clear ();
+  m_rxSpatialIndex = RxSpatialIndex ();
   m_spectrumModel = 0;
   SpectrumChannel::DoDispose ();
 }
@@ -79,6 +80,7 @@ SingleModelSpectrumChannel::RemoveRx (Ptr<SpectrumPhy> phy)
   auto it = std::find (begin (m_phyList), end (m_phyList), phy);
   if (it != std::end (m_phyList))
     {
+      RemoveFromSpatialIndex (m_rxSpatialIndex, it - m_phyList.begin ());
       m_phyList.erase (it);
     }
 }
@@ -88,6 +90,7 @@ SingleModelSpectrumChannel::AddRx (Ptr<SpectrumPhy> phy)
 {
   NS_LOG_FUNCTION (this << phy);
   m_phyList.push_back (phy);
+  AddToSpatialIndex (m_rxSpatialIndex, phy);
 }
 
 
@@ -98,8 +101,11 @@ SingleModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
   NS_ASSERT_MSG (txParams->psd, "NULL txPsd");
   NS_ASSERT_MSG (txParams->txPhy, "NULL txPhy");
 
-  Ptr<SpectrumSignalParameters> txParamsTrace = txParams->Copy (); // copy it since traced value cannot be const (because of potential underlying DynamicCasts)
-  m_txSigParamsTrace (txParamsTrace);
+  if (!m_txSigParamsTrace.IsEmpty ())
+    {
+      Ptr<SpectrumSignalParameters> txParamsTrace = txParams->Copy (); // copy it since traced value cannot be const (because of potential underlying DynamicCasts)
+      m_txSigParamsTrace (txParamsTrace);
+    }
 
   // just a sanity check routine. We might want to remove it to save some computational load -- one "if" statement  ;-)
   if (m_spectrumModel == 0)
@@ -118,8 +124,13 @@ SingleModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
 
   Ptr<MobilityModel> senderMobility = txParams->txPhy->GetMobility ();
 
-  for (PhyList::const_iterator rxPhyIterator = m_phyList.begin ();
-       rxPhyIterator != m_phyList.end ();
+  // skip the receivers out of range, if they are indexed
+  PhyList candidates;
+  const PhyList &rxPhys = GetRxCandidates (m_rxSpatialIndex, m_phyList, txParams, senderMobility, candidates)
+    ? candidates : m_phyList;
+
+  for (PhyList::const_iterator rxPhyIterator = rxPhys.begin ();
+       rxPhyIterator != rxPhys.end ();
        ++rxPhyIterator)
     {
       Ptr<NetDevice> rxNetDevice = (*rxPhyIterator)->GetDevice ();
@@ -137,22 +148,20 @@ SingleModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
 
       if ((*rxPhyIterator) != txParams->txPhy)
         {
-          Time delay  = MicroSeconds (0);
-
           Ptr<MobilityModel> receiverMobility = (*rxPhyIterator)->GetMobility ();
-          NS_LOG_LOGIC ("copying signal parameters " << txParams);
-          Ptr<SpectrumSignalParameters> rxParams = txParams->Copy ();
 
+          // check the range before copying the signal parameters
+          double pathGainLinear = 1;
           if (senderMobility && receiverMobility)
             {
               double txAntennaGain = 0;
               double rxAntennaGain = 0;
               double propagationGainDb = 0;
               double pathLossDb = 0;
-              if (rxParams->txAntenna != 0)
+              if (txParams->txAntenna != 0)
                 {
                   Angles txAngles (receiverMobility->GetPosition (), senderMobility->GetPosition ());
-                  txAntennaGain = rxParams->txAntenna->GetGainDb (txAngles);
+                  txAntennaGain = txParams->txAntenna->GetGainDb (txAngles);
                   NS_LOG_LOGIC ("txAntennaGain = " << txAntennaGain << " dB");
                   pathLossDb -= txAntennaGain;
                 }
@@ -180,7 +189,17 @@ SingleModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
                   // beyond range
                   continue;
                 }
-              double pathGainLinear = std::pow (10.0, (-pathLossDb) / 10.0);
+              pathGainLinear = std::pow (10.0, (-pathLossDb) / 10.0);
+            }
+
+          // the copy shares the values of the PSD, which are copied and
+          // scaled in a single pass when they are first accessed
+          Time delay  = MicroSeconds (0);
+          NS_LOG_LOGIC ("copying signal parameters " << txParams);
+          Ptr<SpectrumSignalParameters> rxParams = txParams->Copy ();
+
+          if (senderMobility && receiverMobility)
+            {
               *(rxParams->psd) *= pathGainLinear;              
 
               if (m_spectrumPropagationLoss)
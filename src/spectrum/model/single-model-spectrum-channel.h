@@ -78,6 +78,11 @@ private:
    */
   PhyList m_phyList;
 
+  /**
+   * Spatial index of the SpectrumPhy instances attached to the channel.
+   */
+  RxSpatialIndex m_rxSpatialIndex;
+
   /**
    * SpectrumModel that this channel instance is supporting.
    */
@@ -21,6 +21,12 @@
 #include <ns3/log.h>
 #include <ns3/double.h>
 #include <ns3/pointer.h>
+#include <ns3/object-factory.h>
+#include <ns3/antenna-model.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
 
 #include "spectrum-channel.h"
 
@@ -32,6 +38,7 @@ NS_LOG_COMPONENT_DEFINE ("SpectrumChannel");
 NS_OBJECT_ENSURE_REGISTERED (SpectrumChannel);
 
 SpectrumChannel::SpectrumChannel ()
+  : m_spatialIndexCellSize (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -76,6 +83,21 @@ SpectrumChannel::GetTypeId (void)
                    MakePointerAccessor (&SpectrumChannel::m_propagationLoss),
                    MakePointerChecker<PropagationLossModel> ())
 
+    .AddAttribute ("SpatialIndexCellSize",
+                   "If positive, the receivers are placed in a grid of "
+                   "square cells of this size, in meters, which lets "
+                   "the channel skip the receivers for which the loss "
+                   "is bound to exceed MaxLossDb, given the range of "
+                   "the PropagationLossModel and the maximum gains of "
+                   "the antennas. The receivers skipped are not reported "
+                   "by the Gain and PathLoss trace sources. The mobility "
+                   "models and the antennas of the receivers must not "
+                   "be replaced once they are attached to the channel. "
+                   "A value of zero disables the index.",
+                   DoubleValue (0),
+                   MakeDoubleAccessor (&SpectrumChannel::m_spatialIndexCellSize),
+                   MakeDoubleChecker<double> (0))
+
     .AddTraceSource ("Gain",
                      "This trace is fired whenever a new path loss value "
                      "is calculated. The parameters to this trace are : "
@@ -174,5 +196,95 @@ SpectrumChannel::GetPropagationLossModel ()
   return m_propagationLoss;
 }
 
+SpectrumChannel::RxSpatialIndex::RxSpatialIndex ()
+  : m_maxAntennaGainDb (-std::numeric_limits<double>::infinity ())
+{
+}
+
+void
+SpectrumChannel::AddToSpatialIndex (RxSpatialIndex &rxIndex, Ptr<SpectrumPhy> phy) const
+{
+  NS_LOG_FUNCTION (this << phy);
+  if (rxIndex.m_index == 0)
+    {
+      return;
+    }
+  rxIndex.m_keys.push_back (rxIndex.m_index->Add (phy->GetMobility ()));
+  Ptr<AntennaModel> antenna = DynamicCast<AntennaModel> (phy->GetAntenna ());
+  // the gain of the other antennas is not accounted for in the loss
+  double gainDb = antenna != 0 ? antenna->GetMaxGainDb () : 0;
+  rxIndex.m_maxAntennaGainDb = std::max (rxIndex.m_maxAntennaGainDb, gainDb);
+}
+
+void
+SpectrumChannel::RemoveFromSpatialIndex (RxSpatialIndex &rxIndex, std::size_t position) const
+{
+  NS_LOG_FUNCTION (this << position);
+  if (rxIndex.m_index == 0)
+    {
+      return;
+    }
+  NS_ASSERT (position < rxIndex.m_keys.size ());
+  rxIndex.m_index->Remove (rxIndex.m_keys[position]);
+  rxIndex.m_keys.erase (rxIndex.m_keys.begin () + position);
+}
+
+bool
+SpectrumChannel::GetRxCandidates (RxSpatialIndex &rxIndex,
+                                  const std::vector<Ptr<SpectrumPhy> > &rxPhys,
+                                  Ptr<const SpectrumSignalParameters> txParams,
+                                  Ptr<MobilityModel> txMobility,
+                                  std::vector<Ptr<SpectrumPhy> > &candidates) const
+{
+  NS_LOG_FUNCTION (this << txParams << txMobility);
+  if (m_spatialIndexCellSize <= 0 || txMobility == 0 || rxPhys.empty ())
+    {
+      return false;
+    }
+  if (rxIndex.m_index == 0)
+    {
+      rxIndex.m_index = CreateObjectWithAttributes<SpatialIndex> ("CellSize", DoubleValue (m_spatialIndexCellSize));
+      for (const auto &phy : rxPhys)
+        {
+          AddToSpatialIndex (rxIndex, phy);
+        }
+    }
+  NS_ASSERT (rxIndex.m_keys.size () == rxPhys.size ());
+  double range = GetMaxRange (txParams->txAntenna, rxIndex.m_maxAntennaGainDb);
+  if (std::isinf (range))
+    {
+      return false;
+    }
+  std::vector<uint32_t> keys;
+  rxIndex.m_index->GetCandidates (txMobility->GetPosition (), range, keys);
+  NS_LOG_LOGIC ("range " << range << " m, " << keys.size () << " of " << rxPhys.size () << " receivers");
+  candidates.clear ();
+  candidates.reserve (keys.size ());
+  // the keys of the list are increasing, as are the keys of the candidates
+  auto keyIt = rxIndex.m_keys.begin ();
+  for (uint32_t key : keys)
+    {
+      keyIt = std::lower_bound (keyIt, rxIndex.m_keys.end (), key);
+      NS_ASSERT (keyIt != rxIndex.m_keys.end () && *keyIt == key);
+      candidates.push_back (rxPhys[keyIt - rxIndex.m_keys.begin ()]);
+    }
+  return true;
+}
+
+double
+SpectrumChannel::GetMaxRange (Ptr<const AntennaModel> txAntenna, double maxRxAntennaGainDb) const
+{
+  NS_LOG_FUNCTION (this << txAntenna << maxRxAntennaGainDb);
+  if (m_propagationLoss == 0)
+    {
+      return std::numeric_limits<double>::infinity ();
+    }
+  double maxTxAntennaGainDb = txAntenna != 0 ? txAntenna->GetMaxGainDb () : 0;
+  // the loss exceeds MaxLossDb wherever the propagation gain is below
+  // this threshold; the margin allows for rounding errors
+  double minPropagationGainDb = -(m_maxLossDb + maxTxAntennaGainDb + maxRxAntennaGainDb) - 1e-6;
+  return m_propagationLoss->GetMaxRange (0, minPropagationGainDb);
+}
+
 
 } // namespace
@@ -33,6 +33,9 @@
 #include <ns3/spectrum-phy.h>
 #include <ns3/traced-callback.h>
 #include <ns3/mobility-model.h>
+#include <ns3/spatial-index.h>
+
+#include <vector>
 
 namespace ns3 {
 
@@ -188,6 +191,66 @@ public:
 
 protected:
 
+  /**
+   * The spatial index of a list of receivers, used to skip the receivers
+   * beyond the range set by the MaxLossDb attribute.
+   */
+  struct RxSpatialIndex
+  {
+    RxSpatialIndex ();
+
+    Ptr<SpatialIndex> m_index;       //!< The index, or 0 until it is first used.
+    std::vector<uint32_t> m_keys;    //!< The keys of the receivers, in the order of the list.
+    double m_maxAntennaGainDb;       //!< An upper bound of the gains of the receiver antennas.
+  };
+
+  /**
+   * Add a receiver to the end of an indexed list of receivers.
+   *
+   * \param rxIndex the index of the list
+   * \param phy the receiver
+   */
+  void AddToSpatialIndex (RxSpatialIndex &rxIndex, Ptr<SpectrumPhy> phy) const;
+
+  /**
+   * Remove a receiver from an indexed list of receivers.
+   *
+   * \param rxIndex the index of the list
+   * \param position the position of the receiver in the list
+   */
+  void RemoveFromSpatialIndex (RxSpatialIndex &rxIndex, std::size_t position) const;
+
+  /**
+   * Select, from a list of receivers, the receivers which a transmission
+   * may reach with a loss not larger than MaxLossDb.  The index of the
+   * list is built when it is first used, if the SpatialIndexCellSize
+   * attribute is positive.
+   *
+   * \param rxIndex the index of the list
+   * \param rxPhys the list of receivers
+   * \param txParams the parameters of the transmission
+   * \param txMobility the mobility model of the transmitter
+   * \param candidates the receivers which may be reached, in the order of the list
+   * \return false if all the receivers must be considered, in which case
+   *         the candidates are not set
+   */
+  bool GetRxCandidates (RxSpatialIndex &rxIndex,
+                        const std::vector<Ptr<SpectrumPhy> > &rxPhys,
+                        Ptr<const SpectrumSignalParameters> txParams,
+                        Ptr<MobilityModel> txMobility,
+                        std::vector<Ptr<SpectrumPhy> > &candidates) const;
+
+  /**
+   * Returns a distance beyond which the loss between a transmitter and
+   * any receiver is larger than MaxLossDb, from the single-frequency
+   * propagation loss model and upper bounds of the antenna gains.
+   *
+   * \param txAntenna the antenna of the transmitter, or 0
+   * \param maxRxAntennaGainDb an upper bound of the gains of the receiver antennas
+   * \return the distance in meters, possibly infinite
+   */
+  double GetMaxRange (Ptr<const AntennaModel> txAntenna, double maxRxAntennaGainDb) const;
+
   /**
    * The `PathLoss` trace source. Exporting the pointers to the Tx and Rx
    * SpectrumPhy and a pathloss value, in dB.
@@ -233,6 +296,12 @@ protected:
    */
   Ptr<PhasedArraySpectrumPropagationLossModel> m_phasedArraySpectrumPropagationLoss;
 
+  /**
+   * Size of the cells of the spatial index of the receivers [m], or 0
+   * if the receivers are not indexed.
+   */
+  double m_spatialIndexCellSize;
+
 
 };
 
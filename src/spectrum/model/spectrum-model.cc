@@ -68,6 +68,7 @@ SpectrumModel::SpectrumModel (const std::vector<double>& centerFreqs)
         }
       m_bands.push_back (e);
     }
+  InitBandWidths ();
 }
 
 SpectrumModel::SpectrumModel (const Bands& bands)
@@ -75,6 +76,7 @@ SpectrumModel::SpectrumModel (const Bands& bands)
   m_uid = ++m_uidCount;
   NS_LOG_INFO ("creating new SpectrumModel, m_uid=" << m_uid);
   m_bands = bands;
+  InitBandWidths ();
 }
 
 SpectrumModel::SpectrumModel (Bands&& bands)
@@ -82,6 +84,17 @@ SpectrumModel::SpectrumModel (Bands&& bands)
 {
   m_uid = ++m_uidCount;
   NS_LOG_INFO ("creating new SpectrumModel, m_uid=" << m_uid);
+  InitBandWidths ();
+}
+
+void
+SpectrumModel::InitBandWidths ()
+{
+  m_bandWidths.reserve (m_bands.size ());
+  for (const auto &band : m_bands)
+    {
+      m_bandWidths.push_back (band.fh - band.fl);
+    }
 }
 
 Bands::const_iterator
@@ -96,6 +109,12 @@ SpectrumModel::End () const
   return m_bands.end ();
 }
 
+const std::vector<double> &
+SpectrumModel::GetBandWidths () const
+{
+  return m_bandWidths;
+}
+
 size_t
 SpectrumModel::GetNumBands () const
 {
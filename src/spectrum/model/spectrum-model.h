@@ -134,6 +134,13 @@ public:
    */
   Bands::const_iterator End () const;
 
+  /**
+   * Get the width of the bands, i.e., fh - fl, in the order of the bands.
+   *
+   * @return the vector of band widths, in Hz
+   */
+  const std::vector<double> & GetBandWidths () const;
+
   /**
    * Check if another SpectrumModels has bands orthogonal to our bands.
    *
@@ -143,7 +150,13 @@ public:
   bool IsOrthogonal (const SpectrumModel &other) const;
 
 private:
+  /**
+   * Compute m_bandWidths from m_bands.
+   */
+  void InitBandWidths ();
+
   Bands m_bands;         //!< Actual definition of frequency bands within this SpectrumModel
+  std::vector<double> m_bandWidths; //!< Width of each band, for the integrals
   SpectrumModelUid_t m_uid;        //!< unique id for a given set of frequencies
   static SpectrumModelUid_t m_uidCount;    //!< counter to assign m_uids
 };
@@ -22,35 +22,604 @@
 #include <ns3/spectrum-value.h>
 #include <ns3/math.h>
 #include <ns3/log.h>
+#include <ns3/boolean.h>
+#include <ns3/global-value.h>
+
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+#if defined (__GNUC__) && (defined (__x86_64__) || defined (__i386__))
+/// The SIMD kernels use the GCC vector extensions and target attributes.
+#define SPECTRUM_VALUE_SIMD
+#endif
 
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("SpectrumValue");
 
+/**
+ * \ingroup spectrum
+ * \anchor GlobalValueSpectrumValueSimd
+ * Use the SIMD instructions of the processor in the SpectrumValue
+ * operations.
+ *
+ * This is accessible as "--SpectrumValueSimd" from CommandLine.
+ */
+static GlobalValue g_spectrumValueSimd ("SpectrumValueSimd",
+                                        "Use the SIMD instructions of the processor "
+                                        "in the SpectrumValue operations",
+                                        BooleanValue (true),
+                                        MakeBooleanChecker ());
+
+namespace {
+
+/** Number of partial sums of the reductions. */
+const std::size_t LANES = 8;
+
+#ifdef SPECTRUM_VALUE_SIMD
+/// Force the inlining of the generic kernels into the target-specific functions.
+#define SPECTRUM_VALUE_INLINE inline __attribute__ ((always_inline))
+/// Four doubles, in an AVX2 register.
+typedef double Double4 __attribute__ ((vector_size (32)));
+/// Eight doubles, in an AVX-512 register.
+typedef double Double8 __attribute__ ((vector_size (64)));
+#else
+/// Inlining hint of the generic kernels.
+#define SPECTRUM_VALUE_INLINE inline
+#endif
+
+#if defined (__GNUC__) && !defined (__clang__)
+/**
+ * GCC contracts a product and a sum into a fused multiply-add when the
+ * target has one (e.g., AVX-512), which rounds differently: keep the
+ * separate roundings of the scalar operations.
+ */
+#define SPECTRUM_VALUE_NO_CONTRACT __attribute__ ((optimize ("fp-contract=off")))
+#else
+/// Clang only contracts the operations of a single expression.
+#define SPECTRUM_VALUE_NO_CONTRACT
+#endif
+
+/*
+ * The generic kernels below process the elements by groups of V, which
+ * is double for the scalar kernels, or a vector of doubles.  The
+ * vectors are only held in local variables (never passed by value), so
+ * that the kernels can be compiled without the target instructions and
+ * inlined into the functions compiled for these instructions.
+ */
+
+/** Elementwise a + b. */
+struct AddOp
+{
+  /**
+   * \param [in,out] a the first operand and the result
+   * \param [in] b the second operand
+   */
+  template <typename V>
+  static SPECTRUM_VALUE_INLINE void Apply (double *a, const double *b)
+  {
+    V x, y;
+    std::memcpy (&x, a, sizeof (V));
+    std::memcpy (&y, b, sizeof (V));
+    x = x + y;
+    std::memcpy (a, &x, sizeof (V));
+  }
+};
+
+/** Elementwise a - b. */
+struct SubtractOp
+{
+  /**
+   * \param [in,out] a the first operand and the result
+   * \param [in] b the second operand
+   */
+  template <typename V>
+  static SPECTRUM_VALUE_INLINE void Apply (double *a, const double *b)
+  {
+    V x, y;
+    std::memcpy (&x, a, sizeof (V));
+    std::memcpy (&y, b, sizeof (V));
+    x = x - y;
+    std::memcpy (a, &x, sizeof (V));
+  }
+};
+
+/** Elementwise a * b. */
+struct MultiplyOp
+{
+  /**
+   * \param [in,out] a the first operand and the result
+   * \param [in] b the second operand
+   */
+  template <typename V>
+  static SPECTRUM_VALUE_INLINE void Apply (double *a, const double *b)
+  {
+    V x, y;
+    std::memcpy (&x, a, sizeof (V));
+    std::memcpy (&y, b, sizeof (V));
+    x = x * y;
+    std::memcpy (a, &x, sizeof (V));
+  }
+};
+
+/** Elementwise a / b. */
+struct DivideOp
+{
+  /**
+   * \param [in,out] a the first operand and the result
+   * \param [in] b the second operand
+   */
+  template <typename V>
+  static SPECTRUM_VALUE_INLINE void Apply (double *a, const double *b)
+  {
+    V x, y;
+    std::memcpy (&x, a, sizeof (V));
+    std::memcpy (&y, b, sizeof (V));
+    x = x / y;
+    std::memcpy (a, &x, sizeof (V));
+  }
+};
+
+/**
+ * Apply an elementwise operation to two arrays.
+ *
+ * \param [in,out] a the first operands and the results
+ * \param [in] b the second operands
+ * \param [in] n the number of elements
+ */
+template <typename V, typename Op>
+SPECTRUM_VALUE_INLINE void
+ApplyKernel (double *a, const double *b, std::size_t n)
+{
+  const std::size_t width = sizeof (V) / sizeof (double);
+  std::size_t i = 0;
+  for (; i + width <= n; i += width)
+    {
+      Op::template Apply<V> (a + i, b + i);
+    }
+  for (; i < n; ++i)
+    {
+      Op::template Apply<double> (a + i, b + i);
+    }
+}
+
+/**
+ * Apply an elementwise operation to an array and a scalar.
+ *
+ * \param [in,out] a the first operands and the results
+ * \param [in] s the second operand
+ * \param [in] n the number of elements
+ */
+template <typename V, typename Op>
+SPECTRUM_VALUE_INLINE void
+ApplyScalarKernel (double *a, double s, std::size_t n)
+{
+  const std::size_t width = sizeof (V) / sizeof (double);
+  double b[width];
+  std::fill (b, b + width, s);
+  std::size_t i = 0;
+  for (; i + width <= n; i += width)
+    {
+      Op::template Apply<V> (a + i, b);
+    }
+  for (; i < n; ++i)
+    {
+      Op::template Apply<double> (a + i, b);
+    }
+}
+
+/**
+ * Compute a = b * s.
+ *
+ * \param [out] a the results
+ * \param [in] b the array to scale
+ * \param [in] s the scale factor
+ * \param [in] n the number of elements
+ */
+template <typename V>
+SPECTRUM_VALUE_INLINE void
+ScaleKernel (double *a, const double *b, double s, std::size_t n)
+{
+  const std::size_t width = sizeof (V) / sizeof (double);
+  double scale[width];
+  std::fill (scale, scale + width, s);
+  std::size_t i = 0;
+  for (; i + width <= n; i += width)
+    {
+      std::memcpy (a + i, b + i, sizeof (V));
+      MultiplyOp::Apply<V> (a + i, scale);
+    }
+  for (; i < n; ++i)
+    {
+      a[i] = b[i] * s;
+    }
+}
+
+/**
+ * Compute a += b * s, rounding the product before the sum as in the
+ * two-pass form.
+ *
+ * \param [in,out] a the array to add to
+ * \param [in] b the array to scale
+ * \param [in] s the scale factor
+ * \param [in] n the number of elements
+ */
+template <typename V>
+SPECTRUM_VALUE_INLINE void
+AddScaledKernel (double *a, const double *b, double s, std::size_t n)
+{
+  const std::size_t width = sizeof (V) / sizeof (double);
+  double scale[width];
+  std::fill (scale, scale + width, s);
+  std::size_t i = 0;
+  for (; i + width <= n; i += width)
+    {
+      double product[width];
+      std::memcpy (product, b + i, sizeof (product));
+      MultiplyOp::Apply<V> (product, scale);
+      AddOp::Apply<V> (a + i, product);
+    }
+  for (; i < n; ++i)
+    {
+      double product = b[i] * s;
+      a[i] += product;
+    }
+}
+
+/**
+ * Combine the partial sums of a reduction, in a fixed order.
+ *
+ * \param [in] lanes the partial sums
+ * \return the sum
+ */
+SPECTRUM_VALUE_INLINE double
+CombineLanes (const double *lanes)
+{
+  return ((lanes[0] + lanes[1]) + (lanes[2] + lanes[3]))
+         + ((lanes[4] + lanes[5]) + (lanes[6] + lanes[7]));
+}
+
+/**
+ * Sum the elements of an array.  Element i is accumulated in the
+ * partial sum i % LANES, whatever V.
+ *
+ * \param [in] a the array
+ * \param [in] n the number of elements
+ * \return the sum
+ */
+template <typename V>
+SPECTRUM_VALUE_INLINE double
+SumKernel (const double *a, std::size_t n)
+{
+  const std::size_t width = sizeof (V) / sizeof (double);
+  double lanes[LANES] = {};
+  std::size_t i = 0;
+  for (; i + LANES <= n; i += LANES)
+    {
+      for (std::size_t k = 0; k < LANES; k += width)
+        {
+          AddOp::Apply<V> (lanes + k, a + i + k);
+        }
+    }
+  for (; i < n; ++i)
+    {
+      lanes[i % LANES] += a[i];
+    }
+  return CombineLanes (lanes);
+}
+
+/**
+ * Compute the dot product of two arrays, with the partial sums of
+ * SumKernel.
+ *
+ * \param [in] a the first array
+ * \param [in] b the second array
+ * \param [in] n the number of elements
+ * \return the dot product
+ */
+template <typename V>
+SPECTRUM_VALUE_INLINE double
+DotKernel (const double *a, const double *b, std::size_t n)
+{
+  const std::size_t width = sizeof (V) / sizeof (double);
+  double lanes[LANES] = {};
+  std::size_t i = 0;
+  for (; i + LANES <= n; i += LANES)
+    {
+      double product[LANES];
+      std::memcpy (product, a + i, sizeof (product));
+      for (std::size_t k = 0; k < LANES; k += width)
+        {
+          MultiplyOp::Apply<V> (product + k, b + i + k);
+          AddOp::Apply<V> (lanes + k, product + k);
+        }
+    }
+  for (; i < n; ++i)
+    {
+      double product = a[i] * b[i];
+      lanes[i % LANES] += product;
+    }
+  return CombineLanes (lanes);
+}
+
+/** The kernels of the SpectrumValue operations, for one instruction set. */
+struct Kernels
+{
+  const char *name;                                                  //!< Instruction set
+  void (*add) (double *a, const double *b, std::size_t n);           //!< a += b
+  void (*subtract) (double *a, const double *b, std::size_t n);      //!< a -= b
+  void (*multiply) (double *a, const double *b, std::size_t n);      //!< a *= b
+  void (*divide) (double *a, const double *b, std::size_t n);        //!< a /= b
+  void (*addScalar) (double *a, double s, std::size_t n);            //!< a += s
+  void (*multiplyScalar) (double *a, double s, std::size_t n);       //!< a *= s
+  void (*divideScalar) (double *a, double s, std::size_t n);         //!< a /= s
+  void (*scale) (double *a, const double *b, double s, std::size_t n);     //!< a = b * s
+  void (*addScaled) (double *a, const double *b, double s, std::size_t n); //!< a += b * s
+  double (*sum) (const double *a, std::size_t n);                    //!< sum of a
+  double (*dot) (const double *a, const double *b, std::size_t n);   //!< dot product of a and b
+};
+
+/**
+ * Define the kernels of an instruction set.
+ *
+ * \param [in] isa The name of the instruction set.
+ * \param [in] attributes The attributes of the kernel functions.
+ * \param [in] V The type processed by the kernels.
+ */
+#define SPECTRUM_VALUE_KERNELS(isa, attributes, V)                      \
+  attributes void Add_ ## isa (double *a, const double *b, std::size_t n) \
+  { ApplyKernel<V, AddOp> (a, b, n); }                                  \
+  attributes void Subtract_ ## isa (double *a, const double *b, std::size_t n) \
+  { ApplyKernel<V, SubtractOp> (a, b, n); }                             \
+  attributes void Multiply_ ## isa (double *a, const double *b, std::size_t n) \
+  { ApplyKernel<V, MultiplyOp> (a, b, n); }                             \
+  attributes void Divide_ ## isa (double *a, const double *b, std::size_t n) \
+  { ApplyKernel<V, DivideOp> (a, b, n); }                               \
+  attributes void AddScalar_ ## isa (double *a, double s, std::size_t n) \
+  { ApplyScalarKernel<V, AddOp> (a, s, n); }                            \
+  attributes void MultiplyScalar_ ## isa (double *a, double s, std::size_t n) \
+  { ApplyScalarKernel<V, MultiplyOp> (a, s, n); }                       \
+  attributes void DivideScalar_ ## isa (double *a, double s, std::size_t n) \
+  { ApplyScalarKernel<V, DivideOp> (a, s, n); }                         \
+  attributes void Scale_ ## isa (double *a, const double *b, double s, std::size_t n) \
+  { ScaleKernel<V> (a, b, s, n); }                                      \
+  attributes void AddScaled_ ## isa (double *a, const double *b, double s, std::size_t n) \
+  { AddScaledKernel<V> (a, b, s, n); }                                  \
+  attributes double Sum_ ## isa (const double *a, std::size_t n)        \
+  { return SumKernel<V> (a, n); }                                       \
+  attributes double Dot_ ## isa (const double *a, const double *b, std::size_t n) \
+  { return DotKernel<V> (a, b, n); }                                    \
+  const Kernels g_ ## isa = {                                           \
+    #isa, Add_ ## isa, Subtract_ ## isa, Multiply_ ## isa, Divide_ ## isa, \
+    AddScalar_ ## isa, MultiplyScalar_ ## isa, DivideScalar_ ## isa,    \
+    Scale_ ## isa, AddScaled_ ## isa, Sum_ ## isa, Dot_ ## isa          \
+  }
+
+SPECTRUM_VALUE_KERNELS (none, SPECTRUM_VALUE_NO_CONTRACT, double);
+#ifdef SPECTRUM_VALUE_SIMD
+SPECTRUM_VALUE_KERNELS (avx2, __attribute__ ((target ("avx2"))) SPECTRUM_VALUE_NO_CONTRACT, Double4);
+SPECTRUM_VALUE_KERNELS (avx512f, __attribute__ ((target ("avx512f"))) SPECTRUM_VALUE_NO_CONTRACT, Double8);
+#endif
+
+/**
+ * Select the kernels of the processor, the first time they are used.
+ *
+ * \return the kernels
+ */
+const Kernels *
+GetKernels ()
+{
+  static const Kernels *kernels = [] () {
+      BooleanValue simd;
+      g_spectrumValueSimd.GetValue (simd);
+      if (!simd.Get ())
+        {
+          return &g_none;
+        }
+#ifdef SPECTRUM_VALUE_SIMD
+      __builtin_cpu_init ();
+      if (__builtin_cpu_supports ("avx512f"))
+        {
+          return &g_avx512f;
+        }
+      if (__builtin_cpu_supports ("avx2"))
+        {
+          return &g_avx2;
+        }
+#endif
+      return &g_none;
+    } ();
+  return kernels;
+}
+
+/** Maximum number of released buffers kept in the pool of a SpectrumModel. */
+const std::size_t SPECTRUM_VALUE_POOL_MAX = 1024;
+
+/**
+ * Per-thread pools of released SpectrumValueBuffer objects.
+ *
+ * This is a trivially destructible aggregate so that it can be used
+ * safely at any time during thread and process teardown; the buffers
+ * are released by SpectrumValueBufferPoolReleaser.
+ */
+struct SpectrumValueBufferPool
+{
+  /// The released buffers, by SpectrumModel uid.
+  std::unordered_map<SpectrumModelUid_t, std::vector<SpectrumValueBuffer *> > *free;
+  SpectrumValue::PoolStats stats; //!< Recycling statistics.
+  bool destroyed;                 //!< Releaser has run.
+};
+
+/** The pools of the current thread. */
+thread_local SpectrumValueBufferPool g_bufferPool;
+
+/** Release the pools of the current thread at thread exit. */
+struct SpectrumValueBufferPoolReleaser
+{
+  /** Make sure the destructor is registered for this thread. */
+  void Arm ()
+  {
+    g_bufferPool.free = new std::unordered_map<SpectrumModelUid_t, std::vector<SpectrumValueBuffer *> > ();
+  }
+  /** Release all cached buffers and switch to the system allocator. */
+  ~SpectrumValueBufferPoolReleaser ()
+  {
+    SpectrumValueBufferPool &pool = g_bufferPool;
+    if (pool.free != 0)
+      {
+        for (auto &list : *pool.free)
+          {
+            for (SpectrumValueBuffer *buffer : list.second)
+              {
+                delete buffer;
+              }
+          }
+        delete pool.free;
+        pool.free = 0;
+      }
+    pool.stats.cached = 0;
+    pool.destroyed = true;
+  }
+};
+
+/** Registers the per-thread release of g_bufferPool. */
+thread_local SpectrumValueBufferPoolReleaser g_bufferPoolReleaser;
+
+} // unnamed namespace
+
+Ptr<SpectrumValueBuffer>
+SpectrumValueBuffer::Allocate (SpectrumModelUid_t uid, std::size_t n)
+{
+  // Do not add function logging here: this is called for every copy.
+  SpectrumValueBufferPool &pool = g_bufferPool;
+  if (pool.free != 0)
+    {
+      auto it = pool.free->find (uid);
+      if (it != pool.free->end () && !it->second.empty ())
+        {
+          SpectrumValueBuffer *buffer = it->second.back ();
+          it->second.pop_back ();
+          pool.stats.cached--;
+          pool.stats.recycled++;
+          NS_ASSERT (buffer->m_values.size () == n);
+          // the reference count of a released buffer is zero
+          return Ptr<SpectrumValueBuffer> (buffer);
+        }
+    }
+  pool.stats.allocated++;
+  SpectrumValueBuffer *buffer = new SpectrumValueBuffer ();
+  buffer->m_values.resize (n);
+  buffer->m_uid = uid;
+  return Ptr<SpectrumValueBuffer> (buffer, false);
+}
+
+void
+SpectrumValueBufferDeleter::Delete (SpectrumValueBuffer *buffer)
+{
+  SpectrumValueBufferPool &pool = g_bufferPool;
+  if (pool.destroyed)
+    {
+      delete buffer;
+      return;
+    }
+  if (pool.free == 0)
+    {
+      // The buffer may have been allocated by another thread: make
+      // sure this thread releases its pools when it exits.
+      g_bufferPoolReleaser.Arm ();
+    }
+  std::vector<SpectrumValueBuffer *> &list = (*pool.free)[buffer->m_uid];
+  if (list.size () >= SPECTRUM_VALUE_POOL_MAX)
+    {
+      pool.stats.released++;
+      delete buffer;
+      return;
+    }
+  list.push_back (buffer);
+  pool.stats.cached++;
+}
+
 SpectrumValue::SpectrumValue ()
+  : m_buffer (SpectrumValueBuffer::Allocate (0, 0)),
+    m_gain (1)
 {
 }
 
 SpectrumValue::SpectrumValue (Ptr<const SpectrumModel> sof)
   : m_spectrumModel (sof),
-    m_values (sof->GetNumBands ())
+    m_buffer (SpectrumValueBuffer::Allocate (sof->GetUid (), sof->GetNumBands ())),
+    m_gain (1)
+{
+  std::fill (m_buffer->m_values.begin (), m_buffer->m_values.end (), 0);
+}
+
+void
+SpectrumValue::Unshare () const
+{
+  const Values &values = m_buffer->m_values;
+  Ptr<SpectrumValueBuffer> buffer = SpectrumValueBuffer::Allocate (m_buffer->m_uid, values.size ());
+  if (m_gain == 1)
+    {
+      std::copy (values.begin (), values.end (), buffer->m_values.begin ());
+    }
+  else
+    {
+      GetKernels ()->scale (buffer->m_values.data (), values.data (), m_gain, values.size ());
+    }
+  m_buffer = buffer;
+  m_gain = 1;
+}
+
+void
+SpectrumValue::Materialize () const
+{
+  if (m_gain == 1)
+    {
+      return;
+    }
+  if (m_buffer->GetReferenceCount () > 1)
+    {
+      Unshare ();
+      return;
+    }
+  Values &values = m_buffer->m_values;
+  GetKernels ()->multiplyScalar (values.data (), m_gain, values.size ());
+  m_gain = 1;
+}
+
+void
+SpectrumValue::Detach ()
 {
+  if (m_buffer->GetReferenceCount () > 1)
+    {
+      Unshare ();
+      return;
+    }
+  Materialize ();
+}
 
+const Values &
+SpectrumValue::GetValues () const
+{
+  Materialize ();
+  return m_buffer->m_values;
 }
 
 double&
 SpectrumValue::operator[] (size_t index)
 {
-  return m_values.at (index);
+  Detach ();
+  return m_buffer->m_values.at (index);
 }
 
 const double&
 SpectrumValue::operator[] (size_t index) const
 {
-  return m_values.at (index);
+  return GetValues ().at (index);
 }
 
-
 SpectrumModelUid_t
 SpectrumValue::GetSpectrumModelUid () const
 {
@@ -68,26 +637,28 @@ SpectrumValue::GetSpectrumModel () const
 Values::const_iterator
 SpectrumValue::ConstValuesBegin () const
 {
-  return m_values.begin ();
+  return GetValues ().begin ();
 }
 
 Values::const_iterator
 SpectrumValue::ConstValuesEnd () const
 {
-  return m_values.end ();
+  return GetValues ().end ();
 }
 
 
 Values::iterator
 SpectrumValue::ValuesBegin ()
 {
-  return m_values.begin ();
+  Detach ();
+  return m_buffer->m_values.begin ();
 }
 
 Values::iterator
 SpectrumValue::ValuesEnd ()
 {
-  return m_values.end ();
+  Detach ();
+  return m_buffer->m_values.end ();
 }
 
 Bands::const_iterator
@@ -106,50 +677,48 @@ SpectrumValue::ConstBandsEnd () const
 void
 SpectrumValue::Add (const SpectrumValue& x)
 {
-  Values::iterator it1 = m_values.begin ();
-  Values::const_iterator it2 = x.m_values.begin ();
-
   NS_ASSERT (m_spectrumModel == x.m_spectrumModel);
-  NS_ASSERT (m_values.size () == x.m_values.size ());
+  Detach ();
+  Values &values = m_buffer->m_values;
+  const Values &other = x.GetValues ();
+  NS_ASSERT (values.size () == other.size ());
 
-  while (it1 != m_values.end ())
-    {
-      *it1 += *it2;
-      ++it1;
-      ++it2;
-    }
+  GetKernels ()->add (values.data (), other.data (), values.size ());
 }
 
 
 void
 SpectrumValue::Add (double s)
 {
-  Values::iterator it1 = m_values.begin ();
-
-  while (it1 != m_values.end ())
-    {
-      *it1 += s;
-      ++it1;
-    }
+  Detach ();
+  Values &values = m_buffer->m_values;
+  GetKernels ()->addScalar (values.data (), s, values.size ());
 }
 
 
+void
+SpectrumValue::AddScaled (const SpectrumValue& x, double s)
+{
+  NS_ASSERT (m_spectrumModel == x.m_spectrumModel);
+  Detach ();
+  Values &values = m_buffer->m_values;
+  const Values &other = x.GetValues ();
+  NS_ASSERT (values.size () == other.size ());
+
+  GetKernels ()->addScaled (values.data (), other.data (), s, values.size ());
+}
+
 
 void
 SpectrumValue::Subtract (const SpectrumValue& x)
 {
-  Values::iterator it1 = m_values.begin ();
-  Values::const_iterator it2 = x.m_values.begin ();
-
   NS_ASSERT (m_spectrumModel == x.m_spectrumModel);
-  NS_ASSERT (m_values.size () == x.m_values.size ());
+  Detach ();
+  Values &values = m_buffer->m_values;
+  const Values &other = x.GetValues ();
+  NS_ASSERT (values.size () == other.size ());
 
-  while (it1 != m_values.end ())
-    {
-      *it1 -= *it2;
-      ++it1;
-      ++it2;
-    }
+  GetKernels ()->subtract (values.data (), other.data (), values.size ());
 }
 
 
@@ -164,31 +733,28 @@ SpectrumValue::Subtract (double s)
 void
 SpectrumValue::Multiply (const SpectrumValue& x)
 {
-  Values::iterator it1 = m_values.begin ();
-  Values::const_iterator it2 = x.m_values.begin ();
-
   NS_ASSERT (m_spectrumModel == x.m_spectrumModel);
-  NS_ASSERT (m_values.size () == x.m_values.size ());
+  Detach ();
+  Values &values = m_buffer->m_values;
+  const Values &other = x.GetValues ();
+  NS_ASSERT (values.size () == other.size ());
 
-  while (it1 != m_values.end ())
-    {
-      *it1 *= *it2;
-      ++it1;
-      ++it2;
-    }
+  GetKernels ()->multiply (values.data (), other.data (), values.size ());
 }
 
 
 void
 SpectrumValue::Multiply (double s)
 {
-  Values::iterator it1 = m_values.begin ();
-
-  while (it1 != m_values.end ())
+  if (m_gain == 1 && m_buffer->GetReferenceCount () > 1)
     {
-      *it1 *= s;
-      ++it1;
+      // defer the product to the copy of the shared values
+      m_gain = s;
+      return;
     }
+  Detach ();
+  Values &values = m_buffer->m_values;
+  GetKernels ()->multiplyScalar (values.data (), s, values.size ());
 }
 
 
@@ -197,18 +763,13 @@ SpectrumValue::Multiply (double s)
 void
 SpectrumValue::Divide (const SpectrumValue& x)
 {
-  Values::iterator it1 = m_values.begin ();
-  Values::const_iterator it2 = x.m_values.begin ();
-
   NS_ASSERT (m_spectrumModel == x.m_spectrumModel);
-  NS_ASSERT (m_values.size () == x.m_values.size ());
+  Detach ();
+  Values &values = m_buffer->m_values;
+  const Values &other = x.GetValues ();
+  NS_ASSERT (values.size () == other.size ());
 
-  while (it1 != m_values.end ())
-    {
-      *it1 /= *it2;
-      ++it1;
-      ++it2;
-    }
+  GetKernels ()->divide (values.data (), other.data (), values.size ());
 }
 
 
@@ -216,13 +777,9 @@ void
 SpectrumValue::Divide (double s)
 {
   NS_LOG_FUNCTION (this << s);
-  Values::iterator it1 = m_values.begin ();
-
-  while (it1 != m_values.end ())
-    {
-      *it1 /= s;
-      ++it1;
-    }
+  Detach ();
+  Values &values = m_buffer->m_values;
+  GetKernels ()->divideScalar (values.data (), s, values.size ());
 }
 
 
@@ -231,9 +788,11 @@ SpectrumValue::Divide (double s)
 void
 SpectrumValue::ChangeSign ()
 {
-  Values::iterator it1 = m_values.begin ();
+  Detach ();
+  Values &values = m_buffer->m_values;
+  Values::iterator it1 = values.begin ();
 
-  while (it1 != m_values.end ())
+  while (it1 != values.end ())
     {
       *it1 = -(*it1);
       ++it1;
@@ -244,15 +803,17 @@ SpectrumValue::ChangeSign ()
 void
 SpectrumValue::ShiftLeft (int n)
 {
+  Detach ();
+  Values &values = m_buffer->m_values;
   int i = 0;
-  while (i < (int) m_values.size () - n)
+  while (i < (int) values.size () - n)
     {
-      m_values.at (i) = m_values.at (i + n);
+      values.at (i) = values.at (i + n);
       i++;
     }
-  while (i < (int)m_values.size ())
+  while (i < (int) values.size ())
     {
-      m_values.at (i) = 0;
+      values.at (i) = 0;
       i++;
     }
 }
@@ -261,15 +822,17 @@ SpectrumValue::ShiftLeft (int n)
 void
 SpectrumValue::ShiftRight (int n)
 {
-  int i = m_values.size () - 1;
+  Detach ();
+  Values &values = m_buffer->m_values;
+  int i = values.size () - 1;
   while (i - n >= 0)
     {
-      m_values.at (i) = m_values.at (i - n);
+      values.at (i) = values.at (i - n);
       i = i - 1;
     }
   while (i >= 0)
     {
-      m_values.at (i) = 0;
+      values.at (i) = 0;
       --i;
     }
 }
@@ -280,9 +843,11 @@ void
 SpectrumValue::Pow (double exp)
 {
   NS_LOG_FUNCTION (this << exp);
-  Values::iterator it1 = m_values.begin ();
+  Detach ();
+  Values &values = m_buffer->m_values;
+  Values::iterator it1 = values.begin ();
 
-  while (it1 != m_values.end ())
+  while (it1 != values.end ())
     {
       *it1 = std::pow (*it1, exp);
       ++it1;
@@ -294,9 +859,11 @@ void
 SpectrumValue::Exp (double base)
 {
   NS_LOG_FUNCTION (this << base);
-  Values::iterator it1 = m_values.begin ();
+  Detach ();
+  Values &values = m_buffer->m_values;
+  Values::iterator it1 = values.begin ();
 
-  while (it1 != m_values.end ())
+  while (it1 != values.end ())
     {
       *it1 = std::pow (base, *it1);
       ++it1;
@@ -308,9 +875,11 @@ void
 SpectrumValue::Log10 ()
 {
   NS_LOG_FUNCTION (this);
-  Values::iterator it1 = m_values.begin ();
+  Detach ();
+  Values &values = m_buffer->m_values;
+  Values::iterator it1 = values.begin ();
 
-  while (it1 != m_values.end ())
+  while (it1 != values.end ())
     {
       *it1 = std::log10 (*it1);
       ++it1;
@@ -321,9 +890,11 @@ void
 SpectrumValue::Log2 ()
 {
   NS_LOG_FUNCTION (this);
-  Values::iterator it1 = m_values.begin ();
+  Detach ();
+  Values &values = m_buffer->m_values;
+  Values::iterator it1 = values.begin ();
 
-  while (it1 != m_values.end ())
+  while (it1 != values.end ())
     {
       *it1 = log2 (*it1);
       ++it1;
@@ -335,9 +906,11 @@ void
 SpectrumValue::Log ()
 {
   NS_LOG_FUNCTION (this);
-  Values::iterator it1 = m_values.begin ();
+  Detach ();
+  Values &values = m_buffer->m_values;
+  Values::iterator it1 = values.begin ();
 
-  while (it1 != m_values.end ())
+  while (it1 != values.end ())
     {
       *it1 = std::log (*it1);
       ++it1;
@@ -347,28 +920,16 @@ SpectrumValue::Log ()
 double
 Norm (const SpectrumValue& x)
 {
-  double s = 0;
-  Values::const_iterator it1 = x.ConstValuesBegin ();
-  while (it1 != x.ConstValuesEnd ())
-    {
-      s += (*it1) * (*it1);
-      ++it1;
-    }
-  return std::sqrt (s);
+  const Values &values = x.GetValues ();
+  return std::sqrt (GetKernels ()->dot (values.data (), values.data (), values.size ()));
 }
 
 
 double
 Sum (const SpectrumValue& x)
 {
-  double s = 0;
-  Values::const_iterator it1 = x.ConstValuesBegin ();
-  while (it1 != x.ConstValuesEnd ())
-    {
-      s += (*it1);
-      ++it1;
-    }
-  return s;
+  const Values &values = x.GetValues ();
+  return GetKernels ()->sum (values.data (), values.size ());
 }
 
 
@@ -389,18 +950,10 @@ Prod (const SpectrumValue& x)
 double
 Integral (const SpectrumValue& arg)
 {
-  double i = 0;
-  Values::const_iterator vit = arg.ConstValuesBegin ();
-  Bands::const_iterator bit = arg.ConstBandsBegin ();
-  while (vit != arg.ConstValuesEnd ())
-    {
-      NS_ASSERT (bit != arg.ConstBandsEnd ());
-      i += (*vit) * (bit->fh - bit->fl);
-      ++vit;
-      ++bit;
-    }
-  NS_ASSERT (bit == arg.ConstBandsEnd ());
-  return i;
+  const std::vector<double> &widths = arg.m_spectrumModel->GetBandWidths ();
+  const Values &values = arg.GetValues ();
+  NS_ASSERT (widths.size () == values.size ());
+  return GetKernels ()->dot (values.data (), widths.data (), values.size ());
 }
 
 
@@ -408,11 +961,8 @@ Integral (const SpectrumValue& arg)
 Ptr<SpectrumValue>
 SpectrumValue::Copy () const
 {
-  Ptr<SpectrumValue> p = Create<SpectrumValue> (m_spectrumModel);
-  *p = *this;
-  return p;
-
-  //  return Copy<SpectrumValue> (*this)
+  // the copy shares the values until either is modified
+  return Create<SpectrumValue> (*this);
 }
 
 
@@ -467,9 +1017,8 @@ operator+ (double lhs, const SpectrumValue& rhs)
 SpectrumValue
 operator- (const SpectrumValue& lhs, const SpectrumValue& rhs)
 {
-  SpectrumValue res = rhs;
-  res.ChangeSign ();
-  res.Add (lhs);
+  SpectrumValue res = lhs;
+  res.Subtract (rhs);
   return res;
 }
 
@@ -664,13 +1213,13 @@ SpectrumValue::operator/= (double rhs)
 SpectrumValue&
 SpectrumValue::operator= (double rhs)
 {
-  Values::iterator it1 = m_values.begin ();
-
-  while (it1 != m_values.end ())
+  if (m_buffer->GetReferenceCount () > 1)
     {
-      *it1 = rhs;
-      ++it1;
+      // no need to copy the values which are overwritten
+      m_buffer = SpectrumValueBuffer::Allocate (m_buffer->m_uid, m_buffer->m_values.size ());
     }
+  m_gain = 1;
+  std::fill (m_buffer->m_values.begin (), m_buffer->m_values.end (), rhs);
   return *this;
 }
 
@@ -695,13 +1244,25 @@ SpectrumValue::operator>> (int n) const
 uint32_t
 SpectrumValue::GetValuesN () const
 {
-  return m_values.size ();
+  return m_buffer->m_values.size ();
 }
 
 const double &
 SpectrumValue::ValuesAt (uint32_t pos) const
 {
-  return m_values.at (pos);
+  return GetValues ().at (pos);
+}
+
+std::string
+SpectrumValue::GetSimdInstructionSet ()
+{
+  return GetKernels ()->name;
+}
+
+SpectrumValue::PoolStats
+SpectrumValue::GetPoolStats ()
+{
+  return g_bufferPool.stats;
 }
 
 } // namespace ns3
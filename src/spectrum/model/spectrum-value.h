@@ -22,16 +22,133 @@
 #define SPECTRUM_VALUE_H
 
 #include <ns3/ptr.h>
+#include <ns3/empty.h>
 #include <ns3/simple-ref-count.h>
 #include <ns3/spectrum-model.h>
+#include <cstdint>
 #include <ostream>
+#include <string>
 #include <vector>
 
 namespace ns3 {
 
+/**
+ * \ingroup spectrum
+ *
+ * \brief Allocator of the storage of the SpectrumValue elements
+ *
+ * The elements are aligned on 64-byte boundaries, i.e., on cache lines,
+ * so that the vectorized SpectrumValue operations never load or store
+ * a SIMD register across two cache lines.
+ */
+template <typename T>
+class SpectrumValueAllocator
+{
+public:
+  typedef T value_type; //!< The type of the allocated elements
+
+  /** The alignment of the storage, in bytes */
+  static const std::size_t ALIGNMENT = 64;
+
+  SpectrumValueAllocator () = default;
+  /**
+   * Conversion from the allocator of another type
+   * \param [in] other the allocator to convert
+   */
+  template <typename U>
+  SpectrumValueAllocator (const SpectrumValueAllocator<U> &other)
+  {
+  }
+
+  /**
+   * Allocate the storage of n elements
+   * \param [in] n the number of elements
+   * \return the storage
+   */
+  T * allocate (std::size_t n)
+  {
+    // The aligned operator new is much slower than the plain one with
+    // glibc: over-allocate instead, and keep the address of the block
+    // just before the aligned storage.
+    char *block = static_cast<char *> (::operator new (n * sizeof (T) + ALIGNMENT));
+    std::uintptr_t aligned = (reinterpret_cast<std::uintptr_t> (block) + ALIGNMENT) & ~(ALIGNMENT - 1);
+    reinterpret_cast<char **> (aligned)[-1] = block;
+    return reinterpret_cast<T *> (aligned);
+  }
+  /**
+   * Release the storage of n elements
+   * \param [in] p the storage, returned by allocate()
+   * \param [in] n the number of elements
+   */
+  void deallocate (T *p, std::size_t n)
+  {
+    ::operator delete (reinterpret_cast<char **> (p)[-1]);
+  }
+};
+
+/**
+ * All the SpectrumValueAllocator objects are equivalent.
+ * \return true
+ */
+template <typename T, typename U>
+bool operator== (const SpectrumValueAllocator<T> &, const SpectrumValueAllocator<U> &)
+{
+  return true;
+}
+
+/**
+ * All the SpectrumValueAllocator objects are equivalent.
+ * \return false
+ */
+template <typename T, typename U>
+bool operator!= (const SpectrumValueAllocator<T> &, const SpectrumValueAllocator<U> &)
+{
+  return false;
+}
 
 /// Container for element values
-typedef std::vector<double> Values;
+typedef std::vector<double, SpectrumValueAllocator<double> > Values;
+
+class SpectrumValueBuffer;
+
+/**
+ * \ingroup spectrum
+ *
+ * Return the released SpectrumValueBuffer objects to the buffer pool
+ * of the calling thread.
+ */
+struct SpectrumValueBufferDeleter
+{
+  /**
+   * \param [in] buffer the buffer to release
+   */
+  static void Delete (SpectrumValueBuffer *buffer);
+};
+
+/**
+ * \ingroup spectrum
+ *
+ * \brief The values of a SpectrumValue, shared by its copies
+ *
+ * The released buffers are kept in per-thread pools, one per
+ * SpectrumModel, and reused by the next SpectrumValue objects of the
+ * same SpectrumModel.
+ */
+class SpectrumValueBuffer : public SimpleRefCount<SpectrumValueBuffer, empty, SpectrumValueBufferDeleter>
+{
+public:
+  /**
+   * Get a buffer from the pool of the calling thread.
+   *
+   * \param [in] uid the uid of the SpectrumModel of the values
+   * \param [in] n the number of values
+   * \return a buffer of n values, whose contents are unspecified
+   */
+  static Ptr<SpectrumValueBuffer> Allocate (SpectrumModelUid_t uid, std::size_t n);
+
+  Values m_values;          //!< The values
+  SpectrumModelUid_t m_uid; //!< The uid of the SpectrumModel of the values
+};
 
 /**
  * \ingroup spectrum
@@ -54,6 +171,22 @@ typedef std::vector<double> Values;
  * The intended use of this class is to represent frequency-dependent
  * things, such as power spectral densities, frequency-dependent
  * propagation losses, spectral masks, etc.
+ *
+ * The elementwise arithmetic operations and the Sum, Norm and Integral
+ * reductions use the widest SIMD instructions of the processor among
+ * AVX-512F and AVX2, which are detected at run time, unless the
+ * "SpectrumValueSimd" global value is false.  The reductions accumulate
+ * the elements in eight interleaved partial sums, whatever the
+ * instructions, so their results do not depend on the processor.
+ *
+ * The copies of a SpectrumValue share their values until one of them
+ * is modified, e.g., when a channel hands the transmitted power
+ * spectral density to each receiver.  Multiplying a SpectrumValue
+ * whose values are shared by a scalar only records the factor, which
+ * is applied when the values are accessed, in the same pass as their
+ * copy.  As with any copy-on-write container, the references and
+ * iterators obtained from the non-const accessors are invalidated
+ * by the next copy of the SpectrumValue.
  */
 class SpectrumValue : public SimpleRefCount<SpectrumValue>
 {
@@ -170,6 +303,39 @@ public:
    */
   const double & ValuesAt (uint32_t pos) const;
 
+  /**
+   * Add a scaled SpectrumValue, i.e., compute *this += x * s in a single
+   * pass over the elements, without a temporary SpectrumValue.
+   *
+   * \param x the SpectrumValue to scale and add
+   * \param s the scale factor
+   */
+  void AddScaled (const SpectrumValue& x, double s);
+
+  /**
+   * \return the SIMD instruction set used by the operations: "avx512f",
+   * "avx2" or "none"
+   */
+  static std::string GetSimdInstructionSet ();
+
+  /**
+   * Statistics of the pools of SpectrumValueBuffer objects.
+   *
+   * The pools are kept per thread, so these counters describe the
+   * allocations and releases performed by the calling thread only.
+   */
+  struct PoolStats
+  {
+    uint64_t allocated;  //!< Buffers obtained from the system allocator.
+    uint64_t recycled;   //!< Allocations served from a pool.
+    uint64_t released;   //!< Buffers handed back to the system allocator.
+    uint64_t cached;     //!< Buffers currently held in the pools.
+  };
+  /**
+   * \return the buffer pool statistics of the calling thread
+   */
+  static PoolStats GetPoolStats ();
+
   /**
    *  addition operator
    *
@@ -606,6 +772,26 @@ private:
    */
   void Log ();
 
+  /**
+   * Apply the pending gain to the values, copying them if they are
+   * shared.
+   */
+  void Materialize () const;
+  /**
+   * Make the values modifiable, i.e., apply the pending gain and stop
+   * sharing them.
+   */
+  void Detach ();
+  /**
+   * Replace the values by a copy owned by this object, with the
+   * pending gain applied.
+   */
+  void Unshare () const;
+  /**
+   * \return the values, with the pending gain applied
+   */
+  const Values & GetValues () const;
+
   Ptr<const SpectrumModel> m_spectrumModel; //!< The spectrum model
 
 
@@ -615,8 +801,16 @@ private:
    * on what these values represent (a transmission power density, a
    * propagation loss, etc.).
    *
+   * The buffer is shared by the copies of this SpectrumValue until
+   * they are modified.
+   */
+  mutable Ptr<SpectrumValueBuffer> m_buffer;
+
+  /**
+   * The factor by which the values in m_buffer must still be
+   * multiplied.  It is only different from 1 while m_buffer is shared.
    */
-  Values m_values;
+  mutable double m_gain;
 
 
 };
@@ -1811,37 +1811,51 @@ ThreeGppChannelModel::GetNewChannel (Ptr<const ThreeGppChannelParams> channelPar
 
   //Step 11: Generate channel coefficients for each cluster n and each receiver
   // and transmitter element pair u,s.
-  Complex3DVector hUsn;  //channel coffecient hUsn[u][s][n];
-  // where u and s are receive and transmit antenna element, n is cluster index.
   // NOTE Since each of the strongest 2 clusters are divided into 3 sub-clusters,
   // the total cluster will be numReducedCLuster + 4.
   uint64_t uSize = uAntenna->GetNumberOfElements ();
   uint64_t sSize = sAntenna->GetNumberOfElements ();
-
-  hUsn.resize (uSize);
-  for (uint64_t uIndex = 0; uIndex < uSize; uIndex++)
+  uint8_t numReducedCluster = channelParams->m_reducedClusterNumber;
+  uint8_t raysPerCluster = table3gpp->m_raysPerCluster;
+
+  NS_ASSERT (numReducedCluster <= channelParams->m_clusterPhase.size ());
+  NS_ASSERT (numReducedCluster <= channelParams->m_clusterPower.size ());
+  NS_ASSERT (numReducedCluster <= channelParams->m_crossPolarizationPowerRatios.size ());
+  NS_ASSERT (numReducedCluster <= rayZoaRadian.size ());
+  NS_ASSERT (numReducedCluster <= rayZodRadian.size ());
+  NS_ASSERT (numReducedCluster <= rayAoaRadian.size ());
+  NS_ASSERT (numReducedCluster <= rayAodRadian.size ());
+  NS_ASSERT (raysPerCluster <= channelParams->m_clusterPhase[0].size ());
+  NS_ASSERT (raysPerCluster <= channelParams->m_crossPolarizationPowerRatios[0].size ());
+  NS_ASSERT (raysPerCluster <= rayZoaRadian[0].size ());
+  NS_ASSERT (raysPerCluster <= rayZodRadian[0].size ());
+  NS_ASSERT (raysPerCluster <= rayAoaRadian[0].size ());
+  NS_ASSERT (raysPerCluster <= rayAodRadian[0].size ());
+
+  uint8_t numStrongCluster = 0;
+  for (uint8_t nIndex = 0; nIndex < numReducedCluster; nIndex++)
     {
-      hUsn[uIndex].resize (sSize);
-      for (uint64_t sIndex = 0; sIndex < sSize; sIndex++)
+      if (nIndex == channelParams->m_cluster1st || nIndex == channelParams->m_cluster2nd)
         {
-          hUsn[uIndex][sIndex].resize (channelParams->m_reducedClusterNumber);
+          numStrongCluster++;
         }
     }
 
-  NS_ASSERT (channelParams->m_reducedClusterNumber <= channelParams->m_clusterPhase.size ());
-  NS_ASSERT (channelParams->m_reducedClusterNumber <= channelParams->m_clusterPower.size ());
-  NS_ASSERT (channelParams->m_reducedClusterNumber <= channelParams->m_crossPolarizationPowerRatios.size ());
-  NS_ASSERT (channelParams->m_reducedClusterNumber <= rayZoaRadian.size ());
-  NS_ASSERT (channelParams->m_reducedClusterNumber <= rayZodRadian.size ());
-  NS_ASSERT (channelParams->m_reducedClusterNumber <= rayAoaRadian.size ());
-  NS_ASSERT (channelParams->m_reducedClusterNumber <= rayAodRadian.size ());
-  NS_ASSERT (table3gpp->m_raysPerCluster <= channelParams->m_clusterPhase[0].size ());
-  NS_ASSERT (table3gpp->m_raysPerCluster <= channelParams->m_crossPolarizationPowerRatios[0].size ());
-  NS_ASSERT (table3gpp->m_raysPerCluster <= rayZoaRadian[0].size ());
-  NS_ASSERT (table3gpp->m_raysPerCluster <= rayZodRadian[0].size ());
-  NS_ASSERT (table3gpp->m_raysPerCluster <= rayAoaRadian[0].size ());
-  NS_ASSERT (table3gpp->m_raysPerCluster <= rayAodRadian[0].size ());
+  //channel coffecient hUsn (u, s, n);
+  // where u and s are receive and transmit antenna element, n is cluster index.
+  // The sub-clusters 2 and 3 of the strongest clusters follow the other clusters.
+  Complex3DVector hUsn (uSize, sSize, numReducedCluster + 2 * numStrongCluster);
 
+  std::vector<Vector> uLoc (uSize);
+  for (uint64_t uIndex = 0; uIndex < uSize; uIndex++)
+    {
+      uLoc[uIndex] = uAntenna->GetElementLocation (uIndex);
+    }
+  std::vector<Vector> sLoc (sSize);
+  for (uint64_t sIndex = 0; sIndex < sSize; sIndex++)
+    {
+      sLoc[sIndex] = sAntenna->GetElementLocation (sIndex);
+    }
 
   double x = sMob->GetPosition ().x - uMob->GetPosition ().x;
   double y = sMob->GetPosition ().y - uMob->GetPosition ().y;
@@ -1856,159 +1870,194 @@ ThreeGppChannelModel::GetNewChannel (Ptr<const ThreeGppChannelParams> channelPar
   Angles sAngle (uMob->GetPosition (), sMob->GetPosition ());
   Angles uAngle (sMob->GetPosition (), uMob->GetPosition ());
 
-
-  // The following for loops computes the channel coefficients
-  for (uint64_t uIndex = 0; uIndex < uSize; uIndex++)
+  // The coefficient of a ray m of a cluster n between the elements u and s
+  // is the product of a polarization term, which depends on the ray only,
+  // of the phase shift of the ray at the element u and of the phase shift
+  // of the ray at the element s. The phase shifts are computed once per
+  // element, and the products are summed by page, the elements being
+  // stored as separate real and imaginary parts (hRe and hIm, indexed by
+  // uIndex * sSize + sIndex) so that the loops over the s elements can be
+  // vectorized.
+  std::vector<double> rxRe (raysPerCluster * uSize);
+  std::vector<double> rxIm (raysPerCluster * uSize);
+  std::vector<double> txRe (raysPerCluster * sSize);
+  std::vector<double> txIm (raysPerCluster * sSize);
+  std::vector<std::complex<double> > polarization (raysPerCluster);
+  std::vector<double> hRe (3 * uSize * sSize);
+  std::vector<double> hIm (3 * uSize * sSize);
+  uint8_t subClusterPage = numReducedCluster;
+
+  for (uint8_t nIndex = 0; nIndex < numReducedCluster; nIndex++)
     {
-      Vector uLoc = uAntenna->GetElementLocation (uIndex);
+      bool isStrong = (nIndex == channelParams->m_cluster1st || nIndex == channelParams->m_cluster2nd);
 
-      for (uint64_t sIndex = 0; sIndex < sSize; sIndex++)
+      for (uint8_t mIndex = 0; mIndex < raysPerCluster; mIndex++)
         {
-          Vector sLoc = sAntenna->GetElementLocation (sIndex);
+          //lambda_0 is accounted in the antenna spacing uLoc and sLoc.
+          double rxX = sin (rayZoaRadian[nIndex][mIndex]) * cos (rayAoaRadian[nIndex][mIndex]);
+          double rxY = sin (rayZoaRadian[nIndex][mIndex]) * sin (rayAoaRadian[nIndex][mIndex]);
+          double rxZ = cos (rayZoaRadian[nIndex][mIndex]);
+          for (uint64_t uIndex = 0; uIndex < uSize; uIndex++)
+            {
+              double rxPhaseDiff = 2 * M_PI * (rxX * uLoc[uIndex].x + rxY * uLoc[uIndex].y + rxZ * uLoc[uIndex].z);
+              rxRe[mIndex * uSize + uIndex] = cos (rxPhaseDiff);
+              rxIm[mIndex * uSize + uIndex] = sin (rxPhaseDiff);
+            }
+          double txX = sin (rayZodRadian[nIndex][mIndex]) * cos (rayAodRadian[nIndex][mIndex]);
+          double txY = sin (rayZodRadian[nIndex][mIndex]) * sin (rayAodRadian[nIndex][mIndex]);
+          double txZ = cos (rayZodRadian[nIndex][mIndex]);
+          for (uint64_t sIndex = 0; sIndex < sSize; sIndex++)
+            {
+              double txPhaseDiff = 2 * M_PI * (txX * sLoc[sIndex].x + txY * sLoc[sIndex].y + txZ * sLoc[sIndex].z);
+              txRe[mIndex * sSize + sIndex] = cos (txPhaseDiff);
+              txIm[mIndex * sSize + sIndex] = sin (txPhaseDiff);
+            }
+          // NOTE Doppler is computed in the CalcBeamformingGain function and is simplified to only account for the center angle of each cluster.
+
+          double k = channelParams->m_crossPolarizationPowerRatios[nIndex][mIndex];
+          const DoubleVector &initialPhase = channelParams->m_clusterPhase[nIndex][mIndex];
+          NS_ASSERT (4 <= initialPhase.size ());
+          double rxFieldPatternPhi, rxFieldPatternTheta, txFieldPatternPhi, txFieldPatternTheta;
+          if (isStrong)
+            {
+              std::tie (rxFieldPatternPhi, rxFieldPatternTheta) = uAntenna->GetElementFieldPattern (Angles (rayAoaRadian[nIndex][mIndex], rayZoaRadian[nIndex][mIndex]));
+              std::tie (txFieldPatternPhi, txFieldPatternTheta) = sAntenna->GetElementFieldPattern (Angles (rayAodRadian[nIndex][mIndex], rayZodRadian[nIndex][mIndex]));
+            }
+          else
+            {
+              std::tie (rxFieldPatternPhi, rxFieldPatternTheta) = uAntenna->GetElementFieldPattern (Angles (channelParams->m_rayAoaRadian[nIndex][mIndex], channelParams->m_rayZoaRadian[nIndex][mIndex]));
+              std::tie (txFieldPatternPhi, txFieldPatternTheta) = sAntenna->GetElementFieldPattern (Angles (channelParams->m_rayAodRadian[nIndex][mIndex], channelParams->m_rayZodRadian[nIndex][mIndex]));
+            }
+          polarization[mIndex] = std::complex<double> (cos (initialPhase[0]), sin (initialPhase[0])) * rxFieldPatternTheta * txFieldPatternTheta +
+            std::complex<double> (cos (initialPhase[1]), sin (initialPhase[1])) * std::sqrt (1 / k) * rxFieldPatternTheta * txFieldPatternPhi +
+            std::complex<double> (cos (initialPhase[2]), sin (initialPhase[2])) * std::sqrt (1 / k) * rxFieldPatternPhi * txFieldPatternTheta +
+            std::complex<double> (cos (initialPhase[3]), sin (initialPhase[3])) * rxFieldPatternPhi * txFieldPatternPhi;
+        }
 
-          for (uint8_t nIndex = 0; nIndex < channelParams->m_reducedClusterNumber; nIndex++)
+      // sum the rays of the cluster, or of each of its 3 sub-clusters (7.5-28)
+      std::fill (hRe.begin (), hRe.end (), 0.0);
+      std::fill (hIm.begin (), hIm.end (), 0.0);
+      for (uint8_t mIndex = 0; mIndex < raysPerCluster; mIndex++)
+        {
+          uint8_t subCluster = 0;
+          if (isStrong)
             {
-              //Compute the N-2 weakest cluster, assuming 0 slant angle and a
-              //polarization slant angle configured in the array (7.5-22)
-              if (nIndex != channelParams->m_cluster1st && nIndex != channelParams->m_cluster2nd)
+              switch (mIndex)
                 {
-                  std::complex<double> rays (0,0);
-                  for (uint8_t mIndex = 0; mIndex < table3gpp->m_raysPerCluster; mIndex++)
-                    {
-                      DoubleVector initialPhase = channelParams->m_clusterPhase[nIndex][mIndex];
-                      double k = channelParams->m_crossPolarizationPowerRatios[nIndex][mIndex];
-                      //lambda_0 is accounted in the antenna spacing uLoc and sLoc.
-                      double rxPhaseDiff = 2 * M_PI * (sin (rayZoaRadian[nIndex][mIndex]) * cos (rayAoaRadian[nIndex][mIndex]) * uLoc.x
-                                                       + sin (rayZoaRadian[nIndex][mIndex]) * sin (rayAoaRadian[nIndex][mIndex]) * uLoc.y
-                                                       + cos (rayZoaRadian[nIndex][mIndex]) * uLoc.z);
-
-                      double txPhaseDiff = 2 * M_PI * (sin (rayZodRadian[nIndex][mIndex]) * cos (rayAodRadian[nIndex][mIndex]) * sLoc.x
-                                                       + sin (rayZodRadian[nIndex][mIndex]) * sin (rayAodRadian[nIndex][mIndex]) * sLoc.y
-                                                       + cos (rayZodRadian[nIndex][mIndex]) * sLoc.z);
-                      // NOTE Doppler is computed in the CalcBeamformingGain function and is simplified to only account for the center angle of each cluster.
-
-                      double rxFieldPatternPhi, rxFieldPatternTheta, txFieldPatternPhi, txFieldPatternTheta;
-                      std::tie (rxFieldPatternPhi, rxFieldPatternTheta) = uAntenna->GetElementFieldPattern (Angles (channelParams->m_rayAoaRadian[nIndex][mIndex], channelParams->m_rayZoaRadian[nIndex][mIndex]));
-                      std::tie (txFieldPatternPhi, txFieldPatternTheta) = sAntenna->GetElementFieldPattern (Angles (channelParams->m_rayAodRadian[nIndex][mIndex], channelParams->m_rayZodRadian[nIndex][mIndex]));
-                      NS_ASSERT (4 <= initialPhase.size ());
-                      rays += (std::complex<double> (cos (initialPhase[0]), sin (initialPhase[0])) * rxFieldPatternTheta * txFieldPatternTheta +
-                               std::complex<double> (cos (initialPhase[1]), sin (initialPhase[1])) * std::sqrt (1 / k) * rxFieldPatternTheta * txFieldPatternPhi +
-                               std::complex<double> (cos (initialPhase[2]), sin (initialPhase[2])) * std::sqrt (1 / k) * rxFieldPatternPhi * txFieldPatternTheta +
-                               std::complex<double> (cos (initialPhase[3]), sin (initialPhase[3])) * rxFieldPatternPhi * txFieldPatternPhi)
-                        * std::complex<double> (cos (rxPhaseDiff), sin (rxPhaseDiff))
-                        * std::complex<double> (cos (txPhaseDiff), sin (txPhaseDiff));
-                    }
-                  rays *= sqrt (channelParams->m_clusterPower[nIndex] / table3gpp->m_raysPerCluster);
-                  hUsn[uIndex][sIndex][nIndex] = rays;
+                  case 9:
+                  case 10:
+                  case 11:
+                  case 12:
+                  case 17:
+                  case 18:
+                    subCluster = 1;
+                    break;
+                  case 13:
+                  case 14:
+                  case 15:
+                  case 16:
+                    subCluster = 2;
+                    break;
+                  default:                      //case 1,2,3,4,5,6,7,8,19,20
+                    subCluster = 0;
+                    break;
                 }
-              else  //(7.5-28)
+            }
+          const double *tRe = &txRe[mIndex * sSize];
+          const double *tIm = &txIm[mIndex * sSize];
+          for (uint64_t uIndex = 0; uIndex < uSize; uIndex++)
+            {
+              std::complex<double> a = polarization[mIndex] * std::complex<double> (rxRe[mIndex * uSize + uIndex], rxIm[mIndex * uSize + uIndex]);
+              double aRe = a.real ();
+              double aIm = a.imag ();
+              double *re = &hRe[(subCluster * uSize + uIndex) * sSize];
+              double *im = &hIm[(subCluster * uSize + uIndex) * sSize];
+              for (uint64_t sIndex = 0; sIndex < sSize; sIndex++)
                 {
-                  std::complex<double> raysSub1 (0, 0);
-                  std::complex<double> raysSub2 (0, 0);
-                  std::complex<double> raysSub3 (0, 0);
-
-                  for (uint8_t mIndex = 0; mIndex < table3gpp->m_raysPerCluster; mIndex++)
-                    {
-                      double k = channelParams->m_crossPolarizationPowerRatios[nIndex][mIndex];
-
-                      //ZML:Just remind me that the angle offsets for the 3 subclusters were not generated correctly.
-                      DoubleVector initialPhase = channelParams->m_clusterPhase[nIndex][mIndex];
-                      NS_ASSERT (4 <= initialPhase.size ());
-
-                      double rxPhaseDiff = 2 * M_PI * (sin (rayZoaRadian[nIndex][mIndex]) * cos (rayAoaRadian[nIndex][mIndex]) * uLoc.x
-                                                       + sin (rayZoaRadian[nIndex][mIndex]) * sin (rayAoaRadian[nIndex][mIndex]) * uLoc.y
-                                                       + cos (rayZoaRadian[nIndex][mIndex]) * uLoc.z);
-                      double txPhaseDiff = 2 * M_PI * (sin (rayZodRadian[nIndex][mIndex]) * cos (rayAodRadian[nIndex][mIndex]) * sLoc.x
-                                                       + sin (rayZodRadian[nIndex][mIndex]) * sin (rayAodRadian[nIndex][mIndex]) * sLoc.y
-                                                       + cos (rayZodRadian[nIndex][mIndex]) * sLoc.z);
-
-                      double rxFieldPatternPhi, rxFieldPatternTheta, txFieldPatternPhi, txFieldPatternTheta;
-                      std::tie (rxFieldPatternPhi, rxFieldPatternTheta) = uAntenna->GetElementFieldPattern (Angles (rayAoaRadian[nIndex][mIndex], rayZoaRadian[nIndex][mIndex]));
-                      std::tie (txFieldPatternPhi, txFieldPatternTheta) = sAntenna->GetElementFieldPattern (Angles (rayAodRadian[nIndex][mIndex], rayZodRadian[nIndex][mIndex]));
-
-                      std::complex<double> raySub = (std::complex<double> (cos (initialPhase[0]), sin (initialPhase[0])) * rxFieldPatternTheta * txFieldPatternTheta +
-                                                     std::complex<double> (cos (initialPhase[1]), sin (initialPhase[1])) * sqrt (1 / k) * rxFieldPatternTheta * txFieldPatternPhi +
-                                                     std::complex<double> (cos (initialPhase[2]), sin (initialPhase[2])) * sqrt (1 / k) * rxFieldPatternPhi * txFieldPatternTheta +
-                                                     std::complex<double> (cos (initialPhase[3]), sin (initialPhase[3])) * rxFieldPatternPhi * txFieldPatternPhi)
-                        * std::complex<double> (cos (rxPhaseDiff), sin (rxPhaseDiff))
-                        * std::complex<double> (cos (txPhaseDiff), sin (txPhaseDiff));
-
-                      switch (mIndex)
-                        {
-                          case 9:
-                          case 10:
-                          case 11:
-                          case 12:
-                          case 17:
-                          case 18:
-                            raysSub2 += raySub;
-                            break;
-                          case 13:
-                          case 14:
-                          case 15:
-                          case 16:
-                            raysSub3 += raySub;
-                            break;
-                          default:                      //case 1,2,3,4,5,6,7,8,19,20
-                            raysSub1 += raySub;
-                            break;
-                        }
-                    }
-                  raysSub1 *= sqrt (channelParams->m_clusterPower[nIndex] / table3gpp->m_raysPerCluster);
-                  raysSub2 *= sqrt (channelParams->m_clusterPower[nIndex] / table3gpp->m_raysPerCluster);
-                  raysSub3 *= sqrt (channelParams->m_clusterPower[nIndex] / table3gpp->m_raysPerCluster);
-                  hUsn[uIndex][sIndex][nIndex] = raysSub1;
-                  hUsn[uIndex][sIndex].push_back (raysSub2);
-                  hUsn[uIndex][sIndex].push_back (raysSub3);
+                  re[sIndex] += aRe * tRe[sIndex] - aIm * tIm[sIndex];
+                  im[sIndex] += aRe * tIm[sIndex] + aIm * tRe[sIndex];
                 }
             }
+        }
 
-          if (channelParams->m_losCondition == ChannelCondition::LOS) //(7.5-29) && (7.5-30)
+      double scale = sqrt (channelParams->m_clusterPower[nIndex] / raysPerCluster);
+      for (uint8_t subCluster = 0; subCluster < (isStrong ? 3 : 1); subCluster++)
+        {
+          std::complex<double> *page = hUsn.GetPagePointer (subCluster == 0 ? nIndex : subClusterPage++);
+          for (uint64_t uIndex = 0; uIndex < uSize; uIndex++)
             {
-              std::complex<double> ray (0, 0);
-              double rxPhaseDiff = 2 * M_PI * (sin (uAngle.GetInclination ()) * cos (uAngle.GetAzimuth ()) * uLoc.x
-                                               + sin (uAngle.GetInclination ()) * sin (uAngle.GetAzimuth ()) * uLoc.y
-                                               + cos (uAngle.GetInclination ()) * uLoc.z);
-              double txPhaseDiff = 2 * M_PI * (sin (sAngle.GetInclination ()) * cos (sAngle.GetAzimuth ()) * sLoc.x
-                                               + sin (sAngle.GetInclination ()) * sin (sAngle.GetAzimuth ()) * sLoc.y
-                                               + cos (sAngle.GetInclination ()) * sLoc.z);
-
-              double rxFieldPatternPhi, rxFieldPatternTheta, txFieldPatternPhi, txFieldPatternTheta;
-              std::tie (rxFieldPatternPhi, rxFieldPatternTheta) = uAntenna->GetElementFieldPattern (Angles (uAngle.GetAzimuth (), uAngle.GetInclination ()));
-              std::tie (txFieldPatternPhi, txFieldPatternTheta) = sAntenna->GetElementFieldPattern (Angles (sAngle.GetAzimuth (), sAngle.GetInclination ()));
-
-              double lambda = 3e8 / m_frequency; // the wavelength of the carrier frequency
-
-              ray = (rxFieldPatternTheta * txFieldPatternTheta - rxFieldPatternPhi * txFieldPatternPhi)
-                * std::complex<double> (cos (-2 * M_PI * distance3D / lambda), sin (-2 * M_PI * distance3D / lambda))
-                * std::complex<double> (cos (rxPhaseDiff), sin (rxPhaseDiff))
-                * std::complex<double> (cos (txPhaseDiff), sin (txPhaseDiff));
-
-              double kLinear = pow (10, channelParams->m_K_factor / 10);
-              // the LOS path should be attenuated if blockage is enabled.
-              hUsn[uIndex][sIndex][0] = sqrt (1 / (kLinear + 1)) * hUsn[uIndex][sIndex][0] + sqrt (kLinear / (1 + kLinear)) * ray / pow (10, channelParams->m_attenuation_dB[0] / 10);           //(7.5-30) for tau = tau1
-              double tempSize = hUsn[uIndex][sIndex].size ();
-              for (uint8_t nIndex = 1; nIndex < tempSize; nIndex++)
+              for (uint64_t sIndex = 0; sIndex < sSize; sIndex++)
                 {
-                  hUsn[uIndex][sIndex][nIndex] *= sqrt (1 / (kLinear + 1)); //(7.5-30) for tau = tau2...taunN
+                  uint64_t i = (subCluster * uSize + uIndex) * sSize + sIndex;
+                  page[sIndex * uSize + uIndex] = std::complex<double> (hRe[i] * scale, hIm[i] * scale);
                 }
             }
         }
     }
 
+  if (channelParams->m_losCondition == ChannelCondition::LOS) //(7.5-29) && (7.5-30)
+    {
+      double rxFieldPatternPhi, rxFieldPatternTheta, txFieldPatternPhi, txFieldPatternTheta;
+      std::tie (rxFieldPatternPhi, rxFieldPatternTheta) = uAntenna->GetElementFieldPattern (Angles (uAngle.GetAzimuth (), uAngle.GetInclination ()));
+      std::tie (txFieldPatternPhi, txFieldPatternTheta) = sAntenna->GetElementFieldPattern (Angles (sAngle.GetAzimuth (), sAngle.GetInclination ()));
+
+      double lambda = 3e8 / m_frequency; // the wavelength of the carrier frequency
+
+      std::complex<double> ray = (rxFieldPatternTheta * txFieldPatternTheta - rxFieldPatternPhi * txFieldPatternPhi)
+        * std::complex<double> (cos (-2 * M_PI * distance3D / lambda), sin (-2 * M_PI * distance3D / lambda));
+
+      std::vector<std::complex<double> > rxRay (uSize);
+      for (uint64_t uIndex = 0; uIndex < uSize; uIndex++)
+        {
+          double rxPhaseDiff = 2 * M_PI * (sin (uAngle.GetInclination ()) * cos (uAngle.GetAzimuth ()) * uLoc[uIndex].x
+                                           + sin (uAngle.GetInclination ()) * sin (uAngle.GetAzimuth ()) * uLoc[uIndex].y
+                                           + cos (uAngle.GetInclination ()) * uLoc[uIndex].z);
+          rxRay[uIndex] = ray * std::complex<double> (cos (rxPhaseDiff), sin (rxPhaseDiff));
+        }
+      std::vector<std::complex<double> > txRay (sSize);
+      for (uint64_t sIndex = 0; sIndex < sSize; sIndex++)
+        {
+          double txPhaseDiff = 2 * M_PI * (sin (sAngle.GetInclination ()) * cos (sAngle.GetAzimuth ()) * sLoc[sIndex].x
+                                           + sin (sAngle.GetInclination ()) * sin (sAngle.GetAzimuth ()) * sLoc[sIndex].y
+                                           + cos (sAngle.GetInclination ()) * sLoc[sIndex].z);
+          txRay[sIndex] = std::complex<double> (cos (txPhaseDiff), sin (txPhaseDiff));
+        }
+
+      double kLinear = pow (10, channelParams->m_K_factor / 10);
+      double nlosFactor = sqrt (1 / (kLinear + 1));
+      double losFactor = sqrt (kLinear / (1 + kLinear));
+      // the LOS path should be attenuated if blockage is enabled.
+      double blockage = pow (10, channelParams->m_attenuation_dB[0] / 10);
+      for (uint64_t sIndex = 0; sIndex < sSize; sIndex++)
+        {
+          for (uint64_t uIndex = 0; uIndex < uSize; uIndex++)
+            {
+              hUsn (uIndex, sIndex, 0) = nlosFactor * hUsn (uIndex, sIndex, 0) + losFactor * (rxRay[uIndex] * txRay[sIndex]) / blockage; //(7.5-30) for tau = tau1
+            }
+        }
+      for (size_t nIndex = 1; nIndex < hUsn.GetNumPages (); nIndex++)
+        {
+          std::complex<double> *page = hUsn.GetPagePointer (nIndex);
+          for (uint64_t i = 0; i < uSize * sSize; i++)
+            {
+              page[i] *= nlosFactor; //(7.5-30) for tau = tau2...taunN
+            }
+        }
+    }
+
   NS_LOG_DEBUG ("Husn (sAntenna, uAntenna):" << sAntenna->GetId () << ", " << uAntenna->GetId ());
-  for (auto& i:hUsn)
+  for (uint64_t uIndex = 0; uIndex < uSize; uIndex++)
     {
-      for (auto& j:i)
+      for (uint64_t sIndex = 0; sIndex < sSize; sIndex++)
         {
-          for (auto& k:j)
+          for (size_t nIndex = 0; nIndex < hUsn.GetNumPages (); nIndex++)
             {
-              NS_LOG_DEBUG (" " << k << ",");
+              NS_LOG_DEBUG (" " << hUsn (uIndex, sIndex, nIndex) << ",");
             }
         }
     }
-  NS_LOG_INFO ("size of coefficient matrix =[" << hUsn.size () << "][" << hUsn[0].size () << "][" << hUsn[0][0].size () << "]");
-  channelMatrix->m_channel = hUsn;
+  NS_LOG_INFO ("size of coefficient matrix =[" << hUsn.GetNumRows () << "][" << hUsn.GetNumCols () << "][" << hUsn.GetNumPages () << "]");
+  channelMatrix->m_channel = std::move (hUsn);
   return channelMatrix;
 }
 
@@ -105,7 +105,7 @@ ThreeGppSpectrumPropagationLossModel::GetChannelModelAttribute (const std::strin
 }
 
 PhasedArrayModel::ComplexVector
-ThreeGppSpectrumPropagationLossModel::CalcLongTerm (Ptr<const MatrixBasedChannelModel::ChannelMatrix> params,
+ThreeGppSpectrumPropagationLossModel::CalcLongTerm (const MatrixBasedChannelModel::ChannelMatrix &params,
                                                     const PhasedArrayModel::ComplexVector &sW,
                                                     const PhasedArrayModel::ComplexVector &uW) const
 {
@@ -114,27 +114,26 @@ ThreeGppSpectrumPropagationLossModel::CalcLongTerm (Ptr<const MatrixBasedChannel
   uint16_t sAntenna = static_cast<uint16_t> (sW.size ());
   uint16_t uAntenna = static_cast<uint16_t> (uW.size ());
 
-  NS_ASSERT (uAntenna == params->m_channel.size ());
-  NS_ASSERT (sAntenna == params->m_channel.at (0).size());
+  NS_ASSERT (uAntenna == params.m_channel.GetNumRows ());
+  NS_ASSERT (sAntenna == params.m_channel.GetNumCols ());
 
   NS_LOG_DEBUG ("CalcLongTerm with sAntenna " << sAntenna << " uAntenna " << uAntenna);
   //store the long term part to reduce computation load
   //only the small scale fading needs to be updated if the large scale parameters and antenna weights remain unchanged.
   PhasedArrayModel::ComplexVector longTerm;
-  uint8_t numCluster = static_cast<uint8_t> (params->m_channel[0][0].size ());
-
-  NS_ASSERT (uAntenna == params->m_channel.size ());
-  NS_ASSERT (sAntenna == params->m_channel.at (0).size());
+  uint8_t numCluster = static_cast<uint8_t> (params.m_channel.GetNumPages ());
 
   for (uint8_t cIndex = 0; cIndex < numCluster; cIndex++)
     {
+      // the elements of a column of a page are contiguous
+      const std::complex<double> *page = params.m_channel.GetPagePointer (cIndex);
       std::complex<double> txSum (0, 0);
       for (uint16_t sIndex = 0; sIndex < sAntenna; sIndex++)
         {
           std::complex<double> rxSum (0, 0);
           for (uint16_t uIndex = 0; uIndex < uAntenna; uIndex++)
             {
-              rxSum = rxSum + uW[uIndex] * params->m_channel[uIndex][sIndex][cIndex];
+              rxSum = rxSum + uW[uIndex] * page[sIndex * uAntenna + uIndex];
             }
           txSum = txSum + sW[sIndex] * rxSum;
         }
@@ -143,25 +142,34 @@ ThreeGppSpectrumPropagationLossModel::CalcLongTerm (Ptr<const MatrixBasedChannel
   return longTerm;
 }
 
-Ptr<SpectrumValue>
-ThreeGppSpectrumPropagationLossModel::CalcBeamformingGain (Ptr<SpectrumValue> txPsd,
-                                                           PhasedArrayModel::ComplexVector longTerm,
-                                                           Ptr<const MatrixBasedChannelModel::ChannelMatrix> channelMatrix,
-                                                           Ptr<const MatrixBasedChannelModel::ChannelParams> channelParams,
-                                                           const ns3::Vector &sSpeed, const ns3::Vector &uSpeed) const
+void
+ThreeGppSpectrumPropagationLossModel::CalcBeamformingGain (const BeamformingGain &gain) const
 {
   NS_LOG_FUNCTION (this);
 
-  Ptr<SpectrumValue> tempPsd = Copy<SpectrumValue> (txPsd);
+  // the references avoid copying the pointers, whose reference counts are
+  // not atomic, since this method may run in several threads
+  LongTerm &longTermItem = *gain.m_longTerm;
+  const MatrixBasedChannelModel::ChannelMatrix &channelMatrix = *gain.m_channelMatrix;
+  const MatrixBasedChannelModel::ChannelParams &channelParams = *gain.m_channelParams;
+  const Vector &sSpeed = gain.m_sSpeed;
+  const Vector &uSpeed = gain.m_uSpeed;
+  SpectrumValue &psd = *gain.m_psd;
+
+  if (longTermItem.m_longTerm.empty ())
+    {
+      NS_LOG_DEBUG ("compute the long term");
+      longTermItem.m_longTerm = CalcLongTerm (channelMatrix, longTermItem.m_sW, longTermItem.m_uW);
+    }
+  const PhasedArrayModel::ComplexVector &longTerm = longTermItem.m_longTerm;
 
   //channel[rx][tx][cluster]
-  uint8_t numCluster = static_cast<uint8_t> (channelMatrix->m_channel[0][0].size ());
+  uint8_t numCluster = static_cast<uint8_t> (channelMatrix.m_channel.GetNumPages ());
 
   // compute the doppler term
   // NOTE the update of Doppler is simplified by only taking the center angle of
   // each cluster in to consideration.
-  double slotTime = Simulator::Now ().GetSeconds ();
-  double factor = 2 * M_PI * slotTime * GetFrequency () / 3e8;
+  double factor = 2 * M_PI * gain.m_slotTime * gain.m_frequency / 3e8;
   PhasedArrayModel::ComplexVector doppler;
 
   // The following asserts might seem paranoic, but it is important to
@@ -169,16 +177,16 @@ ThreeGppSpectrumPropagationLossModel::CalcBeamformingGain (Ptr<SpectrumValue> tx
   // are of the correct dimensions before using the operator [].
   // If you dont understand the comment read about the difference of .at()
   // and [] operators, ...
-  NS_ASSERT (numCluster <= channelParams->m_alpha.size ());
-  NS_ASSERT (numCluster <= channelParams->m_D.size());
-  NS_ASSERT (numCluster <= channelParams->m_angle[MatrixBasedChannelModel::ZOA_INDEX].size());
-  NS_ASSERT (numCluster <= channelParams->m_angle[MatrixBasedChannelModel::ZOD_INDEX].size());
-  NS_ASSERT (numCluster <= channelParams->m_angle[MatrixBasedChannelModel::AOA_INDEX].size());
-  NS_ASSERT (numCluster <= channelParams->m_angle[MatrixBasedChannelModel::AOD_INDEX].size());
+  NS_ASSERT (numCluster <= channelParams.m_alpha.size ());
+  NS_ASSERT (numCluster <= channelParams.m_D.size());
+  NS_ASSERT (numCluster <= channelParams.m_angle[MatrixBasedChannelModel::ZOA_INDEX].size());
+  NS_ASSERT (numCluster <= channelParams.m_angle[MatrixBasedChannelModel::ZOD_INDEX].size());
+  NS_ASSERT (numCluster <= channelParams.m_angle[MatrixBasedChannelModel::AOA_INDEX].size());
+  NS_ASSERT (numCluster <= channelParams.m_angle[MatrixBasedChannelModel::AOD_INDEX].size());
   NS_ASSERT (numCluster <= longTerm.size());
 
   // check if channelParams structure is generated in direction s-to-u or u-to-s
-  bool isSameDirection = (channelParams->m_nodeIds == channelMatrix->m_nodeIds);
+  bool isSameDirection = (channelParams.m_nodeIds == channelMatrix.m_nodeIds);
 
   MatrixBasedChannelModel::DoubleVector zoa;
   MatrixBasedChannelModel::DoubleVector zod;
@@ -191,17 +199,17 @@ ThreeGppSpectrumPropagationLossModel::CalcBeamformingGain (Ptr<SpectrumValue> tx
   // of channel matrix, otherwise we need to flip angles and zenits of departure and arrival
   if (isSameDirection)
     {
-      zoa = channelParams->m_angle[MatrixBasedChannelModel::ZOA_INDEX];
-      zod = channelParams->m_angle[MatrixBasedChannelModel::ZOD_INDEX];
-      aoa = channelParams->m_angle[MatrixBasedChannelModel::AOA_INDEX];
-      aod = channelParams->m_angle[MatrixBasedChannelModel::AOD_INDEX];
+      zoa = channelParams.m_angle[MatrixBasedChannelModel::ZOA_INDEX];
+      zod = channelParams.m_angle[MatrixBasedChannelModel::ZOD_INDEX];
+      aoa = channelParams.m_angle[MatrixBasedChannelModel::AOA_INDEX];
+      aod = channelParams.m_angle[MatrixBasedChannelModel::AOD_INDEX];
     }
   else
     {
-      zod = channelParams->m_angle[MatrixBasedChannelModel::ZOA_INDEX];
-      zoa = channelParams->m_angle[MatrixBasedChannelModel::ZOD_INDEX];
-      aod = channelParams->m_angle[MatrixBasedChannelModel::AOA_INDEX];
-      aoa = channelParams->m_angle[MatrixBasedChannelModel::AOD_INDEX];
+      zod = channelParams.m_angle[MatrixBasedChannelModel::ZOA_INDEX];
+      zoa = channelParams.m_angle[MatrixBasedChannelModel::ZOD_INDEX];
+      aod = channelParams.m_angle[MatrixBasedChannelModel::AOA_INDEX];
+      aoa = channelParams.m_angle[MatrixBasedChannelModel::AOD_INDEX];
     }
 
   for (uint8_t cIndex = 0; cIndex < numCluster; cIndex++)
@@ -217,8 +225,8 @@ ThreeGppSpectrumPropagationLossModel::CalcBeamformingGain (Ptr<SpectrumValue> tx
       // By default, m_vScatt is set to 0, so there is no additional Doppler
       // contribution.
 
-      double alpha = channelParams->m_alpha [cIndex];
-      double D = channelParams->m_D [cIndex];
+      double alpha = channelParams.m_alpha [cIndex];
+      double D = channelParams.m_D [cIndex];
 
       //cluster angle angle[direction][n], where direction = 0(aoa), 1(zoa).
       double tempDoppler = factor * ((sin (zoa [cIndex] * M_PI / 180) * cos (aoa [cIndex] * M_PI / 180) * uSpeed.x
@@ -234,9 +242,9 @@ ThreeGppSpectrumPropagationLossModel::CalcBeamformingGain (Ptr<SpectrumValue> tx
 
   // apply the doppler term and the propagation delay to the long term component
   // to obtain the beamforming gain
-  auto vit = tempPsd->ValuesBegin (); // psd iterator
-  auto sbit = tempPsd->ConstBandsBegin (); // band iterator
-  while (vit != tempPsd->ValuesEnd ())
+  auto vit = psd.ValuesBegin (); // psd iterator
+  auto sbit = psd.ConstBandsBegin (); // band iterator
+  while (vit != psd.ValuesEnd ())
     {
       if ((*vit) != 0.00)
         {
@@ -244,7 +252,7 @@ ThreeGppSpectrumPropagationLossModel::CalcBeamformingGain (Ptr<SpectrumValue> tx
           double fsb = (*sbit).fc; // center frequency of the sub-band
           for (uint8_t cIndex = 0; cIndex < numCluster; cIndex++)
             {
-              double delay = -2 * M_PI * fsb * (channelParams->m_delay[cIndex]);
+              double delay = -2 * M_PI * fsb * (channelParams.m_delay[cIndex]);
               subsbandGain = subsbandGain + longTerm[cIndex] * doppler[cIndex] * std::complex<double> (cos (delay), sin (delay));
             }
           *vit = (*vit) * (norm (subsbandGain));
@@ -252,16 +260,13 @@ ThreeGppSpectrumPropagationLossModel::CalcBeamformingGain (Ptr<SpectrumValue> tx
       vit++;
       sbit++;
     }
-  return tempPsd;
 }
 
-PhasedArrayModel::ComplexVector
+Ptr<ThreeGppSpectrumPropagationLossModel::LongTerm>
 ThreeGppSpectrumPropagationLossModel::GetLongTerm (Ptr<const MatrixBasedChannelModel::ChannelMatrix> channelMatrix,
                                                    Ptr<const PhasedArrayModel> aPhasedArrayModel,
                                                    Ptr<const PhasedArrayModel> bPhasedArrayModel) const
 {
-  PhasedArrayModel::ComplexVector longTerm; // vector containing the long term component for each cluster
-
   // check if the channel matrix was generated considering a as the s-node and
   // b as the u-node or viceversa
   PhasedArrayModel::ComplexVector sW, uW;
@@ -276,57 +281,59 @@ ThreeGppSpectrumPropagationLossModel::GetLongTerm (Ptr<const MatrixBasedChannelM
     uW = aPhasedArrayModel->GetBeamformingVector ();
   }
 
-  bool update = false; // indicates whether the long term has to be updated
-  bool notFound = false; // indicates if the long term has not been computed yet
-
   // compute the long term key, the key is unique for each tx-rx pair
   uint64_t longTermId = MatrixBasedChannelModel::GetKey (aPhasedArrayModel->GetId (), bPhasedArrayModel->GetId ());
 
   // look for the long term in the map and check if it is valid
-  if (m_longTermMap.find (longTermId) != m_longTermMap.end ())
+  auto it = m_longTermMap.find (longTermId);
+  if (it != m_longTermMap.end ())
     {
       NS_LOG_DEBUG ("found the long term component in the map");
-      longTerm = m_longTermMap[longTermId]->m_longTerm;
 
       // check if the channel matrix has been updated
       // or the s beam has been changed
       // or the u beam has been changed
-      update = (m_longTermMap[longTermId]->m_channel->m_generatedTime != channelMatrix->m_generatedTime
-                || m_longTermMap[longTermId]->m_sW != sW
-                || m_longTermMap[longTermId]->m_uW != uW);
-
+      const LongTerm &item = *it->second;
+      if (item.m_channel->m_generatedTime == channelMatrix->m_generatedTime
+          && item.m_sW == sW
+          && item.m_uW == uW)
+        {
+          if (!item.m_longTerm.empty ())
+            {
+              return it->second;
+            }
+          // the long term is being computed for another receiver of the
+          // same transmission, possibly in another thread: compute it again
+          // in a private item, rather than share the pending one
+          NS_LOG_DEBUG ("long term component pending");
+          Ptr<LongTerm> longTermItem = Create<LongTerm> ();
+          longTermItem->m_channel = channelMatrix;
+          longTermItem->m_sW = sW;
+          longTermItem->m_uW = uW;
+          return longTermItem;
+        }
     }
   else
     {
       NS_LOG_DEBUG ("long term component NOT found");
-      notFound = true;
     }
 
-  if (update || notFound)
-    {
-      NS_LOG_DEBUG ("compute the long term");
-      // compute the long term component
-      longTerm = CalcLongTerm (channelMatrix, sW, uW);
+  // store the long term, which is computed with the beamforming gain
+  Ptr<LongTerm> longTermItem = Create<LongTerm> ();
+  longTermItem->m_channel = channelMatrix;
+  longTermItem->m_sW = sW;
+  longTermItem->m_uW = uW;
 
-      // store the long term
-      Ptr<LongTerm> longTermItem = Create<LongTerm> ();
-      longTermItem->m_longTerm = longTerm;
-      longTermItem->m_channel = channelMatrix;
-      longTermItem->m_sW = sW;
-      longTermItem->m_uW = uW;
-
-      m_longTermMap[longTermId] = longTermItem;
-    }
-
-  return longTerm;
+  m_longTermMap[longTermId] = longTermItem;
+  return longTermItem;
 }
 
-Ptr<SpectrumValue>
-ThreeGppSpectrumPropagationLossModel::DoCalcRxPowerSpectralDensity (Ptr<const SpectrumValue> txPsd,
-                                                                    Ptr<const MobilityModel> a,
-                                                                    Ptr<const MobilityModel> b,
-                                                                    Ptr<const PhasedArrayModel> aPhasedArrayModel,
-                                                                    Ptr<const PhasedArrayModel> bPhasedArrayModel) const
+Ptr<ThreeGppSpectrumPropagationLossModel::BeamformingGain>
+ThreeGppSpectrumPropagationLossModel::PrepareBeamformingGain (Ptr<SpectrumValue> rxPsd,
+                                                              Ptr<const MobilityModel> a,
+                                                              Ptr<const MobilityModel> b,
+                                                              Ptr<const PhasedArrayModel> aPhasedArrayModel,
+                                                              Ptr<const PhasedArrayModel> bPhasedArrayModel) const
 {
   NS_LOG_FUNCTION (this);
   uint32_t aId = a->GetObject<Node> ()->GetId (); // id of the node a
@@ -335,8 +342,6 @@ ThreeGppSpectrumPropagationLossModel::DoCalcRxPowerSpectralDensity (Ptr<const Sp
   NS_ASSERT (aId != bId);
   NS_ASSERT_MSG (a->GetDistanceFrom (b) > 0.0, "The position of a and b devices cannot be the same");
 
-  Ptr<SpectrumValue> rxPsd = Copy<SpectrumValue> (txPsd);
-
   // retrieve the antenna of device a
   NS_ASSERT_MSG (aPhasedArrayModel, "Antenna not found for node " << aId);
   NS_LOG_DEBUG ("a node " << a->GetObject<Node> () << " antenna " << aPhasedArrayModel);
@@ -345,14 +350,48 @@ ThreeGppSpectrumPropagationLossModel::DoCalcRxPowerSpectralDensity (Ptr<const Sp
   NS_ASSERT_MSG (bPhasedArrayModel, "Antenna not found for device " << bId);
   NS_LOG_DEBUG ("b node " << bId << " antenna " << bPhasedArrayModel);
 
-  Ptr<const MatrixBasedChannelModel::ChannelMatrix> channelMatrix = m_channelModel->GetChannel (a, b, aPhasedArrayModel, bPhasedArrayModel);
-  Ptr<const MatrixBasedChannelModel::ChannelParams> channelParams = m_channelModel->GetParams (a, b);
+  Ptr<BeamformingGain> gain = Create<BeamformingGain> ();
+  gain->m_channelMatrix = m_channelModel->GetChannel (a, b, aPhasedArrayModel, bPhasedArrayModel);
+  gain->m_channelParams = m_channelModel->GetParams (a, b);
 
   // retrieve the long term component
-  PhasedArrayModel::ComplexVector longTerm = GetLongTerm (channelMatrix, aPhasedArrayModel, bPhasedArrayModel);
+  gain->m_longTerm = GetLongTerm (gain->m_channelMatrix, aPhasedArrayModel, bPhasedArrayModel);
+
+  gain->m_psd = rxPsd;
+  // stop sharing the values of the PSD here, before they are modified
+  rxPsd->ValuesBegin ();
+  gain->m_sSpeed = a->GetVelocity ();
+  gain->m_uSpeed = b->GetVelocity ();
+  gain->m_slotTime = Simulator::Now ().GetSeconds ();
+  gain->m_frequency = GetFrequency ();
+  return gain;
+}
+
+std::function<void ()>
+ThreeGppSpectrumPropagationLossModel::DoPrepareRxPowerSpectralDensity (Ptr<SpectrumValue> rxPsd,
+                                                                       Ptr<const MobilityModel> a,
+                                                                       Ptr<const MobilityModel> b,
+                                                                       Ptr<const PhasedArrayModel> aPhasedArrayModel,
+                                                                       Ptr<const PhasedArrayModel> bPhasedArrayModel) const
+{
+  NS_LOG_FUNCTION (this);
+  Ptr<BeamformingGain> gain = PrepareBeamformingGain (rxPsd, a, b, aPhasedArrayModel, bPhasedArrayModel);
+  return [this, gain] () { CalcBeamformingGain (*gain); };
+}
+
+Ptr<SpectrumValue>
+ThreeGppSpectrumPropagationLossModel::DoCalcRxPowerSpectralDensity (Ptr<const SpectrumValue> txPsd,
+                                                                    Ptr<const MobilityModel> a,
+                                                                    Ptr<const MobilityModel> b,
+                                                                    Ptr<const PhasedArrayModel> aPhasedArrayModel,
+                                                                    Ptr<const PhasedArrayModel> bPhasedArrayModel) const
+{
+  NS_LOG_FUNCTION (this);
+  Ptr<SpectrumValue> rxPsd = Copy<SpectrumValue> (txPsd);
 
   // apply the beamforming gain
-  rxPsd = CalcBeamformingGain (rxPsd, longTerm, channelMatrix, channelParams, a->GetVelocity (), b->GetVelocity ());
+  Ptr<BeamformingGain> gain = PrepareBeamformingGain (rxPsd, a, b, aPhasedArrayModel, bPhasedArrayModel);
+  CalcBeamformingGain (*gain);
 
   return rxPsd;
 }
@@ -129,12 +129,50 @@ private:
    */
   struct LongTerm : public SimpleRefCount<LongTerm>
   {
-    PhasedArrayModel::ComplexVector m_longTerm; //!< vector containing the long term component for each cluster
+    PhasedArrayModel::ComplexVector m_longTerm; //!< vector containing the long term component for each cluster, or empty if not computed yet
     Ptr<const MatrixBasedChannelModel::ChannelMatrix> m_channel; //!< pointer to the channel matrix used to compute the long term
     PhasedArrayModel::ComplexVector m_sW; //!< the beamforming vector for the node s used to compute the long term
     PhasedArrayModel::ComplexVector m_uW; //!< the beamforming vector for the node u used to compute the long term
   };
 
+  /**
+   * Data structure that stores the inputs of the computation of the
+   * beamforming gain of a received PSD
+   */
+  struct BeamformingGain : public SimpleRefCount<BeamformingGain>
+  {
+    Ptr<SpectrumValue> m_psd; //!< the PSD to which the gain is applied
+    Ptr<LongTerm> m_longTerm; //!< the long term component, computed with the gain if needed
+    Ptr<const MatrixBasedChannelModel::ChannelMatrix> m_channelMatrix; //!< the channel matrix
+    Ptr<const MatrixBasedChannelModel::ChannelParams> m_channelParams; //!< the channel params
+    Vector m_sSpeed; //!< speed of the first node
+    Vector m_uSpeed; //!< speed of the second node
+    double m_slotTime; //!< the time of the computation, in seconds
+    double m_frequency; //!< the operating frequency in Hz
+  };
+
+  /**
+   * Prepares the computation of the received PSD.
+   *
+   * \param rxPsd the PSD to which the beamforming gain is applied
+   * \param a first node mobility model
+   * \param b second node mobility model
+   * \param aPhasedArrayModel the antenna array of the first node
+   * \param bPhasedArrayModel the antenna array of the second node
+   * \return the inputs of CalcBeamformingGain
+   */
+  Ptr<BeamformingGain> PrepareBeamformingGain (Ptr<SpectrumValue> rxPsd,
+                                               Ptr<const MobilityModel> a,
+                                               Ptr<const MobilityModel> b,
+                                               Ptr<const PhasedArrayModel> aPhasedArrayModel,
+                                               Ptr<const PhasedArrayModel> bPhasedArrayModel) const;
+
+  std::function<void ()> DoPrepareRxPowerSpectralDensity (Ptr<SpectrumValue> rxPsd,
+                                                          Ptr<const MobilityModel> a,
+                                                          Ptr<const MobilityModel> b,
+                                                          Ptr<const PhasedArrayModel> aPhasedArrayModel,
+                                                          Ptr<const PhasedArrayModel> bPhasedArrayModel) const override;
+
   /**
    * Get the operating frequency
    * \return the operating frequency in Hz
@@ -144,15 +182,16 @@ private:
   /**
    * Looks for the long term component in m_longTermMap. If found, checks
    * whether it has to be updated. If not found or if it has to be updated,
-   * calls the method CalcLongTerm to compute it.
+   * returns a new item, stored in the map, whose long term component is
+   * computed by CalcBeamformingGain.
    * \param channelMatrix the channel matrix
    * \param aPhasedArrayModel the antenna array of the tx device
    * \param bPhasedArrayModel the antenna array of the rx device
-   * \return vector containing the long term component for each cluster
+   * \return the long term component
    */
-  PhasedArrayModel::ComplexVector GetLongTerm (Ptr<const MatrixBasedChannelModel::ChannelMatrix> channelMatrix,
-                                               Ptr<const PhasedArrayModel> aPhasedArrayModel,
-                                               Ptr<const PhasedArrayModel> bPhasedArrayModel) const;
+  Ptr<LongTerm> GetLongTerm (Ptr<const MatrixBasedChannelModel::ChannelMatrix> channelMatrix,
+                             Ptr<const PhasedArrayModel> aPhasedArrayModel,
+                             Ptr<const PhasedArrayModel> bPhasedArrayModel) const;
   /**
    * Computes the long term component
    * \param channelMatrix the channel matrix H
@@ -160,27 +199,23 @@ private:
    * \param uW the beamforming vector of the u device
    * \return the long term component
    */
-  PhasedArrayModel::ComplexVector CalcLongTerm (Ptr<const MatrixBasedChannelModel::ChannelMatrix> channelMatrix,
+  PhasedArrayModel::ComplexVector CalcLongTerm (const MatrixBasedChannelModel::ChannelMatrix &channelMatrix,
                                                 const PhasedArrayModel::ComplexVector &sW,
                                                 const PhasedArrayModel::ComplexVector &uW) const;
 
   /**
-   * Computes the beamforming gain and applies it to the tx PSD
-   * \param txPsd the tx PSD
-   * \param longTerm the long term component
-   * \param channelMatrix The channel matrix structure
-   * \param channelParams The channel params structure
-   * \param sSpeed speed of the first node
-   * \param uSpeed speed of the second node
-   * \return the rx PSD
+   * Computes the beamforming gain and applies it to the PSD, in place.
+   *
+   * This method only modifies the PSD and the long term component of
+   * \p gain, and does not copy nor release any Ptr: it can run
+   * in any thread, concurrently with the computations of the other
+   * PSDs prepared by PrepareBeamformingGain.
+   *
+   * \param gain the inputs of the computation
    */
-  Ptr<SpectrumValue> CalcBeamformingGain (Ptr<SpectrumValue> txPsd,
-                                          PhasedArrayModel::ComplexVector longTerm,
-                                          Ptr<const MatrixBasedChannelModel::ChannelMatrix> channelMatrix,
-                                          Ptr<const MatrixBasedChannelModel::ChannelParams> channelParams,
-                                          const Vector &sSpeed, const Vector &uSpeed) const;
+  void CalcBeamformingGain (const BeamformingGain &gain) const;
 
-  mutable std::unordered_map < uint64_t, Ptr<const LongTerm> > m_longTermMap; //!< map containing the long term components
+  mutable std::unordered_map < uint64_t, Ptr<LongTerm> > m_longTermMap; //!< map containing the long term components
   Ptr<MatrixBasedChannelModel> m_channelModel; //!< the model to generate the channel matrix
 };
 } // namespace ns3
@@ -0,0 +1,271 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/test.h>
+#include <ns3/log.h>
+#include <ns3/simulator.h>
+#include <ns3/double.h>
+#include <ns3/constant-position-mobility-model.h>
+#include <ns3/constant-velocity-mobility-model.h>
+#include <ns3/isotropic-antenna-model.h>
+#include <ns3/parabolic-antenna-model.h>
+#include <ns3/propagation-loss-model.h>
+#include <ns3/random-variable-stream.h>
+#include <ns3/single-model-spectrum-channel.h>
+#include <ns3/multi-model-spectrum-channel.h>
+#include <ns3/net-device.h>
+#include <ns3/spectrum-phy.h>
+#include <ns3/spectrum-value.h>
+
+#include <tuple>
+#include <vector>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("SpectrumChannelSpatialIndexTest");
+
+/**
+ * \ingroup spectrum-tests
+ *
+ * \brief SpectrumPhy recording the signals it receives.
+ */
+class SpatialIndexTestPhy : public SpectrumPhy
+{
+public:
+  /// A received signal: time (ns), receiver, transmitter, power.
+  typedef std::tuple<int64_t, uint32_t, uint32_t, double> Record;
+
+  /**
+   * Constructor.
+   *
+   * \param id the identifier of the PHY
+   * \param rxModel the spectrum model of the receiver
+   * \param records the list of the signals received by all the PHYs
+   */
+  SpatialIndexTestPhy (uint32_t id, Ptr<const SpectrumModel> rxModel, std::vector<Record> *records)
+    : m_id (id),
+      m_rxModel (rxModel),
+      m_records (records)
+  {}
+
+  void SetDevice (Ptr<NetDevice> d) override
+  {}
+  Ptr<NetDevice> GetDevice () const override
+  {
+    return 0;
+  }
+  void SetMobility (Ptr<MobilityModel> m) override
+  {
+    m_mobility = m;
+  }
+  Ptr<MobilityModel> GetMobility () const override
+  {
+    return m_mobility;
+  }
+  void SetChannel (Ptr<SpectrumChannel> c) override
+  {}
+  Ptr<const SpectrumModel> GetRxSpectrumModel () const override
+  {
+    return m_rxModel;
+  }
+  Ptr<Object> GetAntenna () const override
+  {
+    return m_antenna;
+  }
+  void StartRx (Ptr<SpectrumSignalParameters> params) override
+  {
+    uint32_t txId = DynamicCast<SpatialIndexTestPhy> (params->txPhy)->m_id;
+    m_records->push_back (Record (Simulator::Now ().GetNanoSeconds (), m_id, txId, Sum (*params->psd)));
+  }
+
+  uint32_t m_id;                       //!< Identifier of the PHY.
+  Ptr<const SpectrumModel> m_rxModel;  //!< Spectrum model of the receiver.
+  std::vector<Record> *m_records;      //!< Signals received by all the PHYs.
+  Ptr<MobilityModel> m_mobility;       //!< Mobility model.
+  Ptr<AntennaModel> m_antenna;         //!< Antenna.
+};
+
+/**
+ * \ingroup spectrum-tests
+ *
+ * \brief Check that the spatial index of the receivers of a SpectrumChannel
+ * does not change the signals received, and that it skips receivers.
+ */
+class SpectrumChannelSpatialIndexTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor.
+   *
+   * \param channelType the TypeId name of the channel
+   */
+  SpectrumChannelSpatialIndexTestCase (std::string channelType);
+
+private:
+  void DoRun (void) override;
+
+  /**
+   * Run a scenario.
+   *
+   * \param cellSize the size of the cells of the index, or 0
+   * \param records the signals received
+   * \return the number of path losses computed
+   */
+  uint32_t RunScenario (double cellSize, std::vector<SpatialIndexTestPhy::Record> &records);
+
+  /**
+   * Count a path loss computation.
+   *
+   * \param txPhy the transmitter
+   * \param rxPhy the receiver
+   * \param lossDb the loss
+   */
+  void PathLoss (Ptr<const SpectrumPhy> txPhy, Ptr<const SpectrumPhy> rxPhy, double lossDb);
+
+  std::string m_channelType; //!< TypeId name of the channel.
+  uint32_t m_pathLosses;     //!< Number of path losses computed.
+};
+
+SpectrumChannelSpatialIndexTestCase::SpectrumChannelSpatialIndexTestCase (std::string channelType)
+  : TestCase ("Check the spatial index of the receivers of a " + channelType),
+    m_channelType (channelType),
+    m_pathLosses (0)
+{}
+
+void
+SpectrumChannelSpatialIndexTestCase::PathLoss (Ptr<const SpectrumPhy> txPhy, Ptr<const SpectrumPhy> rxPhy,
+                                               double lossDb)
+{
+  ++m_pathLosses;
+}
+
+uint32_t
+SpectrumChannelSpatialIndexTestCase::RunScenario (double cellSize, std::vector<SpatialIndexTestPhy::Record> &records)
+{
+  m_pathLosses = 0;
+  ObjectFactory factory (m_channelType);
+  factory.Set ("MaxLossDb", DoubleValue (100));
+  factory.Set ("SpatialIndexCellSize", DoubleValue (cellSize));
+  Ptr<SpectrumChannel> channel = factory.Create<SpectrumChannel> ();
+  channel->AddPropagationLossModel (CreateObject<FriisPropagationLossModel> ());
+  channel->TraceConnectWithoutContext ("PathLoss", MakeCallback (&SpectrumChannelSpatialIndexTestCase::PathLoss, this));
+
+  Ptr<SpectrumModel> model = Create<SpectrumModel> (std::vector<double> {2.1e9, 2.11e9, 2.12e9});
+  Ptr<UniformRandomVariable> rng = CreateObject<UniformRandomVariable> ();
+  rng->SetStream (7);
+
+  std::vector<Ptr<SpatialIndexTestPhy> > phys;
+  for (uint32_t i = 0; i < 150; ++i)
+    {
+      Ptr<SpatialIndexTestPhy> phy = CreateObject<SpatialIndexTestPhy> (i, model, &records);
+      Ptr<MobilityModel> mobility;
+      if (i % 10 == 4)
+        {
+          Ptr<ConstantVelocityMobilityModel> moving = CreateObject<ConstantVelocityMobilityModel> ();
+          // setting the position stops the model
+          moving->SetPosition (Vector (rng->GetValue (0, 5000), rng->GetValue (0, 5000), 1.5));
+          moving->SetVelocity (Vector (rng->GetValue (-20, 20), rng->GetValue (-20, 20), 0));
+          mobility = moving;
+        }
+      else if (i % 25 != 9)
+        {
+          mobility = CreateObject<ConstantPositionMobilityModel> ();
+          mobility->SetPosition (Vector (rng->GetValue (0, 5000), rng->GetValue (0, 5000), 1.5));
+        }
+      phy->SetMobility (mobility);
+      if (i % 3 == 0)
+        {
+          phy->m_antenna = CreateObjectWithAttributes<IsotropicAntennaModel> ("Gain", DoubleValue (3));
+        }
+      phys.push_back (phy);
+      if (i % 5 != 1)
+        {
+          channel->AddRx (phy);
+        }
+    }
+
+  for (uint32_t t = 0; t < 40; ++t)
+    {
+      Ptr<SpatialIndexTestPhy> txPhy = phys[(t * 37) % phys.size ()];
+      Ptr<SpectrumSignalParameters> params = Create<SpectrumSignalParameters> ();
+      params->psd = Create<SpectrumValue> (model);
+      *params->psd = 1e-3;
+      params->duration = MilliSeconds (1);
+      params->txPhy = txPhy;
+      if (t % 2 == 0)
+        {
+          params->txAntenna = CreateObjectWithAttributes<ParabolicAntennaModel> ("Orientation", DoubleValue (t * 9));
+        }
+      Simulator::Schedule (Seconds (t), &SpectrumChannel::StartTx, channel, params);
+      if (t % 8 == 5)
+        {
+          // move, add and remove some receivers between the transmissions
+          Ptr<MobilityModel> mobility = phys[t]->GetMobility ();
+          if (mobility != 0)
+            {
+              Simulator::Schedule (Seconds (t + 0.5), &MobilityModel::SetPosition, mobility,
+                                   Vector (rng->GetValue (0, 5000), rng->GetValue (0, 5000), 1.5));
+            }
+          Simulator::Schedule (Seconds (t + 0.5), &SpectrumChannel::RemoveRx, channel, phys[t + 20]);
+          Simulator::Schedule (Seconds (t + 0.5), &SpectrumChannel::AddRx, channel, phys[t + 21]);
+        }
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+  channel->Dispose ();
+  return m_pathLosses;
+}
+
+void
+SpectrumChannelSpatialIndexTestCase::DoRun (void)
+{
+  std::vector<SpatialIndexTestPhy::Record> expected;
+  uint32_t allPathLosses = RunScenario (0, expected);
+  NS_TEST_ASSERT_MSG_GT (expected.size (), 0, "No signal received");
+
+  for (double cellSize : {50.0, 400.0, 3000.0})
+    {
+      std::vector<SpatialIndexTestPhy::Record> records;
+      uint32_t pathLosses = RunScenario (cellSize, records);
+      NS_TEST_ASSERT_MSG_EQ (records.size (), expected.size (), "Wrong number of signals received, cell size " << cellSize);
+      for (std::size_t i = 0; i < records.size (); ++i)
+        {
+          NS_TEST_ASSERT_MSG_EQ ((records[i] == expected[i]), true, "Signal " << i << " differs, cell size " << cellSize);
+        }
+      NS_TEST_EXPECT_MSG_LT (pathLosses, allPathLosses, "No receiver skipped, cell size " << cellSize);
+    }
+}
+
+/**
+ * \ingroup spectrum-tests
+ *
+ * \brief Test suite for the spatial index of the receivers of the spectrum channels.
+ */
+class SpectrumChannelSpatialIndexTestSuite : public TestSuite
+{
+public:
+  SpectrumChannelSpatialIndexTestSuite ();
+};
+
+SpectrumChannelSpatialIndexTestSuite::SpectrumChannelSpatialIndexTestSuite ()
+  : TestSuite ("spectrum-channel-spatial-index", UNIT)
+{
+  AddTestCase (new SpectrumChannelSpatialIndexTestCase ("ns3::SingleModelSpectrumChannel"), TestCase::QUICK);
+  AddTestCase (new SpectrumChannelSpatialIndexTestCase ("ns3::MultiModelSpectrumChannel"), TestCase::QUICK);
+}
+
+/// Static variable for test initialization
+static SpectrumChannelSpatialIndexTestSuite g_spectrumChannelSpatialIndexTestSuite;
@@ -96,6 +96,188 @@ SpectrumValueTestCase::DoRun (void)
 
 
 
+/**
+ * \ingroup spectrum-tests
+ *
+ * \brief Test the vectorized SpectrumValue operations against scalar loops
+ */
+class SpectrumValueSimdTestCase : public TestCase
+{
+public:
+  SpectrumValueSimdTestCase ();
+  virtual void DoRun (void);
+
+private:
+  /**
+   * Check the operations on SpectrumValues of a given size
+   * \param n the number of bands
+   */
+  void CheckSize (uint32_t n);
+};
+
+SpectrumValueSimdTestCase::SpectrumValueSimdTestCase ()
+  : TestCase ("Check the vectorized SpectrumValue operations")
+{
+}
+
+void
+SpectrumValueSimdTestCase::CheckSize (uint32_t n)
+{
+  Bands bands;
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      BandInfo band;
+      band.fl = 2e9 + i * 180e3;
+      band.fc = band.fl + 90e3 + i;
+      band.fh = band.fl + 180e3 + 2 * i;
+      bands.push_back (band);
+    }
+  Ptr<SpectrumModel> model = Create<SpectrumModel> (bands);
+  SpectrumValue a (model), b (model);
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      a[i] = 1e-13 * (11 + 10 * std::sin (i * 0.37));
+      b[i] = 1e-14 * (3 + 2 * std::cos (i * 1.3));
+    }
+  if (n > 0)
+    {
+      NS_TEST_EXPECT_MSG_EQ (reinterpret_cast<uintptr_t> (&(*a.ConstValuesBegin ())) % 64, 0,
+                             "Values not aligned on a cache line");
+    }
+
+  // the elementwise operations give exactly the results of scalar loops
+  SpectrumValue sum = a + b, difference = a - b, product = a * b, quotient = a / b;
+  SpectrumValue sumScalar = a + 3e-14, productScalar = a * 0.7, quotientScalar = a / 0.7;
+  SpectrumValue scaled = a;
+  scaled.AddScaled (b, 0.3);
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      NS_TEST_EXPECT_MSG_EQ (sum[i], a[i] + b[i], "Wrong sum of " << n << " bands at " << i);
+      NS_TEST_EXPECT_MSG_EQ (difference[i], a[i] - b[i], "Wrong difference of " << n << " bands at " << i);
+      NS_TEST_EXPECT_MSG_EQ (product[i], a[i] * b[i], "Wrong product of " << n << " bands at " << i);
+      NS_TEST_EXPECT_MSG_EQ (quotient[i], a[i] / b[i], "Wrong quotient of " << n << " bands at " << i);
+      NS_TEST_EXPECT_MSG_EQ (sumScalar[i], a[i] + 3e-14, "Wrong scalar sum of " << n << " bands at " << i);
+      NS_TEST_EXPECT_MSG_EQ (productScalar[i], a[i] * 0.7, "Wrong scalar product of " << n << " bands at " << i);
+      NS_TEST_EXPECT_MSG_EQ (quotientScalar[i], a[i] / 0.7, "Wrong scalar quotient of " << n << " bands at " << i);
+      double term = b[i] * 0.3;
+      NS_TEST_EXPECT_MSG_EQ (scaled[i], a[i] + term, "Wrong scaled sum of " << n << " bands at " << i);
+    }
+
+  // the reductions sum the elements in eight interleaved partial sums
+  double lanes[8] = {};
+  double integralLanes[8] = {};
+  double naiveSum = 0;
+  double naiveIntegral = 0;
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      double width = bands[i].fh - bands[i].fl;
+      double term = a[i] * width;
+      lanes[i % 8] += a[i];
+      integralLanes[i % 8] += term;
+      naiveSum += a[i];
+      naiveIntegral += term;
+    }
+  double expectedSum = ((lanes[0] + lanes[1]) + (lanes[2] + lanes[3]))
+    + ((lanes[4] + lanes[5]) + (lanes[6] + lanes[7]));
+  double expectedIntegral = ((integralLanes[0] + integralLanes[1]) + (integralLanes[2] + integralLanes[3]))
+    + ((integralLanes[4] + integralLanes[5]) + (integralLanes[6] + integralLanes[7]));
+  NS_TEST_EXPECT_MSG_EQ (Sum (a), expectedSum, "Wrong Sum of " << n << " bands");
+  NS_TEST_EXPECT_MSG_EQ (Integral (a), expectedIntegral, "Wrong Integral of " << n << " bands");
+  NS_TEST_EXPECT_MSG_EQ_TOL (Sum (a), naiveSum, naiveSum * 1e-14, "Sum differs from the sequential sum");
+  NS_TEST_EXPECT_MSG_EQ_TOL (Integral (a), naiveIntegral, naiveIntegral * 1e-14,
+                             "Integral differs from the sequential sum");
+  NS_TEST_EXPECT_MSG_EQ_TOL (Norm (a) * Norm (a), Sum (a * a), Sum (a * a) * 1e-14, "Wrong Norm");
+}
+
+void
+SpectrumValueSimdTestCase::DoRun (void)
+{
+  uint32_t sizes[] = {0, 1, 3, 7, 8, 9, 15, 16, 17, 25, 100, 273, 275, 1000};
+  for (uint32_t n : sizes)
+    {
+      CheckSize (n);
+    }
+}
+
+
+/**
+ * \ingroup spectrum-tests
+ *
+ * \brief Test the sharing of the values of copied SpectrumValues
+ */
+class SpectrumValueCopyOnWriteTestCase : public TestCase
+{
+public:
+  SpectrumValueCopyOnWriteTestCase ();
+  virtual void DoRun (void);
+};
+
+SpectrumValueCopyOnWriteTestCase::SpectrumValueCopyOnWriteTestCase ()
+  : TestCase ("Check the copy-on-write SpectrumValues and their buffer pool")
+{
+}
+
+void
+SpectrumValueCopyOnWriteTestCase::DoRun (void)
+{
+  std::vector<double> freqs;
+  for (int i = 1; i <= 25; i++)
+    {
+      freqs.push_back (i);
+    }
+  Ptr<SpectrumModel> model = Create<SpectrumModel> (freqs);
+
+  Ptr<SpectrumValue> tx = Create<SpectrumValue> (model);
+  for (uint32_t i = 0; i < tx->GetValuesN (); ++i)
+    {
+      (*tx)[i] = 1e-13 * (3 + std::sin (i * 0.7));
+    }
+  SpectrumValue reference = *tx;
+  const double gain = 3.7e-9;
+
+  // a scaled copy reads the values of the eager computation, and
+  // leaves the original untouched
+  Ptr<SpectrumValue> rx = tx->Copy ();
+  *rx *= gain;
+  Ptr<SpectrumValue> rx2 = Copy<SpectrumValue> (tx);
+  *rx2 *= 2.0;
+  *rx2 *= 0.5;
+  for (uint32_t i = 0; i < tx->GetValuesN (); ++i)
+    {
+      const SpectrumValue &crx = *rx;
+      NS_TEST_ASSERT_MSG_EQ (crx[i], reference[i] * gain, "wrong scaled copy at " << i);
+      NS_TEST_ASSERT_MSG_EQ ((*rx2)[i], reference[i] * 2.0 * 0.5, "wrong rescaled copy at " << i);
+      NS_TEST_ASSERT_MSG_EQ (tx->ValuesAt (i), reference[i], "original modified at " << i);
+    }
+  NS_TEST_ASSERT_MSG_EQ (Integral (*tx->Copy () * gain), Integral (*rx), "wrong scaled integral");
+
+  // modifying the original, or writing through the accessors, does not
+  // modify the copies
+  SpectrumValue copy = *tx;
+  *tx += 1;
+  *tx->ValuesBegin () = 5;
+  copy[1] = 7;
+  NS_TEST_ASSERT_MSG_EQ (copy[0], reference[0], "copy modified by the original");
+  NS_TEST_ASSERT_MSG_EQ (copy[1], 7, "wrong copy");
+  NS_TEST_ASSERT_MSG_EQ ((*tx)[0], 5, "wrong original");
+  NS_TEST_ASSERT_MSG_EQ ((*tx)[1], reference[1] + 1, "original modified by the copy");
+  copy = 2.5;
+  NS_TEST_ASSERT_MSG_EQ (Sum (copy), 2.5 * 25, "wrong assignment");
+  NS_TEST_ASSERT_MSG_EQ ((*tx)[2], reference[2] + 1, "original modified by the assignment");
+
+  // the buffers of released SpectrumValues are reused
+  rx = 0;
+  rx2 = 0;
+  SpectrumValue::PoolStats before = SpectrumValue::GetPoolStats ();
+  NS_TEST_ASSERT_MSG_GT (before.cached, 0, "no buffer released to the pool");
+  SpectrumValue fresh (model);
+  SpectrumValue::PoolStats after = SpectrumValue::GetPoolStats ();
+  NS_TEST_ASSERT_MSG_EQ (after.recycled, before.recycled + 1, "buffer not recycled");
+  NS_TEST_ASSERT_MSG_EQ (after.allocated, before.allocated, "buffer allocated");
+  NS_TEST_ASSERT_MSG_EQ (Sum (fresh), 0, "recycled buffer not cleared");
+}
+
+
 /**
  * \ingroup spectrum-tests
  *
@@ -260,6 +442,9 @@ SpectrumValueTestSuite::SpectrumValueTestSuite ()
   tv1rs3 = v1 >> 3;
   AddTestCase (new SpectrumValueTestCase (tv1rs3, v1rs3, "tv1rs3 = v1 >> 3"), TestCase::QUICK);
 
+  AddTestCase (new SpectrumValueSimdTestCase, TestCase::QUICK);
+  AddTestCase (new SpectrumValueCopyOnWriteTestCase, TestCase::QUICK);
+
 
 }
 
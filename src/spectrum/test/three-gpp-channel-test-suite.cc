@@ -35,6 +35,9 @@
 #include "ns3/channel-condition-model.h"
 #include "ns3/three-gpp-spectrum-propagation-loss-model.h"
 #include "ns3/wifi-spectrum-value-helper.h"
+#include "ns3/multi-model-spectrum-channel.h"
+#include "ns3/spectrum-phy.h"
+#include "ns3/spectrum-signal-parameters.h"
 
 using namespace ns3;
 
@@ -97,7 +100,7 @@ ThreeGppChannelMatrixComputationTest::DoComputeNorm (Ptr<ThreeGppChannelModel> c
   Ptr<const ThreeGppChannelModel::ChannelMatrix> channelMatrix = channelModel->GetChannel (txMob, rxMob, txAntenna, rxAntenna);
 
   double channelNorm = 0;
-  uint8_t numTotClusters = channelMatrix->m_channel.at (0).at (0).size ();
+  uint8_t numTotClusters = channelMatrix->m_channel.GetNumPages ();
   for (uint8_t cIndex = 0; cIndex < numTotClusters; cIndex++)
   {
     double clusterNorm = 0;
@@ -105,7 +108,7 @@ ThreeGppChannelMatrixComputationTest::DoComputeNorm (Ptr<ThreeGppChannelModel> c
     {
       for (uint32_t uIndex = 0; uIndex < rxAntennaElements; uIndex++)
       {
-        clusterNorm += std::pow (std::abs (channelMatrix->m_channel.at (uIndex).at (sIndex).at (cIndex)), 2);
+        clusterNorm += std::pow (std::abs (channelMatrix->m_channel (uIndex, sIndex, cIndex)), 2);
       }
     }
     channelNorm += clusterNorm;
@@ -167,8 +170,8 @@ ThreeGppChannelMatrixComputationTest::DoRun (void)
   Ptr<const ThreeGppChannelModel::ChannelMatrix> channelMatrix = channelModel->GetChannel (txMob, rxMob, txAntenna, rxAntenna);
 
   // check the channel matrix dimensions
-  NS_TEST_ASSERT_MSG_EQ (channelMatrix->m_channel.at (0).size (), txAntennaElements [0] * txAntennaElements [1], "The second dimension of H should be equal to the number of tx antenna elements");
-  NS_TEST_ASSERT_MSG_EQ (channelMatrix->m_channel.size (), rxAntennaElements [0] * rxAntennaElements [1], "The first dimension of H should be equal to the number of rx antenna elements");
+  NS_TEST_ASSERT_MSG_EQ (channelMatrix->m_channel.GetNumCols (), txAntennaElements [0] * txAntennaElements [1], "The second dimension of H should be equal to the number of tx antenna elements");
+  NS_TEST_ASSERT_MSG_EQ (channelMatrix->m_channel.GetNumRows (), rxAntennaElements [0] * rxAntennaElements [1], "The first dimension of H should be equal to the number of rx antenna elements");
 
   // test if the channel matrix is correctly generated
   uint16_t numIt = 1000;
@@ -577,6 +580,199 @@ ThreeGppSpectrumPropagationLossModelTest::DoRun ()
   Simulator::Destroy ();
 }
 
+/**
+ * \ingroup spectrum-tests
+ *
+ * SpectrumPhy recording the PSDs it receives
+ */
+class ThreeGppParallelRxPsdTestPhy : public SpectrumPhy
+{
+public:
+  /**
+   * Constructor
+   * \param device the device of the PHY
+   * \param antenna the antenna array of the PHY
+   * \param rxModel the spectrum model of the receiver
+   * \param psds the PSDs received by all the PHYs
+   */
+  ThreeGppParallelRxPsdTestPhy (Ptr<NetDevice> device, Ptr<PhasedArrayModel> antenna,
+                                Ptr<const SpectrumModel> rxModel,
+                                std::vector<std::vector<double> > *psds)
+    : m_device (device),
+      m_antenna (antenna),
+      m_rxModel (rxModel),
+      m_psds (psds)
+  {
+  }
+
+  void SetDevice (Ptr<NetDevice> d) override
+  {
+  }
+  Ptr<NetDevice> GetDevice () const override
+  {
+    return m_device;
+  }
+  void SetMobility (Ptr<MobilityModel> m) override
+  {
+  }
+  Ptr<MobilityModel> GetMobility () const override
+  {
+    return m_device->GetNode ()->GetObject<MobilityModel> ();
+  }
+  void SetChannel (Ptr<SpectrumChannel> c) override
+  {
+  }
+  Ptr<const SpectrumModel> GetRxSpectrumModel () const override
+  {
+    return m_rxModel;
+  }
+  Ptr<Object> GetAntenna () const override
+  {
+    return m_antenna;
+  }
+  void StartRx (Ptr<SpectrumSignalParameters> params) override
+  {
+    m_psds->push_back (std::vector<double> (params->psd->ConstValuesBegin (), params->psd->ConstValuesEnd ()));
+  }
+
+private:
+  Ptr<NetDevice> m_device;                  //!< the device
+  Ptr<PhasedArrayModel> m_antenna;          //!< the antenna array
+  Ptr<const SpectrumModel> m_rxModel;       //!< the spectrum model of the receiver
+  std::vector<std::vector<double> > *m_psds; //!< the PSDs received by all the PHYs
+};
+
+/**
+ * \ingroup spectrum-tests
+ *
+ * Test case checking that the PSDs received through a
+ * MultiModelSpectrumChannel with a ThreeGppSpectrumPropagationLossModel
+ * are the same when they are computed in parallel
+ */
+class ThreeGppParallelRxPsdTest : public TestCase
+{
+public:
+  /**
+   * Constructor
+   */
+  ThreeGppParallelRxPsdTest ();
+
+private:
+  /**
+   * Build the test scenario
+   */
+  void DoRun (void) override;
+
+  /**
+   * Run the scenario
+   * \param rxThreads the number of threads computing the PSDs
+   * \param psds the PSDs received
+   */
+  void RunScenario (uint32_t rxThreads, std::vector<std::vector<double> > &psds);
+
+  /**
+   * Points the beam of a device towards another one
+   * \param thisDevice the device to configure
+   * \param thisAntenna the antenna object associated to thisDevice
+   * \param otherDevice the device to communicate with
+   */
+  static void DoBeamforming (Ptr<NetDevice> thisDevice, Ptr<PhasedArrayModel> thisAntenna, Ptr<NetDevice> otherDevice);
+};
+
+ThreeGppParallelRxPsdTest::ThreeGppParallelRxPsdTest ()
+  : TestCase ("Check the received PSDs computed in parallel by the ThreeGppSpectrumPropagationLossModel")
+{
+}
+
+void
+ThreeGppParallelRxPsdTest::DoBeamforming (Ptr<NetDevice> thisDevice, Ptr<PhasedArrayModel> thisAntenna, Ptr<NetDevice> otherDevice)
+{
+  Vector aPos = thisDevice->GetNode ()->GetObject<MobilityModel> ()->GetPosition ();
+  Vector bPos = otherDevice->GetNode ()->GetObject<MobilityModel> ()->GetPosition ();
+  thisAntenna->SetBeamformingVector (thisAntenna->GetBeamformingVector (Angles (bPos, aPos)));
+}
+
+void
+ThreeGppParallelRxPsdTest::RunScenario (uint32_t rxThreads, std::vector<std::vector<double> > &psds)
+{
+  Config::SetDefault ("ns3::ThreeGppChannelModel::UpdatePeriod", TimeValue (MilliSeconds (100)));
+
+  Ptr<ThreeGppSpectrumPropagationLossModel> lossModel = CreateObject<ThreeGppSpectrumPropagationLossModel> ();
+  lossModel->SetChannelModelAttribute ("Frequency", DoubleValue (2.4e9));
+  lossModel->SetChannelModelAttribute ("Scenario", StringValue ("UMa"));
+  lossModel->SetChannelModelAttribute ("ChannelConditionModel", PointerValue (CreateObject<AlwaysLosChannelConditionModel> ()));
+  DynamicCast<ThreeGppChannelModel> (lossModel->GetChannelModel ())->AssignStreams (1);
+
+  Ptr<MultiModelSpectrumChannel> channel = CreateObjectWithAttributes<MultiModelSpectrumChannel> ("RxThreads", UintegerValue (rxThreads));
+  channel->AddPhasedArraySpectrumPropagationLossModel (lossModel);
+
+  WifiSpectrumValue5MhzFactory sf;
+  Ptr<SpectrumValue> txPsd = sf.CreateTxPowerSpectralDensity (0.1, 1);
+
+  const uint32_t nNodes = 8;
+  NodeContainer nodes;
+  nodes.Create (nNodes);
+  std::vector<Ptr<SimpleNetDevice> > devices;
+  std::vector<Ptr<PhasedArrayModel> > antennas;
+  std::vector<Ptr<ThreeGppParallelRxPsdTestPhy> > phys;
+  for (uint32_t i = 0; i < nNodes; ++i)
+    {
+      Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice> ();
+      nodes.Get (i)->AddDevice (device);
+      device->SetNode (nodes.Get (i));
+      Ptr<MobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+      mobility->SetPosition (Vector (20.0 * (i % 4), 15.0 * (i / 4) + 3.0 * i, 1.5 + i));
+      nodes.Get (i)->AggregateObject (mobility);
+      Ptr<PhasedArrayModel> antenna = CreateObjectWithAttributes<UniformPlanarArray> ("NumColumns", UintegerValue (2),
+                                                                                      "NumRows", UintegerValue (2),
+                                                                                      "AntennaElement", PointerValue (CreateObject<IsotropicAntennaModel> ()));
+      Ptr<ThreeGppParallelRxPsdTestPhy> phy = Create<ThreeGppParallelRxPsdTestPhy> (device, antenna, txPsd->GetSpectrumModel (), &psds);
+      channel->AddRx (phy);
+      devices.push_back (device);
+      antennas.push_back (antenna);
+      phys.push_back (phy);
+    }
+  for (uint32_t i = 0; i < nNodes; ++i)
+    {
+      DoBeamforming (devices[i], antennas[i], devices[(i + 1) % nNodes]);
+    }
+
+  // transmissions before and after the update of the channel matrices,
+  // with a change of beam in between
+  for (uint32_t t = 0; t < 12; ++t)
+    {
+      Ptr<SpectrumSignalParameters> params = Create<SpectrumSignalParameters> ();
+      params->psd = txPsd;
+      params->duration = MilliSeconds (1);
+      params->txPhy = phys[(t * 3) % nNodes];
+      Simulator::Schedule (MilliSeconds (30 * t), &SpectrumChannel::StartTx, channel, params);
+    }
+  Simulator::Schedule (MilliSeconds (140), &ThreeGppParallelRxPsdTest::DoBeamforming, devices[2], antennas[2], devices[5]);
+
+  Simulator::Run ();
+  Simulator::Destroy ();
+  channel->Dispose ();
+}
+
+void
+ThreeGppParallelRxPsdTest::DoRun ()
+{
+  std::vector<std::vector<double> > expected;
+  RunScenario (1, expected);
+  NS_TEST_ASSERT_MSG_EQ (expected.size (), 12 * 7, "Wrong number of PSDs received");
+
+  for (uint32_t rxThreads : {2, 4})
+    {
+      std::vector<std::vector<double> > psds;
+      RunScenario (rxThreads, psds);
+      NS_TEST_ASSERT_MSG_EQ (psds.size (), expected.size (), "Wrong number of PSDs received with " << rxThreads << " threads");
+      for (std::size_t i = 0; i < psds.size (); ++i)
+        {
+          NS_TEST_ASSERT_MSG_EQ ((psds[i] == expected[i]), true, "PSD " << i << " differs with " << rxThreads << " threads");
+        }
+    }
+}
+
 /**
  * \ingroup spectrum-tests
  *
@@ -597,6 +793,7 @@ ThreeGppChannelTestSuite::ThreeGppChannelTestSuite ()
   AddTestCase (new ThreeGppChannelMatrixComputationTest, TestCase::QUICK);
   AddTestCase (new ThreeGppChannelMatrixUpdateTest, TestCase::QUICK);
   AddTestCase (new ThreeGppSpectrumPropagationLossModelTest, TestCase::QUICK);
+  AddTestCase (new ThreeGppParallelRxPsdTest, TestCase::QUICK);
 }
 
 /// Static variable for test initialization
@@ -305,7 +305,10 @@ PhyEntity::EndReceiveField (WifiPpduField field, Ptr<Event> event)
             if (status.reason == FILTERED)
               {
                 //PHY-RXSTART is immediately followed by PHY-RXEND (Filtered)
-                m_wifiPhy->m_phyRxPayloadBeginTrace (txVector, NanoSeconds (0)); //this callback (equivalent to PHY-RXSTART primitive) is also triggered for filtered PPDUs
+                if (!m_wifiPhy->m_phyRxPayloadBeginTrace.IsEmpty ())
+                  {
+                    m_wifiPhy->m_phyRxPayloadBeginTrace (txVector, NanoSeconds (0)); //this callback (equivalent to PHY-RXSTART primitive) is also triggered for filtered PPDUs
+                  }
               }
             m_wifiPhy->NotifyRxDrop (GetAddressedPsduInPpdu (ppdu), status.reason);
             m_state->SwitchMaybeToCcaBusy (GetRemainingDurationAfterField (ppdu, field)); //keep in CCA busy state till the end
@@ -533,7 +536,10 @@ PhyEntity::StartReceivePayload (Ptr<Event> event)
 
   //TODO: Add method in WifiPhy to clear all other PHYs (since this one is starting Rx)
   m_state->SwitchToRx (payloadDuration);
-  m_wifiPhy->m_phyRxPayloadBeginTrace (txVector, payloadDuration); //this callback (equivalent to PHY-RXSTART primitive) is triggered only if headers have been correctly decoded and that the mode within is supported
+  if (!m_wifiPhy->m_phyRxPayloadBeginTrace.IsEmpty ())
+    {
+      m_wifiPhy->m_phyRxPayloadBeginTrace (txVector, payloadDuration); //this callback (equivalent to PHY-RXSTART primitive) is triggered only if headers have been correctly decoded and that the mode within is supported
+    }
 
   DoStartReceivePayload (event);
 }
@@ -1040,7 +1046,10 @@ PhyEntity::GetCenterFrequencyForChannelWidth (const WifiTxVector& txVector) cons
 void
 PhyEntity::NotifyPayloadBegin (const WifiTxVector& txVector, const Time& payloadDuration)
 {
-  m_wifiPhy->m_phyRxPayloadBeginTrace (txVector, payloadDuration);
+  if (!m_wifiPhy->m_phyRxPayloadBeginTrace.IsEmpty ())
+    {
+      m_wifiPhy->m_phyRxPayloadBeginTrace (txVector, payloadDuration);
+    }
 }
 
 void
@@ -26,11 +26,16 @@
 #include "ns3/propagation-loss-model.h"
 #include "ns3/propagation-delay-model.h"
 #include "ns3/mobility-model.h"
+#include "ns3/spatial-index.h"
+#include "ns3/double.h"
 #include "yans-wifi-channel.h"
 #include "yans-wifi-phy.h"
 #include "wifi-utils.h"
 #include "wifi-ppdu.h"
 #include "wifi-psdu.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
 
 namespace ns3 {
 
@@ -53,11 +58,21 @@ YansWifiChannel::GetTypeId (void)
                    PointerValue (),
                    MakePointerAccessor (&YansWifiChannel::m_delay),
                    MakePointerChecker<PropagationDelayModel> ())
+    .AddAttribute ("SpatialIndexCellSize",
+                   "If positive, the PHYs are placed in a grid of square cells "
+                   "of this size, in meters, which lets the channel skip the "
+                   "PHYs out of range of the propagation loss model. "
+                   "A value of zero disables the index.",
+                   DoubleValue (0),
+                   MakeDoubleAccessor (&YansWifiChannel::m_spatialIndexCellSize),
+                   MakeDoubleChecker<double> (0))
   ;
   return tid;
 }
 
 YansWifiChannel::YansWifiChannel ()
+  : m_spatialIndexCellSize (0),
+    m_maxRxMarginDb (-std::numeric_limits<double>::infinity ())
 {
   NS_LOG_FUNCTION (this);
 }
@@ -66,6 +81,7 @@ YansWifiChannel::~YansWifiChannel ()
 {
   NS_LOG_FUNCTION (this);
   m_phyList.clear ();
+  m_spatialIndex = 0;
 }
 
 void
@@ -88,7 +104,38 @@ YansWifiChannel::Send (Ptr<YansWifiPhy> sender, Ptr<const WifiPpdu> ppdu, double
   NS_LOG_FUNCTION (this << sender << ppdu << txPowerDbm);
   Ptr<MobilityModel> senderMobility = sender->GetMobility ();
   NS_ASSERT (senderMobility != 0);
-  for (PhyList::const_iterator i = m_phyList.begin (); i != m_phyList.end (); i++)
+
+  // skip the PHYs out of range, if they are indexed
+  PhyList candidates;
+  const PhyList *phyList = &m_phyList;
+  if (m_spatialIndexCellSize > 0 && m_loss != 0)
+    {
+      if (m_spatialIndex == 0)
+        {
+          m_spatialIndex = CreateObjectWithAttributes<SpatialIndex> ("CellSize", DoubleValue (m_spatialIndexCellSize));
+          for (const auto &phy : m_phyList)
+            {
+              AddToSpatialIndex (phy);
+            }
+        }
+      // a PHY drops the signals below its sensitivity; the margin
+      // allows for rounding errors
+      double range = m_loss->GetMaxRange (txPowerDbm, -m_maxRxMarginDb - 1e-6);
+      if (!std::isinf (range))
+        {
+          std::vector<uint32_t> keys;
+          m_spatialIndex->GetCandidates (senderMobility->GetPosition (), range, keys);
+          NS_LOG_LOGIC ("range " << range << " m, " << keys.size () << " of " << m_phyList.size () << " PHYs");
+          // the keys are the positions in the PHY list, which is never shrunk
+          for (uint32_t key : keys)
+            {
+              candidates.push_back (m_phyList[key]);
+            }
+          phyList = &candidates;
+        }
+    }
+
+  for (PhyList::const_iterator i = phyList->begin (); i != phyList->end (); i++)
     {
       if (sender != (*i))
         {
@@ -155,6 +202,18 @@ YansWifiChannel::Add (Ptr<YansWifiPhy> phy)
 {
   NS_LOG_FUNCTION (this << phy);
   m_phyList.push_back (phy);
+  AddToSpatialIndex (phy);
+}
+
+void
+YansWifiChannel::AddToSpatialIndex (Ptr<YansWifiPhy> phy) const
+{
+  if (m_spatialIndex == 0)
+    {
+      return;
+    }
+  m_spatialIndex->Add (phy->GetMobility ());
+  m_maxRxMarginDb = std::max (m_maxRxMarginDb, phy->GetRxGain () - phy->GetRxSensitivity ());
 }
 
 int64_t
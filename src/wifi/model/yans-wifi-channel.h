@@ -28,6 +28,7 @@ namespace ns3 {
 class NetDevice;
 class PropagationLossModel;
 class PropagationDelayModel;
+class SpatialIndex;
 class YansWifiPhy;
 class Packet;
 class Time;
@@ -41,6 +42,13 @@ class WifiPpdu;
  * class and supports an ns3::PropagationLossModel and an
  * ns3::PropagationDelayModel.  By default, no propagation models are set;
  * it is the caller's responsibility to set them before using the channel.
+ *
+ * If the SpatialIndexCellSize attribute is positive, the channel places
+ * the PHYs in a SpatialIndex when it first sends a PPDU, and skips the
+ * PHYs beyond the range in which the propagation loss model lets the
+ * signal reach the sensitivity of any PHY.  The RxGain and RxSensitivity
+ * attributes of a PHY must then not change once it sent or received a
+ * PPDU, nor its mobility model be replaced.
  */
 class YansWifiChannel : public Channel
 {
@@ -114,9 +122,19 @@ private:
    */
   static void Receive (Ptr<YansWifiPhy> receiver, Ptr<WifiPpdu> ppdu, double txPowerDbm);
 
+  /**
+   * Add a PHY to the spatial index, if it exists.
+   *
+   * \param phy the PHY, at the end of the PHY list
+   */
+  void AddToSpatialIndex (Ptr<YansWifiPhy> phy) const;
+
   PhyList m_phyList;                   //!< List of YansWifiPhys connected to this YansWifiChannel
   Ptr<PropagationLossModel> m_loss;    //!< Propagation loss model
   Ptr<PropagationDelayModel> m_delay;  //!< Propagation delay model
+  double m_spatialIndexCellSize;       //!< Size of the cells of the spatial index (m), or 0
+  mutable Ptr<SpatialIndex> m_spatialIndex; //!< Spatial index of the PHYs, or 0 until first used
+  mutable double m_maxRxMarginDb;      //!< Largest RxGain minus RxSensitivity of the PHYs (dB)
 };
 
 } //namespace ns3
@@ -0,0 +1,179 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/core-module.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \file
+ * \ingroup system-tests-perf
+ *
+ * Benchmark the cost of making, copying and invoking Callbacks, and of
+ * firing a TracedCallback with many sinks.
+ *
+ * Each benchmark reports the mean time per operation, in nanoseconds.
+ */
+
+namespace {
+
+/** Callback target. */
+class Target : public SimpleRefCount<Target>
+{
+public:
+  /**
+   * Accumulate a value.
+   * \param [in] a The value.
+   */
+  void Add (uint32_t a)
+  {
+    m_sum += a;
+  }
+  /**
+   * Accumulate a value, with a bound argument.
+   * \param [in] target The target.
+   * \param [in] a The value.
+   */
+  static void BoundAdd (Target *target, uint32_t a)
+  {
+    target->m_sum += a;
+  }
+  uint64_t m_sum = 0; //!< The sum of the values.
+};
+
+/**
+ * Measure the mean duration of a loop iteration.
+ *
+ * \tparam F \deduced The loop body type.
+ * \param [in] label The benchmark label.
+ * \param [in] n The number of iterations.
+ * \param [in] body The loop body, called with the iteration index.
+ */
+template <typename F>
+void
+Measure (std::string label, uint32_t n, F body)
+{
+  auto start = std::chrono::steady_clock::now ();
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      body (i);
+    }
+  auto end = std::chrono::steady_clock::now ();
+  double ns = std::chrono::duration<double, std::nano> (end - start).count () / n;
+  std::cout << std::left << std::setw (32) << label
+            << std::right << std::fixed << std::setprecision (2) << std::setw (10) << ns
+            << " ns" << std::endl;
+}
+
+/**
+ * Benchmark a Callback.
+ *
+ * \param [in] label The Callback kind.
+ * \param [in] n The number of iterations.
+ * \param [in] make Make the Callback.
+ */
+void
+Bench (std::string label, uint32_t n, Callback<Callback<void, uint32_t> > make)
+{
+  Measure (label + " make", n, [&make] (uint32_t i) {
+          Callback<void, uint32_t> cb = make ();
+          cb (i);
+        });
+  Callback<void, uint32_t> cb = make ();
+  std::vector<Callback<void, uint32_t> > copies (16);
+  Measure (label + " copy", n, [&cb, &copies] (uint32_t i) {
+          copies[i % copies.size ()] = cb;
+        });
+  Measure (label + " invoke", n, [&cb] (uint32_t i) {
+          cb (i);
+        });
+}
+
+/** Target of all the callbacks. */
+Target g_target;
+/** Reference counted target of all the callbacks. */
+Ptr<Target> g_ptrTarget;
+
+/** \returns A Callback with an object pointer. */
+Callback<void, uint32_t>
+MakeRawPointerCallback (void)
+{
+  return MakeCallback (&Target::Add, &g_target);
+}
+
+/** \returns A Callback with an object Ptr. */
+Callback<void, uint32_t>
+MakePtrCallback (void)
+{
+  return MakeCallback (&Target::Add, g_ptrTarget);
+}
+
+/** \returns A Callback with a bound argument. */
+Callback<void, uint32_t>
+MakeBound (void)
+{
+  return MakeBoundCallback (&Target::BoundAdd, &g_target);
+}
+
+}  // unnamed namespace
+
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t n = 10000000;
+  uint32_t sinks = 1000;
+
+  CommandLine cmd (__FILE__);
+  cmd.Usage ("Benchmark Callback and TracedCallback operations.");
+  cmd.AddValue ("n", "number of iterations", n);
+  cmd.AddValue ("sinks", "number of TracedCallback sinks", sinks);
+  cmd.Parse (argc, argv);
+
+  if (n == 0)
+    {
+      return 0;
+    }
+  g_ptrTarget = Create<Target> ();
+
+  Bench ("MakeCallback (obj*)", n, MakeCallback (&MakeRawPointerCallback));
+  Bench ("MakeCallback (Ptr<obj>)", n, MakeCallback (&MakePtrCallback));
+  Bench ("MakeBoundCallback", n, MakeCallback (&MakeBound));
+
+  TracedCallback<uint32_t> traced;
+  for (uint32_t i = 0; i < sinks; ++i)
+    {
+      traced.ConnectWithoutContext (MakeCallback (&Target::Add, &g_target));
+    }
+  uint32_t fires = std::max (n / std::max (sinks, 1u), 1u);
+  std::ostringstream label;
+  label << "TracedCallback (" << sinks << " sinks)";
+  Measure (label.str (), fires, [&traced] (uint32_t i) {
+          traced (i);
+        });
+
+  std::cout << "checksum " << g_target.m_sum + g_ptrTarget->m_sum << std::endl;
+  g_ptrTarget = 0;
+  return 0;
+}
@@ -0,0 +1,147 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/core-module.h"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \file
+ * \ingroup system-tests-perf
+ *
+ * Benchmark the injection of events from other threads with
+ * Simulator::ScheduleWithContext(), as done by emulation and
+ * FdNetDevice reader threads.
+ *
+ * Each of the `--threads` producer threads schedules `--events` events
+ * as fast as it can, while the main thread runs the simulation.  The
+ * benchmark reports the time until the last event has run, and the
+ * resulting aggregate injection rate.
+ */
+
+namespace {
+
+/** Number of injected events which have run. */
+uint64_t g_received = 0;
+/** Total number of events to inject. */
+uint64_t g_total = 0;
+
+/** Injected event: count it, and stop when all have run. */
+void
+Receive (void)
+{
+  if (++g_received == g_total)
+    {
+      Simulator::Stop ();
+    }
+}
+
+/**
+ * Keep the DefaultSimulatorImpl running while waiting for injected
+ * events, which it moves to the event list after each event.
+ */
+void
+Tick (void)
+{
+  if (g_received < g_total)
+    {
+      Simulator::Schedule (NanoSeconds (1), &Tick);
+    }
+}
+
+/**
+ * Producer thread body.
+ * \param [in] context The number of events to inject and the event context.
+ */
+void
+Inject (std::pair<uint64_t, uint32_t> context)
+{
+  for (uint64_t i = 0; i < context.first; ++i)
+    {
+      Simulator::ScheduleWithContext (context.second, Seconds (0), &Receive);
+    }
+}
+
+}  // unnamed namespace
+
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t threads = 4;
+  uint64_t events = 1000000;
+  bool realtime = false;
+
+  CommandLine cmd (__FILE__);
+  cmd.Usage ("Benchmark event injection from other threads.");
+  cmd.AddValue ("threads", "number of producer threads", threads);
+  cmd.AddValue ("events", "number of events injected by each thread", events);
+  cmd.AddValue ("realtime", "use RealtimeSimulatorImpl", realtime);
+  cmd.Parse (argc, argv);
+
+  if (realtime)
+    {
+      GlobalValue::Bind ("SimulatorImplementationType",
+                         StringValue ("ns3::RealtimeSimulatorImpl"));
+    }
+
+  g_received = 0;
+  g_total = uint64_t (threads) * events;
+  if (g_total == 0)
+    {
+      return 0;
+    }
+  if (!realtime)
+    {
+      Simulator::Schedule (NanoSeconds (1), &Tick);
+    }
+
+  std::vector<Ptr<SystemThread> > producers;
+  for (uint32_t i = 0; i < threads; ++i)
+    {
+      producers.push_back (Create<SystemThread> (MakeBoundCallback (
+        &Inject, std::pair<uint64_t, uint32_t> (events, i))));
+    }
+
+  auto start = std::chrono::steady_clock::now ();
+  for (uint32_t i = 0; i < threads; ++i)
+    {
+      producers[i]->Start ();
+    }
+  Simulator::Run ();
+  auto end = std::chrono::steady_clock::now ();
+
+  for (uint32_t i = 0; i < threads; ++i)
+    {
+      producers[i]->Join ();
+    }
+  Simulator::Destroy ();
+
+  double seconds = std::chrono::duration<double> (end - start).count ();
+  std::cout << (realtime ? "RealtimeSimulatorImpl" : "DefaultSimulatorImpl")
+            << "  threads: " << threads
+            << "  events: " << g_total
+            << "  time: " << std::fixed << std::setprecision (3) << seconds << " s"
+            << "  rate: " << std::setprecision (0) << g_total / seconds << " events/s"
+            << std::endl;
+  return 0;
+}
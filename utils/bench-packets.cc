@@ -32,6 +32,8 @@
 #include <stdlib.h> // for exit ()
 #include <limits>
 #include <algorithm>
+#include <vector>
+#include <malloc.h>
 
 using namespace ns3;
 
@@ -328,6 +330,125 @@ benchByteTags (uint32_t n)
     }
 }
 
+/**
+ * Carry a packet through the layers of a protocol stack, like the
+ * flow, bearer, PDCP, RLC and PHY tags of the LTE stack: each layer
+ * looks up the tags of the layers above and hands a tagged copy to
+ * the layer below, and the receiver removes the tags in reverse order.
+ * \param n number of packets
+ */
+static void
+benchPacketTags (uint32_t n)
+{
+  BenchTag<4> flow;
+  BenchTag<8> bearer;
+  BenchTag<9> pdcp;
+  BenchTag<10> rlc;
+  BenchTag<12> phy;
+
+  for (uint32_t i = 0; i < n; i++)
+    {
+      Ptr<Packet> p = Create<Packet> (1000);
+      p->AddPacketTag (flow);
+      p->AddPacketTag (bearer);
+      Ptr<Packet> q = p->Copy ();
+      q->PeekPacketTag (flow);
+      q->PeekPacketTag (bearer);
+      q->AddPacketTag (pdcp);
+      Ptr<Packet> r = q->Copy ();
+      r->PeekPacketTag (bearer);
+      r->PeekPacketTag (pdcp);
+      r->AddPacketTag (rlc);
+      Ptr<Packet> s = r->Copy ();
+      s->PeekPacketTag (bearer);
+      s->AddPacketTag (phy);
+
+      s->RemovePacketTag (phy);
+      s->PeekPacketTag (rlc);
+      s->RemovePacketTag (rlc);
+      s->PeekPacketTag (pdcp);
+      s->RemovePacketTag (pdcp);
+      s->PeekPacketTag (bearer);
+      s->RemovePacketTag (bearer);
+      s->PeekPacketTag (flow);
+    }
+}
+
+/**
+ * Get the number of bytes allocated on the heap.
+ * \returns The number of allocated bytes, or 0 when not available.
+ */
+static uint64_t
+GetHeapSize (void)
+{
+#if defined (__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+  return mallinfo2 ().uordblks;
+#else
+  return 0;
+#endif
+}
+
+/// UDP packet with a 1000 byte payload.
+static Ptr<Packet>
+MakeUdpPacket (void)
+{
+  BenchHeader<25> ipv4;
+  BenchHeader<8> udp;
+  Ptr<Packet> p = Create<Packet> (1000);
+  p->AddHeader (udp);
+  p->AddHeader (ipv4);
+  return p;
+}
+
+/// IP fragment of a 2000 byte UDP packet.
+static Ptr<Packet>
+MakeFragment (void)
+{
+  BenchHeader<25> ipv4;
+  BenchHeader<8> udp;
+  Ptr<Packet> p = Create<Packet> (2000);
+  p->AddHeader (udp);
+  Ptr<Packet> fragment = p->CreateFragment (1000, p->GetSize () - 1000);
+  fragment->AddHeader (ipv4);
+  return fragment;
+}
+
+/// Concatenation of two UDP packets, e.g. in an A-MSDU or an RLC PDU.
+static Ptr<Packet>
+MakeConcatenation (void)
+{
+  BenchHeader<4> subheader;
+  Ptr<Packet> p = MakeUdpPacket ();
+  Ptr<Packet> q = MakeUdpPacket ();
+  q->AddHeader (subheader);
+  p->AddAtEnd (q);
+  p->AddHeader (subheader);
+  return p;
+}
+
+/**
+ * Measure the heap memory used by each of n packets kept in flight.
+ * \param make The function making a packet.
+ * \param n The number of packets.
+ * \param name The benchmark name.
+ */
+static void
+runMemoryBench (Ptr<Packet> (*make) (void), uint32_t n, char const *name)
+{
+  std::vector<Ptr<Packet> > packets;
+  packets.reserve (n);
+  uint64_t before = GetHeapSize ();
+  for (uint32_t i = 0; i < n; i++)
+    {
+      packets.push_back ((*make) ());
+    }
+  uint64_t after = GetHeapSize ();
+  std::cout << static_cast<double> (after - before) / n << " bytes/packet"
+            << " (" << packets.back ()->GetSize () << " byte packets)\t"
+            << name
+            << std::endl;
+}
+
 static uint64_t
 runBenchOneIteration (void (*bench) (uint32_t), uint32_t n)
 {
@@ -385,6 +506,15 @@ int main (int argc, char *argv[])
   runBench (&benchD, n, minIterations, "Intermixed add/remove headers and tags");
   runBench (&benchFragment, n, minIterations, "Fragmentation and concatenation");
   runBench (&benchByteTags, n, minIterations, "Benchmark byte tags");
+  runBench (&benchPacketTags, n, minIterations, "Packet tags through the layers");
+
+  if (GetHeapSize () != 0)
+    {
+      std::cout << "Heap memory per packet in flight:" << std::endl;
+      runMemoryBench (&MakeUdpPacket, n, "UDP packet");
+      runMemoryBench (&MakeFragment, n, "Fragment");
+      runMemoryBench (&MakeConcatenation, n, "Concatenation");
+    }
 
   return 0;
 }
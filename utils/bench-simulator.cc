@@ -204,7 +204,9 @@ int main (int argc, char *argv[])
 {
 
   bool schedCal           = false;
+  bool schedCompactHeap   = false;
   bool schedHeap          = false;
+  bool schedLadder        = false;
   bool schedList          = false;
   bool schedMap           = true;
   bool schedPriorityQueue = false;
@@ -226,7 +228,9 @@ int main (int argc, char *argv[])
              "to be ascii, giving the relative event times in ns.");
   cmd.AddValue ("cal",   "use CalendarSheduler",          schedCal);
   cmd.AddValue ("calrev", "reverse ordering in the CalendarScheduler", calRev);
+  cmd.AddValue ("compact", "use CompactHeapScheduler",    schedCompactHeap);
   cmd.AddValue ("heap",  "use HeapScheduler",             schedHeap);
+  cmd.AddValue ("ladder", "use LadderScheduler",          schedLadder);
   cmd.AddValue ("list",  "use ListSheduler",              schedList);
   cmd.AddValue ("map",   "use MapScheduler (default)",    schedMap);
   cmd.AddValue ("pri",   "use PriorityQueue",             schedPriorityQueue);
@@ -246,10 +250,18 @@ int main (int argc, char *argv[])
       factory.SetTypeId ("ns3::CalendarScheduler");
       factory.Set ("Reverse", BooleanValue (calRev));
     }
+  if (schedCompactHeap)
+    {
+      factory.SetTypeId ("ns3::CompactHeapScheduler");
+    }
   if (schedHeap)
     {
       factory.SetTypeId ("ns3::HeapScheduler");
     }
+  if (schedLadder)
+    {
+      factory.SetTypeId ("ns3::LadderScheduler");
+    }
   if (schedList)
     {
       factory.SetTypeId ("ns3::ListScheduler");
@@ -315,6 +327,10 @@ int main (int argc, char *argv[])
     }
 
   LOG ("");
+  EventImpl::PoolStats stats = EventImpl::GetPoolStats ();
+  LOGME ("event storage: " << stats.allocated << " allocated, "
+         << stats.recycled << " recycled, "
+         << stats.released << " released");
   Simulator::Destroy ();
   delete bench;
   return 0;
@@ -0,0 +1,199 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program benchmarks the SpectrumValue operations used by the
+// interference and SINR computations, on the spectrum models of a
+// 20 MHz LTE carrier (100 RBs) and of a 100 MHz NR carrier (275 RBs).
+// Compare the SIMD kernels with the scalar ones with:
+//   ./ns3 run 'bench-spectrum-value --n=1000000'
+//   ./ns3 run 'bench-spectrum-value --n=1000000 --SpectrumValueSimd=0'
+
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/spectrum-value.h"
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <algorithm>
+#include <stdlib.h> // for exit ()
+
+using namespace ns3;
+
+/// The operands of the benchmarks.
+struct Operands
+{
+  /**
+   * Create the operands.
+   * \param model the spectrum model
+   */
+  Operands (Ptr<const SpectrumModel> model);
+
+  SpectrumValue signal;     //!< A received signal
+  SpectrumValue allSignals; //!< The sum of the received signals
+  SpectrumValue noise;      //!< The noise
+  SpectrumValue sinr;       //!< The SINR
+};
+
+Operands::Operands (Ptr<const SpectrumModel> model)
+  : signal (model),
+    allSignals (model),
+    noise (model),
+    sinr (model)
+{
+  for (uint32_t i = 0; i < signal.GetValuesN (); ++i)
+    {
+      signal[i] = 1e-13 * (11 + 10 * std::sin (i * 0.37));
+      allSignals[i] = 1e-12 * (2 + std::cos (i * 0.11));
+      noise[i] = 4e-21;
+    }
+}
+
+/**
+ * Create the spectrum model of a carrier.
+ * \param rbs the number of resource blocks
+ * \param rbWidth the width of a resource block, in Hz
+ * \return the spectrum model
+ */
+static Ptr<SpectrumModel>
+MakeModel (uint32_t rbs, double rbWidth)
+{
+  Bands bands;
+  for (uint32_t i = 0; i < rbs; ++i)
+    {
+      BandInfo band;
+      band.fl = 2e9 + i * rbWidth;
+      band.fc = band.fl + rbWidth / 2;
+      band.fh = band.fl + rbWidth;
+      bands.push_back (band);
+    }
+  return Create<SpectrumModel> (bands);
+}
+
+/// The operations done when a signal starts and ends, and for the SINR.
+static void
+benchInterference (Operands &o, uint32_t n)
+{
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      o.allSignals += o.signal;
+      o.sinr = o.signal / (o.allSignals - o.signal + o.noise);
+      o.allSignals -= o.signal;
+    }
+}
+
+/// The copy of a transmitted PSD for a receiver, scaled by the path gain.
+static void
+benchScale (Operands &o, uint32_t n)
+{
+  Ptr<SpectrumValue> txPsd = o.signal.Copy ();
+  double sum = 0;
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      Ptr<SpectrumValue> rxPsd = txPsd->Copy ();
+      *rxPsd *= 0.999;
+      sum += rxPsd->ValuesAt (0);
+    }
+  if (sum == 0)
+    {
+      std::cerr << "unexpected sum" << std::endl;
+    }
+}
+
+/// Accumulation of a scaled PSD, in one or two passes.
+static void
+benchAddScaled (Operands &o, uint32_t n)
+{
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      o.allSignals.AddScaled (o.signal, 1e-3);
+      o.allSignals.AddScaled (o.signal, -1e-3);
+    }
+}
+
+/// The reductions used for the received power and the average SINR.
+static void
+benchReductions (Operands &o, uint32_t n)
+{
+  double sum = 0;
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      sum += Integral (o.signal) + Sum (o.allSignals);
+    }
+  if (sum == 0)
+    {
+      std::cerr << "unexpected sum" << std::endl;
+    }
+}
+
+/**
+ * Run a benchmark.
+ * \param bench the benchmark
+ * \param model the spectrum model
+ * \param n the number of iterations
+ * \param minIterations the number of runs to keep the fastest of
+ * \param name the name of the benchmark
+ */
+static void
+runBench (void (*bench) (Operands &, uint32_t), Ptr<const SpectrumModel> model,
+          uint32_t n, uint32_t minIterations, char const *name)
+{
+  uint64_t minDelay = std::numeric_limits<uint64_t>::max ();
+  for (uint32_t i = 0; i < minIterations; i++)
+    {
+      Operands operands (model);
+      SystemWallClockMs time;
+      time.Start ();
+      (*bench) (operands, n);
+      minDelay = std::min (minDelay, static_cast<uint64_t> (time.End ()));
+    }
+  std::cout << minDelay * 1e6 / n << " ns/iteration"
+            << " (" << minDelay << " ms elapsed)\t"
+            << model->GetNumBands () << " RBs: " << name
+            << std::endl;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t n = 0;
+  uint32_t minIterations = 1;
+
+  CommandLine cmd (__FILE__);
+  cmd.Usage ("Benchmark SpectrumValue operations");
+  cmd.AddValue ("n", "number of iterations", n);
+  cmd.AddValue ("min-iterations", "number of subiterations to minimize iteration time over", minIterations);
+  cmd.Parse (argc, argv);
+
+  if (n == 0)
+    {
+      std::cerr << "Error-- number of iterations must be specified " <<
+        "by command-line argument --n=(number of iterations)" << std::endl;
+      exit (1);
+    }
+  std::cout << "Running bench-spectrum-value with n=" << n
+            << ", SIMD instructions: " << SpectrumValue::GetSimdInstructionSet ()
+            << std::endl;
+
+  Ptr<SpectrumModel> models[] = {MakeModel (100, 180e3), MakeModel (275, 360e3)};
+  for (Ptr<SpectrumModel> model : models)
+    {
+      runBench (&benchInterference, model, n, minIterations, "Add, subtract and SINR");
+      runBench (&benchScale, model, n, minIterations, "Copy, scale and read");
+      runBench (&benchAddScaled, model, n, minIterations, "Add scaled PSD");
+      runBench (&benchReductions, model, n, minIterations, "Integral and Sum");
+    }
+
+  return 0;
+}
@@ -0,0 +1,161 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/core-module.h"
+
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \file
+ * \ingroup system-tests-perf
+ *
+ * Benchmark the Time conversions and arithmetic used by the PHY models.
+ *
+ * Each benchmark reports the mean time per operation, in nanoseconds.
+ * The operands are read from an array, and the results are folded into
+ * a checksum, so that the compiler can not hoist the operations out of
+ * the loops.  The checksum only depends on the results, so it can be
+ * compared between builds to check that they compute the same values.
+ */
+
+namespace {
+
+/** Checksum of the results. */
+uint64_t g_checksum = 0;
+
+/**
+ * Fold a result into the checksum.
+ *
+ * \param [in] v The result.
+ */
+inline void
+Fold (int64_t v)
+{
+  g_checksum = g_checksum * 31 + static_cast<uint64_t> (v);
+}
+
+/**
+ * Fold a floating point result into the checksum.
+ *
+ * \param [in] v The result.
+ */
+inline void
+Fold (double v)
+{
+  int64_t bits;
+  static_assert (sizeof (bits) == sizeof (v), "Unexpected double size");
+  std::memcpy (&bits, &v, sizeof (bits));
+  Fold (bits);
+}
+
+/**
+ * Measure the mean duration of a loop iteration.
+ *
+ * \tparam F \deduced The loop body type.
+ * \param [in] label The benchmark label.
+ * \param [in] n The number of iterations.
+ * \param [in] body The loop body, called with the iteration index.
+ */
+template <typename F>
+void
+Measure (std::string label, uint32_t n, F body)
+{
+  auto start = std::chrono::steady_clock::now ();
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      body (i);
+    }
+  auto end = std::chrono::steady_clock::now ();
+  double ns = std::chrono::duration<double, std::nano> (end - start).count () / n;
+  std::cout << std::left << std::setw (32) << label
+            << std::right << std::fixed << std::setprecision (2) << std::setw (10) << ns
+            << " ns" << std::endl;
+}
+
+}  // unnamed namespace
+
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t n = 10000000;
+
+  CommandLine cmd (__FILE__);
+  cmd.Usage ("Benchmark Time conversions and arithmetic.");
+  cmd.AddValue ("n", "number of iterations", n);
+  cmd.Parse (argc, argv);
+
+  if (n == 0)
+    {
+      return 0;
+    }
+
+  // Operands: a spread of PHY-like durations and scale factors.
+  const uint32_t size = 1024;
+  std::vector<int64_t> integers (size);
+  std::vector<double> doubles (size);
+  std::vector<Time> times (size);
+  Ptr<UniformRandomVariable> rng = CreateObject<UniformRandomVariable> ();
+  for (uint32_t i = 0; i < size; ++i)
+    {
+      integers[i] = rng->GetInteger (1, 100000);
+      doubles[i] = rng->GetValue (1e-6, 1e3);
+      times[i] = NanoSeconds (static_cast<int64_t> (rng->GetValue (1, 1e10)));
+    }
+  const uint32_t mask = size - 1;
+  // Time objects are only recorded for a resolution change until the
+  // simulation starts: run an empty simulation to stop the recording.
+  Simulator::Run ();
+
+  Measure ("MicroSeconds (int)", n, [&] (uint32_t i) {
+            Fold (MicroSeconds (integers[i & mask]).GetTimeStep ());
+          });
+  Measure ("MicroSeconds (double)", n, [&] (uint32_t i) {
+            Fold (MicroSeconds (doubles[i & mask]).GetTimeStep ());
+          });
+  Measure ("Seconds (double)", n, [&] (uint32_t i) {
+            Fold (Seconds (doubles[i & mask] * 1e-3).GetTimeStep ());
+          });
+  Measure ("GetSeconds", n, [&] (uint32_t i) {
+            Fold (times[i & mask].GetSeconds ());
+          });
+  Measure ("GetMicroSeconds", n, [&] (uint32_t i) {
+            Fold (times[i & mask].GetMicroSeconds ());
+          });
+  Measure ("To (Time::US)", n, [&] (uint32_t i) {
+            Fold (times[i & mask].To (Time::US).GetHigh ());
+          });
+  Measure ("Time * double", n, [&] (uint32_t i) {
+            Fold ((times[i & mask] * doubles[(i + 1) & mask]).GetTimeStep ());
+          });
+  Measure ("Time / Time", n, [&] (uint32_t i) {
+            Fold ((times[i & mask] / times[(i + 1) & mask]).GetDouble ());
+          });
+  Measure ("Time < Time", n, [&] (uint32_t i) {
+            Fold (static_cast<int64_t> (times[i & mask] < times[(i + 1) & mask]));
+          });
+
+  std::cout << "checksum " << g_checksum << std::endl;
+  Simulator::Destroy ();
+  return 0;
+}